@@ -0,0 +1,661 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw benchmark program
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+//  odbench runs the plugin's hot paths on a generated data set, without
+//  OpenCPN. Build with -DOD_BUILD_BENCHMARK=ON -DOD_USE_SVG=OFF, then
+//
+//      odbench generate FILE [--boundaries N] [--vertices N] [--ebls N] [--drs N]
+//                            [--drpoints N] [--textpoints N] [--boundarypoints N] [--seed N]
+//      odbench run FILE [--iterations N] [--queries N] [--deletes N] [--png DIR]
+//      odbench compare BEFORE AFTER
+//
+//  --boundaries 100 --vertices 1000 gives the 100k point file used for the
+//  loader. run needs an X display, xvfb-run will do. Each benchmark writes one JSON
+//  object on a line of its own to stdout, the log goes to stderr. --png saves
+//  the last frame of each render case, for comparing by eye or by diff. run
+//  exits with 1 if one of its consistency checks fails. compare takes the
+//  output of two runs, say before and after a change, and writes a line for
+//  each case found in both with the two medians and allocation counts.
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include <wx/atomic.h>
+#include <wx/dcmemory.h>
+#include <wx/filename.h>
+#include <wx/stopwatch.h>
+#include <wx/textfile.h>
+
+#include "ODBenchGenerator.h"
+#include "ODBenchStubs.h"
+#include "ocpn_draw_pi.h"
+#include "ODConfig.h"
+#include "ODdc.h"
+#include "ODGPXLoadContext.h"
+#include "ODJSON.h"
+#include "ODNavObjectChanges.h"
+#include "ODPath.h"
+#include "ODPoint.h"
+#include "ODProjection.h"
+#include "ODSelect.h"
+#include "ODStats.h"
+#include "BoundaryMan.h"
+#include "PathMan.h"
+#include "PointMan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+extern ODConfig         *g_pODConfig;
+extern ODSelect         *g_pODSelect;
+extern ODStats          *g_pODStats;
+extern PathList         *g_pPathList;
+extern PathMan          *g_pPathMan;
+extern PointMan         *g_pODPointMan;
+extern BoundaryMan      *g_pBoundaryMan;
+extern wxString         *g_pData;
+
+//  Select radius is worked out for 100 metres a pixel
+#define ODBENCH_SELECT_SCALE    0.01
+
+//  Render cases, in pixels per metre from a whole data set in view to a close up
+static const double s_RenderScales[] = { 0.0005, 0.005, 0.05 };
+static const int s_RenderSizes[][2] = { { 800, 600 }, { 1920, 1080 } };
+
+//  Every allocation made through new counts, on any thread
+static wxAtomicInt s_iAllocations = 0;
+
+void *operator new( size_t size )
+{
+    wxAtomicInc( s_iAllocations );
+    void *p = malloc( size ? size : 1 );
+    if( !p ) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete( void *p ) throw()
+{
+    free( p );
+}
+
+typedef std::vector<wxLongLong_t> ODBenchTimes;
+
+//  What compare takes from one line of run output
+struct ODBenchResult
+{
+    wxString    m_sCase;            // benchmark name, and frame for the render cases
+    double      m_dMedian;
+    double      m_dAllocations;
+};
+typedef std::vector<ODBenchResult> ODBenchResults;
+
+class ODBenchApp : public wxApp
+{
+public:
+    virtual bool OnInit();
+    virtual int OnRun();
+
+private:
+    bool GetOption( const wxString &name, long *value );
+    bool GetOption( const wxString &name, wxString *value );
+    int Generate( void );
+    int Run( void );
+    int Compare( void );
+    bool ReadResults( const wxString &filename, ODBenchResults *pResults );
+
+    void ClearObjects( void );
+    void GetBounds( void );
+    void NextPosition( double *lat, double *lon );
+    void MakeViewPort( PlugIn_ViewPort *pvp, int width, int height, double scale_ppm );
+    void Render( ocpn_draw_pi *pPlugin, int width, int height, double scale_ppm );
+    void Project( int width, int height, double scale_ppm );
+
+    void StartSample( void );
+    void EndSample( void );
+    void Report( const char *name, long objects, PlugIn_ViewPort *pvp = NULL );
+
+    long            m_iIterations;
+    long            m_iQueries;
+    long            m_iDeletes;
+    wxString        m_sPNGDir;
+    unsigned int    m_iRandom;
+    double          m_dLatMin, m_dLatMax, m_dLonMin, m_dLonMax;
+
+    wxStopWatch     m_sw;
+    int             m_iSampleAllocations;
+    ODBenchTimes    m_Times;
+    double          m_dAllocations;     // over all samples of the case
+};
+
+IMPLEMENT_APP( ODBenchApp )
+
+bool ODBenchApp::OnInit()
+{
+    //  No wxApp::OnInit, it would take the options as its own
+    delete wxLog::SetActiveTarget( new wxLogStderr );
+    return true;
+}
+
+bool ODBenchApp::GetOption( const wxString &name, long *value )
+{
+    for( int i = 3; i + 1 < argc; i++ ) {
+        if( wxString( argv[i] ) == wxT("--") + name )
+            return wxString( argv[i + 1] ).ToLong( value );
+    }
+    return false;
+}
+
+bool ODBenchApp::GetOption( const wxString &name, wxString *value )
+{
+    for( int i = 3; i + 1 < argc; i++ ) {
+        if( wxString( argv[i] ) == wxT("--") + name ) {
+            *value = wxString( argv[i + 1] );
+            return true;
+        }
+    }
+    return false;
+}
+
+int ODBenchApp::OnRun()
+{
+    wxString l_sCommand = argc > 2 ? wxString( argv[1] ) : wxString();
+    if( l_sCommand == wxT("generate") ) return Generate();
+    if( l_sCommand == wxT("run") ) return Run();
+    if( l_sCommand == wxT("compare") && argc > 3 ) return Compare();
+
+    fprintf( stderr, "usage: odbench generate FILE [--boundaries N] [--vertices N] [--ebls N] [--drs N]\n"
+                     "                             [--drpoints N] [--textpoints N] [--boundarypoints N] [--seed N]\n"
+                     "       odbench run FILE [--iterations N] [--queries N] [--deletes N] [--png DIR]\n"
+                     "       odbench compare BEFORE AFTER\n" );
+    return 2;
+}
+
+int ODBenchApp::Generate( void )
+{
+    ODBenchDataset l_set;
+    long l_value;
+    if( GetOption( wxT("boundaries"), &l_value ) ) l_set.m_iBoundaries = l_value;
+    if( GetOption( wxT("vertices"), &l_value ) ) l_set.m_iVertices = l_value;
+    if( GetOption( wxT("ebls"), &l_value ) ) l_set.m_iEBLs = l_value;
+    if( GetOption( wxT("drs"), &l_value ) ) l_set.m_iDRs = l_value;
+    if( GetOption( wxT("drpoints"), &l_value ) ) l_set.m_iDRPoints = l_value;
+    if( GetOption( wxT("textpoints"), &l_value ) ) l_set.m_iTextPoints = l_value;
+    if( GetOption( wxT("boundarypoints"), &l_value ) ) l_set.m_iBoundaryPoints = l_value;
+    if( GetOption( wxT("seed"), &l_value ) ) l_set.m_iSeed = (unsigned int)l_value;
+
+    if( !ODBenchGenerate( l_set, wxString( argv[2] ).mb_str() ) ) {
+        fprintf( stderr, "odbench: unable to write %s\n", (const char *)wxString( argv[2] ).mb_str() );
+        return 1;
+    }
+    return 0;
+}
+
+bool ODBenchApp::ReadResults( const wxString &filename, ODBenchResults *pResults )
+{
+    wxTextFile l_file;
+    if( !wxFileExists( filename ) || !l_file.Open( filename ) ) {
+        fprintf( stderr, "odbench: unable to read %s\n", (const char *)filename.mb_str() );
+        return false;
+    }
+
+    ODJSONReader l_reader;
+    for( size_t i = 0; i < l_file.GetLineCount(); i++ ) {
+        wxString l_sLine = l_file[i];
+        ODBenchResult l_result;
+        if( !l_reader.Parse( l_sLine ) || !l_reader.GetString( "benchmark", &l_result.m_sCase ) ||
+            !l_reader.GetDouble( "median_us", &l_result.m_dMedian ) )
+            continue;
+        if( !l_reader.GetDouble( "allocations", &l_result.m_dAllocations ) ) l_result.m_dAllocations = 0.;
+
+        int l_iWidth, l_iHeight;
+        double l_dScale;
+        if( l_reader.GetInt( "width", &l_iWidth ) && l_reader.GetInt( "height", &l_iHeight ) &&
+            l_reader.GetDouble( "scale_ppm", &l_dScale ) )
+            l_result.m_sCase << wxString::Format( wxT(" %dx%d %g"), l_iWidth, l_iHeight, l_dScale );
+        pResults->push_back( l_result );
+    }
+    return true;
+}
+
+int ODBenchApp::Compare( void )
+{
+    ODBenchResults l_before, l_after;
+    if( !ReadResults( wxString( argv[2] ), &l_before ) || !ReadResults( wxString( argv[3] ), &l_after ) )
+        return 1;
+
+    ODJSONWriter l_writer;
+    for( size_t i = 0; i < l_after.size(); i++ ) {
+        const ODBenchResult &a = l_after[i];
+        for( size_t j = 0; j < l_before.size(); j++ ) {
+            const ODBenchResult &b = l_before[j];
+            if( b.m_sCase != a.m_sCase ) continue;
+
+            l_writer.Begin();
+            l_writer.AddString( "case", a.m_sCase );
+            l_writer.AddDouble( "before_median_us", b.m_dMedian );
+            l_writer.AddDouble( "after_median_us", a.m_dMedian );
+            l_writer.AddDouble( "speedup", a.m_dMedian > 0. ? b.m_dMedian / a.m_dMedian : 0. );
+            l_writer.AddDouble( "before_allocations", b.m_dAllocations );
+            l_writer.AddDouble( "after_allocations", a.m_dAllocations );
+            printf( "%s\n", (const char *)l_writer.End().mb_str() );
+            break;
+        }
+    }
+    return 0;
+}
+
+//  Everything loaded goes, without touching the changes file
+void ODBenchApp::ClearObjects( void )
+{
+    bool l_bSkip = g_pODConfig->m_bSkipChangeSetUpdate;
+    g_pODConfig->m_bSkipChangeSetUpdate = true;
+
+    ODPathSet l_paths;
+    for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() )
+        l_paths.insert( node->GetData() );
+    g_pPathMan->DeletePaths( l_paths );
+
+    ODPointSet l_points;
+    for( wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst(); node; node = node->GetNext() )
+        l_points.insert( node->GetData() );
+    g_pODPointMan->DeleteODPoints( l_points, false );
+
+    g_pODConfig->m_bSkipChangeSetUpdate = l_bSkip;
+}
+
+void ODBenchApp::GetBounds( void )
+{
+    m_dLatMin = m_dLonMin = 1000.;
+    m_dLatMax = m_dLonMax = -1000.;
+    for( wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst(); node; node = node->GetNext() ) {
+        ODPoint *pp = node->GetData();
+        m_dLatMin = wxMin( m_dLatMin, pp->m_lat );
+        m_dLatMax = wxMax( m_dLatMax, pp->m_lat );
+        m_dLonMin = wxMin( m_dLonMin, pp->m_lon );
+        m_dLonMax = wxMax( m_dLonMax, pp->m_lon );
+    }
+    if( m_dLatMin > m_dLatMax ) m_dLatMin = m_dLatMax = m_dLonMin = m_dLonMax = 0.;
+}
+
+//  Query positions are spread over the data and are the same every run
+void ODBenchApp::NextPosition( double *lat, double *lon )
+{
+    m_iRandom = m_iRandom * 1664525u + 1013904223u;
+    *lat = m_dLatMin + ( m_dLatMax - m_dLatMin ) * ( ( m_iRandom >> 8 ) / 16777216. );
+    m_iRandom = m_iRandom * 1664525u + 1013904223u;
+    *lon = m_dLonMin + ( m_dLonMax - m_dLonMin ) * ( ( m_iRandom >> 8 ) / 16777216. );
+}
+
+void ODBenchApp::StartSample( void )
+{
+    m_iSampleAllocations = s_iAllocations;
+    m_sw.Start();
+}
+
+void ODBenchApp::EndSample( void )
+{
+    m_Times.push_back( m_sw.TimeInMicro().GetValue() );
+    m_dAllocations += s_iAllocations - m_iSampleAllocations;
+}
+
+void ODBenchApp::Report( const char *name, long objects, PlugIn_ViewPort *pvp )
+{
+    if( m_Times.empty() ) return;
+    std::sort( m_Times.begin(), m_Times.end() );
+    double l_dTotal = 0.;
+    for( size_t i = 0; i < m_Times.size(); i++ )
+        l_dTotal += (double)m_Times[i];
+
+    ODJSONWriter l_writer;
+    l_writer.Begin();
+    l_writer.AddString( "benchmark", name );
+    l_writer.AddInt( "objects", objects );
+    if( pvp ) {
+        l_writer.AddInt( "width", pvp->pix_width );
+        l_writer.AddInt( "height", pvp->pix_height );
+        l_writer.AddDouble( "scale_ppm", pvp->view_scale_ppm );
+    }
+    l_writer.AddInt( "iterations", (long)m_Times.size() );
+    l_writer.AddDouble( "min_us", (double)m_Times.front() );
+    l_writer.AddDouble( "median_us", (double)m_Times[ m_Times.size() / 2 ] );
+    l_writer.AddDouble( "mean_us", l_dTotal / m_Times.size() );
+    l_writer.AddDouble( "max_us", (double)m_Times.back() );
+    l_writer.AddDouble( "allocations", m_dAllocations / m_Times.size() );
+    //  and what the plugin counted while it ran
+    g_pODStats->Write( l_writer );
+    printf( "%s\n", (const char *)l_writer.End().mb_str() );
+    fflush( stdout );
+
+    m_Times.clear();
+    m_dAllocations = 0.;
+    g_pODStats->Reset();
+}
+
+//  A frame centred on the data
+void ODBenchApp::MakeViewPort( PlugIn_ViewPort *pvp, int width, int height, double scale_ppm )
+{
+    pvp->clat = ( m_dLatMin + m_dLatMax ) / 2.;
+    pvp->clon = ( m_dLonMin + m_dLonMax ) / 2.;
+    pvp->view_scale_ppm = scale_ppm;
+    pvp->skew = 0.;
+    pvp->rotation = 0.;
+    pvp->chart_scale = 1. / ( scale_ppm * 0.00028 );   // OpenCPN's 0.28 mm pixel
+    pvp->pix_width = width;
+    pvp->pix_height = height;
+    pvp->rv_rect = wxRect( 0, 0, width, height );
+    pvp->b_quilt = false;
+    pvp->m_projection_type = PI_PROJECTION_MERCATOR;
+    GetCanvasLLPix( pvp, wxPoint( 0, height ), &pvp->lat_min, &pvp->lon_min );
+    GetCanvasLLPix( pvp, wxPoint( width, 0 ), &pvp->lat_max, &pvp->lon_max );
+    pvp->bValid = true;
+}
+
+//  Drawn whole through RenderOverlay and then paths and points on their own
+void ODBenchApp::Render( ocpn_draw_pi *pPlugin, int width, int height, double scale_ppm )
+{
+    PlugIn_ViewPort l_vp;
+    MakeViewPort( &l_vp, width, height, scale_ppm );
+
+    LLBBox l_llbb;
+    l_llbb.SetMin( l_vp.lon_min, l_vp.lat_min );
+    l_llbb.SetMax( l_vp.lon_max, l_vp.lat_max );
+
+    wxBitmap l_bm( width, height );
+    wxMemoryDC l_dc( l_bm );
+    long l_iObjects = g_pPathList->GetCount() + g_pODPointMan->GetODPointList()->GetCount();
+
+    for( long i = 0; i < m_iIterations; i++ ) {
+        l_dc.SetBackground( *wxWHITE_BRUSH );
+        l_dc.Clear();
+        StartSample();
+        pPlugin->RenderOverlay( l_dc, &l_vp );
+        EndSample();
+    }
+    Report( "RenderOverlay", l_iObjects, &l_vp );
+
+    if( !m_sPNGDir.IsEmpty() ) {
+        l_dc.SelectObject( wxNullBitmap );
+        wxString l_sFile;
+        l_sFile.Printf( wxT("odbench_%dx%d_%g.png"), width, height, scale_ppm );
+        l_bm.SaveFile( wxFileName( m_sPNGDir, l_sFile ).GetFullPath(), wxBITMAP_TYPE_PNG );
+        l_dc.SelectObject( l_bm );
+    }
+
+    {
+        ODDC l_odc( l_dc );
+        for( long i = 0; i < m_iIterations; i++ ) {
+            StartSample();
+            pPlugin->DrawAllPathsInBBox( l_odc, l_llbb );
+            EndSample();
+        }
+        Report( "DrawAllPathsInBBox", (long)g_pPathList->GetCount(), &l_vp );
+
+        for( long i = 0; i < m_iIterations; i++ ) {
+            StartSample();
+            pPlugin->DrawAllODPointsInBBox( l_odc, l_llbb );
+            EndSample();
+        }
+        Report( "DrawAllODPointsInBBox", (long)g_pODPointMan->GetODPointList()->GetCount(), &l_vp );
+    }
+    l_dc.SelectObject( wxNullBitmap );
+}
+
+//  Every path vertex projected through ODProjection, as the path drawing
+//  does, and then one GetCanvasPixLL each, as it did before. Here
+//  GetCanvasPixLL is the stub's plain mercator, inside OpenCPN it also
+//  costs a call into the core.
+void ODBenchApp::Project( int width, int height, double scale_ppm )
+{
+    PlugIn_ViewPort l_vp;
+    MakeViewPort( &l_vp, width, height, scale_ppm );
+
+    long l_iVertices = 0;
+    size_t l_iMost = 0;
+    for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() ) {
+        l_iVertices += node->GetData()->m_pODPointList->GetCount();
+        l_iMost = wxMax( l_iMost, node->GetData()->m_pODPointList->GetCount() );
+    }
+    std::vector<wxPoint> l_pts( l_iMost + 1 );
+
+    for( long i = 0; i < m_iIterations; i++ ) {
+        StartSample();
+        ODProjection &l_Projection = ODProjection::ForViewPort( l_vp );
+        for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() )
+            l_Projection.GetPixFromLL( node->GetData()->m_pODPointList, &l_pts[0] );
+        EndSample();
+    }
+    Report( "ODProjection", l_iVertices, &l_vp );
+
+    for( long i = 0; i < m_iIterations; i++ ) {
+        StartSample();
+        for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() ) {
+            int j = 0;
+            for( wxODPointListNode *pnode = node->GetData()->m_pODPointList->GetFirst(); pnode; pnode = pnode->GetNext() )
+                GetCanvasPixLL( &l_vp, &l_pts[ j++ ], pnode->GetData()->m_lat, pnode->GetData()->m_lon );
+        }
+        EndSample();
+    }
+    Report( "GetCanvasPixLL", l_iVertices, &l_vp );
+}
+
+int ODBenchApp::Run( void )
+{
+    wxString l_sInput = wxString( argv[2] );
+    if( !wxFileExists( l_sInput ) ) {
+        fprintf( stderr, "odbench: no file %s\n", (const char *)l_sInput.mb_str() );
+        return 1;
+    }
+    m_iIterations = 10;
+    m_iQueries = 1000;
+    m_iDeletes = 100;
+    GetOption( wxT("iterations"), &m_iIterations );
+    GetOption( wxT("queries"), &m_iQueries );
+    GetOption( wxT("deletes"), &m_iDeletes );
+    GetOption( wxT("png"), &m_sPNGDir );
+    if( m_iIterations < 1 ) m_iIterations = 1;
+    if( !m_sPNGDir.IsEmpty() && !wxImage::FindHandler( wxBITMAP_TYPE_PNG ) )
+        wxImage::AddHandler( new wxPNGHandler );
+    m_dAllocations = 0.;
+
+    //  The plugin keeps its files under the private data directory
+    wxString l_sDir = wxFileName::CreateTempFileName( wxT("odbench") );
+    wxRemoveFile( l_sDir );
+    wxMkdir( l_sDir );
+    ODBenchSetDataDirs( l_sDir, l_sDir );
+
+    wxFrame *l_pCanvas = new wxFrame( NULL, wxID_ANY, wxT("odbench"), wxDefaultPosition, wxSize( 1024, 768 ) );
+    ODBenchSetCanvas( l_pCanvas );
+    SetTopWindow( l_pCanvas );
+
+    ocpn_draw_pi *l_pPlugin = new ocpn_draw_pi( NULL );
+    wxString l_sNavObj = *g_pData + wxT("ODnavobj.xml");
+    wxCopyFile( l_sInput, l_sNavObj );
+    l_pPlugin->Init();
+
+    g_pODStats->SetLogInterval( 0 );
+    g_pODStats->Enable( true );
+    g_pODStats->Reset();
+    g_pODSelect->SetSelectScale( ODBENCH_SELECT_SCALE );
+
+    //  Load, from the navobj file and then from the snapshot made when it is saved
+    for( long i = 0; i < m_iIterations; i++ ) {
+        ClearObjects();
+        wxRemoveFile( g_pODConfig->m_sODNavObjSnapshotFile );
+        StartSample();
+        g_pODConfig->LoadNavObjects();
+        EndSample();
+    }
+    long l_iObjects = g_pPathList->GetCount() + g_pODPointMan->GetODPointList()->GetCount();
+    Report( "LoadNavObjects", l_iObjects );
+
+    g_pODConfig->UpdateNavObj();
+    for( long i = 0; i < m_iIterations; i++ ) {
+        ClearObjects();
+        StartSample();
+        g_pODConfig->LoadNavObjects();
+        EndSample();
+    }
+    Report( "LoadNavObjectsSnapshot", l_iObjects );
+
+    //  The element and attribute dispatch of the loader on its own, from an
+    //  already parsed document and without making any objects
+    {
+        ODNavObjectChanges l_doc;
+        ODGPXRecordSet l_records;
+        if( l_doc.load_file( l_sNavObj.fn_str() ) ) {
+            for( long i = 0; i < m_iIterations; i++ ) {
+                StartSample();
+                l_doc.ReadAllGPXRecords( &l_records );
+                EndSample();
+            }
+            Report( "ReadAllGPXRecords", (long)l_records.m_Points.size() );
+        }
+    }
+
+    GetBounds();
+    long l_iSelectables = g_pODSelect->GetSelectList()->GetCount();
+    double l_dLat, l_dLon;
+
+    m_iRandom = 1;
+    for( long i = 0; i < m_iIterations; i++ ) {
+        StartSample();
+        for( long q = 0; q < m_iQueries; q++ ) {
+            NextPosition( &l_dLat, &l_dLon );
+            g_pODSelect->FindSelection( l_dLat, l_dLon, SELTYPE_ODPOINT );
+            g_pODSelect->FindSelection( l_dLat, l_dLon, SELTYPE_PATHSEGMENT );
+        }
+        EndSample();
+    }
+    Report( "FindSelection", l_iSelectables );
+
+    m_iRandom = 1;
+    for( long i = 0; i < m_iIterations; i++ ) {
+        StartSample();
+        for( long q = 0; q < m_iQueries; q++ ) {
+            NextPosition( &l_dLat, &l_dLon );
+            SelectableItemList l_points = g_pODSelect->FindSelectionList( l_dLat, l_dLon, SELTYPE_ODPOINT );
+            SelectableItemList l_segments = g_pODSelect->FindSelectionList( l_dLat, l_dLon, SELTYPE_PATHSEGMENT );
+        }
+        EndSample();
+    }
+    Report( "FindSelectionList", l_iSelectables );
+
+    m_iRandom = 1;
+    for( long i = 0; i < m_iIterations; i++ ) {
+        StartSample();
+        for( long q = 0; q < m_iQueries; q++ ) {
+            NextPosition( &l_dLat, &l_dLon );
+            g_pBoundaryMan->FindPointInBoundary( l_dLat, l_dLon, ID_BOUNDARY_ANY );
+        }
+        EndSample();
+    }
+    Report( "FindPointInBoundary", l_iObjects );
+
+    for( long i = 0; i < m_iIterations; i++ ) {
+        StartSample();
+        for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() )
+            node->GetData()->UpdateSegmentDistances();
+        EndSample();
+    }
+    Report( "UpdateSegmentDistances", (long)g_pPathList->GetCount() );
+
+    for( size_t s = 0; s < WXSIZEOF( s_RenderSizes ); s++ ) {
+        for( size_t z = 0; z < WXSIZEOF( s_RenderScales ); z++ )
+            Render( l_pPlugin, s_RenderSizes[s][0], s_RenderSizes[s][1], s_RenderScales[z] );
+    }
+    for( size_t z = 0; z < WXSIZEOF( s_RenderScales ); z++ )
+        Project( s_RenderSizes[1][0], s_RenderSizes[1][1], s_RenderScales[z] );
+
+    //  Every path written to the changes file as changed, and flushed
+    ODNavObjectChanges *pChanges = g_pODConfig->m_pODNavObjectChangesSet;
+    for( long i = 0; i < m_iIterations; i++ ) {
+        StartSample();
+        for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() )
+            pChanges->AddPath( node->GetData(), "change" );
+        pChanges->FlushChanges();
+        EndSample();
+    }
+    Report( "AddPath", (long)g_pPathList->GetCount() );
+    pChanges->RemoveChangesFile();
+
+    //  Points deleted one at a time from the largest path, each a sample.
+    //  This changes the data, so it comes last.
+    ODPath *pLargest = NULL;
+    for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() ) {
+        if( !pLargest || node->GetData()->GetnPoints() > pLargest->GetnPoints() )
+            pLargest = node->GetData();
+    }
+    if( pLargest ) {
+        long l_iPoints = pLargest->GetnPoints();
+        //  The second point each time, so a closed path keeps its ends
+        for( long i = 0; i < m_iDeletes && pLargest->GetnPoints() > 3; i++ ) {
+            ODPoint *pp = pLargest->GetPoint( 2 );
+            StartSample();
+            pLargest->DeletePoint( pp );
+            EndSample();
+        }
+        pChanges->FlushChanges();
+        Report( "DeletePoint", l_iPoints );
+        pChanges->RemoveChangesFile();
+    }
+
+    //  Not timed: the first point of a closed boundary deleted, after which
+    //  its GUID must be gone and every other point found by its own
+    int l_iResult = 0;
+    ODPath *pClosed = NULL;
+    for( wxPathListNode *node = g_pPathList->GetFirst(); node && !pClosed; node = node->GetNext() ) {
+        ODPath *pPath = node->GetData();
+        if( pPath->m_sTypeString == wxT("Boundary") && pPath->GetnPoints() > 4 &&
+            pPath->m_pODPointList->GetFirst()->GetData() == pPath->m_pODPointList->GetLast()->GetData() )
+            pClosed = pPath;
+    }
+    if( pClosed ) {
+        ODPoint *pFirst = pClosed->GetPoint( 1 );
+        wxString l_sGUID = pFirst->m_GUID;
+        pClosed->DeletePoint( pFirst );
+        pChanges->FlushChanges();
+        pChanges->RemoveChangesFile();
+
+        long l_iMissing = pClosed->GetPoint( l_sGUID ) ? 1 : 0;
+        for( wxODPointListNode *node = pClosed->m_pODPointList->GetFirst(); node; node = node->GetNext() ) {
+            if( pClosed->GetPoint( node->GetData()->m_GUID ) != node->GetData() ) l_iMissing++;
+        }
+        if( l_iMissing ) {
+            fprintf( stderr, "odbench: %ld GUID lookups wrong after deleting the first point of a closed boundary\n", l_iMissing );
+            l_iResult = 1;
+        }
+    }
+
+    //  No DeInit, it would save the navobj file again and tear down windows
+    //  that are going with the process anyway
+    wxFileName::Rmdir( l_sDir, wxPATH_RMDIR_RECURSIVE );
+    return l_iResult;
+}
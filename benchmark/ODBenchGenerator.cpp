@@ -0,0 +1,286 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw benchmark dataset generator
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "ODBenchGenerator.h"
+#include "pugixml.hpp"
+
+#include <stdio.h>
+#include <math.h>
+#include <string>
+
+#ifndef PI
+#define PI        3.1415926535897931160E0      /* pi */
+#endif
+
+ODBenchDataset::ODBenchDataset()
+{
+    m_iBoundaries = 100;
+    m_iVertices = 100;
+    m_iEBLs = 10;
+    m_iDRs = 10;
+    m_iDRPoints = 20;
+    m_iTextPoints = 100;
+    m_iBoundaryPoints = 100;
+    m_iSeed = 1;
+    m_dLat = 50.;
+    m_dLon = -4.;
+    m_dSpread = 2.;
+}
+
+//  The same sequence on every platform, rand() is not
+class ODBenchRandom
+{
+public:
+    ODBenchRandom( unsigned int seed ) { m_iState = seed; }
+
+    double Next( void )
+    {
+        m_iState = m_iState * 1664525u + 1013904223u;
+        return ( m_iState >> 8 ) / 16777216.;
+    }
+
+    double Range( double min, double max ) { return min + ( max - min ) * Next(); }
+
+private:
+    unsigned int    m_iState;
+};
+
+class ODBenchWriter
+{
+public:
+    ODBenchWriter( const ODBenchDataset &set ) : m_Set( set ), m_Random( set.m_iSeed )
+    {
+        m_iObjects = set.m_iBoundaries + set.m_iEBLs + set.m_iDRs + set.m_iTextPoints + set.m_iBoundaryPoints;
+        m_iColumns = 1;
+        while( m_iColumns * m_iColumns < m_iObjects ) m_iColumns++;
+        m_dCell = set.m_dSpread / m_iColumns;
+        m_iNextObject = 0;
+        m_iNextGUID = 0;
+    }
+
+    //  Centre of the next grid cell, taken in turn by every object
+    void NextCell( double *lat, double *lon )
+    {
+        int l_iRow = m_iNextObject / m_iColumns;
+        int l_iCol = m_iNextObject % m_iColumns;
+        m_iNextObject++;
+        *lat = m_Set.m_dLat - m_Set.m_dSpread / 2. + ( l_iRow + 0.5 ) * m_dCell;
+        *lon = m_Set.m_dLon - m_Set.m_dSpread / 2. + ( l_iCol + 0.5 ) * m_dCell;
+    }
+
+    const char *NextGUID( void )
+    {
+        snprintf( m_sGUID, sizeof( m_sGUID ), "0dbe0c00-%04x-4000-8000-%012x", m_Set.m_iSeed & 0xffff, m_iNextGUID++ );
+        return m_sGUID;
+    }
+
+    static void AddText( pugi::xml_node node, const char *name, const char *value )
+    {
+        node.append_child( name ).append_child( pugi::node_pcdata ).set_value( value );
+    }
+
+    static void SetPosition( pugi::xml_node node, double lat, double lon )
+    {
+        char l_sValue[32];
+        snprintf( l_sValue, sizeof( l_sValue ), "%.9f", lat );
+        node.append_attribute( "lat" ) = l_sValue;
+        snprintf( l_sValue, sizeof( l_sValue ), "%.9f", lon );
+        node.append_attribute( "lon" ) = l_sValue;
+    }
+
+    pugi::xml_node AddPoint( pugi::xml_node parent, const char *type, const char *name, double lat, double lon, const char *guid )
+    {
+        pugi::xml_node node = parent.append_child( "opencpn:ODPoint" );
+        SetPosition( node, lat, lon );
+        AddText( node, "opencpn:type", type );
+        AddText( node, "name", name );
+        AddText( node, "opencpn:guid", guid );
+        return node;
+    }
+
+    pugi::xml_node AddPath( pugi::xml_node root, const char *type, const char *name )
+    {
+        pugi::xml_node node = root.append_child( "opencpn:path" );
+        AddText( node, "opencpn:type", type );
+        AddText( node, "name", name );
+        AddText( node, "opencpn:guid", NextGUID() );
+        AddText( node, "opencpn:viz", "1" );
+        AddText( node, "opencpn:active", "1" );
+        return node;
+    }
+
+    void AddBoundary( pugi::xml_node root, int index )
+    {
+        static const char *s_Types[] = { "Exclusion", "Inclusion", "Neither" };
+        char l_sName[64];
+        snprintf( l_sName, sizeof( l_sName ), "Boundary %d", index );
+        pugi::xml_node path = AddPath( root, "Boundary", l_sName );
+        AddText( path, "opencpn:boundary_type", s_Types[ index % 3 ] );
+
+        double l_dLat, l_dLon;
+        NextCell( &l_dLat, &l_dLon );
+        double l_dCos = cos( l_dLat * PI / 180. );
+        double l_dRadius = m_dCell * 0.4;
+
+        //  A star shaped polygon round the cell centre, closed on its first point
+        std::string l_sFirstGUID;
+        double l_dFirstLat = 0., l_dFirstLon = 0.;
+        for( int i = 0; i < m_Set.m_iVertices; i++ ) {
+            double l_dAngle = 2. * PI * ( i + m_Random.Range( 0., 0.5 ) ) / m_Set.m_iVertices;
+            double l_dR = l_dRadius * m_Random.Range( 0.6, 1. );
+            double lat = l_dLat + l_dR * cos( l_dAngle );
+            double lon = l_dLon + l_dR * sin( l_dAngle ) / l_dCos;
+            snprintf( l_sName, sizeof( l_sName ), "%03d", i + 1 );
+            const char *l_sGUID = NextGUID();
+            if( i == 0 ) {
+                l_sFirstGUID = l_sGUID;
+                l_dFirstLat = lat;
+                l_dFirstLon = lon;
+            }
+            AddPoint( path, "Boundary Point", l_sName, lat, lon, l_sGUID );
+        }
+        if( m_Set.m_iVertices > 0 )
+            AddPoint( path, "Boundary Point", "001", l_dFirstLat, l_dFirstLon, l_sFirstGUID.c_str() );
+    }
+
+    void AddEBL( pugi::xml_node root, int index )
+    {
+        char l_sName[64];
+        snprintf( l_sName, sizeof( l_sName ), "EBL %d", index );
+        pugi::xml_node path = AddPath( root, "EBL", l_sName );
+        AddText( path, "opencpn:persistence", "0" );
+        AddText( path, "opencpn:fixed_end_position", "1" );
+
+        double l_dLat, l_dLon;
+        NextCell( &l_dLat, &l_dLon );
+        double l_dAngle = m_Random.Range( 0., 2. * PI );
+        double l_dLen = m_dCell * 0.4;
+        AddPoint( path, "EBL Point", "Start", l_dLat, l_dLon, NextGUID() );
+        AddPoint( path, "EBL Point", "End", l_dLat + l_dLen * cos( l_dAngle ), l_dLon + l_dLen * sin( l_dAngle ), NextGUID() );
+    }
+
+    void AddDR( pugi::xml_node root, int index )
+    {
+        char l_sName[64];
+        snprintf( l_sName, sizeof( l_sName ), "DR %d", index );
+        pugi::xml_node path = AddPath( root, "DR", l_sName );
+
+        double l_dLat, l_dLon;
+        NextCell( &l_dLat, &l_dLon );
+        double l_dAngle = m_Random.Range( 0., 2. * PI );
+        double l_dStep = m_Set.m_iDRPoints > 1 ? m_dCell * 0.8 / ( m_Set.m_iDRPoints - 1 ) : 0.;
+        l_dLat -= l_dStep * ( m_Set.m_iDRPoints - 1 ) / 2. * cos( l_dAngle );
+        l_dLon -= l_dStep * ( m_Set.m_iDRPoints - 1 ) / 2. * sin( l_dAngle );
+        for( int i = 0; i < m_Set.m_iDRPoints; i++ ) {
+            snprintf( l_sName, sizeof( l_sName ), "%03d", i + 1 );
+            AddPoint( path, "DR Point", l_sName, l_dLat + i * l_dStep * cos( l_dAngle ), l_dLon + i * l_dStep * sin( l_dAngle ), NextGUID() );
+        }
+    }
+
+    void AddTextPoint( pugi::xml_node root, int index )
+    {
+        char l_sName[64];
+        double l_dLat, l_dLon;
+        NextCell( &l_dLat, &l_dLon );
+        snprintf( l_sName, sizeof( l_sName ), "Text %d", index );
+        pugi::xml_node node = AddPoint( root, "Text Point", l_sName, l_dLat, l_dLon, NextGUID() );
+        AddText( node, "opencpn:text", l_sName );
+        AddText( node, "opencpn:text_position", "0" );
+    }
+
+    void AddBoundaryPoint( pugi::xml_node root, int index )
+    {
+        char l_sName[64];
+        double l_dLat, l_dLon;
+        NextCell( &l_dLat, &l_dLon );
+        snprintf( l_sName, sizeof( l_sName ), "Point %d", index );
+        pugi::xml_node node = AddPoint( root, "Boundary Point", l_sName, l_dLat, l_dLon, NextGUID() );
+        AddText( node, "opencpn:boundary_type", index & 1 ? "Inclusion" : "Exclusion" );
+
+        //  Rings out to about a third of the cell
+        char l_sStep[32];
+        snprintf( l_sStep, sizeof( l_sStep ), "%.3f", m_dCell * 60. * 0.3 / 3. );
+        pugi::xml_node rings = node.append_child( "opencpn:ODPoint_range_rings" );
+        rings.append_attribute( "visible" ) = "true";
+        rings.append_attribute( "number" ) = "3";
+        rings.append_attribute( "step" ) = l_sStep;
+        rings.append_attribute( "units" ) = "0";
+    }
+
+    //  Objects of each type are interleaved so every kind is spread over the area
+    bool Write( const char *filename )
+    {
+        pugi::xml_document doc;
+        pugi::xml_node decl = doc.append_child( pugi::node_declaration );
+        decl.append_attribute( "version" ) = "1.0";
+        pugi::xml_node root = doc.append_child( "OCPNDraw" );
+        root.append_attribute( "version" ) = "0.1";
+        root.append_attribute( "creator" ) = "OpenCPN";
+        root.append_attribute( "xmlns:xsi" ) = "http://www.w3.org/2001/XMLSchema-instance";
+        root.append_attribute( "xmlns:opencpn" ) = "http://www.opencpn.org";
+
+        int l_iCounts[5] = { m_Set.m_iBoundaries, m_Set.m_iEBLs, m_Set.m_iDRs, m_Set.m_iTextPoints, m_Set.m_iBoundaryPoints };
+        int l_iDone[5] = { 0, 0, 0, 0, 0 };
+        for( int n = 0; n < m_iObjects; n++ ) {
+            //  Whichever type is furthest behind its share goes next
+            int l_iType = 0;
+            double l_dBest = 2.;
+            for( int t = 0; t < 5; t++ ) {
+                if( l_iDone[t] >= l_iCounts[t] ) continue;
+                double l_dShare = (double)l_iDone[t] / l_iCounts[t];
+                if( l_dShare < l_dBest ) {
+                    l_dBest = l_dShare;
+                    l_iType = t;
+                }
+            }
+            switch( l_iType ) {
+                case 0: AddBoundary( root, l_iDone[0] ); break;
+                case 1: AddEBL( root, l_iDone[1] ); break;
+                case 2: AddDR( root, l_iDone[2] ); break;
+                case 3: AddTextPoint( root, l_iDone[3] ); break;
+                case 4: AddBoundaryPoint( root, l_iDone[4] ); break;
+            }
+            l_iDone[ l_iType ]++;
+        }
+
+        return doc.save_file( filename, "  " );
+    }
+
+private:
+    const ODBenchDataset    &m_Set;
+    ODBenchRandom           m_Random;
+    int                     m_iObjects;
+    int                     m_iColumns;
+    double                  m_dCell;
+    int                     m_iNextObject;
+    unsigned int            m_iNextGUID;
+    char                    m_sGUID[64];
+};
+
+bool ODBenchGenerate( const ODBenchDataset &set, const char *filename )
+{
+    ODBenchWriter l_writer( set );
+    return l_writer.Write( filename );
+}
@@ -0,0 +1,51 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw benchmark dataset generator
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODBENCHGENERATOR_H
+#define ODBENCHGENERATOR_H
+
+//  What odbench generate writes. Objects are laid out on a grid over a square
+//  of m_dSpread degrees around m_dLat/m_dLon, so a given seed and set of counts
+//  always gives the same file.
+struct ODBenchDataset
+{
+    ODBenchDataset();
+
+    int             m_iBoundaries;
+    int             m_iVertices;        // per boundary, the closing point not counted
+    int             m_iEBLs;
+    int             m_iDRs;
+    int             m_iDRPoints;        // per DR path
+    int             m_iTextPoints;
+    int             m_iBoundaryPoints;  // isolated, with range rings
+    unsigned int    m_iSeed;
+    double          m_dLat;
+    double          m_dLon;
+    double          m_dSpread;
+};
+
+bool ODBenchGenerate( const ODBenchDataset &set, const char *filename );
+
+#endif // ODBENCHGENERATOR_H
@@ -0,0 +1,270 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw benchmark stand in for the OpenCPN plugin API
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include <wx/fileconf.h>
+#include <wx/filename.h>
+
+#include "ODBenchStubs.h"
+#include "ocpn_plugin.h"
+#include "georef.h"
+
+//  Only what the plugin calls is here. odbench runs the plugin code without
+//  OpenCPN, so anything that would draw on or ask things of the chart window
+//  is a no-op or gives a fixed answer.
+
+static wxString     s_sSharedData;
+static wxString     s_sPrivateData;
+static wxWindow     *s_pCanvas = NULL;
+static wxFileConfig *s_pConfig = NULL;
+
+void ODBenchSetDataDirs( const wxString &shared, const wxString &priv )
+{
+    s_sSharedData = shared;
+    s_sPrivateData = priv;
+}
+
+void ODBenchSetCanvas( wxWindow *pCanvas )
+{
+    s_pCanvas = pCanvas;
+}
+
+//----------------------------------------------------------------------------
+//  Plugin base classes
+//----------------------------------------------------------------------------
+
+opencpn_plugin::~opencpn_plugin() {}
+int opencpn_plugin::Init( void ) { return 0; }
+bool opencpn_plugin::DeInit( void ) { return true; }
+int opencpn_plugin::GetAPIVersionMajor() { return 1; }
+int opencpn_plugin::GetAPIVersionMinor() { return 13; }
+int opencpn_plugin::GetPlugInVersionMajor() { return 1; }
+int opencpn_plugin::GetPlugInVersionMinor() { return 0; }
+wxBitmap *opencpn_plugin::GetPlugInBitmap() { return NULL; }
+wxString opencpn_plugin::GetCommonName() { return wxEmptyString; }
+wxString opencpn_plugin::GetShortDescription() { return wxEmptyString; }
+wxString opencpn_plugin::GetLongDescription() { return wxEmptyString; }
+void opencpn_plugin::SetDefaults( void ) {}
+int opencpn_plugin::GetToolbarToolCount( void ) { return 0; }
+int opencpn_plugin::GetToolboxPanelCount( void ) { return 0; }
+void opencpn_plugin::SetupToolboxPanel( int page_sel, wxNotebook *pnotebook ) {}
+void opencpn_plugin::OnCloseToolboxPanel( int page_sel, int ok_apply_cancel ) {}
+void opencpn_plugin::ShowPreferencesDialog( wxWindow *parent ) {}
+bool opencpn_plugin::RenderOverlay( wxMemoryDC *pmdc, PlugIn_ViewPort *vp ) { return false; }
+void opencpn_plugin::SetCursorLatLon( double lat, double lon ) {}
+void opencpn_plugin::SetCurrentViewPort( PlugIn_ViewPort &vp ) {}
+void opencpn_plugin::SetPositionFix( PlugIn_Position_Fix &pfix ) {}
+void opencpn_plugin::SetNMEASentence( wxString &sentence ) {}
+void opencpn_plugin::SetAISSentence( wxString &sentence ) {}
+void opencpn_plugin::ProcessParentResize( int x, int y ) {}
+void opencpn_plugin::SetColorScheme( PI_ColorScheme cs ) {}
+void opencpn_plugin::OnToolbarToolCallback( int id ) {}
+void opencpn_plugin::OnContextMenuItemCallback( int id ) {}
+void opencpn_plugin::UpdateAuiStatus( void ) {}
+wxArrayString opencpn_plugin::GetDynamicChartClassNameArray( void ) { return wxArrayString(); }
+
+opencpn_plugin_18::opencpn_plugin_18( void *pmgr ) : opencpn_plugin( pmgr ) {}
+opencpn_plugin_18::~opencpn_plugin_18() {}
+bool opencpn_plugin_18::RenderOverlay( wxDC &dc, PlugIn_ViewPort *vp ) { return false; }
+bool opencpn_plugin_18::RenderGLOverlay( wxGLContext *pcontext, PlugIn_ViewPort *vp ) { return false; }
+void opencpn_plugin_18::SetPluginMessage( wxString &message_id, wxString &message_body ) {}
+void opencpn_plugin_18::SetPositionFixEx( PlugIn_Position_Fix_Ex &pfix ) {}
+
+opencpn_plugin_19::opencpn_plugin_19( void *pmgr ) : opencpn_plugin_18( pmgr ) {}
+opencpn_plugin_19::~opencpn_plugin_19() {}
+void opencpn_plugin_19::OnSetupOptions( void ) {}
+
+opencpn_plugin_110::opencpn_plugin_110( void *pmgr ) : opencpn_plugin_19( pmgr ) {}
+opencpn_plugin_110::~opencpn_plugin_110() {}
+void opencpn_plugin_110::LateInit( void ) {}
+
+opencpn_plugin_111::opencpn_plugin_111( void *pmgr ) : opencpn_plugin_110( pmgr ) {}
+opencpn_plugin_111::~opencpn_plugin_111() {}
+
+opencpn_plugin_112::opencpn_plugin_112( void *pmgr ) : opencpn_plugin_111( pmgr ) {}
+opencpn_plugin_112::~opencpn_plugin_112() {}
+bool opencpn_plugin_112::MouseEventHook( wxMouseEvent &event ) { return false; }
+void opencpn_plugin_112::SendVectorChartObjectInfo( wxString &chart, wxString &feature, wxString &objname, double lat, double lon, double scale, int nativescale ) {}
+
+opencpn_plugin_113::opencpn_plugin_113( void *pmgr ) : opencpn_plugin_112( pmgr ) {}
+opencpn_plugin_113::~opencpn_plugin_113() {}
+bool opencpn_plugin_113::KeyboardEventHook( wxKeyEvent &event ) { return false; }
+void opencpn_plugin_113::OnToolbarToolDownCallback( int id ) {}
+void opencpn_plugin_113::OnToolbarToolUpCallback( int id ) {}
+
+//----------------------------------------------------------------------------
+//  Application, toolbar and window services
+//----------------------------------------------------------------------------
+
+wxString *GetpSharedDataLocation() { return &s_sSharedData; }
+wxString *GetpPrivateApplicationDataLocation() { return &s_sPrivateData; }
+wxWindow *GetOCPNCanvasWindow() { return s_pCanvas; }
+
+wxFileConfig *GetOCPNConfigObject( void )
+{
+    if( !s_pConfig ) {
+        wxFileName l_fn( s_sPrivateData, wxT("odbench.conf") );
+        s_pConfig = new wxFileConfig( wxEmptyString, wxEmptyString, l_fn.GetFullPath(), wxEmptyString, wxCONFIG_USE_LOCAL_FILE );
+    }
+    return s_pConfig;
+}
+
+bool AddLocaleCatalog( wxString catalog ) { return true; }
+bool AddPersistentFontKey( wxString TextElement ) { return true; }
+void RequestRefresh( wxWindow * ) {}
+void DimeWindow( wxWindow * ) {}
+void JumpToPosition( double lat, double lon, double scale ) {}
+void SendPluginMessage( wxString message_id, wxString message_body ) {}
+void SetCursor_PlugIn( wxCursor *pPlugin_Cursor ) {}
+bool CheckEdgePan_PlugIn( int x, int y, bool dragging, int margin, int delta ) { return false; }
+
+int InsertPlugInTool( wxString label, wxBitmap *bitmap, wxBitmap *bmpRollover, wxItemKind kind,
+                      wxString shortHelp, wxString longHelp, wxObject *clientData, int position,
+                      int tool_sel, opencpn_plugin *pplugin )
+{
+    static int s_iTool = 0;
+    return ++s_iTool;
+}
+
+int InsertPlugInToolSVG( wxString label, wxString SVGfile, wxString SVGfileRollover, wxString SVGfileToggled,
+                         wxItemKind kind, wxString shortHelp, wxString longHelp,
+                         wxObject *clientData, int position, int tool_sel, opencpn_plugin *pplugin )
+{
+    return InsertPlugInTool( label, NULL, NULL, kind, shortHelp, longHelp, clientData, position, tool_sel, pplugin );
+}
+
+void RemovePlugInTool( int tool_id ) {}
+void SetToolbarItemState( int item, bool toggle ) {}
+void SetToolbarToolBitmaps( int item, wxBitmap *bitmap, wxBitmap *bmpRollover ) {}
+void SetToolbarToolBitmapsSVG( int item, wxString SVGfile, wxString SVGfileRollover, wxString SVGfileToggled ) {}
+
+int OCPNMessageBox_PlugIn( wxWindow *parent, const wxString &message, const wxString &caption, int style, int x, int y )
+{
+    wxLogMessage( caption + wxT(": ") + message );
+    return ( style & wxYES_NO ) ? wxID_YES : wxID_OK;
+}
+
+wxBitmap GetIcon_PlugIn( const wxString &name )
+{
+    return wxBitmap( 16, 16 );
+}
+
+//----------------------------------------------------------------------------
+//  Fonts and colours
+//----------------------------------------------------------------------------
+
+static wxFont *GetBenchFont( int size )
+{
+    return wxTheFontList->FindOrCreateFont( size > 0 ? size : 10, wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL );
+}
+
+wxFont *OCPNGetFont( wxString TextElement, int default_size ) { return GetBenchFont( default_size ); }
+wxFont *GetOCPNScaledFont_PlugIn( wxString TextElement, int default_size ) { return GetBenchFont( default_size ); }
+wxFont GetOCPNGUIScaledFont_PlugIn( wxString item ) { return *GetBenchFont( 0 ); }
+double GetOCPNGUIToolScaleFactor_PlugIn( int GUIScaledFactor ) { return 1.; }
+double GetOCPNGUIToolScaleFactor_PlugIn() { return 1.; }
+wxColour GetFontColour_PlugIn( wxString TextElement ) { return *wxBLACK; }
+
+//  Every name gets a colour of its own, the same one every run
+bool GetGlobalColor( wxString colorName, wxColour *pcolour )
+{
+    unsigned int l_iHash = 2166136261u;
+    for( size_t i = 0; i < colorName.Len(); i++ )
+        l_iHash = ( l_iHash ^ (unsigned int)colorName[i].GetValue() ) * 16777619u;
+    pcolour->Set( l_iHash & 0xff, ( l_iHash >> 8 ) & 0xff, ( l_iHash >> 16 ) & 0xff );
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  Geography and units, on a plain mercator chart with north up
+//----------------------------------------------------------------------------
+
+void DistanceBearingMercator_Plugin( double lat0, double lon0, double lat1, double lon1, double *brg, double *dist )
+{
+    DistanceBearingMercator( lat0, lon0, lat1, lon1, brg, dist );
+}
+
+void PositionBearingDistanceMercator_Plugin( double lat, double lon, double brg, double dist, double *dlat, double *dlon )
+{
+    PositionBearingDistanceMercator( lat, lon, brg, dist, dlat, dlon );
+}
+
+void GetCanvasPixLL( PlugIn_ViewPort *vp, wxPoint *pp, double lat, double lon )
+{
+    double easting, northing;
+    toSM( lat, lon, vp->clat, vp->clon, &easting, &northing );
+    pp->x = (int)wxRound( vp->pix_width / 2. + easting * vp->view_scale_ppm );
+    pp->y = (int)wxRound( vp->pix_height / 2. - northing * vp->view_scale_ppm );
+}
+
+void GetCanvasLLPix( PlugIn_ViewPort *vp, wxPoint p, double *plat, double *plon )
+{
+    double easting = ( p.x - vp->pix_width / 2. ) / vp->view_scale_ppm;
+    double northing = ( vp->pix_height / 2. - p.y ) / vp->view_scale_ppm;
+    fromSM( easting, northing, vp->clat, vp->clon, plat, plon );
+}
+
+void PlugInNormalizeViewport( PlugIn_ViewPort *vp, float lat, float lon )
+{
+    vp->clat = lat;
+    vp->clon = lon;
+    vp->skew = 0.;
+    vp->rotation = 0.;
+}
+
+double toUsrDistance_Plugin( double nm_distance, int unit ) { return nm_distance; }
+wxString getUsrDistanceUnit_Plugin( int unit ) { return wxT("NMi"); }
+
+wxString toSDMM_PlugIn( int NEflag, double a, bool hi_precision )
+{
+    double l_dAbs = fabs( a );
+    int l_iDeg = (int)l_dAbs;
+    double l_dMin = ( l_dAbs - l_iDeg ) * 60.;
+    wxChar l_cHemi = NEflag == 1 ? ( a < 0. ? 'S' : 'N' ) : ( a < 0. ? 'W' : 'E' );
+    wxString s;
+    if( hi_precision )
+        s.Printf( wxT("%03d %07.4f %c"), l_iDeg, l_dMin, l_cHemi );
+    else
+        s.Printf( wxT("%03d %05.2f %c"), l_iDeg, l_dMin, l_cHemi );
+    return s;
+}
+
+double fromDMM_Plugin( wxString sdms )
+{
+    double l_dDeg = 0., l_dMin = 0.;
+    wxString l_sRest = sdms.Strip( wxString::both );
+    wxString l_sDeg = l_sRest.BeforeFirst( ' ' );
+    l_sDeg.ToDouble( &l_dDeg );
+    l_sRest.AfterFirst( ' ' ).BeforeFirst( ' ' ).ToDouble( &l_dMin );
+    double l_dValue = fabs( l_dDeg ) + l_dMin / 60.;
+    wxChar l_cHemi = l_sRest.Last();
+    if( l_dDeg < 0. || l_cHemi == 'S' || l_cHemi == 'W' ) l_dValue = -l_dValue;
+    return l_dValue;
+}
@@ -0,0 +1,38 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw benchmark stand in for the OpenCPN plugin API
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODBENCHSTUBS_H
+#define ODBENCHSTUBS_H
+
+#include <wx/string.h>
+
+class wxWindow;
+
+//  Where the stubbed API says the shared and private data live, and the
+//  hidden frame handed out as the chart canvas
+void ODBenchSetDataDirs( const wxString &shared, const wxString &priv );
+void ODBenchSetCanvas( wxWindow *pCanvas );
+
+#endif // ODBENCHSTUBS_H
@@ -29,12 +29,108 @@
 
 #include "PathMan.h"
 
+#include <wx/hashmap.h>
+#include <map>
+#include <vector>
+
 class Boundary;
 class BoundaryPoint;
+class ODBoundaryGeometry;
+
+//  Size in degrees of a cell of the boundary edge index
+#define ODBOUNDARY_CELL_SIZE        0.1
+//  Edges whose box covers more cells than this are kept out of the cells and always tested
+#define ODBOUNDARY_MAX_EDGE_CELLS   256
+
+//  Lat/lon box around edge i of a boundary, vertex i to vertex i + 1
+struct ODBoundaryEdgeBox
+{
+    double  m_dMinLat, m_dMaxLat, m_dMinLon, m_dMaxLon;
+};
+
+struct ODBoundaryEdgeRef
+{
+    ODBoundaryGeometry  *m_pGeometry;
+    int                 m_iEdge;
+};
+
+typedef std::vector<ODBoundaryEdgeRef> ODBoundaryEdgeRefs;
+WX_DECLARE_HASH_MAP( int, ODBoundaryEdgeRefs, wxIntegerHash, wxIntegerEqual, ODBoundaryCellHash );
+
+//  Vertices of one boundary copied out of its point list, with the lat/lon box around them
+class ODBoundaryGeometry
+{
+    public:
+        bool Contains( double lat, double lon );
+        
+        Boundary            *m_pBoundary;
+        wxString            m_GUID;
+        int                 m_iPointCount;      // m_pODPointList count when built
+        std::vector<double> m_dLat;
+        std::vector<double> m_dLon;
+        double              m_dMinLat, m_dMaxLat, m_dMinLon, m_dMaxLon;
+        std::vector<ODBoundaryEdgeBox>  m_EdgeBox;
+        std::vector<unsigned int>       m_iEdgeStamp;   // last query that tested the edge
+};
+
+//  Answer to a nearest edge or boundary crossing query. Distances are in NM.
+class ODBoundaryHit
+{
+    public:
+        Boundary    *m_pBoundary;       // NULL when nothing was found
+        double      m_dDistance;
+        double      m_dBearing;         // from the query position
+        double      m_dLat, m_dLon;     // closest point on the edge, or the crossing point
+        double      m_dTime;            // hours until the crossing
+        bool        m_bInside;          // query position is inside m_pBoundary
+};
+
+//  A position reported by an event subscriber, and the boundaries it was last seen inside
+class ODTrackedTarget
+{
+    public:
+        wxString        m_sSubscriber;
+        wxString        m_sId;
+        double          m_dLat;
+        double          m_dLon;
+        wxArrayString   m_aInside;
+};
+
+//  An entry or exit found while updating, copied out so it can be sent once
+//  the update has finished with the targets and boundaries
+struct ODBoundaryEvent
+{
+    wxString    m_sSubscriber;
+    wxString    m_sId;
+    double      m_dLat, m_dLon;
+    wxString    m_sGUID;
+    wxString    m_sName;
+    bool        m_bBoundaryPoint;
+    bool        m_bExclusion, m_bInclusion;
+    bool        m_bEntered;
+};
+
+//  Lat/lon box around a boundary, or around the range rings of a boundary point
+struct ODBoundaryArea
+{
+    Boundary        *m_pBoundary;
+    BoundaryPoint   *m_pBoundaryPoint;
+    double          m_dMinLat, m_dMaxLat, m_dMinLon, m_dMaxLon;
+};
+
+typedef std::vector<ODBoundaryEvent> ODBoundaryEventArray;
+typedef std::vector<ODBoundaryArea> ODBoundaryAreas;
+WX_DECLARE_HASH_MAP( int, ODBoundaryAreas, wxIntegerHash, wxIntegerEqual, ODBoundaryAreaCellHash );
+WX_DECLARE_STRING_HASH_MAP( ODBoundaryArea, ODBoundaryAreaGUIDHash );
+WX_DECLARE_STRING_HASH_MAP( int, ODBoundarySubscriberHash );
+WX_DECLARE_STRING_HASH_MAP( ODTrackedTarget *, ODTrackedTargetHash );
 
 class BoundaryMan : public PathMan
 {
     public:
+        BoundaryMan();
+        virtual ~BoundaryMan();
+        
         wxString    FindPointInBoundary( double lat, double lon, int type );
         bool        FindPointInBoundary( Boundary *pBoundary, double lat, double lon );
         bool        FindPointInBoundary( wxString l_GUID, double lat, double lon );
@@ -42,8 +138,60 @@ class BoundaryMan : public PathMan
         bool        FindPointInBoundaryPoint( BoundaryPoint *pBoundaryPoint, double lat, double lon );
         bool        FindPointInBoundaryPoint( wxString l_GUID, double lat, double lon );
         
+        //  Boundary entry/exit events for positions tracked on behalf of other plugins
+        void        SubscribeBoundaryEvents( const wxString &subscriber, int type );
+        void        UnsubscribeBoundaryEvents( const wxString &subscriber );
+        bool        IsSubscribed( const wxString &subscriber );
+        void        UpdateTrackedPosition( const wxString &subscriber, const wxString &id, double lat, double lon );
+        void        RemoveTrackedTarget( const wxString &subscriber, const wxString &id );
+        //  Events are queued while targets are updated, the caller sends them
+        //  when it is done with its own state. A subscriber may call back in.
+        void        SendBoundaryEvents( void );
+        
+        //  Called when a boundary or boundary point is added, changed or about to be deleted
+        void        BoundaryChanged( Boundary *pBoundary, bool bDeleted );
+        void        BoundaryPointChanged( BoundaryPoint *pBoundaryPoint, bool bDeleted );
+        
+        //  Closest boundary edge to a position, and the first edge crossed when running a
+        //  rhumb line at cog/sog for up to hours
+        bool        FindNearestBoundaryEdge( double lat, double lon, int type, ODBoundaryHit *pHit );
+        bool        FindBoundaryCrossing( double lat, double lon, double cog, double sog, double hours, int type, ODBoundaryHit *pHit );
+        
     private:
         bool    pointInPolygon(int polyCorners, double *polyX, double *polyY, double x, double y);
+        
+        ODBoundaryGeometry *GetBoundaryGeometry( Boundary *pBoundary );
+        void    ClearBoundaryGeometry( void );
+        bool    IsBoundaryType( int type, bool bExclusion, bool bInclusion );
+        bool    IsInsideBoundaryPoint( BoundaryPoint *pBoundaryPoint, double lat, double lon );
+        void    SetTargetInside( ODTrackedTarget *pTarget, Boundary *pBoundary, BoundaryPoint *pBoundaryPoint, bool bInside );
+        
+        bool    ValidateEdgeIndex( void );
+        void    ValidateAreaIndex( void );
+        void    AddToAreaIndex( const ODBoundaryArea &area );
+        void    TestAreas( ODBoundaryAreas *pAreas, ODTrackedTarget *pTarget, int type, wxArrayString *pTested );
+        void    AddToEdgeIndex( ODBoundaryGeometry *pGeometry );
+        ODBoundaryEdgeRefs *FindEdgeCell( int ilat, int ilon );
+        void    TestNearestEdges( ODBoundaryEdgeRefs *pRefs, double lat, double lon, int type, double *pBest, ODBoundaryEdgeRef *pBestRef );
+        void    TestCrossingEdges( ODBoundaryEdgeRefs *pRefs, double lat, double lon, double dx, double dy, int type, double *pBest, ODBoundaryEdgeRef *pBestRef );
+        
+        std::map<Boundary *, ODBoundaryGeometry *>  m_BoundaryGeometry;
+        ODBoundaryCellHash          m_EdgeCells;
+        ODBoundaryEdgeRefs          m_LargeEdges;
+        bool                        m_bEdgeIndexValid;
+        int                         m_iIndexedBoundaries;
+        int                         m_iCellMinLat, m_iCellMaxLat, m_iCellMinLon, m_iCellMaxLon;
+        unsigned int                m_iQueryStamp;
+        double                      m_dCosLat;      // scale of the local projection for the current query
+        ODBoundarySubscriberHash    m_BoundarySubscribers;
+        ODTrackedTargetHash         m_TrackedTargets;
+        ODBoundaryEventArray        m_PendingEvents;
+        ODBoundaryAreaCellHash      m_AreaCells;
+        ODBoundaryAreas             m_LargeAreas;
+        ODBoundaryAreaGUIDHash      m_AreaGUIDs;
+        bool                        m_bAreaIndexValid;
+        size_t                      m_iAreaBoundaries;  // list counts when the area index was built
+        size_t                      m_iAreaPoints;
 };
 
 #endif // BOUNDARYMAN_H
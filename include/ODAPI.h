@@ -0,0 +1,96 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw plugin message API
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODAPI_H
+#define ODAPI_H
+
+#include "ODJSON.h"
+
+#include <wx/hashmap.h>
+
+class ODAPI;
+class ODTrackedTarget;
+class Boundary;
+class BoundaryPoint;
+class ODBoundaryHit;
+struct ODBoundaryEvent;
+
+typedef bool (ODAPI::*ODAPIHandler)( void );
+WX_DECLARE_STRING_HASH_MAP( ODAPIHandler, ODAPIHandlerHash );
+
+//----------------------------------------------------------------------------
+//  ODAPI
+//
+//  Handles the OCPN_DRAW_PI plugin messages. Each "Msg" name is registered
+//  against a handler method, the handler reads the fields it needs from the
+//  request and writes its response through the shared writer.
+//----------------------------------------------------------------------------
+
+class ODAPI
+{
+public:
+    ODAPI();
+    ~ODAPI();
+
+    bool ProcessMessage( const wxString &message_body );
+    void RegisterHandler( const wxString &msg, ODAPIHandler handler );
+    void SendBoundaryEvent( const ODBoundaryEvent &event );
+
+private:
+    bool Version( void );
+    bool FindPathByGUID( void );
+    bool FindPositionAlongPath( void );
+    bool FindPointInAnyBoundary( void );
+    bool FindPointInBoundary( void );
+    bool FindPointInGuardZone( void );
+    bool SubscribeBoundaryEvents( void );
+    bool UpdateTrackedPositions( void );
+    bool FindNearestBoundary( void );
+    bool FindBoundaryCrossing( void );
+    bool Stats( void );
+
+    void AddNearestBoundary( ODJSONReader &position, int type );
+    void AddBoundaryCrossing( ODJSONReader &position, int type );
+    void AddBoundaryHit( const ODBoundaryHit &hit );
+
+    bool IsRequest( void ) { return m_reader.IsString( "Type", "Request" ); }
+    bool RequireMember( const char *key, const wxChar *what );
+    void BeginResponse( void );
+    void SendResponse( void );
+
+    ODJSONReader        m_reader;
+    ODJSONReader        m_element;          // member objects of request arrays
+    ODJSONWriter        m_writer;
+    ODAPIHandlerHash    m_Handlers;
+
+    // reused for every message
+    wxString    m_sMsg;
+    wxString    m_sSource;
+    wxString    m_sMsgId;
+    wxString    m_sGUID;
+    wxString    m_sId;
+};
+
+#endif // ODAPI_H
@@ -0,0 +1,112 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw changes file writer thread
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODCHANGESWRITER_H
+#define ODCHANGESWRITER_H
+
+#include <wx/string.h>
+#include <wx/thread.h>
+#include <wx/longlong.h>
+
+#include <stdio.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+//  Groups waiting for the writer before Write blocks the caller
+#define ODCHANGES_QUEUE_MAX     256
+
+//  One call to Write, written in full or not at all
+struct ODChangesEntry
+{
+    ODChangesEntry() { m_iRecords = 0; m_iQueuedUs = 0; }
+
+    std::string     m_sData;
+    size_t          m_iRecords;
+    wxLongLong_t    m_iQueuedUs;
+};
+
+//  Timing of one group written by the thread, handed back to the GUI thread
+struct ODChangesSample
+{
+    wxLongLong_t    m_iQueuedUs;        // oldest entry in the group
+    wxLongLong_t    m_iStartUs;
+    wxLongLong_t    m_iEndUs;
+};
+
+//----------------------------------------------------------------------------
+//  ODChangesWriter
+//
+//  Owns the changes file and appends the records handed to Write from a
+//  worker thread. Whatever has queued up while the thread was busy, or
+//  during the flush interval, goes out with a single flush. Remove, Rotate
+//  and Flush wait for the queue to drain before they return. Without a
+//  thread everything is written by the caller.
+//----------------------------------------------------------------------------
+
+class ODChangesWriter
+{
+public:
+    ODChangesWriter( const wxString &filename );
+    ~ODChangesWriter();
+
+    bool    IsOpen( void ) { return m_file != NULL; }
+    void    SetFlushInterval( int ms );
+
+    bool    Write( std::string &data, size_t records );
+    bool    Flush( void );
+    void    Stop( void );
+
+    void    Remove( void );
+    bool    Rotate( const wxString &to );
+
+    //  Worker thread side
+    void    Run( void );
+
+private:
+    bool    WriteEntries( std::deque<ODChangesEntry> &entries );
+    void    TruncateFile( long length );
+    void    WaitIdle( void );
+    void    ReportStats( void );
+
+    wxString            m_sFilename;
+    FILE                *m_file;
+    wxThread            *m_pThread;
+
+    //  Shared with the worker thread
+    wxMutex             m_mutex;
+    wxCondition         m_condWork;         // something queued, a flush wanted or stopping
+    wxCondition         m_condIdle;         // queue space freed or the thread went idle
+    std::deque<ODChangesEntry>      m_Queue;
+    bool                m_bBusy;
+    bool                m_bFlushNow;
+    bool                m_bStop;
+    bool                m_bFailed;
+    int                 m_iFlushIntervalMs;
+    size_t              m_iPeakDepth;
+    std::vector<ODChangesSample>    m_Samples;
+};
+
+#endif // ODCHANGESWRITER_H
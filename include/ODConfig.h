@@ -30,6 +30,9 @@
 #include "ODNavObjectChanges.h"
 
 class NavObjectCollection;
+class ODGPXExport;
+class ODGPXImport;
+class ODNavObjCompactor;
 //class NavObjectChanges;
 
 //class ODConfig : public MyConfig
@@ -42,14 +45,32 @@ class ODConfig
 
         virtual bool AddNewPath(ODPath *pr, int ConfigRouteNum = -1);
         virtual bool UpdatePath(ODPath *pr);
+        bool UpdatePathPointInserted( ODPath *pb, ODPoint *pPrev, ODPoint *pOP );
+        bool UpdatePathPointRemoved( ODPath *pb, ODPoint *pOP );
         virtual bool DeleteConfigPath(ODPath *pr);
         
         virtual bool AddNewODPoint(ODPoint *pWP, int ConfigRouteNum = -1);
         virtual bool UpdateODPoint(ODPoint *pWP);
         virtual bool DeleteODPoint(ODPoint *pWP);
+        //  One changeset record for objects deleted together, layer objects
+        //  are not expected in the sets
+        bool DeleteConfigObjects( const ODPathSet *pPaths, const ODPointSet *pPoints );
+
+        //  Changeset records made between Begin and Commit are coalesced and
+        //  written to the changes file in one go. Transactions may be nested,
+        //  only the outermost commit writes. If that write fails the objects
+        //  stay as edited and the whole navobj file is saved instead.
+        void BeginTransaction( void );
+        bool CommitTransaction( void );
+        bool IsInTransaction( void ) { return m_iTransactionDepth > 0; }
 
         virtual void UpdateNavObj();
         virtual void LoadNavObjects();
+        
+        //  Called from a timer on the GUI thread. Once the changes file has
+        //  grown large enough it builds a snapshot of the objects, a slice per
+        //  call, then starts a background rewrite of the navobj file from it.
+        void CheckNavObjCompaction( void );
 
         void ExportGPX(wxWindow* parent, bool bviz_only = false, bool blayer = false);
         void UI_ImportGPX(wxWindow* parent, bool islayer = false, wxString dirpath = _T(""), bool isdirectory = true);
@@ -63,6 +84,7 @@ class ODConfig
         ODNavObjectChanges  *m_pODNavObjectChangesSet;  
         wxString                m_sODNavObjSetFile;
         wxString                m_sODNavObjSetChangesFile;
+        wxString                m_sODNavObjSnapshotFile;
           
         ODNavObjectChanges    *m_pODNavObjectInputSet;
 
@@ -74,6 +96,19 @@ class ODConfig
       
     protected:
     private:
+        bool WriteGPXExport( ODGPXExport &gpx, const wxString &filename );
+        bool ReadGPXImport( ODGPXImport &gpx );
+        
+        int                     m_iTransactionDepth;
+        
+        ODNavObjCompactor       *m_pNavObjCompactor;
+        bool                    m_bNavObjCompactionFailed;   // not retried until the next full save
+        
+        //  Snapshot being built, dropped if anything changes before it is done
+        ODNavObjectChanges      *m_pNavObjCompactionSnapshot;
+        size_t                  m_iNavObjCompactionChanges;
+        size_t                  m_iNavObjCompactionPaths;
+        size_t                  m_iNavObjCompactionPoints;
 };
 
 #endif // OCPNDRAWCONFIG_H
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw streaming GPX export
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODGPXEXPORT_H
+#define ODGPXEXPORT_H
+
+#include "ODPath.h"
+#include "ODNavObjectChanges.h"
+
+#include <wx/hashmap.h>
+#include <wx/thread.h>
+#include <vector>
+
+//  Size of the stdio buffer used for the export file
+#define ODGPXEXPORT_BUFFER_SIZE     ( 256 * 1024 )
+
+//  Called on the GUI thread while an export runs, return false to cancel it
+typedef bool (*ODGPXExportProgress)( int done, int total, void *data );
+
+typedef std::vector<ODPoint *> ODPointVector;
+WX_DECLARE_HASH_MAP( wxLongLong_t, ODPointVector, wxIntegerHash, wxIntegerEqual, ODPathPointHash );
+
+//  Hash key of a position already scaled to 1e-6 degree cells
+inline wxLongLong_t ODPointPositionKey( int ilat, int ilon )
+{
+    return ( (wxLongLong_t)ilat << 32 ) ^ (wxLongLong_t)(unsigned int)ilon;
+}
+
+//  Points that belong to a path, matched the way ODPoint::IsSame does: same
+//  name and less than 1e-6 degrees apart. Points are hashed on their position
+//  rounded to 1e-6 degrees so a lookup only has to check the neighbouring cells.
+class ODPathPointSet
+{
+public:
+    void Build( PathList *pPaths );
+    bool Contains( ODPoint *pOP );
+    
+private:
+    ODPathPointHash m_Points;
+};
+
+//----------------------------------------------------------------------------
+//  ODGPXExport
+//
+//  Writes the objects added to it to a GPX file. The document is built on the
+//  calling thread, then a worker thread prints it a node at a time to a
+//  buffered file while the calling thread reports progress.
+//----------------------------------------------------------------------------
+
+class ODGPXExport
+{
+public:
+    ODGPXExport();
+    
+    void    AddODPoint( ODPoint *pOP ) { m_ODPoints.push_back( pOP ); }
+    void    AddPath( ODPath *pPath ) { m_Paths.push_back( pPath ); }
+    int     GetCount( void ) { return m_ODPoints.size() + m_Paths.size(); }
+    
+    bool    Write( const wxString &filename, ODGPXExportProgress progress = NULL, void *data = NULL );
+    bool    WasCancelled( void ) { return m_bCancel; }
+    
+    //  Worker thread side
+    void    WriteObjects( void );
+    
+private:
+    bool    IsCancelled( void );
+    void    SetDone( int done );
+    
+    ODPointVector           m_ODPoints;
+    std::vector<ODPath *>   m_Paths;
+    wxString                m_sFileName;
+    ODNavObjectChanges      m_Document;     // read only while the worker runs
+    
+    //  Shared with the worker thread
+    wxCriticalSection       m_csProgress;
+    int                     m_iDone;
+    bool                    m_bCancel;
+    bool                    m_bFinished;
+    bool                    m_bOK;
+};
+
+#endif // ODGPXEXPORT_H
@@ -0,0 +1,135 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw parallel GPX import
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODGPXIMPORT_H
+#define ODGPXIMPORT_H
+
+#include "ODGPXExport.h"
+
+#include <wx/hashmap.h>
+#include <wx/thread.h>
+#include <vector>
+
+class Layer;
+class ODNavObjectChanges;
+
+//  Upper limit on the number of files parsed at the same time
+#define ODGPXIMPORT_MAX_THREADS     8
+
+//  Called on the GUI thread while an import runs, return false to cancel it
+typedef bool (*ODGPXImportProgress)( int done, int total, void *data );
+
+WX_DECLARE_STRING_HASH_MAP( ODPoint *, ODPointGUIDHash );
+
+//  Lookup of the points held by the point manager, by GUID and by name and
+//  position, used in place of the list walks in ODNavObjectChanges while
+//  objects are being loaded. Only points added or removed through the index
+//  are tracked, so it must not outlive the load it was built for.
+class ODPointIndex
+{
+public:
+    void    Build( ODPointList *pODPoints );
+    void    Add( ODPoint *pOP );
+    bool    Remove( ODPoint *pOP );
+    
+    ODPoint *Find( const wxString &guid );
+    ODPoint *Find( const wxString &name, double lat, double lon );
+    
+private:
+    ODPointGUIDHash m_GUIDs;
+    ODPathPointHash m_Positions;
+};
+
+typedef std::vector<ODPath *> ODPathVector;
+WX_DECLARE_STRING_HASH_MAP( ODPath *, ODPathByGUIDHash );
+WX_DECLARE_HASH_MAP( unsigned long, ODPathVector, wxIntegerHash, wxIntegerEqual, ODPathFingerprintHash );
+WX_DECLARE_HASH_MAP( ODPoint *, int, wxPointerHash, wxPointerEqual, ODPointUseHash );
+
+//  Lookup of the paths held in g_pPathList, by GUID and by a fingerprint of
+//  the type and the point sequence, with a count of the indexed paths each
+//  point is used by. Layer paths are not fingerprinted, they never match.
+//  The same limits as for ODPointIndex apply.
+class ODPathIndex
+{
+public:
+    void    Build( PathList *pPaths );
+    void    Add( ODPath *pPath );
+    
+    ODPath  *Find( const wxString &guid );
+    ODPath  *Find( ODPath *pPath );             // same type, ODPath::IsEqualTo
+    bool    IsPointUsed( ODPoint *pOP );
+    
+    static unsigned long Fingerprint( ODPath *pPath );
+    
+private:
+    ODPathByGUIDHash        m_GUIDs;
+    ODPathFingerprintHash   m_Fingerprints;
+    ODPointUseHash          m_PointUse;
+};
+
+//----------------------------------------------------------------------------
+//  ODGPXImport
+//
+//  Loads a set of GPX files. The files are parsed on a pool of worker
+//  threads, each into its own document, while the calling thread creates the
+//  objects from the parsed documents in file order and adds them to the
+//  point and path managers.
+//----------------------------------------------------------------------------
+
+class ODGPXImport
+{
+public:
+    ODGPXImport( Layer *pLayer = NULL );
+    ~ODGPXImport();
+    
+    void    AddFile( const wxString &filename ) { m_Files.Add( filename ); }
+    int     GetCount( void ) { return m_Files.GetCount(); }
+    
+    bool    Load( ODGPXImportProgress progress = NULL, void *data = NULL );
+    bool    WasCancelled( void ) { return m_bCancel; }
+    
+    //  Worker thread side
+    void    ParseFiles( void );
+    void    ThreadDone( void );
+    
+private:
+    void    Cancel( void );
+    void    Commit( ODNavObjectChanges *pSet );
+    ODNavObjectChanges *TakeParsed( int index, bool *bFinished );
+    
+    wxArrayString       m_Files;
+    Layer               *m_pLayer;
+    ODPointIndex        m_Index;
+    ODPathIndex         m_PathIndex;
+    
+    //  Shared with the worker threads
+    wxCriticalSection   m_csFiles;
+    std::vector<ODNavObjectChanges *> m_Parsed;
+    int                 m_iNextFile;
+    int                 m_iThreadsRunning;
+    bool                m_bCancel;
+};
+
+#endif // ODGPXIMPORT_H
@@ -0,0 +1,282 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw GPX loader names and defaults
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODGPXLOADCONTEXT_H
+#define ODGPXLOADCONTEXT_H
+
+#include <wx/string.h>
+#include <wx/colour.h>
+#include <vector>
+
+//  Element and attribute names the GPX loader acts on
+enum {
+    ODGPX_UNKNOWN = 0,
+
+    //  elements
+    ODGPX_SYM,
+    ODGPX_TIME,
+    ODGPX_NAME,
+    ODGPX_DESC,
+    ODGPX_LINK,
+    ODGPX_LINK_TEXT,
+    ODGPX_LINK_TYPE,
+    ODGPX_TEXT,
+    ODGPX_TEXT_POSITION,
+    ODGPX_TEXT_COLOUR,
+    ODGPX_FONT_INFO,
+    ODGPX_BACKGROUND_COLOUR,
+    ODGPX_BACKGROUND_TRANSPARENCY,
+    ODGPX_TYPE,
+    ODGPX_VIZ,
+    ODGPX_VIZ_NAME,
+    ODGPX_GUID,
+    ODGPX_AUTO_NAME,
+    ODGPX_SHARED,
+    ODGPX_ARRIVAL_RADIUS,
+    ODGPX_RANGE_RINGS,
+    ODGPX_BOUNDARY_TYPE,
+    ODGPX_BOUNDARY_POINT_STYLE,
+    ODGPX_NATURAL_SCALE,
+    ODGPX_DISPLAY_TEXT_WHEN,
+    ODGPX_ODPOINT,
+    ODGPX_ACTIVE,
+    ODGPX_STYLE,
+    ODGPX_TIME_DISPLAY,
+    ODGPX_PERSISTENCE,
+    ODGPX_SHOW_ARROW,
+    ODGPX_VRM,
+    ODGPX_FIXED_END_POSITION,
+    ODGPX_DR_SOG,
+    ODGPX_DR_COG,
+    ODGPX_DR_LENGTH,
+    ODGPX_DR_LENGTH_NM,
+    ODGPX_DR_POINT_INTERVAL,
+    ODGPX_DR_POINT_INTERVAL_NM,
+    ODGPX_DR_LENGTH_TYPE,
+    ODGPX_DR_INTERVAL_TYPE,
+    ODGPX_DR_DISTANCE_UNITS,
+    ODGPX_DR_TIME_UNITS,
+
+    //  attributes
+    ODGPX_ATTR_SIZE,
+    ODGPX_ATTR_FAMILY,
+    ODGPX_ATTR_STYLE,
+    ODGPX_ATTR_WEIGHT,
+    ODGPX_ATTR_UNDERLINE,
+    ODGPX_ATTR_STRIKETHROUGH,
+    ODGPX_ATTR_FACE,
+    ODGPX_ATTR_ENCODING,
+    ODGPX_ATTR_NUMBER,
+    ODGPX_ATTR_STEP,
+    ODGPX_ATTR_UNITS,
+    ODGPX_ATTR_VISIBLE,
+    ODGPX_ATTR_COLOUR,
+    ODGPX_ATTR_WIDTH,
+    ODGPX_ATTR_LINE_STYLE,
+    ODGPX_ATTR_FILL_TRANSPARENCY,
+    ODGPX_ATTR_INCLUSION_FILL_SIZE,
+    ODGPX_ATTR_ACTIVE_COLOUR,
+    ODGPX_ATTR_ACTIVE_FILLCOLOUR,
+    ODGPX_ATTR_INACTIVE_COLOUR,
+    ODGPX_ATTR_INACTIVE_FILLCOLOUR,
+    ODGPX_ATTR_INCLUSION_BOUNDARY_SIZE
+};
+
+struct ODGPXLink
+{
+    wxString    m_sHref;
+    wxString    m_sText;
+    wxString    m_sType;
+};
+
+//  What the loader takes from one opencpn:ODPoint element, anything the
+//  element leaves out keeps the load's default
+struct ODGPXPointRecord
+{
+    double      m_dLat;
+    double      m_dLon;
+    wxString    m_sSym;
+    wxString    m_sName;
+    wxString    m_sDesc;
+    wxString    m_sText;
+    wxString    m_sType;
+    wxString    m_sGUID;
+    wxString    m_sTime;
+    size_t      m_iFirstLink;       // in the record set's link array
+    size_t      m_iLinks;
+
+    bool        m_bPropViz;         // viz given, otherwise it follows the load
+    bool        m_bViz;
+    bool        m_bPropVizName;
+    bool        m_bVizName;
+    bool        m_bAutoName;
+    bool        m_bShared;
+    double      m_dArrivalRadius;
+
+    int         m_iTextPointFontSize;
+    int         m_iTextPointFontFamily;
+    int         m_iTextPointFontStyle;
+    int         m_iTextPointFontWeight;
+    bool        m_bTextPointFontUnderline;
+    bool        m_bTextPointFontStrikethrough;
+    wxString    m_wxsTextPointFontFace;
+    int         m_iTextPointFontEncoding;
+    int         m_iTextPosition;
+    wxColour    m_colourTextColour;
+    wxColour    m_colourBackgroundColour;
+    int         m_iBackgroundTransparency;
+    double      m_dNaturalScale;
+    int         m_iDisplayTextWhen;
+
+    int         m_iODPointRangeRingsNumber;
+    float       m_fODPointRangeRingsStep;
+    int         m_iODPointRangeRingsStepUnits;
+    bool        m_bODPointRangeRingsVisible;
+    wxColour    m_wxcODPointRangeRingsColour;
+    int         m_iODPointRangeRingWidth;
+    int         m_iODPointRangeRingStyle;
+
+    bool        m_bExclusionBoundaryPoint;
+    bool        m_bInclusionBoundaryPoint;
+    int         m_iInclusionBoundaryPointSize;
+    unsigned int m_uiBoundaryPointFillTransparency;
+};
+
+//  Path fields found in the file, the others keep the path's own defaults
+enum {
+    ODGPX_PATH_GUID                 = 1 << 0,
+    ODGPX_PATH_ACTIVE_COLOUR        = 1 << 1,
+    ODGPX_PATH_ACTIVE_FILLCOLOUR    = 1 << 2,
+    ODGPX_PATH_INACTIVE_COLOUR      = 1 << 3,
+    ODGPX_PATH_INACTIVE_FILLCOLOUR  = 1 << 4,
+    ODGPX_PATH_STYLE                = 1 << 5,
+    ODGPX_PATH_WIDTH                = 1 << 6,
+    ODGPX_PATH_FILL_TRANSPARENCY    = 1 << 7,
+    ODGPX_PATH_INCLUSION_SIZE       = 1 << 8,
+    ODGPX_PATH_EXCLUSION            = 1 << 9,
+    ODGPX_PATH_INCLUSION            = 1 << 10,
+    ODGPX_PATH_PERSISTENCE          = 1 << 11,
+    ODGPX_PATH_SHOW_ARROW           = 1 << 12,
+    ODGPX_PATH_VRM                  = 1 << 13,
+    ODGPX_PATH_FIXED_END_POSITION   = 1 << 14,
+    ODGPX_PATH_DR_SOG               = 1 << 15,
+    ODGPX_PATH_DR_COG               = 1 << 16,
+    ODGPX_PATH_DR_LENGTH            = 1 << 17,
+    ODGPX_PATH_DR_LENGTH_NM         = 1 << 18,
+    ODGPX_PATH_DR_POINT_INTERVAL    = 1 << 19,
+    ODGPX_PATH_DR_POINT_INTERVAL_NM = 1 << 20,
+    ODGPX_PATH_DR_LENGTH_TYPE       = 1 << 21,
+    ODGPX_PATH_DR_INTERVAL_TYPE     = 1 << 22,
+    ODGPX_PATH_DR_DISTANCE_UNITS    = 1 << 23,
+    ODGPX_PATH_DR_TIME_UNITS        = 1 << 24
+};
+
+struct ODGPXPathRecord
+{
+    void        Reset( const wxString &type );
+
+    wxString    m_sType;
+    wxString    m_sName;
+    wxString    m_sDesc;
+    wxString    m_sGUID;
+    wxString    m_sTimeDisplay;
+    size_t      m_iFirstLink;
+    size_t      m_iLinks;
+    size_t      m_iFirstPoint;      // in the record set's point array
+    size_t      m_iPoints;
+
+    unsigned int m_iFields;         // ODGPX_PATH_*
+    bool        m_bPropViz;
+    bool        m_bViz;
+    bool        m_bActive;
+    wxColour    m_wxcActiveLineColour;
+    wxColour    m_wxcActiveFillColour;
+    wxColour    m_wxcInActiveLineColour;
+    wxColour    m_wxcInActiveFillColour;
+    int         m_iStyle;
+    int         m_iWidth;
+    unsigned int m_uiFillTransparency;
+    int         m_iInclusionBoundarySize;
+    bool        m_bExclusionBoundary;
+    bool        m_bInclusionBoundary;
+    int         m_iPersistence;
+    bool        m_bDrawArrow;
+    bool        m_bVRM;
+    bool        m_bFixedEndPosition;
+    double      m_dSoG;
+    int         m_iCoG;
+    double      m_dDRPathLength;
+    double      m_dTotalLengthNM;
+    double      m_dDRPointInterval;
+    double      m_dDRPointIntervalNM;
+    int         m_iLengthType;
+    int         m_iIntervalType;
+    int         m_iDistanceUnits;
+    int         m_iTimeUnits;
+};
+
+//  Whole document worth of records, top level objects in file order
+struct ODGPXRecordSet
+{
+    void        Clear( void );
+
+    std::vector<ODGPXPointRecord>   m_Points;       // isolated marks and path points
+    std::vector<ODGPXPathRecord>    m_Paths;
+    std::vector<ODGPXLink>          m_Links;
+    std::vector<long>               m_Objects;      // path index, or -1 - point index for a mark
+};
+
+//----------------------------------------------------------------------------
+//  ODGPXLoadContext
+//
+//  State shared by every object of one load. The point defaults come from
+//  the plugin settings and are taken once when the load starts, element and
+//  attribute names are looked up in a hash of the names above so they never
+//  need converting to wxString.
+//----------------------------------------------------------------------------
+
+class ODGPXLoadContext
+{
+public:
+    ODGPXLoadContext() { m_bValid = false; }
+
+    void    Snapshot( void );
+    bool    IsValid( void ) { return m_bValid; }
+
+    //  Sets pRec to the defaults, sym and guid included
+    void    ResetPoint( ODGPXPointRecord *pRec, const wxString &sym, const wxString &guid );
+
+    static int  Lookup( const char *name );
+
+    //  Same results as wxString::ToLong/ToDouble, without making the wxString
+    static bool ToLong( const char *s, long *v );
+    static bool ToDouble( const char *s, double *v );
+
+private:
+    ODGPXPointRecord    m_PointDefaults;
+    bool                m_bValid;
+};
+
+#endif // ODGPXLOADCONTEXT_H
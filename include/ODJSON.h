@@ -0,0 +1,131 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw lightweight JSON message reader and writer
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODJSON_H
+#define ODJSON_H
+
+#include <wx/string.h>
+#include <vector>
+
+#define ODJSON_STRING   's'
+#define ODJSON_NUMBER   'n'
+#define ODJSON_BOOL     'b'
+#define ODJSON_NULL     'z'
+#define ODJSON_OBJECT   'o'
+#define ODJSON_ARRAY    'a'
+
+//  Position of one member of the parsed object within the message text
+struct ODJSONField
+{
+    size_t  m_iKeyStart;
+    size_t  m_iKeyLen;
+    size_t  m_iValueStart;
+    size_t  m_iValueLen;        // for strings this excludes the quotes
+    char    m_cType;
+    bool    m_bEscaped;         // string holds escape sequences
+};
+
+//----------------------------------------------------------------------------
+//  ODJSONReader
+//
+//  Reads a single JSON object and records where each top level member is,
+//  without building a value tree. Values are only converted when a caller
+//  asks for them by name. Nested objects and arrays are kept as text spans,
+//  an array of objects can be walked with GetNextArrayObject. The field table is
+//  reused between messages. The text passed to Parse is not copied and has to
+//  outlive the reader's use of it.
+//----------------------------------------------------------------------------
+
+class ODJSONReader
+{
+public:
+    ODJSONReader();
+
+    bool Parse( const wxString &text );
+    const wxString &GetError( void ) { return m_sError; }
+
+    bool HasMember( const char *key );
+    bool IsString( const char *key, const char *value );
+    bool GetString( const char *key, wxString *value );
+    bool GetDouble( const char *key, double *value );
+    bool GetInt( const char *key, int *value );
+    bool GetBool( const char *key, bool *value );
+
+    int  GetArrayCount( const char *key );
+    bool GetNextArrayObject( const char *key, size_t *cursor, ODJSONReader *object );
+
+private:
+    bool ParseObject( size_t start, size_t end );
+    bool ParseValue( const wxChar *p, size_t len, size_t *pos, ODJSONField *field );
+    bool SkipString( const wxChar *p, size_t len, size_t *pos, bool *escaped );
+    bool SkipNested( const wxChar *p, size_t len, size_t *pos );
+    void SkipSpace( const wxChar *p, size_t len, size_t *pos );
+    bool SetError( const wxChar *msg, size_t pos );
+
+    ODJSONField *Find( const char *key );
+    bool Unescape( ODJSONField *field, wxString *value );
+
+    const wxString  *m_pText;
+    wxString    m_sError;
+    wxString    m_sScratch;         // reused for number conversion
+    std::vector<ODJSONField> m_Fields;
+};
+
+//----------------------------------------------------------------------------
+//  ODJSONWriter
+//
+//  Appends members to a flat JSON object held in a reusable buffer.
+//----------------------------------------------------------------------------
+
+class ODJSONWriter
+{
+public:
+    ODJSONWriter();
+
+    void Begin( void );
+    const wxString &End( void );
+
+    void AddString( const char *key, const wxString &value );
+    void AddString( const char *key, const char *value );     // plain ASCII, not escaped
+    void AddDouble( const char *key, double value );
+    void AddInt( const char *key, long value );
+    void AddBool( const char *key, bool value );
+
+    void BeginArray( const char *key );
+    void EndArray( void );
+    void BeginObject( void );
+    void EndObject( void );
+
+    const wxString &GetText( void ) { return m_sBuffer; }
+
+private:
+    void AddKey( const char *key );
+    void AppendEscaped( const wxString &value );
+
+    wxString    m_sBuffer;
+    bool        m_bFirst;
+};
+
+#endif // ODJSON_H
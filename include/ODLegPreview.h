@@ -0,0 +1,78 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw interactive path leg preview
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODLEGPREVIEW_H
+#define ODLEGPREVIEW_H
+
+#include <wx/colour.h>
+#include <wx/gdicmn.h>
+#include <wx/string.h>
+
+class ODDC;
+class wxFont;
+class wxPen;
+class PlugIn_ViewPort;
+
+//----------------------------------------------------------------------------
+//  ODLegPreview
+//
+//  Draws the rubber band leg and its bearing/distance label while a path is
+//  being placed with the mouse. The pen, font and label colours are looked
+//  up once per placement rather than once per frame, and the label text and
+//  its extents are only rebuilt when the displayed values change.
+//----------------------------------------------------------------------------
+
+class ODLegPreview
+{
+public:
+    ODLegPreview();
+
+    void Invalidate( void ) { m_bValid = false; }
+
+    void DrawSegment( ODDC &dc, const wxPoint &from, const wxPoint &to, PlugIn_ViewPort &VP );
+    void DrawLegInfo( ODDC &dc, const wxPoint &ref_point, double brg, double dist );
+    void DrawLabel( ODDC &dc, int xp, int yp, const wxString &s, const wxSize &extents );
+
+    wxFont *GetFont( void );
+
+private:
+    void Refresh( void );
+
+    bool        m_bValid;
+    wxFont      *m_pFont;
+    wxPen       *m_pLinePen;
+    wxPen       *m_pTextPen;
+    wxColour    m_BackColour;
+    wxColour    m_TextColour;
+
+    // last label drawn, rebuilt when one of these changes
+    int         m_iBearing;
+    bool        m_bMag;
+    double      m_dDist;
+    wxString    m_sLegInfo;
+    wxSize      m_LegInfoExtents;
+};
+
+#endif // ODLEGPREVIEW_H
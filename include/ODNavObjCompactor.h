@@ -0,0 +1,86 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw navobj file compaction
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODNAVOBJCOMPACTOR_H
+#define ODNAVOBJCOMPACTOR_H
+
+#include "pugixml.hpp"
+
+#include <wx/string.h>
+#include <wx/thread.h>
+
+class ODNavObjectChanges;
+
+//  Size and record count of the changes file that start a rewrite of the navobj file
+#define ODNAVOBJ_COMPACT_BYTES      ( 4 * 1024 * 1024 )
+#define ODNAVOBJ_COMPACT_RECORDS    2000
+//  GUI thread time given to building the snapshot on each timer tick
+#define ODNAVOBJ_COMPACT_SLICE_US   25000
+
+//----------------------------------------------------------------------------
+//  ODNavObjCompactor
+//
+//  Writes a snapshot of the navobj objects out on a worker thread. The
+//  snapshot is built on the GUI thread, and the changes recorded before it
+//  are moved aside to the pending changes file. The worker writes the
+//  snapshot to a temporary file, renames it over the navobj file and then
+//  removes the pending changes. If anything goes wrong before that the
+//  pending changes are still there to be replayed on the next start. Once
+//  the navobj file is in place the binary snapshot file is rewritten to
+//  match it.
+//----------------------------------------------------------------------------
+
+class ODNavObjCompactor
+{
+public:
+    ODNavObjCompactor( const wxString &navobj_file, const wxString &pending_changes_file, const wxString &snapshot_file );
+    ~ODNavObjCompactor();
+
+    bool    Start( ODNavObjectChanges *pSnapshot );
+    bool    IsBusy( void );
+    bool    Finish( bool *pbOK );
+
+    const wxString &GetPendingChangesFile( void ) { return m_sPendingChangesFile; }
+
+    //  Writes doc to a temporary file next to filename and renames it into place
+    static bool ReplaceFile( pugi::xml_document &doc, const wxString &filename );
+
+    //  Worker thread side
+    void    WriteSnapshot( void );
+
+private:
+    wxString            m_sNavObjFile;
+    wxString            m_sPendingChangesFile;
+    wxString            m_sSnapshotFile;
+    ODNavObjectChanges  *m_pSnapshot;
+    wxThread            *m_pThread;
+
+    //  Shared with the worker thread
+    wxCriticalSection   m_csState;
+    bool                m_bFinished;
+    bool                m_bOK;
+};
+
+#endif // ODNAVOBJCOMPACTOR_H
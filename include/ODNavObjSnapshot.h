@@ -0,0 +1,53 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw binary cache of the navobj file
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODNAVOBJSNAPSHOT_H
+#define ODNAVOBJSNAPSHOT_H
+
+#include "ODGPXLoadContext.h"
+
+#include <wx/string.h>
+
+#define ODNAVOBJ_SNAPSHOT_VERSION   1
+
+//----------------------------------------------------------------------------
+//  ODNavObjSnapshot
+//
+//  Keeps the records read from the navobj file in a flat binary file next to
+//  it, so a start with an unchanged navobj file skips the XML parse. The
+//  snapshot holds the size, modification time and hash of the navobj file it
+//  was made from and is only used while all three still match. Anything that
+//  does not check out, including a snapshot from another version or machine
+//  byte order, is treated as missing and the XML is loaded instead.
+//----------------------------------------------------------------------------
+
+class ODNavObjSnapshot
+{
+public:
+    static bool Write( const wxString &filename, const wxString &navobj_file, const ODGPXRecordSet &set );
+    static bool Read( const wxString &filename, const wxString &navobj_file, ODGPXRecordSet *pSet );
+};
+
+#endif // ODNAVOBJSNAPSHOT_H
@@ -29,6 +29,14 @@
 //#include <NavObjectCollection.h>
 #include "pugixml.hpp"
 #include "ODPath.h"
+#include "ODGPXLoadContext.h"
+
+#include <wx/hashmap.h>
+
+class ODPointIndex;
+class ODPathIndex;
+class Layer;
+class ODChangesWriter;
 
 //      Bitfield definition controlling the GPX nodes output for point objects
 #define         OUT_TYPE        1 << 1          //  Output point type
@@ -67,6 +75,9 @@
                         (OUT_OCPNPOINT_RANGE_RINGS) +\
                         (OUT_POINTTEXT)
 
+//  Batched change records, keyed on object type and GUID
+WX_DECLARE_STRING_HASH_MAP( pugi::xml_node, ODChangeBatchHash );
+
 //class ODNavObjectChanges : public NavObjectChanges
 class ODNavObjectChanges : public pugi::xml_document
 {
@@ -75,11 +86,14 @@ class ODNavObjectChanges : public pugi::xml_document
         ODNavObjectChanges( wxString file_name );
         virtual ~ODNavObjectChanges();
 
-    bool CreateNavObjGPXPaths(void);
-    bool CreateNavObjGPXPoints( void );    
+    bool CreateNavObjGPXPaths( wxLongLong_t until_us = 0 );
+    bool CreateNavObjGPXPoints( wxLongLong_t until_us = 0 );    
     
     bool AddPath ( ODPath *pb, const char *action );
     bool AddODPoint( ODPoint *pr, const char *action );
+    bool AddDeletes( const ODPathSet *pPaths, const ODPointSet *pPoints );
+    //  A point put into a path after pPrev, or taken out of it if pPrev is NULL
+    bool AddPathPoint( ODPath *pb, ODPoint *pPrev, ODPoint *pOP );
     bool AddGPXPathsList( PathList *pPaths );
     bool AddGPXPath(ODPath *pPath);
     bool AddGPXODPoint(ODPoint *pWP );
@@ -87,17 +101,46 @@ class ODNavObjectChanges : public pugi::xml_document
     bool GPXCreatePath( pugi::xml_node node, ODPath *pPath );
     bool GPXCreateODPoint( pugi::xml_node node, ODPoint *pop, unsigned int flags );
     bool LoadAllGPXObjects( bool b_full_viz = false);
-    int  LoadAllGPXObjectsAsLayer(int layer_id, bool b_layerviz);
+    int  LoadAllGPXObjectsAsLayer( Layer *pLayer );
+    
+    //  LoadAllGPXObjects in two steps, so the records can be kept apart from
+    //  the document they were read from
+    bool ReadAllGPXRecords( ODGPXRecordSet *pSet, bool b_snapshot_defaults = true );
+    //  Takes the load defaults from the plugin settings, for a ReadAllGPXRecords
+    //  that runs off the GUI thread and so is told not to
+    void SnapshotLoadDefaults( void ) { m_LoadContext.Snapshot(); }
+    bool LoadAllGPXRecords( const ODGPXRecordSet &set, bool b_full_viz = false );
     //ODPoint * GPXLoadODPoint1( pugi::xml_node &odpt_node, wxString def_symbol_name, wxString GUID, bool b_fullviz, bool b_layer, bool b_layerviz, int layer_id );
 
-    bool CreateAllGPXObjects();
+    //  With until_us set (an ODStatsNowUs time) it stops there, and the next
+    //  call carries on where it left off. True once every object is written.
+    bool CreateAllGPXObjects( wxLongLong_t until_us = 0 );
     void SetRootGPXNode(void);
     
     bool ApplyChanges(void);
     bool SaveFile( const wxString filename );
     void RemoveChangesFile( void );
+    bool RotateChangesFile( const wxString &to );
+    size_t GetChangeRecords( void ) { return m_iChangeRecords; }
+    size_t GetChangeBytes( void ) { return m_iChangeBytes; }
+    
+    void BeginBatch( void );
+    bool CommitBatch( void );
+    void DiscardBatch( void );
+    bool IsBatching( void ) { return m_bBatching; }
+    bool PatchBatchedPath( ODPath *pb, ODPoint *pPrev, ODPoint *pOP );
+    
+    //  Changes are written to the file by a thread. FlushChanges waits for
+    //  them to reach it, after StopChangesWriter they are written directly.
+    bool FlushChanges( void );
+    void StopChangesWriter( void );
+    void SetChangesFlushInterval( int ms );
     
-    FILE        *m_ODchanges_file;
+    //  While set, point lookups use the index instead of walking the point list
+    void SetPointIndex( ODPointIndex *pIndex ) { m_pPointIndex = pIndex; }
+    //  While set, path lookups use the index and a path equal to one already
+    //  loaded is not added again
+    void SetPathIndex( ODPathIndex *pIndex ) { m_pPathIndex = pIndex; }
     
     pugi::xml_node      m_gpx_root;
     
@@ -115,15 +158,46 @@ class ODNavObjectChanges : public pugi::xml_document
                              );
         ODPath *GPXLoadPath1( pugi::xml_node &odpoint_node, bool b_fullviz,
                       bool b_layer, bool b_layerviz, int layer_id, wxString *TypeString );
+        void ReadODPointRecord( pugi::xml_node &opt_node, const wxString &def_symbol_name, const wxString &GUID,
+                                ODGPXPointRecord *pRec, std::vector<ODGPXLink> *pLinks );
+        ODPoint *CreateODPoint( const ODGPXPointRecord &rec, const std::vector<ODGPXLink> &links,
+                                bool b_fullviz, bool b_layer, bool b_layerviz, int layer_id );
+        void ReadPathRecord( pugi::xml_node &odpoint_node, const wxString &type, ODGPXPathRecord *pRec, ODGPXRecordSet *pSet );
+        ODPath *CreatePath( const ODGPXPathRecord &rec, const ODGPXRecordSet &set, bool b_fullviz,
+                            bool b_layer, bool b_layerviz, int layer_id );
         ODPoint *ODPointExists( const wxString& guid );
         ODPoint *ODPointExists( const wxString& name, double lat, double lon );
         ODPoint *tempODPointExists( const wxString& guid );
-        void InsertPathA( ODPath *pTentPath );
+        bool InsertPathA( ODPath *pTentPath );
         void UpdatePathA( ODPath *pTentPath );
         ODPath *PathExists( const wxString& guid);
         ODPath *PathExists( ODPath * pTentPath );
+        bool WriteChange( pugi::xml_node object );
+        bool BatchChange( pugi::xml_node object, const wxString &key, const char *action, bool b_match_guid );
+        bool UnbatchChange( const wxString &key, bool b_match_guid );
+        void ApplyDeletes( pugi::xml_node object );
+        void ApplyPathPoint( pugi::xml_node object );
         wxString m_ODfilename;
+        ODChangesWriter     *m_pChangesWriter;
         ODPointList *m_ptODPointList;
+        
+        bool                m_bBatching;
+        pugi::xml_document  m_batch;
+        pugi::xml_node      m_batch_root;
+        ODChangeBatchHash   m_BatchIndex;
+        
+        ODPointIndex        *m_pPointIndex;
+        ODPathIndex         *m_pPathIndex;
+        ODGPXLoadContext    m_LoadContext;
+        ODGPXRecordSet      m_LoadRecords;      // reused between objects
+        
+        //  Written to the changes file since it was started
+        size_t              m_iChangeRecords;
+        size_t              m_iChangeBytes;
+        
+        //  List positions CreateAllGPXObjects has got through
+        size_t              m_iCreatedPaths;
+        size_t              m_iCreatedPoints;
 
 
 };
@@ -26,6 +26,9 @@
 
 #include <wx/object.h>
 #include <wx/list.h>
+#include <wx/hashmap.h>
+#include <wx/hashset.h>
+#include <vector>
 
 #include "Quilt.h"
 #include "ocpn_types.h"
@@ -43,6 +46,31 @@
 
 class ODDC;
 
+//  A path vertex as it was when the leg distances were last worked out
+struct ODPathVertex
+{
+    ODPoint     *m_pODPoint;
+    double      m_dLat;
+    double      m_dLon;
+    double      m_dBearing;         // of the leg ending here
+    double      m_dSegLen;
+    double      m_dCumulative;      // from the first point to here
+};
+
+typedef std::vector<ODPathVertex> ODPathVertexArray;
+WX_DECLARE_HASH_MAP( ODPoint *, int, wxPointerHash, wxPointerEqual, ODPathVertexHash );
+
+//  A closed path holds its first point twice, so entries are counted
+struct ODPathGUIDEntry
+{
+    ODPathGUIDEntry() : m_pODPoint( NULL ), m_iCount( 0 ) {}
+
+    ODPoint     *m_pODPoint;
+    int         m_iCount;
+};
+
+WX_DECLARE_STRING_HASH_MAP( ODPathGUIDEntry, ODPathGUIDHash );
+
 class ODPath : public wxObject
 {
 public:
@@ -50,13 +78,13 @@ public:
     virtual ~ODPath(void);
 
     virtual void AddPoint(ODPoint* pNewPoint, bool b_rename_in_sequence = true, bool b_deferBoxCalc = false, bool b_isLoading = false);
-    void AddTentativePoint(const wxString& GUID);
     ODPoint *GetPoint(int nPoint);
     ODPoint *GetPoint ( const wxString &guid );
     int GetIndexOf(ODPoint *prp);
     virtual ODPoint *InsertPointBefore(ODPoint *pOP, double lat, double lon, bool bRenamePoints = false);
     virtual ODPoint *InsertPointAfter(ODPoint *pOP, double lat, double lon, bool bRenamePoints = false);
     virtual void InsertPointAfter( ODPoint *pOP, ODPoint *pnOP, bool bRenamePoints = false);
+    void SetPoints( const std::vector<ODPoint *> &points );
     void DrawPointWhich(ODDC& dc, int iPoint, wxPoint *rpn);
     void DrawSegment(ODDC& dc, wxPoint *rp1, wxPoint *rp2, PlugIn_ViewPort &VP, bool bdraw_arrow);
     virtual void Draw(ODDC& dc, PlugIn_ViewPort &pVP);
@@ -64,9 +92,13 @@ public:
     ODPoint *GetLastPoint();
     virtual void DeletePoint(ODPoint *rp, bool bRenamePoints = false);
     virtual void RemovePoint(ODPoint *rp, bool bRenamePoints = false);
+    void RemovePoints( const ODPointSet &points );
     void DeSelectPath();
     void FinalizeForRendering();
     void UpdateSegmentDistances();
+    double GetDistanceToPoint( int index );
+    double GetDistanceToPoint( ODPoint *pOP );
+    bool GetPositionAtDistance( double dist, double *lat, double *lon );
     void CalculateDCRect(wxDC& dc_boundary, wxRect *prect, PlugIn_ViewPort &VP);
     int GetnPoints(void){ return m_nPoints; }
     wxBoundingBox GetBBox();
@@ -78,7 +110,6 @@ public:
     void RenamePathPoints();
     void ReloadPathPointIcons();
     wxString GetNewMarkSequenced(void);
-    void AssemblePath();
     bool IsEqualTo(ODPath *ptargetboundary);
     void ClonePath(ODPath *psourceboundary, int start_nPoint, int end_nPoint, const wxString & suffix);
     void CloneAddedODPoint(ODPoint *ptargetpoint, ODPoint *psourcepoint);
@@ -130,7 +161,6 @@ public:
     wxString    m_TimeDisplayFormat;
     HyperlinkList     *m_HyperlinkList;
 
-    wxArrayString      ODPointGUIDList;
     ODPointList     *m_pODPointList;
 
     wxRect      active_pt_rect;
@@ -151,6 +181,8 @@ protected:
     wxBoundingBox     RBBox;
 
     bool        CalculateCrossesIDL();
+    void        IndexPointGUID( ODPoint *pOP );
+    void        UnindexPointGUID( ODPoint *pOP );
     int         m_nPoints;
     int         m_nm_sequence;
     bool        m_bVisible; // should this boundary be drawn?
@@ -161,10 +193,20 @@ protected:
     
     
 private:
-
+    bool UnlinkPoint( ODPoint *pOP, bool *pbInPlace );
+    void LinkPoint( wxODPointListNode *node, int index );
+    void VertexRemoved( size_t index, ODPoint *pOP );
+    void VertexInserted( size_t index, ODPoint *pOP );
+    void UpdateVertexLegs( size_t first, size_t last );
+
+    ODPathVertexArray   m_Vertices;
+    ODPathVertexHash    m_VertexIndex;
+    bool                m_bVertexIndexValid;    // rebuilt when next asked for
+    ODPathGUIDHash      m_PointGUIDIndex;
     
 };
 
-WX_DECLARE_LIST(ODPath, PathList); // establish class Path as list member
+OD_DECLARE_POOLED_LIST(ODPath, PathList); // establish class Path as list member
+WX_DECLARE_HASH_SET( ODPath *, wxPointerHash, wxPointerEqual, ODPathSet );
 
 #endif
@@ -8,6 +8,7 @@
 #ifndef __ODPATHPROPERTIESDIALOGDEF_H__
 #define __ODPATHPROPERTIESDIALOGDEF_H__
 
+#include "ODPointListCtrl.h"
 #include <wx/artprov.h>
 #include <wx/xrc/xmlres.h>
 #include <wx/intl.h>
@@ -68,7 +69,7 @@ class ODPathPropertiesDialogDef : public wxDialog
 		wxCheckBox* m_checkBoxPathShowArrow;
 		wxRadioBox* m_radioBoxPathPersistence;
 		wxStaticText* m_staticTextODPoints;
-		wxListCtrl* m_listCtrlODPoints;
+		ODPointListCtrl* m_listCtrlODPoints;
 		wxButton* m_buttonOK;
 		wxButton* m_buttonCancel;
 		
@@ -89,6 +89,7 @@ class ODPathPropertiesDialogImpl : public ODPathPropertiesDialogDef
         ODPoint     *m_pEnroutePoint;
         bool        m_bStartNow;
         int         m_tz_selection;
+        bool        m_bColumnsSized;    // columns are fitted to the first rows shown only
 	
 	public:
 		/** Constructor */
@@ -99,6 +100,7 @@ class ODPathPropertiesDialogImpl : public ODPathPropertiesDialogDef
         void SetPathAndUpdate( ODPath *pB, bool only_points = false );
         virtual bool UpdateProperties( ODPath *pPath );
         virtual bool UpdateProperties( void );
+        void UpdateBoatPosition( void );
         void SetDialogTitle( const wxString &sTitle );
         ODPath *GetPath(void) {return m_pPath;}
         
@@ -29,11 +29,13 @@
 #include <wx/gdicmn.h>
 #include <wx/gauge.h>
 #include <wx/colour.h>
+#include <wx/hashset.h>
 #include "Hyperlink.h"
 #include "ocpn_types.h"
 #include "ocpn_plugin.h"
 #include "OCPNRegion.h"
 #include "viewport.h"
+#include "ODSlabPool.h"
 
 class ODDC;
 class wxDC;
@@ -45,6 +47,10 @@ public:
       ODPoint( ODPoint* orig );
       ODPoint();
       virtual ~ODPoint(void);
+      
+      //  Points, subclasses included, are cut from the shared slab pools
+      static void *operator new( size_t size );
+      static void operator delete( void *p, size_t size );
       virtual void Draw(ODDC& dc, wxPoint *rpn = NULL);
       void ReLoadIcon(void);
 
@@ -159,8 +165,6 @@ public:
 
 #ifdef ocpnUSE_GL
       virtual void DrawGL( PlugIn_ViewPort &pivp );
-      unsigned int m_iTextTexture;
-      int m_iTextTextureWidth, m_iTextTextureHeight;
 
       LLBBox m_wpBBox;
       double m_wpBBox_chart_scale, m_wpBBox_rotation;
@@ -196,6 +200,7 @@ private:
       
 };
 
-WX_DECLARE_LIST(ODPoint, ODPointList);// establish class as list member
+OD_DECLARE_POOLED_LIST(ODPoint, ODPointList);// establish class as list member
+WX_DECLARE_HASH_SET( ODPoint *, wxPointerHash, wxPointerEqual, ODPointSet );
 
 #endif
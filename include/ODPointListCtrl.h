@@ -0,0 +1,104 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw path properties point list
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODPOINTLISTCTRL_H
+#define ODPOINTLISTCTRL_H
+
+#include <wx/listctrl.h>
+#include <vector>
+
+class ODPath;
+class ODPoint;
+
+enum {
+    ID_FROM_POINT = 0,
+    ID_TO_POINT,
+    ID_DISTANCE_FROM_BOAT,
+    ID_BEARING_FROM_BOAT,
+    ID_LATITUDE,
+    ID_LONGITUDE,
+    ID_BEARING_FROM_TO,
+    ID_DESCRIPTION,
+    
+    ID_POINTS_LIST_LAST
+};
+
+//  Values for one row of the list, worked out the first time the row is drawn.
+//  Points are held by GUID and looked up in the path each time, a point can be
+//  deleted while the list is shown.
+class ODPointListRow
+{
+public:
+    wxString    m_sGUID;
+    wxString    m_sNextGUID;
+    bool        m_bFormatted;           // m_sLat, m_sLon and m_dBrgFromTo are set
+    wxString    m_sLat;
+    wxString    m_sLon;
+    double      m_dBrgFromTo;
+    unsigned int m_iFixStamp;           // boat position the from boat values belong to
+    double      m_dDistFromBoat;
+    double      m_dBrgFromBoat;
+};
+
+//----------------------------------------------------------------------------
+//  ODPointListCtrl
+//
+//  Virtual list of the points of a path for the path properties dialog. Rows
+//  are only formatted when the control asks for them, so a boundary with
+//  thousands of points costs no more to show than the rows on screen. A new
+//  boat position only redraws the visible rows and they recalculate their
+//  distance and bearing from the boat.
+//----------------------------------------------------------------------------
+
+class ODPointListCtrl : public wxListCtrl
+{
+public:
+    ODPointListCtrl( wxWindow *parent, wxWindowID id, const wxPoint &pos = wxDefaultPosition,
+                     const wxSize &size = wxDefaultSize, long style = wxLC_REPORT | wxLC_VIRTUAL );
+    
+    void    SetPath( ODPath *pPath );
+    void    SetBoatPosition( double lat, double lon );
+    ODPoint *GetODPoint( long item );
+    
+protected:
+    virtual wxString OnGetItemText( long item, long column ) const;
+    virtual int OnGetItemImage( long item ) const;
+    
+private:
+    void    RefreshVisibleRows( void );
+    ODPoint *FindODPoint( const wxString &guid ) const;
+    void    FormatRow( ODPointListRow &row ) const;
+    void    UpdateFromBoat( ODPointListRow &row ) const;
+    wxString FormatBearing( double brg ) const;
+    
+    //  OnGetItemText is const, the rows fill in their cached values as they are drawn
+    mutable std::vector<ODPointListRow> m_Rows;
+    ODPath          *m_pPath;
+    double          m_dBoatLat;
+    double          m_dBoatLon;
+    unsigned int    m_iFixStamp;
+};
+
+#endif // ODPOINTLISTCTRL_H
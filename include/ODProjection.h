@@ -0,0 +1,74 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw batched lat/lon to canvas projection
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODPROJECTION_H
+#define ODPROJECTION_H
+
+#include "ocpn_plugin.h"
+#include "ODPoint.h"
+
+//----------------------------------------------------------------------------
+//  ODProjection
+//
+//  Holds everything needed to turn lat/lon into canvas pixels for one
+//  PlugIn_ViewPort, so that whole point lists can be projected without a
+//  GetCanvasPixLL round trip into the core for every vertex. The mercator
+//  constants, rotation and skew are worked out once when the viewport is
+//  set. Non mercator viewports, or a core that disagrees with the local
+//  maths, fall back to GetCanvasPixLL.
+//----------------------------------------------------------------------------
+
+class ODProjection
+{
+public:
+    ODProjection();
+    ODProjection( PlugIn_ViewPort &vp );
+
+    void SetViewPort( PlugIn_ViewPort &vp );
+    bool IsSameViewPort( PlugIn_ViewPort &vp );
+
+    void GetPixFromLL( double lat, double lon, wxPoint *r );
+    int  GetPixFromLL( ODPointList *pODPointList, wxPoint *r );
+
+    double GetPixFullCircle( void ) { return m_dPixFullCircle; }
+
+    //  One of a few projections kept for the viewports last drawn, set up
+    //  again only for a viewport not among them
+    static ODProjection &ForViewPort( PlugIn_ViewPort &vp );
+
+private:
+    void ProjectMercator( double lat, double lon, double angle_sin, double angle_cos, double *x, double *y );
+
+    PlugIn_ViewPort m_vp;
+    bool        m_bMercator;
+    double      m_dY30;
+    double      m_dSinAngle;
+    double      m_dCosAngle;
+    double      m_dHalfWidth;
+    double      m_dHalfHeight;
+    double      m_dPixFullCircle;
+};
+
+#endif // ODPROJECTION_H
@@ -28,11 +28,18 @@
 #include "ODPath.h"
 #include "ODvector2D.h"
 
+#include <wx/hashmap.h>
+#include <vector>
+
 #define SELTYPE_UNKNOWN              0x0001
 #define SELTYPE_ODPOINT            0x0002
 #define SELTYPE_PATHSEGMENT          0x0004
 #define SELTYPE_PATHCREATE           0x0008
 
+//  The path segment selectables that end at a point
+typedef std::vector<wxSelectableItemListNode *> ODSegmentNodeArray;
+WX_DECLARE_HASH_MAP( ODPoint *, ODSegmentNodeArray, wxPointerHash, wxPointerEqual, ODSegmentIndexHash );
+
 class ODSelect
 {
 public:
@@ -40,6 +47,8 @@ public:
     ~ODSelect();
 
     void SetSelectPixelRadius(int radius){ pixelRadius = radius; }
+    //  Scale for the select radius when there is no chart canvas to ask, as in odbench
+    void SetSelectScale(double scale_ppm){ m_dSelectScale = scale_ppm; }
 
     bool AddSelectableODPoint( float slat, float slon, ODPoint *pODPointAdd );
     bool AddSelectablePathSegment( float slat1, float slon1, float slat2, float slon2,
@@ -49,6 +58,7 @@ public:
     SelectableItemList FindSelectionList( float slat, float slon, int fseltype );
 
     bool DeleteAllSelectablePathSegments( ODPath * );
+    bool DeleteSelectablePathSegment( ODPath *pr, ODPoint *prp1, ODPoint *prp2 );
     bool DeleteAllSelectableODPoints( ODPath * );
     bool AddAllSelectablePathSegments( ODPath *pr );
     bool AddAllSelectableODPoints( ODPath *pr );
@@ -67,6 +77,13 @@ public:
     bool DeleteAllSelectableTypePoints( int SeltypeToDelete );
 
     bool DeleteSelectableODPoint( ODPoint *prp );
+
+    //    Delete the points and segments of a layer's objects in one pass
+    bool DeleteAllSelectableLayerObjects( int layer_id );
+
+    //    Delete the segments of the paths and the given points in one pass,
+    //    either set may be NULL
+    bool DeleteSelectableObjects( const ODPathSet *pPaths, const ODPointSet *pPoints );
     
     //  Accessors
 
@@ -83,10 +100,15 @@ private:
     pODVector2D vSubtractVectors( pODVector2D v0, pODVector2D v1, pODVector2D v );
     double vVectorSquared( pODVector2D v0 );
     double vVectorMagnitude( pODVector2D v0 );
+    void IndexSegment( wxSelectableItemListNode *node );
+    void UnindexSegment( wxSelectableItemListNode *node );
+    void DeleteSegmentNode( wxSelectableItemListNode *node );
 
     SelectableItemList *pSelectList;
+    ODSegmentIndexHash m_SegmentIndex;
     int pixelRadius;
     float selectRadius;
+    double m_dSelectScale;
 };
 
 #endif
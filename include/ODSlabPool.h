@@ -0,0 +1,120 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw fixed size block pools
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODSLABPOOL_H
+#define ODSLABPOOL_H
+
+#include <wx/list.h>
+
+#include <stddef.h>
+#include <vector>
+
+//  Number of blocks cut from each slab
+#define ODSLABPOOL_BLOCKS   256
+
+//----------------------------------------------------------------------------
+//  ODSlabPool
+//
+//  Hands out blocks of a single size, cut from slabs allocated
+//  ODSLABPOOL_BLOCKS blocks at a time. Freed blocks go on a free list to be
+//  handed out again, and Trim gives back the slabs with no block in use.
+//  Objects made together end up next to each other, and most allocations
+//  just take the head of the free list. Nothing is locked: the import and
+//  compaction threads only parse and write XML, so every object and list
+//  node is made and freed on the GUI thread, which Alloc and Free assert.
+//
+//  ODSelect takes its SelectItems from a pool, ODPoint and its subclasses
+//  take themselves from one, and so do the nodes of ODPointList and
+//  PathList. SelectableItemList and HyperlinkList are declared by OpenCPN,
+//  so their nodes still come from the heap.
+//----------------------------------------------------------------------------
+
+class ODSlabPool
+{
+public:
+    ODSlabPool( size_t size );
+    ~ODSlabPool();
+
+    void    *Alloc( void );
+    void    Free( void *p );
+    void    Trim( void );
+    size_t  GetBlockSize( void ) { return m_iBlockSize; }
+
+    //  A pool shared by everything of this size, for class operator new
+    static ODSlabPool *ForSize( size_t size );
+    //  Trims the shared pools, after a bulk delete
+    static void TrimAll( void );
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock   *m_pNext;
+    };
+
+    void    AddSlab( void );
+    static size_t BlockSize( size_t size );
+
+    size_t              m_iBlockSize;
+    FreeBlock           *m_pFree;
+    size_t              m_iFree;
+    std::vector<char *> m_Slabs;
+};
+
+//  A wxList of T with its nodes cut from the shared pools, declared in place
+//  of WX_DECLARE_LIST( T, name ) and defined with OD_DEFINE_POOLED_LIST( name ).
+//  A list made by copying still gets heap nodes from the wxList copy
+//  constructor, each node goes back to wherever it came from.
+#if wxUSE_STL || wxUSE_STD_CONTAINERS
+#define OD_DECLARE_POOLED_LIST( T, name )   WX_DECLARE_LIST( T, name )
+#define OD_DEFINE_POOLED_LIST( name )       WX_DEFINE_LIST( name )
+#else
+#define OD_DECLARE_POOLED_LIST( T, name )                                                   \
+    WX_DECLARE_LIST( T, name##Base );                                                       \
+    typedef wx##name##BaseNode wx##name##Node;                                              \
+    class name##PooledNode : public wx##name##Node                                          \
+    {                                                                                       \
+    public:                                                                                 \
+        name##PooledNode( wxListBase *list, wx##name##Node *previous, wx##name##Node *next, \
+                          T *data, const wxListKey &key )                                   \
+            : wx##name##Node( list, previous, next, data, key ) {}                          \
+        static void *operator new( size_t size ) { return ODSlabPool::ForSize( size )->Alloc(); } \
+        static void operator delete( void *p, size_t size ) { ODSlabPool::ForSize( size )->Free( p ); } \
+    };                                                                                      \
+    class name : public name##Base                                                          \
+    {                                                                                       \
+    public:                                                                                 \
+        name( wxKeyType keyType = wxKEY_NONE ) : name##Base( keyType ) {}                  \
+    protected:                                                                              \
+        virtual wxNodeBase *CreateNode( wxNodeBase *prev, wxNodeBase *next, void *data,     \
+                                        const wxListKey &key = wxDefaultListKey )           \
+        {                                                                                   \
+            return new name##PooledNode( this, (wx##name##Node *)prev, (wx##name##Node *)next, \
+                                         (T *)data, key );                                  \
+        }                                                                                   \
+    }
+#define OD_DEFINE_POOLED_LIST( name )       WX_DEFINE_LIST( name##Base )
+#endif
+
+#endif // ODSLABPOOL_H
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw runtime counters and timing histograms
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODSTATS_H
+#define ODSTATS_H
+
+#include <wx/longlong.h>
+#include <wx/string.h>
+
+class ODJSONWriter;
+
+//  Timed entry points
+enum {
+    ODSTATS_RENDER_OVERLAY = 0,
+    ODSTATS_RENDER_GL_OVERLAY,
+    ODSTATS_MOUSE_EVENT,
+    ODSTATS_POSITION_FIX,
+    ODSTATS_PLUGIN_MESSAGE,
+    ODSTATS_CHANGES_WRITE,
+    ODSTATS_LOAD_NAVOBJECTS,
+    ODSTATS_NAVOBJ_SNAPSHOT,
+    ODSTATS_CHANGES_FLUSH,          // writer thread, write and flush of one group
+    ODSTATS_CHANGES_COMMIT,         // oldest record of a group queued to flushed
+
+    ODSTATS_TIMER_COUNT
+};
+
+//  Counted events
+enum {
+    ODSTATS_PATHS_DRAWN = 0,
+    ODSTATS_PATHS_CULLED,
+    ODSTATS_POINTS_DRAWN,
+    ODSTATS_POINTS_CULLED,
+    ODSTATS_SELECTABLES_SCANNED,
+    ODSTATS_CHANGES_BYTES,
+    ODSTATS_CHANGES_QUEUE_PEAK,     // high water mark, not a sum
+    ODSTATS_CHANGES_QUEUE_WAITS,
+    ODSTATS_POOL_BLOCKS,            // objects handed out by the slab pools
+    ODSTATS_POOL_SLABS,             // heap allocations made for them
+
+    ODSTATS_COUNTER_COUNT
+};
+
+//  Bucket b holds times below 2^(b+1) microseconds, the last one everything longer
+#define ODSTATS_BUCKETS     24
+
+struct ODStatsHistogram
+{
+    wxLongLong_t    m_iCount;
+    wxLongLong_t    m_iTotalUs;
+    wxLongLong_t    m_iMaxUs;
+    wxLongLong_t    m_iBuckets[ ODSTATS_BUCKETS ];
+};
+
+//----------------------------------------------------------------------------
+//  ODStats
+//
+//  Call counts, timing histograms and event counters for the plugin's busy
+//  entry points. Everything is updated from the GUI thread only, so nothing
+//  is locked. While disabled the hooks below return after a single test.
+//----------------------------------------------------------------------------
+
+class ODStats
+{
+public:
+    ODStats();
+
+    void    Enable( bool bEnable );
+    bool    IsEnabled( void ) { return m_bEnabled; }
+    void    SetLogInterval( int seconds );
+    int     GetLogInterval( void ) { return m_iLogInterval; }
+
+    void    Record( int timer, wxLongLong_t start_us, wxLongLong_t end_us );
+    void    Count( int counter, wxLongLong_t n ) { m_Counters[ counter ] += n; }
+    void    Peak( int counter, wxLongLong_t n ) { if( n > m_Counters[ counter ] ) m_Counters[ counter ] = n; }
+    void    Reset( void );
+
+    void    Write( ODJSONWriter &writer );
+    void    LogSummary( void );
+
+private:
+    double  GetPercentile( const ODStatsHistogram &h, double fraction );
+
+    bool                m_bEnabled;
+    int                 m_iLogInterval;     // seconds, 0 for no periodic log
+    wxLongLong_t        m_iLastLogUs;
+    ODStatsHistogram    m_Timers[ ODSTATS_TIMER_COUNT ];
+    wxLongLong_t        m_Counters[ ODSTATS_COUNTER_COUNT ];
+};
+
+//  Times the enclosing scope against one of the timers
+class ODStatsTimer
+{
+public:
+    ODStatsTimer( int timer );
+    ~ODStatsTimer();
+
+private:
+    int             m_iTimer;
+    wxLongLong_t    m_iStartUs;
+};
+
+void ODStatsCount( int counter, wxLongLong_t n = 1 );
+void ODStatsPeak( int counter, wxLongLong_t n );
+//  For times taken elsewhere, such as on another thread, and handed back
+void ODStatsRecord( int timer, wxLongLong_t start_us, wxLongLong_t end_us );
+//  Microseconds from a clock that only goes forward, for intervals only
+wxLongLong_t ODStatsNowUs( void );
+
+#endif // ODSTATS_H
@@ -0,0 +1,135 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw text extents and label cache
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#ifndef ODTEXTCACHE_H
+#define ODTEXTCACHE_H
+
+#include <wx/font.h>
+#include <wx/hashmap.h>
+#include <list>
+#include <vector>
+
+//    Default upper limit on the memory held by the cache, in bytes
+#define ODTEXTCACHE_DEFAULT_MAX_BYTES   ( 8 * 1024 * 1024 )
+
+class ODTextCacheEntry
+{
+public:
+    ODTextCacheEntry();
+    ~ODTextCacheEntry();
+
+    size_t GetSize( void );
+
+    int             m_iFont;            // index into ODTextCache's font table
+    bool            m_bMultiLine;
+    wxString        m_sText;
+    wxSize          m_Extents;
+#ifdef ocpnUSE_GL
+    unsigned int    m_iTexture;
+    int             m_iTextureWidth;
+    int             m_iTextureHeight;
+#endif
+};
+
+//  Points at the text rather than holding a copy, so a lookup builds no
+//  string. Keys in the hash point at their entry's m_sText.
+class ODTextCacheKey
+{
+public:
+    ODTextCacheKey() { m_iFont = 0; m_bMultiLine = false; m_pText = NULL; }
+    ODTextCacheKey( int font, bool bMultiLine, const wxString *pText )
+        { m_iFont = font; m_bMultiLine = bMultiLine; m_pText = pText; }
+
+    int             m_iFont;
+    bool            m_bMultiLine;
+    const wxString  *m_pText;
+};
+
+class ODTextCacheKeyHash
+{
+public:
+    ODTextCacheKeyHash() {}
+    unsigned long operator()( const ODTextCacheKey &k ) const
+        { return wxStringHash::stringHash( k.m_pText->wc_str() ) ^ ( ( k.m_iFont * 2 + k.m_bMultiLine ) * 0x9E3779B9UL ); }
+    ODTextCacheKeyHash &operator=( const ODTextCacheKeyHash & ) { return *this; }
+};
+
+class ODTextCacheKeyEqual
+{
+public:
+    ODTextCacheKeyEqual() {}
+    bool operator()( const ODTextCacheKey &a, const ODTextCacheKey &b ) const
+        { return a.m_iFont == b.m_iFont && a.m_bMultiLine == b.m_bMultiLine && *a.m_pText == *b.m_pText; }
+    ODTextCacheKeyEqual &operator=( const ODTextCacheKeyEqual & ) { return *this; }
+};
+
+typedef std::list<ODTextCacheEntry *> ODTextCacheLRU;
+WX_DECLARE_HASH_MAP( ODTextCacheKey, ODTextCacheLRU::iterator, ODTextCacheKeyHash, ODTextCacheKeyEqual, ODTextCacheHash );
+
+//----------------------------------------------------------------------------
+//  ODTextCache
+//
+//  Process wide cache of text extents and label textures. Entries are keyed
+//  on the font and the string itself. A font is known by its shared data,
+//  which the font table keeps alive, so a new or rescaled font gets a new
+//  id and a lookup never serialises the font. The least recently used
+//  entries are dropped once the cache holds more than its byte limit.
+//----------------------------------------------------------------------------
+
+class ODTextCache
+{
+public:
+    ODTextCache( size_t max_bytes = ODTEXTCACHE_DEFAULT_MAX_BYTES );
+    ~ODTextCache();
+
+    wxSize GetTextExtent( const wxFont &font, const wxString &text );
+    wxSize GetMultiLineTextExtent( const wxFont &font, const wxString &text );
+#ifdef ocpnUSE_GL
+    unsigned int GetLabelTexture( const wxFont &font, const wxString &text, wxSize *extents, wxSize *texture_size );
+    //  Textures of dropped entries are only deleted here, call with the GL context current
+    void DeleteReleasedTextures( void );
+#endif
+
+    void Clear( void );
+    size_t GetBytesUsed( void ) { return m_BytesUsed; }
+    size_t GetCount( void ) { return m_LRU.size(); }
+
+private:
+    int FontId( const wxFont &font );
+    ODTextCacheEntry *Find( const wxFont &font, const wxString &text, bool bMultiLine );
+    void Trim( void );
+    void Delete( ODTextCacheEntry *pEntry );
+
+    ODTextCacheLRU  m_LRU;              // most recently used at the front
+    ODTextCacheHash m_Hash;
+    std::vector<wxFont> m_Fonts;        // the id of a font is its index
+    size_t          m_MaxBytes;
+    size_t          m_BytesUsed;
+#ifdef ocpnUSE_GL
+    std::vector<unsigned int>   m_ReleasedTextures;
+#endif
+};
+
+#endif // ODTEXTCACHE_H
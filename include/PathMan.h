@@ -35,8 +35,11 @@ class PathMan
         PathMan();
         virtual ~PathMan();
 
-        bool DeletePath(ODPath *pPath);
+        bool DeletePath(ODPath *pPath, bool b_remove_selectables = true);
         void DeleteAllPaths(void);
+        //  Deletes the paths with one pass over each list holding them and one
+        //  changeset record, the caller refreshes the display
+        void DeletePaths(const ODPathSet &paths);
 
         bool IsPathValid(ODPath *pRoute);
 
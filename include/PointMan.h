@@ -75,6 +75,8 @@ class PointMan
       void DeleteAllODPoints(bool b_delete_used);
       ODPoint *FindODPointByGUID(const wxString &guid);
       void DestroyODPoint(ODPoint *pRp, bool b_update_changeset = true);
+      //  Removes and deletes all of the points in one go, the caller refreshes
+      void DeleteODPoints(const ODPointSet &points, bool b_update_changeset = true);
       void ClearODPointFonts(void);
       //void ProcessIcons( ocpnStyle::Style* style );
       void ProcessIcons( );
@@ -100,6 +102,7 @@ protected:
 private:
       //void ProcessUserIcons( ocpnStyle::Style* style );
       void ProcessUserIcons( );
+      void RemoveODPointFromPaths( ODPoint *pRp );
       ODPointList    *m_pODPointList;
       wxBitmap *CreateDimBitmap(wxBitmap *pBitmap, double factor);
 
@@ -175,6 +175,7 @@ class EBL;
 class DR;
 class SelectItem;
 class ODicons;
+class ODLegPreview;
 
 const int StyleValues[] = { wxPENSTYLE_SOLID, wxPENSTYLE_DOT, wxPENSTYLE_LONG_DASH, wxPENSTYLE_SHORT_DASH, wxPENSTYLE_DOT_DASH };
 const int WidthValues[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
@@ -342,6 +343,7 @@ public:
     double  m_view_scale;
     
     ODicons     *m_pODicons;
+    ODLegPreview    *m_pLegPreview;
     
 
 private:
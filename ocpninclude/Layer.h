@@ -28,6 +28,13 @@
 #include <wx/string.h>
 #include <wx/list.h>
 #include <wx/datetime.h>
+#include <set>
+
+class ODPath;
+class ODPoint;
+
+typedef std::set<ODPath *> LayerPathSet;
+typedef std::set<ODPoint *> LayerODPointSet;
 
 class Layer
 {
@@ -42,6 +49,15 @@ public:
       bool HasVisibleNames() { return m_bHasVisibleNames; }
       void SetVisibleNames(bool viz = true){ m_bHasVisibleNames = viz; }
 
+      //  The paths and isolated points loaded into this layer, so layer
+      //  operations do not have to search the global lists
+      void AddPath( ODPath *pPath ) { m_Paths.insert( pPath ); }
+      void RemovePath( ODPath *pPath ) { m_Paths.erase( pPath ); }
+      void AddODPoint( ODPoint *pOP ) { m_ODPoints.insert( pOP ); }
+      void RemoveODPoint( ODPoint *pOP ) { m_ODPoints.erase( pOP ); }
+
+      static Layer *Find( int layer_id );
+
       bool m_bIsVisibleOnChart;
       bool m_bIsVisibleOnListing;
       bool m_bHasVisibleNames;
@@ -52,6 +68,9 @@ public:
       wxString          m_LayerFileName;
       wxString          m_LayerDescription;
       wxDateTime        m_CreateTime;
+
+      LayerPathSet      m_Paths;
+      LayerODPointSet   m_ODPoints;
 };
 
 WX_DECLARE_LIST(Layer, LayerList);// establish class as list member
@@ -50,4 +50,11 @@ Layer::~Layer( void )
 
 }
 
-
+Layer *Layer::Find( int layer_id )
+{
+    if( NULL == pLayerList ) return NULL;
+    for( wxLayerListNode *node = pLayerList->GetFirst(); node; node = node->GetNext() ) {
+        if( node->GetData()->m_LayerID == layer_id ) return node->GetData();
+    }
+    return NULL;
+}
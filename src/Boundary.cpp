@@ -23,6 +23,7 @@
 
 #include "Boundary.h"
 #include "ODdc.h"
+#include "ODProjection.h"
 #include "ocpn_draw_pi.h"
 #include "cutil.h"
 #include "clipper.hpp"
@@ -91,14 +92,8 @@ void Boundary::Draw( ODDC& dc, PlugIn_ViewPort &piVP )
 {
     //ODPath::Draw( dc, piVP );
     if ( m_bVisible && m_pODPointList->GetCount() > 2) {
-        int l_iBoundaryPointCount = 0;
         m_bpts = new wxPoint[ m_pODPointList->GetCount() ];
-        wxPoint r;
-        for(wxODPointListNode *node = m_pODPointList->GetFirst(); node; node = node->GetNext()) {
-            ODPoint *pOp = node->GetData();
-            GetCanvasPixLL( &piVP, &r, pOp->m_lat, pOp->m_lon );
-            m_bpts[ l_iBoundaryPointCount++ ] = r;
-        }
+        ODProjection::ForViewPort( piVP ).GetPixFromLL( m_pODPointList, m_bpts );
         
         if( m_bExclusionBoundary && !m_bInclusionBoundary ) {
             // fill boundary with hatching
@@ -195,14 +190,8 @@ void Boundary::DrawGL( PlugIn_ViewPort &piVP )
             wxPoint *l_AllPoints;
             int     l_iAllPointsSizes[2];
             wxPoint *l_InclusionBoundary;
-            int l_iBoundaryPointCount = 0;
             m_bpts = new wxPoint[ m_pODPointList->GetCount() ];
-            wxPoint r;
-            for(wxODPointListNode *node = m_pODPointList->GetFirst(); node; node = node->GetNext()) {
-                ODPoint *pOp = node->GetData();
-                GetCanvasPixLL( &piVP, &r, pOp->m_lat, pOp->m_lon );
-                m_bpts[ l_iBoundaryPointCount++ ] = r;
-            }
+            int l_iBoundaryPointCount = ODProjection::ForViewPort( piVP ).GetPixFromLL( m_pODPointList, m_bpts );
             
             if( !m_bExclusionBoundary && m_bInclusionBoundary ) {
                 // surround boundary with hatching if there is more than 10 pixels different between points
@@ -315,9 +304,14 @@ void Boundary::DeletePoint( ODPoint *op, bool bRenamePoints )
     //    n.b. must delete Selectables  and update config before deleting the point
     if( op->m_bIsInLayer ) return;
     
+    //  Turned round so the new first point closes the path, the GUID index
+    //  has to count the point it drops and the one it adds
     if((ODPoint *)m_pODPointList->GetFirst()->GetData() == op) {
         m_pODPointList->DeleteObject( op );
-        m_pODPointList->Append( (ODPoint *)m_pODPointList->GetFirst()->GetData() );
+        UnindexPointGUID( op );
+        ODPoint *pFirst = (ODPoint *)m_pODPointList->GetFirst()->GetData();
+        m_pODPointList->Append( pFirst );
+        IndexPointGUID( pFirst );
     }
     
     ODPath::DeletePoint( op, bRenamePoints );
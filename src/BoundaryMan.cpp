@@ -28,6 +28,7 @@
 #include "Boundary.h"
 #include "BoundaryPoint.h"
 #include "PointMan.h"
+#include "ODAPI.h"
 #include "ocpn_draw_pi.h"
 
 #include "math.h"
@@ -36,7 +37,57 @@ extern PathList         *g_pPathList;
 extern BoundaryList     *g_pBoundaryList;
 extern ODPointList      *g_pODPointList;
 extern PointMan         *g_pODPointMan;
+extern ODAPI            *g_pODAPI;
 
+//  Edge queries work on a flat projection around the query position, x east and y north in NM
+static int CellIndex( double deg )
+{
+    return (int)floor( deg / ODBOUNDARY_CELL_SIZE );
+}
+
+static int CellKey( int ilat, int ilon )
+{
+    return ( ilat + 1024 ) * 8192 + ( ilon + 4096 );
+}
+
+//  Distance from the origin to the segment a-b, t is set to where the closest point lies along it
+static double ClosestOnEdge( double ax, double ay, double bx, double by, double *t )
+{
+    double ex = bx - ax;
+    double ey = by - ay;
+    double l_dLen2 = ex * ex + ey * ey;
+    *t = 0.;
+    if( l_dLen2 > 0. ) {
+        *t = -( ax * ex + ay * ey ) / l_dLen2;
+        if( *t < 0. ) *t = 0.;
+        else if( *t > 1. ) *t = 1.;
+    }
+    double px = ax + *t * ex;
+    double py = ay + *t * ey;
+    return sqrt( px * px + py * py );
+}
+
+BoundaryMan::BoundaryMan()
+{
+    m_bEdgeIndexValid = false;
+    m_iIndexedBoundaries = 0;
+    m_iCellMinLat = m_iCellMinLon = 1;
+    m_iCellMaxLat = m_iCellMaxLon = 0;
+    m_iQueryStamp = 0;
+    m_dCosLat = 1.;
+    m_bAreaIndexValid = false;
+    m_iAreaBoundaries = m_iAreaPoints = 0;
+}
+
+BoundaryMan::~BoundaryMan()
+{
+    ClearBoundaryGeometry();
+    
+    for( ODTrackedTargetHash::iterator it = m_TrackedTargets.begin(); it != m_TrackedTargets.end(); ++it )
+        delete it->second;
+    m_TrackedTargets.clear();
+    m_BoundarySubscribers.clear();
+}
 
 
 wxString BoundaryMan::FindPointInBoundary( double lat, double lon, int type )
@@ -287,4 +338,621 @@ bool BoundaryMan::pointInPolygon(int polyCorners, double *polyX, double *polyY,
             
     return oddNodes; 
         
-}
\ No newline at end of file
+}
+bool ODBoundaryGeometry::Contains( double lat, double lon )
+{
+    if( m_dLat.size() < 3 ) return false;
+    if( lat < m_dMinLat || lat > m_dMaxLat || lon < m_dMinLon || lon > m_dMaxLon ) return false;
+    
+    //  Same crossing test as BoundaryMan::pointInPolygon
+    int n = m_dLat.size();
+    int j = n - 1;
+    bool oddNodes = false;
+    for( int i = 0; i < n; i++ ) {
+        if( ( ( m_dLat[i] < lat && m_dLat[j] >= lat ) || ( m_dLat[j] < lat && m_dLat[i] >= lat ) )
+            && ( m_dLon[i] <= lon || m_dLon[j] <= lon ) ) {
+            oddNodes ^= ( m_dLon[i] + ( lat - m_dLat[i] ) / ( m_dLat[j] - m_dLat[i] ) * ( m_dLon[j] - m_dLon[i] ) < lon );
+        }
+        j = i;
+    }
+    return oddNodes;
+}
+
+ODBoundaryGeometry *BoundaryMan::GetBoundaryGeometry( Boundary *pBoundary )
+{
+    int l_iCount = pBoundary->m_pODPointList->GetCount();
+    
+    std::map<Boundary *, ODBoundaryGeometry *>::iterator it = m_BoundaryGeometry.find( pBoundary );
+    if( it != m_BoundaryGeometry.end() ) {
+        // the boundary may have been deleted and its memory reused without us being told
+        if( it->second->m_GUID == pBoundary->m_GUID && it->second->m_iPointCount == l_iCount )
+            return it->second;
+        delete it->second;
+        m_BoundaryGeometry.erase( it );
+    }
+    
+    ODBoundaryGeometry *pGeometry = new ODBoundaryGeometry;
+    pGeometry->m_pBoundary = pBoundary;
+    pGeometry->m_GUID = pBoundary->m_GUID;
+    pGeometry->m_iPointCount = l_iCount;
+    pGeometry->m_dLat.reserve( l_iCount );
+    pGeometry->m_dLon.reserve( l_iCount );
+    pGeometry->m_dMinLat = pGeometry->m_dMinLon = 1000.;
+    pGeometry->m_dMaxLat = pGeometry->m_dMaxLon = -1000.;
+    
+    //  The last point closes the boundary on the first, leave it out as pointInPolygon callers do
+    wxODPointListNode *node = pBoundary->m_pODPointList->GetFirst();
+    wxODPointListNode *last_node = pBoundary->m_pODPointList->GetLast();
+    while( node && node != last_node ) {
+        ODPoint *pop = node->GetData();
+        pGeometry->m_dLat.push_back( pop->m_lat );
+        pGeometry->m_dLon.push_back( pop->m_lon );
+        pGeometry->m_dMinLat = wxMin( pGeometry->m_dMinLat, pop->m_lat );
+        pGeometry->m_dMaxLat = wxMax( pGeometry->m_dMaxLat, pop->m_lat );
+        pGeometry->m_dMinLon = wxMin( pGeometry->m_dMinLon, pop->m_lon );
+        pGeometry->m_dMaxLon = wxMax( pGeometry->m_dMaxLon, pop->m_lon );
+        node = node->GetNext();
+    }
+    
+    //  Edge i runs from vertex i to vertex i + 1, the last one closing back on vertex 0
+    size_t n = pGeometry->m_dLat.size();
+    size_t l_iEdges = n < 3 ? ( n ? n - 1 : 0 ) : n;
+    pGeometry->m_EdgeBox.resize( l_iEdges );
+    pGeometry->m_iEdgeStamp.assign( l_iEdges, 0 );
+    for( size_t i = 0; i < l_iEdges; i++ ) {
+        size_t j = ( i + 1 ) % n;
+        ODBoundaryEdgeBox &box = pGeometry->m_EdgeBox[i];
+        box.m_dMinLat = wxMin( pGeometry->m_dLat[i], pGeometry->m_dLat[j] );
+        box.m_dMaxLat = wxMax( pGeometry->m_dLat[i], pGeometry->m_dLat[j] );
+        box.m_dMinLon = wxMin( pGeometry->m_dLon[i], pGeometry->m_dLon[j] );
+        box.m_dMaxLon = wxMax( pGeometry->m_dLon[i], pGeometry->m_dLon[j] );
+    }
+    
+    m_BoundaryGeometry[ pBoundary ] = pGeometry;
+    m_bEdgeIndexValid = false;
+    m_bAreaIndexValid = false;
+    return pGeometry;
+}
+
+void BoundaryMan::ClearBoundaryGeometry( void )
+{
+    std::map<Boundary *, ODBoundaryGeometry *>::iterator it;
+    for( it = m_BoundaryGeometry.begin(); it != m_BoundaryGeometry.end(); ++it )
+        delete it->second;
+    m_BoundaryGeometry.clear();
+    m_bEdgeIndexValid = false;
+    m_bAreaIndexValid = false;
+}
+
+bool BoundaryMan::IsBoundaryType( int type, bool bExclusion, bool bInclusion )
+{
+    switch( type ) {
+        case ID_BOUNDARY_EXCLUSION:
+            return bExclusion;
+        case ID_BOUNDARY_INCLUSION:
+            return bInclusion;
+        case ID_BOUNDARY_NIETHER:
+            return !bExclusion && !bInclusion;
+        default:
+            return true;
+    }
+}
+
+bool BoundaryMan::IsInsideBoundaryPoint( BoundaryPoint *pBoundaryPoint, double lat, double lon )
+{
+    if( !pBoundaryPoint->m_bShowODPointRangeRings || pBoundaryPoint->m_iODPointRangeRingsNumber <= 0 ) return false;
+    
+    double l_dRangeRingSize = pBoundaryPoint->m_iODPointRangeRingsNumber * pBoundaryPoint->m_fODPointRangeRingsStep;
+    double brg;
+    double l_dPointDistance;
+    DistanceBearingMercator_Plugin( pBoundaryPoint->m_lat, pBoundaryPoint->m_lon, lat, lon, &brg, &l_dPointDistance );
+    return l_dRangeRingSize > l_dPointDistance;
+}
+
+void BoundaryMan::SubscribeBoundaryEvents( const wxString &subscriber, int type )
+{
+    m_BoundarySubscribers[ subscriber ] = type;
+}
+
+void BoundaryMan::UnsubscribeBoundaryEvents( const wxString &subscriber )
+{
+    ODTrackedTargetHash::iterator it = m_TrackedTargets.begin();
+    while( it != m_TrackedTargets.end() ) {
+        if( it->second->m_sSubscriber == subscriber ) {
+            delete it->second;
+            m_TrackedTargets.erase( it );
+            it = m_TrackedTargets.begin();
+        } else
+            ++it;
+    }
+    m_BoundarySubscribers.erase( subscriber );
+}
+
+bool BoundaryMan::IsSubscribed( const wxString &subscriber )
+{
+    return m_BoundarySubscribers.find( subscriber ) != m_BoundarySubscribers.end();
+}
+
+void BoundaryMan::SetTargetInside( ODTrackedTarget *pTarget, Boundary *pBoundary, BoundaryPoint *pBoundaryPoint, bool bInside )
+{
+    const wxString &l_GUID = pBoundary ? pBoundary->m_GUID : pBoundaryPoint->m_GUID;
+    int l_index = pTarget->m_aInside.Index( l_GUID );
+    if( bInside == ( l_index != wxNOT_FOUND ) ) return;
+    
+    if( bInside ) pTarget->m_aInside.Add( l_GUID );
+    else pTarget->m_aInside.RemoveAt( l_index );
+    
+    ODBoundaryEvent l_event;
+    l_event.m_sSubscriber = pTarget->m_sSubscriber;
+    l_event.m_sId = pTarget->m_sId;
+    l_event.m_dLat = pTarget->m_dLat;
+    l_event.m_dLon = pTarget->m_dLon;
+    l_event.m_sGUID = l_GUID;
+    l_event.m_bBoundaryPoint = pBoundary == NULL;
+    l_event.m_bEntered = bInside;
+    if( pBoundary ) {
+        l_event.m_sName = pBoundary->m_PathNameString;
+        l_event.m_bExclusion = pBoundary->m_bExclusionBoundary;
+        l_event.m_bInclusion = pBoundary->m_bInclusionBoundary;
+    } else {
+        l_event.m_sName = pBoundaryPoint->m_ODPointName;
+        l_event.m_bExclusion = pBoundaryPoint->m_bExclusionBoundaryPoint;
+        l_event.m_bInclusion = pBoundaryPoint->m_bInclusionBoundaryPoint;
+    }
+    m_PendingEvents.push_back( l_event );
+}
+
+void BoundaryMan::SendBoundaryEvents( void )
+{
+    if( m_PendingEvents.empty() ) return;
+    
+    //  Anything queued by a subscriber reacting to these goes out on its own call
+    ODBoundaryEventArray l_events;
+    l_events.swap( m_PendingEvents );
+    for( size_t i = 0; i < l_events.size(); i++ ) {
+        if( !g_pODAPI || !IsSubscribed( l_events[i].m_sSubscriber ) ) continue;
+        g_pODAPI->SendBoundaryEvent( l_events[i] );
+    }
+}
+
+void BoundaryMan::UpdateTrackedPosition( const wxString &subscriber, const wxString &id, double lat, double lon )
+{
+    ODBoundarySubscriberHash::iterator sub = m_BoundarySubscribers.find( subscriber );
+    if( sub == m_BoundarySubscribers.end() ) return;
+    int l_type = sub->second;
+    
+    wxString l_key = subscriber + wxT("\t") + id;
+    ODTrackedTarget *pTarget;
+    ODTrackedTargetHash::iterator it = m_TrackedTargets.find( l_key );
+    if( it == m_TrackedTargets.end() ) {
+        pTarget = new ODTrackedTarget;
+        pTarget->m_sSubscriber = subscriber;
+        pTarget->m_sId = id;
+        m_TrackedTargets[ l_key ] = pTarget;
+    } else {
+        pTarget = it->second;
+        if( pTarget->m_dLat == lat && pTarget->m_dLon == lon ) return;
+    }
+    pTarget->m_dLat = lat;
+    pTarget->m_dLon = lon;
+    
+    //  Only areas whose box holds the position can have it inside
+    ValidateAreaIndex();
+    wxArrayString l_Tested;
+    ODBoundaryAreaCellHash::iterator cell = m_AreaCells.find( CellKey( CellIndex( lat ), CellIndex( lon ) ) );
+    if( cell != m_AreaCells.end() ) TestAreas( &cell->second, pTarget, l_type, &l_Tested );
+    TestAreas( &m_LargeAreas, pTarget, l_type, &l_Tested );
+    
+    //  and anything else the target was inside has been left
+    wxArrayString l_Inside = pTarget->m_aInside;
+    for( size_t i = 0; i < l_Inside.GetCount(); i++ ) {
+        if( l_Tested.Index( l_Inside[i] ) != wxNOT_FOUND ) continue;
+        ODBoundaryAreaGUIDHash::iterator area = m_AreaGUIDs.find( l_Inside[i] );
+        if( area != m_AreaGUIDs.end() )
+            SetTargetInside( pTarget, area->second.m_pBoundary, area->second.m_pBoundaryPoint, false );
+        else
+            pTarget->m_aInside.Remove( l_Inside[i] );
+    }
+}
+
+void BoundaryMan::TestAreas( ODBoundaryAreas *pAreas, ODTrackedTarget *pTarget, int type, wxArrayString *pTested )
+{
+    double lat = pTarget->m_dLat;
+    double lon = pTarget->m_dLon;
+    for( size_t i = 0; i < pAreas->size(); i++ ) {
+        ODBoundaryArea &area = (*pAreas)[i];
+        if( lat < area.m_dMinLat || lat > area.m_dMaxLat || lon < area.m_dMinLon || lon > area.m_dMaxLon ) continue;
+        
+        bool l_bInside;
+        if( area.m_pBoundary ) {
+            Boundary *pboundary = area.m_pBoundary;
+            pTested->Add( pboundary->m_GUID );
+            l_bInside = IsBoundaryType( type, pboundary->m_bExclusionBoundary, pboundary->m_bInclusionBoundary ) &&
+                GetBoundaryGeometry( pboundary )->Contains( lat, lon );
+        } else {
+            BoundaryPoint *pboundarypoint = area.m_pBoundaryPoint;
+            pTested->Add( pboundarypoint->m_GUID );
+            l_bInside = IsBoundaryType( type, pboundarypoint->m_bExclusionBoundaryPoint, pboundarypoint->m_bInclusionBoundaryPoint ) &&
+                IsInsideBoundaryPoint( pboundarypoint, lat, lon );
+        }
+        SetTargetInside( pTarget, area.m_pBoundary, area.m_pBoundaryPoint, l_bInside );
+    }
+}
+
+void BoundaryMan::RemoveTrackedTarget( const wxString &subscriber, const wxString &id )
+{
+    ODTrackedTargetHash::iterator it = m_TrackedTargets.find( subscriber + wxT("\t") + id );
+    if( it == m_TrackedTargets.end() ) return;
+    
+    delete it->second;
+    m_TrackedTargets.erase( it );
+}
+
+void BoundaryMan::BoundaryChanged( Boundary *pBoundary, bool bDeleted )
+{
+    std::map<Boundary *, ODBoundaryGeometry *>::iterator it = m_BoundaryGeometry.find( pBoundary );
+    if( it != m_BoundaryGeometry.end() ) {
+        delete it->second;
+        m_BoundaryGeometry.erase( it );
+    }
+    m_bEdgeIndexValid = false;
+    m_bAreaIndexValid = false;
+    
+    if( m_TrackedTargets.empty() ) return;
+    
+    //  Only this boundary needs looking at for each target
+    ODBoundaryGeometry *pGeometry = bDeleted ? NULL : GetBoundaryGeometry( pBoundary );
+    for( ODTrackedTargetHash::iterator target = m_TrackedTargets.begin(); target != m_TrackedTargets.end(); ++target ) {
+        ODTrackedTarget *pTarget = target->second;
+        bool l_bInside = false;
+        if( pGeometry ) {
+            int l_type = m_BoundarySubscribers[ pTarget->m_sSubscriber ];
+            l_bInside = IsBoundaryType( l_type, pBoundary->m_bExclusionBoundary, pBoundary->m_bInclusionBoundary ) &&
+                pGeometry->Contains( pTarget->m_dLat, pTarget->m_dLon );
+        }
+        SetTargetInside( pTarget, pBoundary, NULL, l_bInside );
+    }
+    SendBoundaryEvents();
+}
+
+void BoundaryMan::BoundaryPointChanged( BoundaryPoint *pBoundaryPoint, bool bDeleted )
+{
+    m_bAreaIndexValid = false;
+    
+    for( ODTrackedTargetHash::iterator target = m_TrackedTargets.begin(); target != m_TrackedTargets.end(); ++target ) {
+        ODTrackedTarget *pTarget = target->second;
+        bool l_bInside = false;
+        if( !bDeleted ) {
+            int l_type = m_BoundarySubscribers[ pTarget->m_sSubscriber ];
+            l_bInside = IsBoundaryType( l_type, pBoundaryPoint->m_bExclusionBoundaryPoint, pBoundaryPoint->m_bInclusionBoundaryPoint ) &&
+                IsInsideBoundaryPoint( pBoundaryPoint, pTarget->m_dLat, pTarget->m_dLon );
+        }
+        SetTargetInside( pTarget, NULL, pBoundaryPoint, l_bInside );
+    }
+    SendBoundaryEvents();
+}
+
+bool BoundaryMan::ValidateEdgeIndex( void )
+{
+    //  Picks up boundaries changed behind our back, a rebuilt geometry marks the index stale
+    int l_iCount = 0;
+    for( wxBoundaryListNode *node = g_pBoundaryList->GetFirst(); node; node = node->GetNext() ) {
+        GetBoundaryGeometry( node->GetData() );
+        l_iCount++;
+    }
+    if( m_bEdgeIndexValid && l_iCount == m_iIndexedBoundaries ) return l_iCount > 0;
+    
+    m_EdgeCells.clear();
+    m_LargeEdges.clear();
+    m_iCellMinLat = m_iCellMinLon = 1;
+    m_iCellMaxLat = m_iCellMaxLon = 0;
+    
+    //  Only keep geometry for boundaries that are still in the list
+    std::map<Boundary *, ODBoundaryGeometry *> l_Current;
+    for( wxBoundaryListNode *node = g_pBoundaryList->GetFirst(); node; node = node->GetNext() ) {
+        std::map<Boundary *, ODBoundaryGeometry *>::iterator it = m_BoundaryGeometry.find( node->GetData() );
+        l_Current[ it->first ] = it->second;
+        AddToEdgeIndex( it->second );
+        m_BoundaryGeometry.erase( it );
+    }
+    ClearBoundaryGeometry();
+    m_BoundaryGeometry.swap( l_Current );
+    
+    m_iIndexedBoundaries = l_iCount;
+    m_bEdgeIndexValid = true;
+    m_bAreaIndexValid = false;
+    return l_iCount > 0;
+}
+
+void BoundaryMan::ValidateAreaIndex( void )
+{
+    ValidateEdgeIndex();
+    size_t l_iPoints = g_pODPointMan->GetODPointList()->GetCount();
+    if( m_bAreaIndexValid && m_iAreaBoundaries == g_pBoundaryList->GetCount() && m_iAreaPoints == l_iPoints ) return;
+    
+    m_AreaCells.clear();
+    m_LargeAreas.clear();
+    m_AreaGUIDs.clear();
+    
+    ODBoundaryArea l_area;
+    for( wxBoundaryListNode *node = g_pBoundaryList->GetFirst(); node; node = node->GetNext() ) {
+        ODBoundaryGeometry *pGeometry = GetBoundaryGeometry( node->GetData() );
+        if( pGeometry->m_dLat.empty() ) continue;
+        l_area.m_pBoundary = node->GetData();
+        l_area.m_pBoundaryPoint = NULL;
+        l_area.m_dMinLat = pGeometry->m_dMinLat;
+        l_area.m_dMaxLat = pGeometry->m_dMaxLat;
+        l_area.m_dMinLon = pGeometry->m_dMinLon;
+        l_area.m_dMaxLon = pGeometry->m_dMaxLon;
+        AddToAreaIndex( l_area );
+    }
+    
+    for( wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst(); node; node = node->GetNext() ) {
+        ODPoint *pop = node->GetData();
+        if( pop->m_sTypeString != wxT("Boundary Point") ) continue;
+        BoundaryPoint *pboundarypoint = (BoundaryPoint *)pop;
+        if( !pboundarypoint->m_bShowODPointRangeRings || pboundarypoint->m_iODPointRangeRingsNumber <= 0 ) continue;
+        
+        //  Ring radius in NM, a little over so the mercator distance test is never cut off
+        double l_dRadius = pboundarypoint->m_iODPointRangeRingsNumber * pboundarypoint->m_fODPointRangeRingsStep * 1.01;
+        if( l_dRadius <= 0. ) continue;
+        double l_dLat = l_dRadius / 60.;
+        double l_dCos = cos( pop->m_lat * PI / 180. );
+        double l_dLon = l_dCos > 0.01 ? l_dLat / l_dCos : 360.;
+        l_area.m_pBoundary = NULL;
+        l_area.m_pBoundaryPoint = pboundarypoint;
+        l_area.m_dMinLat = pop->m_lat - l_dLat;
+        l_area.m_dMaxLat = pop->m_lat + l_dLat;
+        l_area.m_dMinLon = pop->m_lon - l_dLon;
+        l_area.m_dMaxLon = pop->m_lon + l_dLon;
+        AddToAreaIndex( l_area );
+    }
+    
+    m_iAreaBoundaries = g_pBoundaryList->GetCount();
+    m_iAreaPoints = l_iPoints;
+    m_bAreaIndexValid = true;
+}
+
+void BoundaryMan::AddToAreaIndex( const ODBoundaryArea &area )
+{
+    m_AreaGUIDs[ area.m_pBoundary ? area.m_pBoundary->m_GUID : area.m_pBoundaryPoint->m_GUID ] = area;
+    
+    int l_iMinLat = CellIndex( area.m_dMinLat );
+    int l_iMaxLat = CellIndex( area.m_dMaxLat );
+    int l_iMinLon = CellIndex( area.m_dMinLon );
+    int l_iMaxLon = CellIndex( area.m_dMaxLon );
+    if( ( l_iMaxLat - l_iMinLat + 1 ) * ( l_iMaxLon - l_iMinLon + 1 ) > ODBOUNDARY_MAX_EDGE_CELLS ) {
+        m_LargeAreas.push_back( area );
+        return;
+    }
+    for( int ilat = l_iMinLat; ilat <= l_iMaxLat; ilat++ )
+        for( int ilon = l_iMinLon; ilon <= l_iMaxLon; ilon++ )
+            m_AreaCells[ CellKey( ilat, ilon ) ].push_back( area );
+}
+
+void BoundaryMan::AddToEdgeIndex( ODBoundaryGeometry *pGeometry )
+{
+    ODBoundaryEdgeRef l_ref;
+    l_ref.m_pGeometry = pGeometry;
+    for( size_t i = 0; i < pGeometry->m_EdgeBox.size(); i++ ) {
+        ODBoundaryEdgeBox &box = pGeometry->m_EdgeBox[i];
+        l_ref.m_iEdge = i;
+        
+        int l_iMinLat = CellIndex( box.m_dMinLat );
+        int l_iMaxLat = CellIndex( box.m_dMaxLat );
+        int l_iMinLon = CellIndex( box.m_dMinLon );
+        int l_iMaxLon = CellIndex( box.m_dMaxLon );
+        if( ( l_iMaxLat - l_iMinLat + 1 ) * ( l_iMaxLon - l_iMinLon + 1 ) > ODBOUNDARY_MAX_EDGE_CELLS ) {
+            m_LargeEdges.push_back( l_ref );
+            continue;
+        }
+        
+        if( m_iCellMinLat > m_iCellMaxLat ) {
+            m_iCellMinLat = l_iMinLat;
+            m_iCellMaxLat = l_iMaxLat;
+            m_iCellMinLon = l_iMinLon;
+            m_iCellMaxLon = l_iMaxLon;
+        } else {
+            m_iCellMinLat = wxMin( m_iCellMinLat, l_iMinLat );
+            m_iCellMaxLat = wxMax( m_iCellMaxLat, l_iMaxLat );
+            m_iCellMinLon = wxMin( m_iCellMinLon, l_iMinLon );
+            m_iCellMaxLon = wxMax( m_iCellMaxLon, l_iMaxLon );
+        }
+        for( int ilat = l_iMinLat; ilat <= l_iMaxLat; ilat++ )
+            for( int ilon = l_iMinLon; ilon <= l_iMaxLon; ilon++ )
+                m_EdgeCells[ CellKey( ilat, ilon ) ].push_back( l_ref );
+    }
+}
+
+ODBoundaryEdgeRefs *BoundaryMan::FindEdgeCell( int ilat, int ilon )
+{
+    if( ilat < m_iCellMinLat || ilat > m_iCellMaxLat || ilon < m_iCellMinLon || ilon > m_iCellMaxLon ) return NULL;
+    ODBoundaryCellHash::iterator it = m_EdgeCells.find( CellKey( ilat, ilon ) );
+    if( it == m_EdgeCells.end() ) return NULL;
+    return &it->second;
+}
+
+void BoundaryMan::TestNearestEdges( ODBoundaryEdgeRefs *pRefs, double lat, double lon, int type, double *pBest, ODBoundaryEdgeRef *pBestRef )
+{
+    if( !pRefs ) return;
+    
+    double l_dScaleX = m_dCosLat * 60.;
+    for( ODBoundaryEdgeRefs::iterator it = pRefs->begin(); it != pRefs->end(); ++it ) {
+        ODBoundaryGeometry *pGeometry = it->m_pGeometry;
+        int i = it->m_iEdge;
+        //  An edge can sit in several cells, only look at it once per query
+        if( pGeometry->m_iEdgeStamp[i] == m_iQueryStamp ) continue;
+        pGeometry->m_iEdgeStamp[i] = m_iQueryStamp;
+        if( !IsBoundaryType( type, pGeometry->m_pBoundary->m_bExclusionBoundary, pGeometry->m_pBoundary->m_bInclusionBoundary ) ) continue;
+        
+        //  Nothing on the edge is closer than its box
+        ODBoundaryEdgeBox &box = pGeometry->m_EdgeBox[i];
+        double bx = 0.;
+        double by = 0.;
+        if( lon < box.m_dMinLon ) bx = ( box.m_dMinLon - lon ) * l_dScaleX;
+        else if( lon > box.m_dMaxLon ) bx = ( lon - box.m_dMaxLon ) * l_dScaleX;
+        if( lat < box.m_dMinLat ) by = ( box.m_dMinLat - lat ) * 60.;
+        else if( lat > box.m_dMaxLat ) by = ( lat - box.m_dMaxLat ) * 60.;
+        if( bx * bx + by * by >= *pBest * *pBest ) continue;
+        
+        int j = ( i + 1 ) % pGeometry->m_dLat.size();
+        double t;
+        double d = ClosestOnEdge( ( pGeometry->m_dLon[i] - lon ) * l_dScaleX, ( pGeometry->m_dLat[i] - lat ) * 60.,
+                                  ( pGeometry->m_dLon[j] - lon ) * l_dScaleX, ( pGeometry->m_dLat[j] - lat ) * 60., &t );
+        if( d < *pBest ) {
+            *pBest = d;
+            *pBestRef = *it;
+        }
+    }
+}
+
+void BoundaryMan::TestCrossingEdges( ODBoundaryEdgeRefs *pRefs, double lat, double lon, double dx, double dy, int type, double *pBest, ODBoundaryEdgeRef *pBestRef )
+{
+    if( !pRefs ) return;
+    
+    double l_dScaleX = m_dCosLat * 60.;
+    double l_dMinX = wxMin( 0., dx );
+    double l_dMaxX = wxMax( 0., dx );
+    double l_dMinY = wxMin( 0., dy );
+    double l_dMaxY = wxMax( 0., dy );
+    for( ODBoundaryEdgeRefs::iterator it = pRefs->begin(); it != pRefs->end(); ++it ) {
+        ODBoundaryGeometry *pGeometry = it->m_pGeometry;
+        int i = it->m_iEdge;
+        if( pGeometry->m_iEdgeStamp[i] == m_iQueryStamp ) continue;
+        pGeometry->m_iEdgeStamp[i] = m_iQueryStamp;
+        if( !IsBoundaryType( type, pGeometry->m_pBoundary->m_bExclusionBoundary, pGeometry->m_pBoundary->m_bInclusionBoundary ) ) continue;
+        
+        ODBoundaryEdgeBox &box = pGeometry->m_EdgeBox[i];
+        if( ( box.m_dMaxLon - lon ) * l_dScaleX < l_dMinX || ( box.m_dMinLon - lon ) * l_dScaleX > l_dMaxX ||
+            ( box.m_dMaxLat - lat ) * 60. < l_dMinY || ( box.m_dMinLat - lat ) * 60. > l_dMaxY )
+            continue;
+        
+        //  Solve s * d = a + u * ( b - a ), s is how far along the run the edge is crossed
+        int j = ( i + 1 ) % pGeometry->m_dLat.size();
+        double ax = ( pGeometry->m_dLon[i] - lon ) * l_dScaleX;
+        double ay = ( pGeometry->m_dLat[i] - lat ) * 60.;
+        double ex = ( pGeometry->m_dLon[j] - lon ) * l_dScaleX - ax;
+        double ey = ( pGeometry->m_dLat[j] - lat ) * 60. - ay;
+        double l_dDenom = dx * ey - dy * ex;
+        if( fabs( l_dDenom ) < 1e-12 ) continue;
+        double l_dS = ( ax * ey - ay * ex ) / l_dDenom;
+        double l_dU = ( ax * dy - ay * dx ) / l_dDenom;
+        if( l_dS < 0. || l_dS > *pBest || l_dU < 0. || l_dU > 1. ) continue;
+        
+        *pBest = l_dS;
+        *pBestRef = *it;
+    }
+}
+
+bool BoundaryMan::FindNearestBoundaryEdge( double lat, double lon, int type, ODBoundaryHit *pHit )
+{
+    pHit->m_pBoundary = NULL;
+    if( !ValidateEdgeIndex() ) return false;
+    
+    m_iQueryStamp++;
+    m_dCosLat = cos( lat * M_PI / 180. );
+    double l_dBest = 1e30;
+    ODBoundaryEdgeRef l_BestRef;
+    l_BestRef.m_pGeometry = NULL;
+    
+    TestNearestEdges( &m_LargeEdges, lat, lon, type, &l_dBest, &l_BestRef );
+    
+    //  Search rings of cells outwards from the position's cell until no unseen cell can be closer
+    if( m_iCellMinLat <= m_iCellMaxLat ) {
+        int l_iLat = CellIndex( lat );
+        int l_iLon = CellIndex( lon );
+        int l_iMaxRing = wxMax( wxMax( abs( l_iLat - m_iCellMinLat ), abs( m_iCellMaxLat - l_iLat ) ),
+                                wxMax( abs( l_iLon - m_iCellMinLon ), abs( m_iCellMaxLon - l_iLon ) ) );
+        for( int r = 0; r <= l_iMaxRing; r++ ) {
+            if( r > 1 && l_dBest <= ( r - 1 ) * ODBOUNDARY_CELL_SIZE * 60. * m_dCosLat ) break;
+            
+            for( int ilat = wxMax( l_iLat - r, m_iCellMinLat ); ilat <= wxMin( l_iLat + r, m_iCellMaxLat ); ilat++ ) {
+                if( ilat == l_iLat - r || ilat == l_iLat + r ) {
+                    for( int ilon = wxMax( l_iLon - r, m_iCellMinLon ); ilon <= wxMin( l_iLon + r, m_iCellMaxLon ); ilon++ )
+                        TestNearestEdges( FindEdgeCell( ilat, ilon ), lat, lon, type, &l_dBest, &l_BestRef );
+                } else {
+                    TestNearestEdges( FindEdgeCell( ilat, l_iLon - r ), lat, lon, type, &l_dBest, &l_BestRef );
+                    TestNearestEdges( FindEdgeCell( ilat, l_iLon + r ), lat, lon, type, &l_dBest, &l_BestRef );
+                }
+            }
+        }
+    }
+    if( !l_BestRef.m_pGeometry ) return false;
+    
+    ODBoundaryGeometry *pGeometry = l_BestRef.m_pGeometry;
+    int i = l_BestRef.m_iEdge;
+    int j = ( i + 1 ) % pGeometry->m_dLat.size();
+    double t;
+    ClosestOnEdge( ( pGeometry->m_dLon[i] - lon ) * m_dCosLat * 60., ( pGeometry->m_dLat[i] - lat ) * 60.,
+                   ( pGeometry->m_dLon[j] - lon ) * m_dCosLat * 60., ( pGeometry->m_dLat[j] - lat ) * 60., &t );
+    
+    pHit->m_pBoundary = pGeometry->m_pBoundary;
+    pHit->m_dLat = pGeometry->m_dLat[i] + t * ( pGeometry->m_dLat[j] - pGeometry->m_dLat[i] );
+    pHit->m_dLon = pGeometry->m_dLon[i] + t * ( pGeometry->m_dLon[j] - pGeometry->m_dLon[i] );
+    DistanceBearingMercator_Plugin( pHit->m_dLat, pHit->m_dLon, lat, lon, &pHit->m_dBearing, &pHit->m_dDistance );
+    pHit->m_dTime = 0.;
+    pHit->m_bInside = pGeometry->Contains( lat, lon );
+    return true;
+}
+
+bool BoundaryMan::FindBoundaryCrossing( double lat, double lon, double cog, double sog, double hours, int type, ODBoundaryHit *pHit )
+{
+    pHit->m_pBoundary = NULL;
+    if( sog <= 0. || hours <= 0. ) return false;
+    if( !ValidateEdgeIndex() ) return false;
+    
+    m_iQueryStamp++;
+    m_dCosLat = cos( lat * M_PI / 180. );
+    double l_dRun = sog * hours;
+    double l_dX = l_dRun * sin( cog * M_PI / 180. );
+    double l_dY = l_dRun * cos( cog * M_PI / 180. );
+    double l_dLatStep = l_dY / 60.;
+    double l_dLonStep = l_dX / ( m_dCosLat * 60. );
+    
+    //  l_dBest is the fraction of the run at the first crossing found so far
+    double l_dBest = 1.;
+    ODBoundaryEdgeRef l_BestRef;
+    l_BestRef.m_pGeometry = NULL;
+    
+    TestCrossingEdges( &m_LargeEdges, lat, lon, l_dX, l_dY, type, &l_dBest, &l_BestRef );
+    
+    //  Walk the cells under the run in order, a crossing inside the current cell ends the walk
+    int l_iLat = CellIndex( lat );
+    int l_iLon = CellIndex( lon );
+    int l_iStepLat = l_dLatStep > 0. ? 1 : -1;
+    int l_iStepLon = l_dLonStep > 0. ? 1 : -1;
+    double l_dNextLat = 1e30;
+    double l_dNextLon = 1e30;
+    double l_dDeltaLat = 1e30;
+    double l_dDeltaLon = 1e30;
+    if( l_dLatStep != 0. ) {
+        l_dNextLat = ( ( l_iLat + ( l_iStepLat > 0 ? 1 : 0 ) ) * ODBOUNDARY_CELL_SIZE - lat ) / l_dLatStep;
+        l_dDeltaLat = ODBOUNDARY_CELL_SIZE / fabs( l_dLatStep );
+    }
+    if( l_dLonStep != 0. ) {
+        l_dNextLon = ( ( l_iLon + ( l_iStepLon > 0 ? 1 : 0 ) ) * ODBOUNDARY_CELL_SIZE - lon ) / l_dLonStep;
+        l_dDeltaLon = ODBOUNDARY_CELL_SIZE / fabs( l_dLonStep );
+    }
+    int l_iCells = abs( CellIndex( lat + l_dLatStep ) - l_iLat ) + abs( CellIndex( lon + l_dLonStep ) - l_iLon ) + 1;
+    for( int c = 0; c < l_iCells; c++ ) {
+        TestCrossingEdges( FindEdgeCell( l_iLat, l_iLon ), lat, lon, l_dX, l_dY, type, &l_dBest, &l_BestRef );
+        if( l_BestRef.m_pGeometry && l_dBest <= wxMin( l_dNextLat, l_dNextLon ) ) break;
+        if( l_dNextLat < l_dNextLon ) {
+            l_dNextLat += l_dDeltaLat;
+            l_iLat += l_iStepLat;
+        } else {
+            l_dNextLon += l_dDeltaLon;
+            l_iLon += l_iStepLon;
+        }
+    }
+    if( !l_BestRef.m_pGeometry ) return false;
+    
+    pHit->m_pBoundary = l_BestRef.m_pGeometry->m_pBoundary;
+    pHit->m_dLat = lat + l_dBest * l_dLatStep;
+    pHit->m_dLon = lon + l_dBest * l_dLonStep;
+    pHit->m_dDistance = l_dBest * l_dRun;
+    pHit->m_dBearing = cog;
+    pHit->m_dTime = l_dBest * hours;
+    pHit->m_bInside = l_BestRef.m_pGeometry->Contains( lat, lon );
+    return true;
+}
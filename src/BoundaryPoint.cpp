@@ -29,6 +29,7 @@
 
 
 #include "BoundaryPoint.h"
+#include "ODProjection.h"
 #include "georef.h"
 #include "ODdc.h"
 #include "ocpn_draw_pi.h"
@@ -75,7 +76,7 @@ BoundaryPoint::BoundaryPoint() : ODPoint()
 void BoundaryPoint::Draw(ODDC& dc, wxPoint* rpn)
 {
     wxPoint r;
-    GetCanvasPixLL( g_pivp, &r,  m_lat, m_lon);
+    ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( m_lat, m_lon, &r );
     
     double factor = 1.00;
     if( m_iODPointRangeRingsStepUnits == 1 )          // nautical miles
@@ -87,7 +88,7 @@ void BoundaryPoint::Draw(ODDC& dc, wxPoint* rpn)
     wxPoint r1;
     ll_gc_ll( m_lat, m_lon, 0, factor, &tlat, &tlon );
     //cc1->GetCanvasPointPix( tlat, tlon, &r1 );
-    GetCanvasPixLL( g_pivp, &r1,  tlat, tlon);
+    ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( tlat, tlon, &r1 );
     
     double lpp = sqrt( pow( (double) (r.x - r1.x), 2) +
     pow( (double) (r.y - r1.y), 2 ) );
@@ -121,7 +122,7 @@ void BoundaryPoint::DrawGL(PlugIn_ViewPort& pivp)
     ODDC dc;
     
     wxPoint r;
-    GetCanvasPixLL( g_pivp, &r,  m_lat, m_lon);
+    ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( m_lat, m_lon, &r );
     
     double factor = 1.00;
     if( m_iODPointRangeRingsStepUnits == 1 )          // nautical miles
@@ -133,7 +134,7 @@ void BoundaryPoint::DrawGL(PlugIn_ViewPort& pivp)
     wxPoint r1;
     ll_gc_ll( m_lat, m_lon, 0, factor, &tlat, &tlon );
     //cc1->GetCanvasPointPix( tlat, tlon, &r1 );
-    GetCanvasPixLL( g_pivp, &r1,  tlat, tlon);
+    ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( tlat, tlon, &r1 );
     
     double lpp = sqrt( pow( (double) (r.x - r1.x), 2) +
     pow( (double) (r.y - r1.y), 2 ) );
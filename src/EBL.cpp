@@ -214,7 +214,6 @@ void EBL::RemovePoint( ODPoint *op, bool bRenamePoints )
     g_pODSelect->DeleteAllSelectablePathSegments( this );
     
     m_pODPointList->DeleteObject( op );
-    if( wxNOT_FOUND != ODPointGUIDList.Index( op->m_GUID ) ) ODPointGUIDList.Remove( op->m_GUID );
     
     // check all other routes to see if this point appears in any other route
     ODPath *pcontainer_path = g_pPathMan->FindPathContainingODPoint( op );
@@ -228,8 +227,11 @@ void EBL::RemovePoint( ODPoint *op, bool bRenamePoints )
         this->DeletePoint( op );
         if(op == g_ocpn_draw_pi->m_pEBLBoatPoint) g_ocpn_draw_pi->m_pEBLBoatPoint = NULL;
         RebuildGUIDList();
-    } else
+    } else {
+        // DeletePoint does this for the other branch
+        UnindexPointGUID( op );
         m_nPoints -= 1;
+    }
     
     
 }
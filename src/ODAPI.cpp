@@ -0,0 +1,583 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw plugin message API
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODAPI.h"
+#include "ocpn_draw_pi.h"
+#include "Boundary.h"
+#include "BoundaryMan.h"
+#include "BoundaryPoint.h"
+#include "PathMan.h"
+#include "PointMan.h"
+#include "ODStats.h"
+#include "version.h"
+
+extern PathMan          *g_pPathMan;
+extern BoundaryMan      *g_pBoundaryMan;
+extern PointMan         *g_pODPointMan;
+extern ODStats          *g_pODStats;
+
+static const char *BoundaryTypeName( bool exclusion, bool inclusion )
+{
+    if( exclusion && !inclusion ) return "Exclusion";
+    if( !exclusion && inclusion ) return "Inclusion";
+    if( !exclusion && !inclusion ) return "Neither";
+    return "Unknown";
+}
+
+static int BoundaryTypeId( ODJSONReader &reader )
+{
+    if( reader.IsString( "BoundaryType", "Exclusion" ) ) return ID_BOUNDARY_EXCLUSION;
+    if( reader.IsString( "BoundaryType", "Inclusion" ) ) return ID_BOUNDARY_INCLUSION;
+    if( reader.IsString( "BoundaryType", "Neither" ) ) return ID_BOUNDARY_NIETHER;
+    return ID_BOUNDARY_ANY;
+}
+
+ODAPI::ODAPI()
+{
+    RegisterHandler( wxS("Version"), &ODAPI::Version );
+    RegisterHandler( wxS("FindPathByGUID"), &ODAPI::FindPathByGUID );
+    RegisterHandler( wxS("FindPositionAlongPath"), &ODAPI::FindPositionAlongPath );
+    RegisterHandler( wxS("FindPointInAnyBoundary"), &ODAPI::FindPointInAnyBoundary );
+    RegisterHandler( wxS("FindPointInBoundary"), &ODAPI::FindPointInBoundary );
+    RegisterHandler( wxS("FindPointInGuardZone"), &ODAPI::FindPointInGuardZone );
+    RegisterHandler( wxS("SubscribeBoundaryEvents"), &ODAPI::SubscribeBoundaryEvents );
+    RegisterHandler( wxS("UpdateTrackedPositions"), &ODAPI::UpdateTrackedPositions );
+    RegisterHandler( wxS("FindNearestBoundary"), &ODAPI::FindNearestBoundary );
+    RegisterHandler( wxS("FindBoundaryCrossing"), &ODAPI::FindBoundaryCrossing );
+    RegisterHandler( wxS("Stats"), &ODAPI::Stats );
+}
+
+ODAPI::~ODAPI()
+{
+    m_Handlers.clear();
+}
+
+void ODAPI::RegisterHandler( const wxString &msg, ODAPIHandler handler )
+{
+    m_Handlers[ msg ] = handler;
+}
+
+bool ODAPI::RequireMember( const char *key, const wxChar *what )
+{
+    if( m_reader.HasMember( key ) ) return true;
+
+    wxString l_msg;
+    l_msg.Printf( wxS("No %s found in message"), what );
+    wxLogMessage( l_msg );
+    return false;
+}
+
+bool ODAPI::ProcessMessage( const wxString &message_body )
+{
+    if( !m_reader.Parse( message_body ) ) {
+        wxString sLogMessage;
+        sLogMessage.Append( wxT("ocpn_draw_pi: Error parsing JSON message - OCPN_DRAW_PI ") );
+        sLogMessage.Append( m_reader.GetError() );
+        wxLogMessage( sLogMessage );
+        return false;
+    }
+
+    bool bFail = false;
+    if( !RequireMember( "Source", wxS("Source") ) ) bFail = true;      // Originator
+    if( !RequireMember( "Msg", wxS("Msg") ) ) bFail = true;            // Message identifier
+    if( !RequireMember( "Type", wxS("Type") ) ) bFail = true;          // Message type, orig or resp
+    if( !RequireMember( "MsgId", wxS("MsgId") ) ) bFail = true;        // Unique (?) Msg number
+    if( bFail ) return false;
+
+    m_reader.GetString( "Msg", &m_sMsg );
+    ODAPIHandlerHash::iterator it = m_Handlers.find( m_sMsg );
+    if( it == m_Handlers.end() ) return false;
+
+    m_reader.GetString( "Source", &m_sSource );
+    m_reader.GetString( "MsgId", &m_sMsgId );
+    return ( this->*( it->second ) )();
+}
+
+void ODAPI::BeginResponse( void )
+{
+    m_writer.Begin();
+    m_writer.AddString( "Source", "OCPN_DRAW_PI" );
+    m_writer.AddString( "Msg", m_sMsg );
+    m_writer.AddString( "Type", "Response" );
+    m_writer.AddString( "MsgId", m_sMsgId );
+}
+
+void ODAPI::SendResponse( void )
+{
+    SendPluginMessage( m_sSource, m_writer.End() );
+}
+
+bool ODAPI::Version( void )
+{
+    BeginResponse();
+    m_writer.AddInt( "Major", PLUGIN_VERSION_MAJOR );
+    m_writer.AddInt( "Minor", PLUGIN_VERSION_MINOR );
+    m_writer.AddInt( "Patch", PLUGIN_VERSION_PATCH );
+    m_writer.AddString( "Date", PLUGIN_VERSION_DATE );
+    SendResponse();
+    return true;
+}
+
+bool ODAPI::FindPathByGUID( void )
+{
+    if( !RequireMember( "GUID", wxS("GUID") ) ) return false;
+    if( !IsRequest() ) return false;
+
+    m_reader.GetString( "GUID", &m_sGUID );
+    ODPath *l_path = g_pPathMan->FindPathByGUID( m_sGUID );
+
+    BeginResponse();
+    if( !l_path ) {
+        wxString l_msg;
+        l_msg.append( wxS("Path, with GUID: ") );
+        l_msg.append( m_sGUID );
+        l_msg.append( wxS(", not found") );
+        wxLogMessage( l_msg );
+        m_writer.AddBool( "Found", false );
+        m_writer.AddString( "GUID", m_sGUID );
+    } else {
+        m_writer.AddBool( "Found", true );
+        m_writer.AddString( "GUID", m_sGUID );
+        m_writer.AddString( "Name", l_path->m_PathNameString );
+        m_writer.AddString( "Description", l_path->m_PathDescription );
+    }
+    SendResponse();
+    return true;
+}
+
+//  Request members: GUID of the path and Distance from its first point in NMi
+bool ODAPI::FindPositionAlongPath( void )
+{
+    bool bFail = false;
+    if( !RequireMember( "GUID", wxS("GUID") ) ) bFail = true;
+    if( !RequireMember( "Distance", wxS("Distance") ) ) bFail = true;
+    if( bFail ) return false;
+    if( !IsRequest() ) return false;
+
+    double l_dDistance = 0.;
+    m_reader.GetString( "GUID", &m_sGUID );
+    m_reader.GetDouble( "Distance", &l_dDistance );
+    ODPath *l_path = g_pPathMan->FindPathByGUID( m_sGUID );
+
+    BeginResponse();
+    m_writer.AddString( "GUID", m_sGUID );
+    m_writer.AddDouble( "Distance", l_dDistance );
+    double l_dLat, l_dLon;
+    if( !l_path || !l_path->GetPositionAtDistance( l_dDistance, &l_dLat, &l_dLon ) ) {
+        m_writer.AddBool( "Found", false );
+    } else {
+        m_writer.AddBool( "Found", true );
+        m_writer.AddDouble( "Length", l_path->m_path_length );
+        m_writer.AddDouble( "lat", l_dLat );
+        m_writer.AddDouble( "lon", l_dLon );
+    }
+    SendResponse();
+    return true;
+}
+
+bool ODAPI::FindPointInAnyBoundary( void )
+{
+    bool bFail = false;
+    if( !RequireMember( "lat", wxS("Latitude") ) ) bFail = true;
+    if( !RequireMember( "lon", wxS("Longitude") ) ) bFail = true;
+    if( !RequireMember( "BoundaryType", wxS("Boundary Type") ) ) bFail = true;
+    if( bFail ) return false;
+
+    double l_dLat = 0.;
+    double l_dLon = 0.;
+    m_reader.GetDouble( "lat", &l_dLat );
+    m_reader.GetDouble( "lon", &l_dLon );
+
+    int l_BoundaryType = BoundaryTypeId( m_reader );
+
+    if( !IsRequest() ) return false;
+
+    bool l_bFoundBoundary = false;
+    bool l_bFoundBoundaryPoint = false;
+    m_sGUID = g_pBoundaryMan->FindPointInBoundary( l_dLat, l_dLon, l_BoundaryType );
+    if( m_sGUID.length() > 0 )
+        l_bFoundBoundary = true;
+    else {
+        m_sGUID = g_pBoundaryMan->FindPointInBoundaryPoint( l_dLat, l_dLon, l_BoundaryType );
+        if( m_sGUID.length() > 0 )
+            l_bFoundBoundaryPoint = true;
+    }
+
+    BeginResponse();
+    m_writer.AddString( "GUID", m_sGUID );
+    m_writer.AddDouble( "lat", l_dLat );
+    m_writer.AddDouble( "lon", l_dLon );
+    if( l_bFoundBoundary ) {
+        Boundary *l_boundary = (Boundary *)g_pBoundaryMan->FindPathByGUID( m_sGUID );
+        m_writer.AddString( "Name", l_boundary->m_PathNameString );
+        m_writer.AddString( "Description", l_boundary->m_PathDescription );
+        m_writer.AddBool( "Found", true );
+        m_writer.AddString( "BoundaryObjectType", "Boundary" );
+        m_writer.AddString( "BoundaryType", BoundaryTypeName( l_boundary->m_bExclusionBoundary, l_boundary->m_bInclusionBoundary ) );
+    } else if( l_bFoundBoundaryPoint ) {
+        BoundaryPoint *l_boundarypoint = (BoundaryPoint *)g_pODPointMan->FindODPointByGUID( m_sGUID );
+        m_writer.AddBool( "Found", true );
+        m_writer.AddString( "Name", l_boundarypoint->m_ODPointName );
+        m_writer.AddString( "Description", l_boundarypoint->m_ODPointDescription );
+        m_writer.AddString( "BoundaryObjectType", "Boundary Point" );
+        m_writer.AddString( "BoundaryType", BoundaryTypeName( l_boundarypoint->m_bExclusionBoundaryPoint, l_boundarypoint->m_bInclusionBoundaryPoint ) );
+    } else
+        m_writer.AddBool( "Found", false );
+    SendResponse();
+    return true;
+}
+
+bool ODAPI::FindPointInBoundary( void )
+{
+    bool bFail = false;
+    if( !RequireMember( "GUID", wxS("GUID") ) ) bFail = true;
+    if( !RequireMember( "lat", wxS("Latitude") ) ) bFail = true;
+    if( !RequireMember( "lon", wxS("Longitude") ) ) bFail = true;
+    if( bFail ) return false;
+    if( !IsRequest() ) return false;
+
+    double l_dLat = 0.;
+    double l_dLon = 0.;
+    m_reader.GetString( "GUID", &m_sGUID );
+    m_reader.GetDouble( "lat", &l_dLat );
+    m_reader.GetDouble( "lon", &l_dLon );
+
+    Boundary *l_boundary = (Boundary *)g_pBoundaryMan->FindPathByGUID( m_sGUID );
+    BoundaryPoint *l_boundarypoint = NULL;
+    if( !l_boundary ) l_boundarypoint = (BoundaryPoint *)g_pODPointMan->FindODPointByGUID( m_sGUID );
+
+    BeginResponse();
+    if( !l_boundary && !l_boundarypoint ) {
+        wxString l_msg;
+        l_msg.append( wxS("Boundary, with GUID: ") );
+        l_msg.append( m_sGUID );
+        l_msg.append( wxS(", not found") );
+        wxLogMessage( l_msg );
+        m_writer.AddBool( "Found", false );
+        m_writer.AddDouble( "lat", l_dLat );
+        m_writer.AddDouble( "lon", l_dLon );
+        m_writer.AddString( "GUID", m_sGUID );
+        SendResponse();
+        return true;
+    }
+
+    bool l_bFound = false;
+    if( l_boundary ) l_bFound = g_pBoundaryMan->FindPointInBoundary( l_boundary, l_dLat, l_dLon );
+    else l_bFound = g_pBoundaryMan->FindPointInBoundaryPoint( l_boundarypoint, l_dLat, l_dLon );
+
+    m_writer.AddBool( "Found", l_bFound );
+    m_writer.AddDouble( "lat", l_dLat );
+    m_writer.AddDouble( "lon", l_dLon );
+    m_writer.AddString( "GUID", m_sGUID );
+    if( l_boundary ) {
+        m_writer.AddString( "BoundaryObjectType", "Boundary" );
+        m_writer.AddString( "BoundaryType", BoundaryTypeName( l_boundary->m_bExclusionBoundary, l_boundary->m_bInclusionBoundary ) );
+    } else {
+        m_writer.AddString( "BoundaryObjectType", "Boundary Point" );
+        m_writer.AddString( "BoundaryType", BoundaryTypeName( l_boundarypoint->m_bExclusionBoundaryPoint, l_boundarypoint->m_bInclusionBoundaryPoint ) );
+    }
+    SendResponse();
+    return true;
+}
+
+bool ODAPI::FindPointInGuardZone( void )
+{
+    bool bFail = false;
+    if( !RequireMember( "GUID", wxS("GUID") ) ) bFail = true;
+    if( !RequireMember( "lat", wxS("Latitude") ) ) bFail = true;
+    if( !RequireMember( "lon", wxS("Longitude") ) ) bFail = true;
+    if( bFail ) return false;
+    if( !IsRequest() ) return false;
+
+    // lat and lon may arrive as strings or numbers
+    double l_dLat = 0.;
+    double l_dLon = 0.;
+    m_reader.GetString( "GUID", &m_sGUID );
+    m_reader.GetDouble( "lat", &l_dLat );
+    m_reader.GetDouble( "lon", &l_dLon );
+
+    Boundary *l_boundary = (Boundary *)g_pBoundaryMan->FindPathByGUID( m_sGUID );
+    BoundaryPoint *l_boundarypoint = NULL;
+    if( !l_boundary ) l_boundarypoint = (BoundaryPoint *)g_pODPointMan->FindODPointByGUID( m_sGUID );
+
+    BeginResponse();
+    if( !l_boundary && !l_boundarypoint ) {
+        wxString l_msg;
+        l_msg.append( wxS("Guard Zone, with GUID: ") );
+        l_msg.append( m_sGUID );
+        l_msg.append( wxS(", not found") );
+        wxLogMessage( l_msg );
+        m_writer.AddBool( "Found", false );
+        m_writer.AddDouble( "lat", l_dLat );
+        m_writer.AddDouble( "lon", l_dLon );
+        m_writer.AddString( "GUID", m_sGUID );
+        SendResponse();
+        return true;
+    }
+
+    bool l_bFound = false;
+    if( l_boundary ) l_bFound = g_pBoundaryMan->FindPointInBoundary( l_boundary, l_dLat, l_dLon );
+    else l_bFound = g_pBoundaryMan->FindPointInBoundaryPoint( l_boundarypoint, l_dLat, l_dLon );
+
+    m_writer.AddBool( "Found", l_bFound );
+    m_writer.AddDouble( "lat", l_dLat );
+    m_writer.AddDouble( "lon", l_dLon );
+    if( l_boundary ) {
+        m_writer.AddString( "Name", l_boundary->m_PathNameString );
+        m_writer.AddString( "Description", l_boundary->m_PathDescription );
+    } else {
+        m_writer.AddString( "Name", l_boundarypoint->m_ODPointName );
+        m_writer.AddString( "Description", l_boundarypoint->m_ODPointDescription );
+    }
+    m_writer.AddString( "GUID", m_sGUID );
+    SendResponse();
+    return true;
+}
+
+//  Request members: BoundaryType (optional, default Any), Subscribe (optional, false to stop)
+bool ODAPI::SubscribeBoundaryEvents( void )
+{
+    if( !IsRequest() ) return false;
+
+    bool l_bSubscribe = true;
+    m_reader.GetBool( "Subscribe", &l_bSubscribe );
+    if( l_bSubscribe )
+        g_pBoundaryMan->SubscribeBoundaryEvents( m_sSource, BoundaryTypeId( m_reader ) );
+    else
+        g_pBoundaryMan->UnsubscribeBoundaryEvents( m_sSource );
+
+    BeginResponse();
+    m_writer.AddBool( "Subscribed", l_bSubscribe );
+    SendResponse();
+    return true;
+}
+
+//  Request members: Targets, an array of { Id, lat, lon } with Remove: true to stop tracking
+//  an Id. Nothing is sent back apart from BoundaryEvent messages for the changes found.
+bool ODAPI::UpdateTrackedPositions( void )
+{
+    if( !RequireMember( "Targets", wxS("Targets") ) ) return false;
+    if( !IsRequest() ) return false;
+    if( !g_pBoundaryMan->IsSubscribed( m_sSource ) ) {
+        wxLogMessage( wxS("UpdateTrackedPositions from ") + m_sSource + wxS(" without SubscribeBoundaryEvents") );
+        return false;
+    }
+
+    //  The events go out below, a subscriber handling one may send us another
+    //  message, so nothing shared is used once the request has been read
+    wxString l_sSource = m_sSource;
+    wxString l_sId;
+    ODJSONReader l_element;
+    size_t l_cursor = 0;
+    while( m_reader.GetNextArrayObject( "Targets", &l_cursor, &l_element ) ) {
+        if( !l_element.GetString( "Id", &l_sId ) ) continue;
+
+        bool l_bRemove = false;
+        l_element.GetBool( "Remove", &l_bRemove );
+        if( l_bRemove ) {
+            g_pBoundaryMan->RemoveTrackedTarget( l_sSource, l_sId );
+            continue;
+        }
+
+        double l_dLat, l_dLon;
+        if( !l_element.GetDouble( "lat", &l_dLat ) || !l_element.GetDouble( "lon", &l_dLon ) ) continue;
+        g_pBoundaryMan->UpdateTrackedPosition( l_sSource, l_sId, l_dLat, l_dLon );
+    }
+
+    g_pBoundaryMan->SendBoundaryEvents();
+    return true;
+}
+
+void ODAPI::SendBoundaryEvent( const ODBoundaryEvent &event )
+{
+    //  Local, so a message sent back while this one is handled cannot change it
+    ODJSONWriter l_writer;
+    l_writer.Begin();
+    l_writer.AddString( "Source", "OCPN_DRAW_PI" );
+    l_writer.AddString( "Msg", "BoundaryEvent" );
+    l_writer.AddString( "Type", "Event" );
+    l_writer.AddString( "Event", event.m_bEntered ? "Entered" : "Exited" );
+    l_writer.AddString( "Id", event.m_sId );
+    l_writer.AddDouble( "lat", event.m_dLat );
+    l_writer.AddDouble( "lon", event.m_dLon );
+    l_writer.AddString( "GUID", event.m_sGUID );
+    l_writer.AddString( "Name", event.m_sName );
+    l_writer.AddString( "BoundaryObjectType", event.m_bBoundaryPoint ? "Boundary Point" : "Boundary" );
+    l_writer.AddString( "BoundaryType", BoundaryTypeName( event.m_bExclusion, event.m_bInclusion ) );
+    SendPluginMessage( event.m_sSubscriber, l_writer.End() );
+}
+
+//  Request members: lat, lon and BoundaryType (optional, default Any). For a batch send
+//  Positions, an array of { Id, lat, lon }, and the answers come back in Results.
+bool ODAPI::FindNearestBoundary( void )
+{
+    if( !IsRequest() ) return false;
+    int l_BoundaryType = BoundaryTypeId( m_reader );
+
+    if( m_reader.HasMember( "Positions" ) ) {
+        BeginResponse();
+        m_writer.BeginArray( "Results" );
+        size_t l_cursor = 0;
+        while( m_reader.GetNextArrayObject( "Positions", &l_cursor, &m_element ) ) {
+            m_writer.BeginObject();
+            AddNearestBoundary( m_element, l_BoundaryType );
+            m_writer.EndObject();
+        }
+        m_writer.EndArray();
+        SendResponse();
+        return true;
+    }
+
+    bool bFail = false;
+    if( !RequireMember( "lat", wxS("Latitude") ) ) bFail = true;
+    if( !RequireMember( "lon", wxS("Longitude") ) ) bFail = true;
+    if( bFail ) return false;
+
+    BeginResponse();
+    AddNearestBoundary( m_reader, l_BoundaryType );
+    SendResponse();
+    return true;
+}
+
+//  Request members: lat, lon, COG, SOG (knots), MaxTime (optional, hours, default 1) and
+//  BoundaryType (optional, default Any), or a Positions array of objects with the same members
+bool ODAPI::FindBoundaryCrossing( void )
+{
+    if( !IsRequest() ) return false;
+    int l_BoundaryType = BoundaryTypeId( m_reader );
+
+    if( m_reader.HasMember( "Positions" ) ) {
+        BeginResponse();
+        m_writer.BeginArray( "Results" );
+        size_t l_cursor = 0;
+        while( m_reader.GetNextArrayObject( "Positions", &l_cursor, &m_element ) ) {
+            m_writer.BeginObject();
+            AddBoundaryCrossing( m_element, l_BoundaryType );
+            m_writer.EndObject();
+        }
+        m_writer.EndArray();
+        SendResponse();
+        return true;
+    }
+
+    bool bFail = false;
+    if( !RequireMember( "lat", wxS("Latitude") ) ) bFail = true;
+    if( !RequireMember( "lon", wxS("Longitude") ) ) bFail = true;
+    if( !RequireMember( "COG", wxS("COG") ) ) bFail = true;
+    if( !RequireMember( "SOG", wxS("SOG") ) ) bFail = true;
+    if( bFail ) return false;
+
+    BeginResponse();
+    AddBoundaryCrossing( m_reader, l_BoundaryType );
+    SendResponse();
+    return true;
+}
+
+void ODAPI::AddNearestBoundary( ODJSONReader &position, int type )
+{
+    double l_dLat = 0.;
+    double l_dLon = 0.;
+    if( position.GetString( "Id", &m_sId ) ) m_writer.AddString( "Id", m_sId );
+    if( !position.GetDouble( "lat", &l_dLat ) || !position.GetDouble( "lon", &l_dLon ) ) {
+        m_writer.AddBool( "Found", false );
+        return;
+    }
+    m_writer.AddDouble( "lat", l_dLat );
+    m_writer.AddDouble( "lon", l_dLon );
+
+    ODBoundaryHit l_hit;
+    if( !g_pBoundaryMan->FindNearestBoundaryEdge( l_dLat, l_dLon, type, &l_hit ) ) {
+        m_writer.AddBool( "Found", false );
+        return;
+    }
+    AddBoundaryHit( l_hit );
+    m_writer.AddDouble( "Distance", l_hit.m_dDistance );
+    m_writer.AddDouble( "Bearing", l_hit.m_dBearing );
+    m_writer.AddDouble( "EdgeLat", l_hit.m_dLat );
+    m_writer.AddDouble( "EdgeLon", l_hit.m_dLon );
+}
+
+void ODAPI::AddBoundaryCrossing( ODJSONReader &position, int type )
+{
+    double l_dLat = 0.;
+    double l_dLon = 0.;
+    double l_dCOG = 0.;
+    double l_dSOG = 0.;
+    double l_dMaxTime = 1.;
+    if( position.GetString( "Id", &m_sId ) ) m_writer.AddString( "Id", m_sId );
+    if( !position.GetDouble( "lat", &l_dLat ) || !position.GetDouble( "lon", &l_dLon ) ||
+        !position.GetDouble( "COG", &l_dCOG ) || !position.GetDouble( "SOG", &l_dSOG ) ) {
+        m_writer.AddBool( "Found", false );
+        return;
+    }
+    position.GetDouble( "MaxTime", &l_dMaxTime );
+    m_writer.AddDouble( "lat", l_dLat );
+    m_writer.AddDouble( "lon", l_dLon );
+
+    ODBoundaryHit l_hit;
+    if( !g_pBoundaryMan->FindBoundaryCrossing( l_dLat, l_dLon, l_dCOG, l_dSOG, l_dMaxTime, type, &l_hit ) ) {
+        m_writer.AddBool( "Found", false );
+        return;
+    }
+    AddBoundaryHit( l_hit );
+    m_writer.AddDouble( "Distance", l_hit.m_dDistance );
+    m_writer.AddDouble( "Time", l_hit.m_dTime );
+    m_writer.AddDouble( "CrossingLat", l_hit.m_dLat );
+    m_writer.AddDouble( "CrossingLon", l_hit.m_dLon );
+}
+
+void ODAPI::AddBoundaryHit( const ODBoundaryHit &hit )
+{
+    m_writer.AddBool( "Found", true );
+    m_writer.AddString( "GUID", hit.m_pBoundary->m_GUID );
+    m_writer.AddString( "Name", hit.m_pBoundary->m_PathNameString );
+    m_writer.AddString( "BoundaryType", BoundaryTypeName( hit.m_pBoundary->m_bExclusionBoundary, hit.m_pBoundary->m_bInclusionBoundary ) );
+    m_writer.AddBool( "Inside", hit.m_bInside );
+}
+
+//  Request members, all optional: Enable, Reset and LogInterval (seconds, 0 for none).
+//  Settings are applied before the response, Reset after it.
+bool ODAPI::Stats( void )
+{
+    if( !IsRequest() ) return false;
+
+    bool l_bFlag;
+    int l_iInterval;
+    if( m_reader.GetBool( "Enable", &l_bFlag ) ) g_pODStats->Enable( l_bFlag );
+    if( m_reader.GetInt( "LogInterval", &l_iInterval ) ) g_pODStats->SetLogInterval( l_iInterval );
+
+    BeginResponse();
+    g_pODStats->Write( m_writer );
+    SendResponse();
+
+    if( m_reader.GetBool( "Reset", &l_bFlag ) && l_bFlag ) g_pODStats->Reset();
+    return true;
+}
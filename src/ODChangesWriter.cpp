@@ -0,0 +1,292 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw changes file writer thread
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODChangesWriter.h"
+#include "ODStats.h"
+
+#include <wx/filefn.h>
+
+#ifdef __WXMSW__
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+class ODChangesWriterThread : public wxThread
+{
+public:
+    ODChangesWriterThread( ODChangesWriter *pWriter ) : wxThread( wxTHREAD_JOINABLE ) { m_pWriter = pWriter; }
+    
+    virtual ExitCode Entry()
+    {
+        m_pWriter->Run();
+        return 0;
+    }
+    
+    ODChangesWriter *m_pWriter;
+};
+
+ODChangesWriter::ODChangesWriter( const wxString &filename ) : m_condWork( m_mutex ), m_condIdle( m_mutex )
+{
+    m_sFilename = filename;
+    m_file = fopen( m_sFilename.mb_str(), "a" );
+    m_bBusy = false;
+    m_bFlushNow = false;
+    m_bStop = false;
+    m_bFailed = false;
+    m_iFlushIntervalMs = 0;
+    m_iPeakDepth = 0;
+    
+    m_pThread = new ODChangesWriterThread( this );
+    if( m_pThread->Create() != wxTHREAD_NO_ERROR || m_pThread->Run() != wxTHREAD_NO_ERROR ) {
+        // Write calls will do the writing themselves
+        delete m_pThread;
+        m_pThread = NULL;
+    }
+}
+
+ODChangesWriter::~ODChangesWriter()
+{
+    Stop();
+    if( m_file )
+        fclose( m_file );
+}
+
+void ODChangesWriter::SetFlushInterval( int ms )
+{
+    wxMutexLocker l_lock( m_mutex );
+    m_iFlushIntervalMs = ms > 0 ? ms : 0;
+    m_condWork.Signal();
+}
+
+//  Takes the contents of data, which is left empty. Only blocks while the
+//  queue is full.
+bool ODChangesWriter::Write( std::string &data, size_t records )
+{
+    if( !m_file ) return false;
+    
+    wxMutexLocker l_lock( m_mutex );
+    if( m_pThread && m_Queue.size() >= ODCHANGES_QUEUE_MAX ) {
+        ODStatsCount( ODSTATS_CHANGES_QUEUE_WAITS );
+        // Cut the flush interval short rather than wait it out
+        m_bFlushNow = true;
+        m_condWork.Signal();
+        while( m_Queue.size() >= ODCHANGES_QUEUE_MAX )
+            m_condIdle.Wait();
+        m_bFlushNow = false;
+    }
+    
+    m_Queue.push_back( ODChangesEntry() );
+    ODChangesEntry &l_entry = m_Queue.back();
+    l_entry.m_sData.swap( data );
+    l_entry.m_iRecords = records;
+    l_entry.m_iQueuedUs = ODStatsNowUs();
+    if( m_Queue.size() > m_iPeakDepth ) m_iPeakDepth = m_Queue.size();
+    
+    if( m_pThread )
+        m_condWork.Signal();
+    else {
+        // Nobody to hand it to
+        wxLongLong_t l_iStartUs = ODStatsNowUs();
+        if( !WriteEntries( m_Queue ) ) m_bFailed = true;
+        ODStatsRecord( ODSTATS_CHANGES_FLUSH, l_iStartUs, ODStatsNowUs() );
+        m_Queue.clear();
+    }
+    
+    ReportStats();
+    return true;
+}
+
+//  Waits until everything written so far is in the file. Returns false if any
+//  of it could not be written since the last Flush.
+bool ODChangesWriter::Flush( void )
+{
+    wxMutexLocker l_lock( m_mutex );
+    WaitIdle();
+    ReportStats();
+    
+    bool l_bOK = !m_bFailed;
+    m_bFailed = false;
+    return l_bOK;
+}
+
+//  Writes what is queued and ends the thread, later writes are done by the caller
+void ODChangesWriter::Stop( void )
+{
+    if( !m_pThread ) return;
+    
+    {
+        wxMutexLocker l_lock( m_mutex );
+        m_bStop = true;
+        m_condWork.Signal();
+    }
+    m_pThread->Wait();
+    delete m_pThread;
+    m_pThread = NULL;
+    
+    wxMutexLocker l_lock( m_mutex );
+    ReportStats();
+}
+
+void ODChangesWriter::Remove( void )
+{
+    wxMutexLocker l_lock( m_mutex );
+    WaitIdle();
+    
+    if( m_file )
+        fclose( m_file );
+    if( ::wxFileExists( m_sFilename ) )
+        ::wxRemoveFile( m_sFilename );
+    m_file = fopen( m_sFilename.mb_str(), "a" );
+    m_bFailed = false;
+}
+
+//  Moves the file to another name and starts a new one. Fails, leaving the
+//  file where it is, if that name is already taken.
+bool ODChangesWriter::Rotate( const wxString &to )
+{
+    wxMutexLocker l_lock( m_mutex );
+    WaitIdle();
+    
+    if( m_file )
+        fclose( m_file );
+    bool l_bOK = !::wxFileExists( m_sFilename ) || ::wxRenameFile( m_sFilename, to, false );
+    m_file = fopen( m_sFilename.mb_str(), "a" );
+    return l_bOK;
+}
+
+//  Called with the mutex held
+void ODChangesWriter::WaitIdle( void )
+{
+    m_bFlushNow = true;
+    m_condWork.Signal();
+    while( !m_Queue.empty() || m_bBusy )
+        m_condIdle.Wait();
+    m_bFlushNow = false;
+}
+
+//  Called with the mutex held, on the GUI thread as ODStats is not locked
+void ODChangesWriter::ReportStats( void )
+{
+    for( size_t i = 0; i < m_Samples.size(); i++ ) {
+        ODStatsRecord( ODSTATS_CHANGES_FLUSH, m_Samples[i].m_iStartUs, m_Samples[i].m_iEndUs );
+        ODStatsRecord( ODSTATS_CHANGES_COMMIT, m_Samples[i].m_iQueuedUs, m_Samples[i].m_iEndUs );
+    }
+    m_Samples.clear();
+    ODStatsPeak( ODSTATS_CHANGES_QUEUE_PEAK, m_iPeakDepth );
+    m_iPeakDepth = m_Queue.size();
+}
+
+void ODChangesWriter::Run( void )
+{
+    std::deque<ODChangesEntry> l_entries;
+    
+    wxMutexLocker l_lock( m_mutex );
+    for( ;; ) {
+        while( m_Queue.empty() && !m_bStop )
+            m_condWork.Wait();
+        if( m_Queue.empty() ) break;
+        
+        l_entries.swap( m_Queue );
+        m_bBusy = true;
+        m_condIdle.Broadcast();
+        
+        ODChangesSample l_sample;
+        l_sample.m_iQueuedUs = l_entries.front().m_iQueuedUs;
+        m_mutex.Unlock();
+        
+        l_sample.m_iStartUs = ODStatsNowUs();
+        bool l_bOK = WriteEntries( l_entries );
+        l_sample.m_iEndUs = ODStatsNowUs();
+        l_entries.clear();
+        
+        m_mutex.Lock();
+        if( !l_bOK ) m_bFailed = true;
+        if( m_Samples.size() < ODCHANGES_QUEUE_MAX ) m_Samples.push_back( l_sample );
+        m_bBusy = false;
+        m_condIdle.Broadcast();
+        
+        // Let more records gather before the next flush, unless someone is waiting
+        wxLongLong_t l_iUntilUs = l_sample.m_iEndUs + (wxLongLong_t)m_iFlushIntervalMs * 1000;
+        while( !m_bStop && !m_bFlushNow ) {
+            wxLongLong_t l_iNowUs = ODStatsNowUs();
+            if( l_iNowUs >= l_iUntilUs ) break;
+            m_condWork.WaitTimeout( (unsigned long)( ( l_iUntilUs - l_iNowUs ) / 1000 ) + 1 );
+        }
+    }
+}
+
+//  Appends the entries with a single flush. If that fails the file is cut back
+//  to where it was, so no entry is left half written.
+bool ODChangesWriter::WriteEntries( std::deque<ODChangesEntry> &entries )
+{
+    if( !m_file ) return false;
+    
+    fseek( m_file, 0, SEEK_END );
+    long l_lLength = ftell( m_file );
+    
+    bool l_bOK = true;
+    size_t l_iBytes = 0;
+    size_t l_iRecords = 0;
+    for( size_t i = 0; i < entries.size() && l_bOK; i++ ) {
+        const std::string &l_data = entries[i].m_sData;
+        l_bOK = fwrite( l_data.data(), 1, l_data.size(), m_file ) == l_data.size();
+        l_iBytes += l_data.size();
+        l_iRecords += entries[i].m_iRecords;
+    }
+    if( l_bOK ) l_bOK = ( fflush( m_file ) == 0 );
+    
+    if( !l_bOK ) {
+        // wxLog is safe from this thread, the message goes out from the GUI thread
+        wxString l_sMsg;
+        l_sMsg.Printf( _T("Failed to write %lu change records, %lu bytes, to %s"), (unsigned long)l_iRecords, (unsigned long)l_iBytes, m_sFilename.c_str() );
+        wxLogMessage( l_sMsg );
+        if( l_lLength >= 0 )
+            TruncateFile( l_lLength );
+    }
+#ifdef __WXMSW__
+    fclose( m_file );
+    m_file = fopen( m_sFilename.mb_str(), "a" );
+#endif
+    
+    return l_bOK;
+}
+
+void ODChangesWriter::TruncateFile( long length )
+{
+    clearerr( m_file );
+#ifdef __WXMSW__
+    _chsize( _fileno( m_file ), length );
+#else
+    if( ftruncate( fileno( m_file ), length ) != 0 )
+        wxLogMessage( _T("Unable to truncate ") + m_sFilename );
+#endif
+}
@@ -25,13 +25,28 @@
 
 #include "ODConfig.h"
 #include "ODNavObjectChanges.h"
+#include "ODGPXExport.h"
+#include "ODGPXImport.h"
+#include "ODStats.h"
+#include "ODNavObjCompactor.h"
+#include "ODNavObjSnapshot.h"
 #include "Layer.h"
 #include "PointMan.h"
+#include "Boundary.h"
+#include "BoundaryMan.h"
+#include "BoundaryPoint.h"
 #include "pugixml.hpp"
 #include <wx/progdlg.h>
 #include <wx/filename.h>
 #include <wx/file.h>
 #include <wx/dir.h>
+#include <wx/stopwatch.h>
+
+#ifdef __WXMSW__
+#include <wx/msw/wrapwin.h>
+#else
+#include <unistd.h>
+#endif
 
 
 extern wxString         *g_pData;
@@ -42,6 +57,7 @@ extern wxString         g_InvisibleLayers;
 extern LayerList        *pLayerList;
 extern PointMan         *g_pODPointMan;  
 extern PathList         *g_pPathList;
+extern BoundaryMan      *g_pBoundaryMan;
 extern int              g_navobjbackups;
 
 //ODConfig::ODConfig(const wxString &appName, const wxString &vendorName,
@@ -53,20 +69,30 @@ ODConfig::ODConfig(const wxString &appName, const wxString &vendorName, const wx
     m_sODNavObjSetFile = *g_pData;
     m_sODNavObjSetFile += wxS( "ODnavobj.xml" );
     m_sODNavObjSetChangesFile = m_sODNavObjSetFile + _T( ".changes" );
+    m_sODNavObjSnapshotFile = m_sODNavObjSetFile + _T( ".snapshot" );
  
     m_pODNavObjectInputSet = NULL;
     m_pODNavObjectChangesSet = NULL;
     m_bSkipChangeSetUpdate = FALSE;
+    m_iTransactionDepth = 0;
+    m_pNavObjCompactor = new ODNavObjCompactor( m_sODNavObjSetFile, m_sODNavObjSetChangesFile + _T( ".compacting" ), m_sODNavObjSnapshotFile );
+    m_bNavObjCompactionFailed = false;
+    m_pNavObjCompactionSnapshot = NULL;
     
 }
 
 ODConfig::~ODConfig()
 {
     //dtor
+    delete m_pNavObjCompactionSnapshot;
+    delete m_pNavObjCompactor;
 }
 
 bool ODConfig::AddNewPath( ODPath *pb, int crm )
 {
+    if( g_pBoundaryMan && pb->m_sTypeString == wxT("Boundary") )
+        g_pBoundaryMan->BoundaryChanged( (Boundary *)pb, false );
+
     if( pb->m_bIsInLayer )
         return true;
 
@@ -80,6 +106,9 @@ bool ODConfig::AddNewPath( ODPath *pb, int crm )
 
 bool ODConfig::UpdatePath( ODPath *pb )
 {
+    if( g_pBoundaryMan && pb->m_sTypeString == wxT("Boundary") )
+        g_pBoundaryMan->BoundaryChanged( (Boundary *)pb, false );
+
     if( pb->m_bIsInLayer ) return true;
 
     if( !m_bSkipChangeSetUpdate ) {
@@ -91,8 +120,44 @@ bool ODConfig::UpdatePath( ODPath *pb )
     return true;
 }
 
+//  For a single point added to or taken out of a path. An update of the path
+//  still waiting in the open batch is edited in place, otherwise the whole
+//  path is written as usual.
+bool ODConfig::UpdatePathPointInserted( ODPath *pb, ODPoint *pPrev, ODPoint *pOP )
+{
+    if( g_pBoundaryMan && pb->m_sTypeString == wxT("Boundary") )
+        g_pBoundaryMan->BoundaryChanged( (Boundary *)pb, false );
+
+    if( pb->m_bIsInLayer ) return true;
+
+    if( !m_bSkipChangeSetUpdate && pb->m_bSaveUpdates ) {
+        if( !m_pODNavObjectChangesSet->PatchBatchedPath( pb, pPrev, pOP ) )
+            m_pODNavObjectChangesSet->AddPathPoint( pb, pPrev, pOP );
+    }
+
+    return true;
+}
+
+bool ODConfig::UpdatePathPointRemoved( ODPath *pb, ODPoint *pOP )
+{
+    if( g_pBoundaryMan && pb->m_sTypeString == wxT("Boundary") )
+        g_pBoundaryMan->BoundaryChanged( (Boundary *)pb, false );
+
+    if( pb->m_bIsInLayer ) return true;
+
+    if( !m_bSkipChangeSetUpdate && pb->m_bSaveUpdates ) {
+        if( !m_pODNavObjectChangesSet->PatchBatchedPath( pb, NULL, pOP ) )
+            m_pODNavObjectChangesSet->AddPathPoint( pb, NULL, pOP );
+    }
+
+    return true;
+}
+
 bool ODConfig::DeleteConfigPath( ODPath *pb )
 {
+    if( g_pBoundaryMan && pb->m_sTypeString == wxT("Boundary") )
+        g_pBoundaryMan->BoundaryChanged( (Boundary *)pb, true );
+
     if( pb->m_bIsInLayer ) return true;
     
     if( !m_bSkipChangeSetUpdate ) {
@@ -104,6 +169,9 @@ bool ODConfig::DeleteConfigPath( ODPath *pb )
 
 bool ODConfig::AddNewODPoint( ODPoint *pWP, int crm )
 {
+    if( g_pBoundaryMan && pWP->m_sTypeString == wxT("Boundary Point") )
+        g_pBoundaryMan->BoundaryPointChanged( (BoundaryPoint *)pWP, false );
+
     if( pWP->m_bIsInLayer )
         return true;
 
@@ -119,6 +187,9 @@ bool ODConfig::AddNewODPoint( ODPoint *pWP, int crm )
 
 bool ODConfig::UpdateODPoint( ODPoint *pWP )
 {
+    if( g_pBoundaryMan && pWP->m_sTypeString == wxT("Boundary Point") )
+        g_pBoundaryMan->BoundaryPointChanged( (BoundaryPoint *)pWP, false );
+
     if( pWP->m_bIsInLayer )
         return true;
 
@@ -131,6 +202,9 @@ bool ODConfig::UpdateODPoint( ODPoint *pWP )
 
 bool ODConfig::DeleteODPoint( ODPoint *pWP )
 {
+    if( g_pBoundaryMan && pWP->m_sTypeString == wxT("Boundary Point") )
+        g_pBoundaryMan->BoundaryPointChanged( (BoundaryPoint *)pWP, true );
+
     if( pWP->m_bIsInLayer )
         return true;
 
@@ -141,6 +215,49 @@ bool ODConfig::DeleteODPoint( ODPoint *pWP )
     return true;
 }
 
+bool ODConfig::DeleteConfigObjects( const ODPathSet *pPaths, const ODPointSet *pPoints )
+{
+    if( g_pBoundaryMan ) {
+        if( pPaths ) {
+            for( ODPathSet::const_iterator it = pPaths->begin(); it != pPaths->end(); ++it )
+                if( (*it)->m_sTypeString == wxT("Boundary") )
+                    g_pBoundaryMan->BoundaryChanged( (Boundary *)*it, true );
+        }
+        if( pPoints ) {
+            for( ODPointSet::const_iterator it = pPoints->begin(); it != pPoints->end(); ++it )
+                if( (*it)->m_sTypeString == wxT("Boundary Point") )
+                    g_pBoundaryMan->BoundaryPointChanged( (BoundaryPoint *)*it, true );
+        }
+    }
+
+    if( !m_bSkipChangeSetUpdate ) {
+        m_pODNavObjectChangesSet->AddDeletes( pPaths, pPoints );
+    }
+
+    return true;
+}
+
+void ODConfig::BeginTransaction( void )
+{
+    if( m_iTransactionDepth++ == 0 && m_pODNavObjectChangesSet )
+        m_pODNavObjectChangesSet->BeginBatch();
+}
+
+bool ODConfig::CommitTransaction( void )
+{
+    if( m_iTransactionDepth == 0 ) return false;
+    if( --m_iTransactionDepth > 0 ) return true;
+    
+    if( !m_pODNavObjectChangesSet ) return false;
+    if( m_pODNavObjectChangesSet->CommitBatch() ) return true;
+    
+    // The objects have changed already and are not put back, the navobj file is
+    // brought up to them instead so the edit is not lost at the next start
+    wxLogMessage( _T("Unable to write the changes to ") + m_sODNavObjSetChangesFile + _T(", saving ") + m_sODNavObjSetFile );
+    UpdateNavObj();
+    return false;
+}
+
 bool ODConfig::ExportGPXPaths( wxWindow* parent, PathList *pPaths, const wxString suggestedName )
 {
     wxFileDialog saveDialog( NULL, _( "Export GPX file" ), m_gpx_path, suggestedName,
@@ -171,12 +288,11 @@ bool ODConfig::ExportGPXPaths( wxWindow* parent, PathList *pPaths, const wxStrin
             if( answer != wxID_YES ) return false;
         }
 
-        ODNavObjectChanges *pgpx = new ODNavObjectChanges;
-        pgpx->AddGPXPathsList( pPaths );
-        pgpx->SaveFile(fn.GetFullPath());
-        delete pgpx;
+        ODGPXExport l_gpx;
+        for( wxPathListNode *node = pPaths->GetFirst(); node; node = node->GetNext() )
+            l_gpx.AddPath( node->GetData() );
 
-        return true;
+        return WriteGPXExport( l_gpx, fn.GetFullPath() );
     } else
         return false;
 }
@@ -201,52 +317,164 @@ bool ODConfig::ExportGPXODPoints( wxWindow* parent, ODPointList *pODPoints, cons
             if( answer != wxID_YES ) return false;
         }
 
-        ODNavObjectChanges *pgpx = new ODNavObjectChanges;
-        pgpx->AddGPXODPointsList( pODPoints );
-        pgpx->SaveFile(fn.GetFullPath());
-        delete pgpx;
+        ODGPXExport l_gpx;
+        for( wxODPointListNode *node = pODPoints->GetFirst(); node; node = node->GetNext() )
+            l_gpx.AddODPoint( node->GetData() );
 
-        return true;
+        return WriteGPXExport( l_gpx, fn.GetFullPath() );
     } else
         return false;
 }
 
 void ODConfig::UpdateNavObj( void )
 {
+    // A background rewrite still running is superseded by this one
+    bool l_bOK;
+    m_pNavObjCompactor->Finish( &l_bOK );
+    delete m_pNavObjCompactionSnapshot;
+    m_pNavObjCompactionSnapshot = NULL;
+
 //   Create the NavObjectCollection, and save to specified file
     ODNavObjectChanges *pNavObjectSet = new ODNavObjectChanges();
 
     pNavObjectSet->CreateAllGPXObjects();
-    pNavObjectSet->SaveFile( m_sODNavObjSetFile );
+    l_bOK = ODNavObjCompactor::ReplaceFile( *pNavObjectSet, m_sODNavObjSetFile );
+
+    // Taken from the document just saved, so the next start gets the same
+    // objects from the snapshot as it would from the XML
+    if( l_bOK ) {
+        ODGPXRecordSet l_records;
+        pNavObjectSet->ReadAllGPXRecords( &l_records );
+        if( !ODNavObjSnapshot::Write( m_sODNavObjSnapshotFile, m_sODNavObjSetFile, l_records ) )
+            wxLogMessage( _T("Unable to save ") + m_sODNavObjSnapshotFile );
+    }
 
     delete pNavObjectSet;
 
+    if( !l_bOK ) {
+        wxLogMessage( _T("Unable to save ") + m_sODNavObjSetFile + _T(", the changes files are kept") );
+        return;
+    }
+    
+    if( wxFileExists( m_pNavObjCompactor->GetPendingChangesFile() ) )
+        ::wxRemoveFile( m_pNavObjCompactor->GetPendingChangesFile() );
+    m_bNavObjCompactionFailed = false;
+
     m_pODNavObjectChangesSet->RemoveChangesFile();
     
     delete m_pODNavObjectChangesSet;
     m_pODNavObjectChangesSet = new ODNavObjectChanges(m_sODNavObjSetChangesFile);
+    
+    // Anything batched so far is in the file just saved, carry on batching from here
+    if( m_iTransactionDepth > 0 )
+        m_pODNavObjectChangesSet->BeginBatch();
 
 }
 
+void ODConfig::CheckNavObjCompaction( void )
+{
+    if( m_pNavObjCompactor->IsBusy() ) return;
+    
+    bool l_bOK;
+    if( m_pNavObjCompactor->Finish( &l_bOK ) ) {
+        if( l_bOK )
+            wxLogMessage( _T("Rewrote ") + m_sODNavObjSetFile );
+        else {
+            // The pending changes stay on disk for UpdateNavObj or the next start
+            wxLogMessage( _T("Unable to rewrite ") + m_sODNavObjSetFile + _T(", changes kept in ") + m_pNavObjCompactor->GetPendingChangesFile() );
+            m_bNavObjCompactionFailed = true;
+        }
+    }
+    
+    if( m_bNavObjCompactionFailed || IsInTransaction() || !m_pODNavObjectChangesSet ) {
+        delete m_pNavObjCompactionSnapshot;
+        m_pNavObjCompactionSnapshot = NULL;
+        return;
+    }
+    
+    if( !m_pNavObjCompactionSnapshot ) {
+        if( m_pODNavObjectChangesSet->GetChangeBytes() < ODNAVOBJ_COMPACT_BYTES &&
+            m_pODNavObjectChangesSet->GetChangeRecords() < ODNAVOBJ_COMPACT_RECORDS ) return;
+        m_pNavObjCompactionSnapshot = new ODNavObjectChanges();
+        m_iNavObjCompactionChanges = m_pODNavObjectChangesSet->GetChangeRecords();
+        m_iNavObjCompactionPaths = g_pPathList->GetCount();
+        m_iNavObjCompactionPoints = g_pODPointMan->GetODPointList()->GetCount();
+    } else if( m_pODNavObjectChangesSet->GetChangeRecords() != m_iNavObjCompactionChanges ||
+        g_pPathList->GetCount() != m_iNavObjCompactionPaths ||
+        g_pODPointMan->GetODPointList()->GetCount() != m_iNavObjCompactionPoints ) {
+        // Part of it is out of date, start again on the next tick
+        delete m_pNavObjCompactionSnapshot;
+        m_pNavObjCompactionSnapshot = NULL;
+        return;
+    }
+    
+    // The objects are only ever touched here, the worker just gets the document
+    {
+        ODStatsTimer l_timer( ODSTATS_NAVOBJ_SNAPSHOT );
+        if( !m_pNavObjCompactionSnapshot->CreateAllGPXObjects( ODStatsNowUs() + ODNAVOBJ_COMPACT_SLICE_US ) ) return;
+    }
+    ODNavObjectChanges *pSnapshot = m_pNavObjCompactionSnapshot;
+    m_pNavObjCompactionSnapshot = NULL;
+    
+    // Everything recorded so far is in the snapshot, later changes go to a new file
+    if( !m_pODNavObjectChangesSet->RotateChangesFile( m_pNavObjCompactor->GetPendingChangesFile() ) ) {
+        delete pSnapshot;
+        m_bNavObjCompactionFailed = true;
+        return;
+    }
+    m_pNavObjCompactor->Start( pSnapshot );
+}
+
 void ODConfig::LoadNavObjects()
 {
+    ODStatsTimer l_timer( ODSTATS_LOAD_NAVOBJECTS );
     //      next thing to do is read tracks, etc from the NavObject XML file,
     wxString sLogMessage;
     sLogMessage.append( _("Loading navobjects from ") );
     sLogMessage.append(m_sODNavObjSetFile );
     wxLogMessage( sLogMessage );
+    wxStopWatch l_swLoad;
     CreateRotatingNavObjBackup();
 
     if( NULL == m_pODNavObjectInputSet )
         m_pODNavObjectInputSet = new ODNavObjectChanges();
 
-    if( wxFileExists( m_sODNavObjSetFile ) &&
+    //  The snapshot is only read back if the navobj file has not changed since it was made
+    ODGPXRecordSet l_records;
+    if( ODNavObjSnapshot::Read( m_sODNavObjSnapshotFile, m_sODNavObjSetFile, &l_records ) ) {
+        wxLogMessage( _T("Using snapshot ") + m_sODNavObjSnapshotFile );
+        m_pODNavObjectInputSet->LoadAllGPXRecords( l_records );
+        l_records.Clear();
+    } else if( wxFileExists( m_sODNavObjSetFile ) &&
         m_pODNavObjectInputSet->load_file( m_sODNavObjSetFile.fn_str() ) )
         m_pODNavObjectInputSet->LoadAllGPXObjects();
 
-    wxLogMessage( _T("Done loading ODnavobjects") );
+    wxString l_sDone;
+    l_sDone.Printf( _T("Done loading ODnavobjects: %u paths, %u points in %ld ms"),
+                    (unsigned int)g_pPathList->GetCount(), (unsigned int)g_pODPointMan->GetODPointList()->GetCount(), l_swLoad.Time() );
+    wxLogMessage( l_sDone );
     delete m_pODNavObjectInputSet;
+    m_pODNavObjectInputSet = NULL;
+
+    //  A background rewrite did not finish, the changes it was to take in come first
+    wxString l_sPending = m_pNavObjCompactor->GetPendingChangesFile();
+    bool l_bPendingApplied = false;
+    if( wxFileExists( l_sPending ) ) {
+        sLogMessage = _("Applying changes from ");
+        sLogMessage.append( l_sPending );
+        wxLogMessage( sLogMessage );
+        //  Saved whole below, recording them again would only grow the changes file
+        bool l_bSkip = m_bSkipChangeSetUpdate;
+        m_bSkipChangeSetUpdate = true;
+        ODNavObjectChanges l_PendingSet;
+        if( l_PendingSet.load_file( l_sPending.fn_str() ) )
+            l_PendingSet.ApplyChanges();
+        m_bSkipChangeSetUpdate = l_bSkip;
+        l_bPendingApplied = true;
+    }
 
+    //  Anything still queued for the changes file has to be in it before it is read
+    if( m_pODNavObjectChangesSet ) m_pODNavObjectChangesSet->FlushChanges();
     if( wxFileExists( m_sODNavObjSetChangesFile ) ) {
 
         wxULongLong size = wxFileName::GetSize(m_sODNavObjSetChangesFile);
@@ -267,14 +495,23 @@ void ODConfig::LoadNavObjects()
             sLogMessage.append( _("Applying changes from ") );
             sLogMessage.append( m_sODNavObjSetChangesFile );
             wxLogMessage( sLogMessage );
+            l_swLoad.Start();
             m_pODNavObjectChangesSet->ApplyChanges();
+            long l_lApply = l_swLoad.Time();
             UpdateNavObj();
+            sLogMessage.Printf( _T("Applied %s bytes of changes in %ld ms, saved in %ld ms"),
+                                size.ToString().c_str(), l_lApply, l_swLoad.Time() - l_lApply );
+            wxLogMessage( sLogMessage );
         }
         
 //        delete m_pODNavObjectChangesSet;
            
     }
 
+    // Save what was replayed, unless that has been done above
+    if( l_bPendingApplied && wxFileExists( l_sPending ) )
+        UpdateNavObj();
+
 //    m_pODNavObjectChangesSet = new ODNavObjectChanges(m_sODNavObjSetChangesFile);
 }
 
@@ -298,33 +535,16 @@ void ODConfig::ExportGPX( wxWindow* parent, bool bviz_only, bool blayer )
             if( answer != wxID_YES ) return;
         }
 
-        ::wxBeginBusyCursor();
-
-        ODNavObjectChanges *pgpx = new ODNavObjectChanges;
+        ODGPXExport l_gpx;
 
-        wxProgressDialog *pprog = NULL;
-        int count = g_pODPointMan->GetODPointList()->GetCount();
-        if( count > 200) {
-            pprog = new wxProgressDialog( _("Export GPX file"), _T("0/0"), count, NULL,
-                                          wxPD_APP_MODAL | wxPD_SMOOTH |
-                                          wxPD_ELAPSED_TIME | wxPD_ESTIMATED_TIME | wxPD_REMAINING_TIME );
-            pprog->SetSize( 400, wxDefaultCoord );
-            pprog->Centre();
-        }
+        //  Built once rather than searching every path for every point
+        ODPathPointSet l_PathPoints;
+        l_PathPoints.Build( g_pPathList );
 
         //Points
-        int ic = 0;
-
         wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst();
         ODPoint *pr;
         while( node ) {
-            if(pprog) {
-                wxString msg;
-                msg.Printf(_T("%d/%d"), ic, count);
-                pprog->Update( ic, msg );
-                ic++;
-            }
-
             pr = node->GetData();
 
             bool b_add = true;
@@ -335,8 +555,8 @@ void ODConfig::ExportGPX( wxWindow* parent, bool bviz_only, bool blayer )
             if( pr->m_bIsInLayer && !blayer )
                 b_add = false;
             if( b_add) {
-                if( pr->m_bKeepXPath || !ODPointIsInPathList( pr ) )
-                    pgpx->AddGPXODPoint( pr);
+                if( pr->m_bKeepXPath || !l_PathPoints.Contains( pr ) )
+                    l_gpx.AddODPoint( pr );
             }
 
             node = node->GetNext();
@@ -355,19 +575,44 @@ void ODConfig::ExportGPX( wxWindow* parent, bool bviz_only, bool blayer )
                 b_add = false;
 
             if( b_add ) {
-                pgpx->AddGPXPath( pPath ); 
+                l_gpx.AddPath( pPath );
                 }
             node1 = node1->GetNext();
         }
 
-        pgpx->SaveFile( fn.GetFullPath() );
-        delete pgpx;
-        ::wxEndBusyCursor();
+        WriteGPXExport( l_gpx, fn.GetFullPath() );
+    }
+}
 
-        if( pprog)
-            delete pprog;
+static bool GPXProgress( int done, int total, void *data )
+{
+    wxProgressDialog *pprog = (wxProgressDialog *)data;
+    wxString msg;
+    msg.Printf( _T("%d/%d"), done, total );
+    return pprog->Update( done, msg );
+}
 
+bool ODConfig::WriteGPXExport( ODGPXExport &gpx, const wxString &filename )
+{
+    ::wxBeginBusyCursor();
+
+    wxProgressDialog *pprog = NULL;
+    int count = gpx.GetCount();
+    if( count > 200) {
+        pprog = new wxProgressDialog( _("Export GPX file"), _T("0/0"), count, NULL,
+                                      wxPD_APP_MODAL | wxPD_SMOOTH | wxPD_CAN_ABORT |
+                                      wxPD_ELAPSED_TIME | wxPD_ESTIMATED_TIME | wxPD_REMAINING_TIME );
+        pprog->SetSize( 400, wxDefaultCoord );
+        pprog->Centre();
     }
+
+    bool l_bOK = gpx.Write( filename, pprog ? GPXProgress : NULL, pprog );
+
+    ::wxEndBusyCursor();
+    if( pprog )
+        delete pprog;
+
+    return l_bOK;
 }
 
 void ODConfig::UI_ImportGPX( wxWindow* parent, bool islayer, wxString dirpath, bool isdirectory )
@@ -431,24 +676,53 @@ void ODConfig::UI_ImportGPX( wxWindow* parent, bool islayer, wxString dirpath, b
             pLayerList->Insert( l );
         }
 
+        ODGPXImport l_gpx( l );
         for( unsigned int i = 0; i < file_array.GetCount(); i++ ) {
-            wxString path = file_array[i];
+            if( wxFileExists( file_array[i] ) )
+                l_gpx.AddFile( file_array[i] );
+        }
+        ReadGPXImport( l_gpx );
+    }
+}
 
-            if( wxFileExists( path ) ) {
+bool ODConfig::ReadGPXImport( ODGPXImport &gpx )
+{
+    ::wxBeginBusyCursor();
+
+    wxProgressDialog *pprog = NULL;
+    int count = gpx.GetCount();
+    if( count > 10 ) {
+        pprog = new wxProgressDialog( _("Import GPX files"), _T("0/0"), count, NULL,
+                                      wxPD_APP_MODAL | wxPD_SMOOTH | wxPD_CAN_ABORT |
+                                      wxPD_ELAPSED_TIME | wxPD_ESTIMATED_TIME | wxPD_REMAINING_TIME );
+        pprog->SetSize( 400, wxDefaultCoord );
+        pprog->Centre();
+    }
 
-                ODNavObjectChanges *pSet = new ODNavObjectChanges;
-                pSet->load_file(path.fn_str());
+    bool l_bOK = gpx.Load( pprog ? GPXProgress : NULL, pprog );
+    if( gpx.WasCancelled() )
+        wxLogMessage( _T("GPX import cancelled, objects already loaded have been kept") );
 
-                if(islayer){
-                    l->m_NoOfItems += pSet->LoadAllGPXObjectsAsLayer(l->m_LayerID, l->m_bIsVisibleOnChart);
-                }
-                else
-                    pSet->LoadAllGPXObjects( true );    // Import with full vizibility of names and objects
+    ::wxEndBusyCursor();
+    if( pprog )
+        delete pprog;
 
-                delete pSet;
-            }
-        }
-    }
+    return l_bOK;
+}
+
+//  The navobj file is never rewritten in place, a new one is always renamed
+//  over it, so a hard link holds on to the old contents as well as a copy does
+static bool LinkOrCopyFile( const wxString &from, const wxString &to )
+{
+    if( ::wxFileExists( to ) )
+        ::wxRemoveFile( to );
+#ifdef __WXMSW__
+    if( CreateHardLink( to.fn_str(), from.fn_str(), NULL ) ) return true;
+#else
+    if( link( from.fn_str(), to.fn_str() ) == 0 ) return true;
+#endif
+    // Not on this filesystem
+    return wxCopyFile( from, to );
 }
 
 void ODConfig::CreateRotatingNavObjBackup()
@@ -476,21 +750,20 @@ void ODConfig::CreateRotatingNavObjBackup()
         }
 
 
-        if ( s_diff != 0 )
+        // The older backups only change name, only the newest needs any data
+        if ( s_diff != 0 && wxFile::Exists( m_sODNavObjSetFile ) )
         {
             for( int i = g_navobjbackups - 1; i >= 1; i-- )
             {
                 oldname = wxString::Format( _T("%s.%d"), m_sODNavObjSetFile.c_str(), i );
                 newname = wxString::Format( _T("%s.%d"), m_sODNavObjSetFile.c_str(), i + 1 );
                 if( wxFile::Exists( oldname ) )
-                    wxCopyFile( oldname, newname );
+                    wxRenameFile( oldname, newname, true );
             }
 
-            if( wxFile::Exists( m_sODNavObjSetFile ) )
-            {
-                newname = wxString::Format( _T("%s.1"), m_sODNavObjSetFile.c_str() );
-                wxCopyFile( m_sODNavObjSetFile, newname );
-            }
+            newname = wxString::Format( _T("%s.1"), m_sODNavObjSetFile.c_str() );
+            if( !LinkOrCopyFile( m_sODNavObjSetFile, newname ) )
+                wxLogMessage( _T("Unable to back up ") + m_sODNavObjSetFile + _T(" to ") + newname );
         }
     }
     //try to clean the backups the user doesn't want - breaks if he deleted some by hand as it tries to be effective...
@@ -196,6 +196,8 @@ void ODEventHandler::OnODTimer1( wxTimerEvent& event )
         ( g_pPathManagerDialog && g_pPathManagerDialog->IsShown() ) ||
         ( g_pODPathPropDialog && g_pODPathPropDialog->IsShown() ) )
         RequestRefresh( m_parentcanvas );
+    
+    if( g_pODConfig ) g_pODConfig->CheckNavObjCompaction();
 }
 
 void ODEventHandler::OnRolloverPopupTimerEvent( wxTimerEvent& event )
@@ -284,17 +286,7 @@ void ODEventHandler::OnRolloverPopupTimerEvent( wxTimerEvent& event )
                     // leg end point.
                     
                     if( segShow_point_a != pp->m_pODPointList->GetFirst()->GetData() ) {
-                        wxODPointListNode *node = (pp->m_pODPointList)->GetFirst()->GetNext();
-                        ODPoint *pop;
-                        float dist_to_endleg = 0;
-                        wxString t;
-                        
-                        while( node ) {
-                            pop = node->GetData();
-                            dist_to_endleg += pop->m_seg_len;
-                            if( pop->IsSame( segShow_point_a ) ) break;
-                            node = node->GetNext();
-                        }
+                        double dist_to_endleg = pp->GetDistanceToPoint( segShow_point_a );
                         s << _T(" (+") << g_ocpn_draw_pi->FormatDistanceAdaptive( dist_to_endleg ) << _T(")");
                     }
                     
@@ -453,24 +445,18 @@ void ODEventHandler::PopupMenuHandler(wxCommandEvent& event )
             g_PathToEdit = m_pSelectedPath;
             g_ocpn_draw_pi->m_bPathEditing = TRUE;
             break;
-        case ID_PATH_MENU_INSERT:
-            // Insert new OD Point
-            m_pSelectedPath->InsertPointAfter( m_pFoundODPoint, m_cursor_lat, m_cursor_lon );
-            
-            g_pODSelect->DeleteAllSelectableODPoints( m_pSelectedPath );
-            g_pODSelect->DeleteAllSelectablePathSegments( m_pSelectedPath );
-            
-            g_pODSelect->AddAllSelectablePathSegments( m_pSelectedPath );
-            g_pODSelect->AddAllSelectableODPoints( m_pSelectedPath );
-            
-            m_pSelectedPath->RebuildGUIDList();          // ensure the GUID list is intact and good
-            g_pODConfig->UpdatePath( m_pSelectedPath );
+        case ID_PATH_MENU_INSERT: {
+            // Insert new OD Point, the path patches its own selectables around it
+            ODPoint *pNewPoint = m_pSelectedPath->InsertPointAfter( m_pFoundODPoint, m_cursor_lat, m_cursor_lon );
+            if( pNewPoint )
+                g_pODConfig->UpdatePathPointInserted( m_pSelectedPath, m_pFoundODPoint, pNewPoint );
             
             if( g_pODPathPropDialog && ( g_pODPathPropDialog->IsShown() ) ) {
                 g_pODPathPropDialog->SetPathAndUpdate( m_pSelectedPath, true );
             }
             
             break;
+        }
         case ID_PATH_MENU_DELETE: {
             dlg_return = wxID_YES;
             if( g_bConfirmObjectDelete ) {
@@ -594,11 +580,6 @@ void ODEventHandler::PopupMenuHandler(wxCommandEvent& event )
             if( dlg_return == wxID_YES ) {
                 m_pSelectedPath->RemovePointFromPath( m_pFoundODPoint, m_pSelectedPath );
                 m_pFoundODPoint->SetTypeString( _("OD Point") );
-                g_pODSelect->DeleteAllSelectableODPoints( m_pSelectedPath );
-                g_pODSelect->DeleteAllSelectablePathSegments( m_pSelectedPath );
-                
-                g_pODSelect->AddAllSelectablePathSegments( m_pSelectedPath );
-                g_pODSelect->AddAllSelectableODPoints( m_pSelectedPath );
             }
             
 
@@ -0,0 +1,204 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw streaming GPX export
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODGPXExport.h"
+#include "ODNavObjectChanges.h"
+#include "ODPoint.h"
+
+#include <wx/filefn.h>
+
+#include <stdio.h>
+#include <math.h>
+
+void ODPathPointSet::Build( PathList *pPaths )
+{
+    m_Points.clear();
+    for( wxPathListNode *node = pPaths->GetFirst(); node; node = node->GetNext() ) {
+        ODPointList *pODPointList = node->GetData()->m_pODPointList;
+        for( wxODPointListNode *node2 = pODPointList->GetFirst(); node2; node2 = node2->GetNext() ) {
+            ODPoint *pOP = node2->GetData();
+            m_Points[ ODPointPositionKey( (int)floor( pOP->m_lat * 1e6 ), (int)floor( pOP->m_lon * 1e6 ) ) ].push_back( pOP );
+        }
+    }
+}
+
+bool ODPathPointSet::Contains( ODPoint *pOP )
+{
+    int l_iLat = (int)floor( pOP->m_lat * 1e6 );
+    int l_iLon = (int)floor( pOP->m_lon * 1e6 );
+    for( int ilat = l_iLat - 1; ilat <= l_iLat + 1; ilat++ ) {
+        for( int ilon = l_iLon - 1; ilon <= l_iLon + 1; ilon++ ) {
+            ODPathPointHash::iterator it = m_Points.find( ODPointPositionKey( ilat, ilon ) );
+            if( it == m_Points.end() ) continue;
+            for( ODPointVector::iterator p = it->second.begin(); p != it->second.end(); ++p ) {
+                if( *p == pOP || pOP->IsSame( *p ) ) return true;
+            }
+        }
+    }
+    return false;
+}
+
+class ODGPXFileWriter : public pugi::xml_writer
+{
+public:
+    ODGPXFileWriter( FILE *file ) { m_file = file; }
+    
+    virtual void write( const void *data, size_t size )
+    {
+        fwrite( data, 1, size, m_file );
+    }
+    
+    FILE    *m_file;
+};
+
+class ODGPXExportThread : public wxThread
+{
+public:
+    ODGPXExportThread( ODGPXExport *pExport ) : wxThread( wxTHREAD_JOINABLE ) { m_pExport = pExport; }
+    
+    virtual ExitCode Entry()
+    {
+        m_pExport->WriteObjects();
+        return 0;
+    }
+    
+    ODGPXExport *m_pExport;
+};
+
+ODGPXExport::ODGPXExport()
+{
+    m_iDone = 0;
+    m_bCancel = false;
+    m_bFinished = false;
+    m_bOK = false;
+}
+
+bool ODGPXExport::IsCancelled( void )
+{
+    wxCriticalSectionLocker l_lock( m_csProgress );
+    return m_bCancel;
+}
+
+void ODGPXExport::SetDone( int done )
+{
+    wxCriticalSectionLocker l_lock( m_csProgress );
+    m_iDone = done;
+}
+
+bool ODGPXExport::Write( const wxString &filename, ODGPXExportProgress progress, void *data )
+{
+    m_sFileName = filename;
+    m_iDone = 0;
+    m_bCancel = false;
+    m_bFinished = false;
+    m_bOK = false;
+    
+    //  The objects belong to the GUI thread and may be changed from the progress
+    //  callback, so they are all turned into nodes here before the worker starts
+    m_Document.reset();
+    for( ODPointVector::iterator it = m_ODPoints.begin(); it != m_ODPoints.end(); ++it ) {
+        pugi::xml_node node = m_Document.append_child( "opencpn:ODPoint" );
+        m_Document.GPXCreateODPoint( node, *it, OPT_OCPNPOINT );
+    }
+    for( std::vector<ODPath *>::iterator it = m_Paths.begin(); it != m_Paths.end(); ++it ) {
+        pugi::xml_node node = m_Document.append_child( "opencpn:path" );
+        m_Document.GPXCreatePath( node, *it );
+    }
+    
+    ODGPXExportThread *pThread = new ODGPXExportThread( this );
+    if( pThread->Create() != wxTHREAD_NO_ERROR || pThread->Run() != wxTHREAD_NO_ERROR ) {
+        // No thread to be had, write it here instead
+        delete pThread;
+        pThread = NULL;
+        WriteObjects();
+    }
+    
+    if( pThread ) {
+        int l_iTotal = GetCount();
+        for( ;; ) {
+            int l_iDone;
+            bool l_bFinished;
+            {
+                wxCriticalSectionLocker l_lock( m_csProgress );
+                l_iDone = m_iDone;
+                l_bFinished = m_bFinished;
+            }
+            if( l_bFinished ) break;
+            if( progress && !progress( l_iDone, l_iTotal, data ) ) {
+                wxCriticalSectionLocker l_lock( m_csProgress );
+                m_bCancel = true;
+            }
+            wxMilliSleep( 50 );
+        }
+        pThread->Wait();
+        delete pThread;
+    }
+    
+    m_Document.reset();
+    if( !m_bOK ) {
+        if( !m_bCancel ) wxLogMessage( _T("Unable to write GPX export to ") + m_sFileName );
+        if( ::wxFileExists( m_sFileName ) ) ::wxRemoveFile( m_sFileName );
+    }
+    return m_bOK;
+}
+
+void ODGPXExport::WriteObjects( void )
+{
+    bool l_bOK = false;
+    FILE *l_file = wxFopen( m_sFileName, wxT("wb") );
+    if( l_file ) {
+        setvbuf( l_file, NULL, _IOFBF, ODGPXEXPORT_BUFFER_SIZE );
+        fputs( "<?xml version=\"1.0\"?>\n"
+               "<OCPNDraw version=\"0.1\" creator=\"OpenCPN\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" xmlns:opencpn=\"http://www.opencpn.org\">\n",
+               l_file );
+        
+        //  Only the document built by Write is touched here, never the objects themselves
+        ODGPXFileWriter l_writer( l_file );
+        int l_iDone = 0;
+        bool l_bCancelled = false;
+        
+        for( pugi::xml_node node = m_Document.first_child(); node && !l_bCancelled; node = node.next_sibling() ) {
+            node.print( l_writer, "  ", pugi::format_default, pugi::encoding_auto, 1 );
+            if( ( ++l_iDone & 63 ) == 0 ) {
+                SetDone( l_iDone );
+                l_bCancelled = IsCancelled();
+            }
+        }
+        
+        fputs( "</OCPNDraw>\n", l_file );
+        l_bOK = !l_bCancelled && !ferror( l_file );
+        if( fclose( l_file ) != 0 ) l_bOK = false;
+    }
+    
+    wxCriticalSectionLocker l_lock( m_csProgress );
+    m_bOK = l_bOK;
+    m_bFinished = true;
+}
@@ -0,0 +1,309 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw parallel GPX import
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODGPXImport.h"
+#include "ODNavObjectChanges.h"
+#include "ODPoint.h"
+#include "PointMan.h"
+#include "Layer.h"
+
+#include <math.h>
+
+extern PointMan         *g_pODPointMan;
+extern PathList         *g_pPathList;
+
+void ODPointIndex::Build( ODPointList *pODPoints )
+{
+    m_GUIDs.clear();
+    m_Positions.clear();
+    for( wxODPointListNode *node = pODPoints->GetFirst(); node; node = node->GetNext() )
+        Add( node->GetData() );
+}
+
+void ODPointIndex::Add( ODPoint *pOP )
+{
+    // a list walk finds the first point with a GUID, so keep the first one
+    if( m_GUIDs.find( pOP->m_GUID ) == m_GUIDs.end() )
+        m_GUIDs[ pOP->m_GUID ] = pOP;
+    m_Positions[ ODPointPositionKey( (int)floor( pOP->m_lat * 1e6 ), (int)floor( pOP->m_lon * 1e6 ) ) ].push_back( pOP );
+}
+
+bool ODPointIndex::Remove( ODPoint *pOP )
+{
+    ODPointGUIDHash::iterator itg = m_GUIDs.find( pOP->m_GUID );
+    if( itg != m_GUIDs.end() && itg->second == pOP )
+        m_GUIDs.erase( itg );
+    
+    ODPathPointHash::iterator it = m_Positions.find( ODPointPositionKey( (int)floor( pOP->m_lat * 1e6 ), (int)floor( pOP->m_lon * 1e6 ) ) );
+    if( it == m_Positions.end() ) return false;
+    for( ODPointVector::iterator p = it->second.begin(); p != it->second.end(); ++p ) {
+        if( *p == pOP ) {
+            it->second.erase( p );
+            if( it->second.empty() ) m_Positions.erase( it );
+            return true;
+        }
+    }
+    return false;
+}
+
+ODPoint *ODPointIndex::Find( const wxString &guid )
+{
+    ODPointGUIDHash::iterator it = m_GUIDs.find( guid );
+    return it == m_GUIDs.end() ? NULL : it->second;
+}
+
+ODPoint *ODPointIndex::Find( const wxString &name, double lat, double lon )
+{
+    int l_iLat = (int)floor( lat * 1e6 );
+    int l_iLon = (int)floor( lon * 1e6 );
+    for( int ilat = l_iLat - 1; ilat <= l_iLat + 1; ilat++ ) {
+        for( int ilon = l_iLon - 1; ilon <= l_iLon + 1; ilon++ ) {
+            ODPathPointHash::iterator it = m_Positions.find( ODPointPositionKey( ilat, ilon ) );
+            if( it == m_Positions.end() ) continue;
+            for( ODPointVector::iterator p = it->second.begin(); p != it->second.end(); ++p ) {
+                ODPoint *pOP = *p;
+                if( name == pOP->GetName() && fabs( lat - pOP->m_lat ) < 1.e-6 && fabs( lon - pOP->m_lon ) < 1.e-6 )
+                    return pOP;
+            }
+        }
+    }
+    return NULL;
+}
+
+void ODPathIndex::Build( PathList *pPaths )
+{
+    m_GUIDs.clear();
+    m_Fingerprints.clear();
+    m_PointUse.clear();
+    for( wxPathListNode *node = pPaths->GetFirst(); node; node = node->GetNext() )
+        Add( node->GetData() );
+}
+
+void ODPathIndex::Add( ODPath *pPath )
+{
+    if( m_GUIDs.find( pPath->m_GUID ) == m_GUIDs.end() )
+        m_GUIDs[ pPath->m_GUID ] = pPath;
+    if( !pPath->m_bIsInLayer )
+        m_Fingerprints[ Fingerprint( pPath ) ].push_back( pPath );
+    for( wxODPointListNode *node = pPath->m_pODPointList->GetFirst(); node; node = node->GetNext() )
+        m_PointUse[ node->GetData() ]++;
+}
+
+ODPath *ODPathIndex::Find( const wxString &guid )
+{
+    ODPathByGUIDHash::iterator it = m_GUIDs.find( guid );
+    return it == m_GUIDs.end() ? NULL : it->second;
+}
+
+ODPath *ODPathIndex::Find( ODPath *pPath )
+{
+    ODPathFingerprintHash::iterator it = m_Fingerprints.find( Fingerprint( pPath ) );
+    if( it == m_Fingerprints.end() ) return NULL;
+    for( ODPathVector::iterator p = it->second.begin(); p != it->second.end(); ++p ) {
+        if( (*p)->m_sTypeString == pPath->m_sTypeString && (*p)->IsEqualTo( pPath ) )
+            return *p;
+    }
+    return NULL;
+}
+
+bool ODPathIndex::IsPointUsed( ODPoint *pOP )
+{
+    return m_PointUse.find( pOP ) != m_PointUse.end();
+}
+
+//  FNV-1a over the type, then the name and the position rounded to 1e-6
+//  degrees of each point in order. Points a hair either side of a rounding
+//  step hash apart, so IsEqualTo can still be true for paths not found here.
+unsigned long ODPathIndex::Fingerprint( ODPath *pPath )
+{
+    wxUint32 h = 2166136261u;
+    const wxString &type = pPath->m_sTypeString;
+    for( size_t i = 0; i < type.Len(); i++ )
+        h = ( h ^ (wxUint32)type[i].GetValue() ) * 16777619u;
+    
+    for( wxODPointListNode *node = pPath->m_pODPointList->GetFirst(); node; node = node->GetNext() ) {
+        ODPoint *pOP = node->GetData();
+        wxUint32 v[2] = { (wxUint32)(int)floor( pOP->m_lat * 1e6 + 0.5 ), (wxUint32)(int)floor( pOP->m_lon * 1e6 + 0.5 ) };
+        for( int j = 0; j < 2; j++ )
+            h = ( h ^ v[j] ) * 16777619u;
+        const wxString &name = pOP->GetName();
+        for( size_t i = 0; i < name.Len(); i++ )
+            h = ( h ^ (wxUint32)name[i].GetValue() ) * 16777619u;
+        h = ( h ^ 0xffu ) * 16777619u;        // name separator
+    }
+    return h;
+}
+
+class ODGPXImportThread : public wxThread
+{
+public:
+    ODGPXImportThread( ODGPXImport *pImport ) : wxThread( wxTHREAD_JOINABLE ) { m_pImport = pImport; }
+    
+    virtual ExitCode Entry()
+    {
+        m_pImport->ParseFiles();
+        m_pImport->ThreadDone();
+        return 0;
+    }
+    
+    ODGPXImport *m_pImport;
+};
+
+ODGPXImport::ODGPXImport( Layer *pLayer )
+{
+    m_pLayer = pLayer;
+    m_iNextFile = 0;
+    m_iThreadsRunning = 0;
+    m_bCancel = false;
+}
+
+ODGPXImport::~ODGPXImport()
+{
+    for( std::vector<ODNavObjectChanges *>::iterator it = m_Parsed.begin(); it != m_Parsed.end(); ++it )
+        delete *it;
+}
+
+void ODGPXImport::ParseFiles( void )
+{
+    for( ;; ) {
+        int l_iFile;
+        {
+            wxCriticalSectionLocker l_lock( m_csFiles );
+            if( m_bCancel || m_iNextFile >= (int)m_Files.GetCount() ) return;
+            l_iFile = m_iNextFile++;
+        }
+        
+        ODNavObjectChanges *pSet = new ODNavObjectChanges;
+        pSet->load_file( m_Files[ l_iFile ].fn_str() );
+        
+        wxCriticalSectionLocker l_lock( m_csFiles );
+        m_Parsed[ l_iFile ] = pSet;
+    }
+}
+
+void ODGPXImport::ThreadDone( void )
+{
+    wxCriticalSectionLocker l_lock( m_csFiles );
+    m_iThreadsRunning--;
+}
+
+ODNavObjectChanges *ODGPXImport::TakeParsed( int index, bool *bFinished )
+{
+    wxCriticalSectionLocker l_lock( m_csFiles );
+    ODNavObjectChanges *pSet = m_Parsed[ index ];
+    m_Parsed[ index ] = NULL;
+    *bFinished = ( m_iThreadsRunning == 0 );
+    return pSet;
+}
+
+void ODGPXImport::Cancel( void )
+{
+    wxCriticalSectionLocker l_lock( m_csFiles );
+    m_bCancel = true;
+}
+
+void ODGPXImport::Commit( ODNavObjectChanges *pSet )
+{
+    pSet->SetPointIndex( &m_Index );
+    if( m_pLayer )
+        m_pLayer->m_NoOfItems += pSet->LoadAllGPXObjectsAsLayer( m_pLayer );
+    else {
+        pSet->SetPathIndex( &m_PathIndex );
+        pSet->LoadAllGPXObjects( true );    // Import with full vizibility of names and objects
+        pSet->SetPathIndex( NULL );
+    }
+    pSet->SetPointIndex( NULL );
+}
+
+bool ODGPXImport::Load( ODGPXImportProgress progress, void *data )
+{
+    int l_iTotal = GetCount();
+    m_Parsed.assign( l_iTotal, (ODNavObjectChanges *)NULL );
+    m_iNextFile = 0;
+    m_iThreadsRunning = 0;
+    m_bCancel = false;
+    if( !l_iTotal ) return true;
+    
+    if( g_pODPointMan )
+        m_Index.Build( g_pODPointMan->GetODPointList() );
+    if( !m_pLayer )
+        m_PathIndex.Build( g_pPathList );
+    
+    int l_iThreads = wxMin( wxThread::GetCPUCount(), ODGPXIMPORT_MAX_THREADS );
+    l_iThreads = wxMin( l_iThreads, l_iTotal );
+    std::vector<ODGPXImportThread *> l_Threads;
+    for( int i = 0; i < l_iThreads; i++ ) {
+        ODGPXImportThread *pThread = new ODGPXImportThread( this );
+        if( pThread->Create() != wxTHREAD_NO_ERROR ) {
+            delete pThread;
+            break;
+        }
+        {
+            wxCriticalSectionLocker l_lock( m_csFiles );
+            m_iThreadsRunning++;
+        }
+        if( pThread->Run() != wxTHREAD_NO_ERROR ) {
+            ThreadDone();
+            delete pThread;
+            break;
+        }
+        l_Threads.push_back( pThread );
+    }
+    
+    // No threads to be had, parse everything here instead
+    if( l_Threads.empty() )
+        ParseFiles();
+    
+    // The objects are created here, in file order, as each file becomes available
+    int l_iDone = 0;
+    while( l_iDone < l_iTotal && !m_bCancel ) {
+        bool l_bFinished;
+        ODNavObjectChanges *pSet = TakeParsed( l_iDone, &l_bFinished );
+        if( pSet ) {
+            Commit( pSet );
+            delete pSet;
+            l_iDone++;
+        } else if( l_bFinished )
+            break;
+        else
+            wxMilliSleep( 10 );
+        
+        if( progress && !progress( l_iDone, l_iTotal, data ) )
+            Cancel();
+    }
+    
+    for( std::vector<ODGPXImportThread *>::iterator it = l_Threads.begin(); it != l_Threads.end(); ++it ) {
+        (*it)->Wait();
+        delete *it;
+    }
+    
+    return l_iDone == l_iTotal;
+}
@@ -0,0 +1,278 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw GPX loader names and defaults
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODGPXLoadContext.h"
+#include "TextPoint.h"
+
+#include <wx/font.h>
+#include <wx/hashmap.h>
+
+#include <errno.h>
+#include <stdlib.h>
+
+extern wxFont           g_DisplayTextFont;
+extern int              g_iTextPosition;
+extern wxColour         g_colourDefaultTextColour;
+extern wxColour         g_colourDefaultTextBackgroundColour;
+extern int              g_iTextBackgroundTransparency;
+extern bool             g_bExclusionBoundaryPoint;
+extern bool             g_bInclusionBoundaryPoint;
+extern int              g_iInclusionBoundaryPointSize;
+extern unsigned int     g_uiBoundaryPointFillTransparency;
+
+//  Keys are the string literals below, looked up with plain char pointers
+WX_DECLARE_HASH_MAP( const char *, int, wxStringHash, wxStringEqual, ODGPXNameHash );
+
+struct ODGPXName
+{
+    const char  *m_pName;
+    int         m_iId;
+};
+
+static const ODGPXName s_Names[] = {
+    { "sym",                            ODGPX_SYM },
+    { "time",                           ODGPX_TIME },
+    { "name",                           ODGPX_NAME },
+    { "desc",                           ODGPX_DESC },
+    { "link",                           ODGPX_LINK },
+    { "text",                           ODGPX_LINK_TEXT },
+    { "type",                           ODGPX_LINK_TYPE },
+    { "opencpn:text",                   ODGPX_TEXT },
+    { "opencpn:text_position",          ODGPX_TEXT_POSITION },
+    { "opencpn:text_colour",            ODGPX_TEXT_COLOUR },
+    { "opencpn:font_info",              ODGPX_FONT_INFO },
+    { "opencpn:background_colour",      ODGPX_BACKGROUND_COLOUR },
+    { "opencpn:background_transparency", ODGPX_BACKGROUND_TRANSPARENCY },
+    { "opencpn:type",                   ODGPX_TYPE },
+    { "opencpn:viz",                    ODGPX_VIZ },
+    { "opencpn:viz_name",               ODGPX_VIZ_NAME },
+    { "opencpn:guid",                   ODGPX_GUID },
+    { "opencpn:auto_name",              ODGPX_AUTO_NAME },
+    { "opencpn:shared",                 ODGPX_SHARED },
+    { "opencpn:arrival_radius",         ODGPX_ARRIVAL_RADIUS },
+    { "opencpn:ODPoint_range_rings",    ODGPX_RANGE_RINGS },
+    { "opencpn:boundary_type",          ODGPX_BOUNDARY_TYPE },
+    { "opencpn:boundary_point_style",   ODGPX_BOUNDARY_POINT_STYLE },
+    { "opencpn:natural_scale",          ODGPX_NATURAL_SCALE },
+    { "opencpn:display_text_when",      ODGPX_DISPLAY_TEXT_WHEN },
+    { "opencpn:ODPoint",                ODGPX_ODPOINT },
+    { "opencpn:active",                 ODGPX_ACTIVE },
+    { "opencpn:style",                  ODGPX_STYLE },
+    { "opencpn:time_display",           ODGPX_TIME_DISPLAY },
+    { "opencpn:persistence",            ODGPX_PERSISTENCE },
+    { "opencpn:show_arrow",             ODGPX_SHOW_ARROW },
+    { "opencpn:VRM",                    ODGPX_VRM },
+    { "opencpn:fixed_end_position",     ODGPX_FIXED_END_POSITION },
+    { "opencpn:DRSOG",                  ODGPX_DR_SOG },
+    { "opencpn:DRCOG",                  ODGPX_DR_COG },
+    { "opencpn:DRLength",               ODGPX_DR_LENGTH },
+    { "opencpn:DRLengthNM",             ODGPX_DR_LENGTH_NM },
+    { "opencpn:DRPointIterval",         ODGPX_DR_POINT_INTERVAL },
+    { "opencpn:DRPointItervalNM",       ODGPX_DR_POINT_INTERVAL_NM },
+    { "opencpn:DRLengthType",           ODGPX_DR_LENGTH_TYPE },
+    { "opencpn:DRIntervalType",         ODGPX_DR_INTERVAL_TYPE },
+    { "opencpn:DRDistanceUnits",        ODGPX_DR_DISTANCE_UNITS },
+    { "opencpn:DRTimeUnits",            ODGPX_DR_TIME_UNITS },
+
+    { "size",                           ODGPX_ATTR_SIZE },
+    { "family",                         ODGPX_ATTR_FAMILY },
+    { "style",                          ODGPX_ATTR_STYLE },
+    { "weight",                         ODGPX_ATTR_WEIGHT },
+    { "underline",                      ODGPX_ATTR_UNDERLINE },
+    { "strikethrough",                  ODGPX_ATTR_STRIKETHROUGH },
+    { "face",                           ODGPX_ATTR_FACE },
+    { "encoding",                       ODGPX_ATTR_ENCODING },
+    { "number",                         ODGPX_ATTR_NUMBER },
+    { "step",                           ODGPX_ATTR_STEP },
+    { "units",                          ODGPX_ATTR_UNITS },
+    { "visible",                        ODGPX_ATTR_VISIBLE },
+    { "colour",                         ODGPX_ATTR_COLOUR },
+    { "width",                          ODGPX_ATTR_WIDTH },
+    { "line_style",                     ODGPX_ATTR_LINE_STYLE },
+    { "fill_transparency",              ODGPX_ATTR_FILL_TRANSPARENCY },
+    { "inclusion_fill_size",            ODGPX_ATTR_INCLUSION_FILL_SIZE },
+    { "active_colour",                  ODGPX_ATTR_ACTIVE_COLOUR },
+    { "active_fillcolour",              ODGPX_ATTR_ACTIVE_FILLCOLOUR },
+    { "inactive_colour",                ODGPX_ATTR_INACTIVE_COLOUR },
+    { "inactive_fillcolour",            ODGPX_ATTR_INACTIVE_FILLCOLOUR },
+    { "inclusion_boundary_size",        ODGPX_ATTR_INCLUSION_BOUNDARY_SIZE }
+};
+
+void ODGPXPathRecord::Reset( const wxString &type )
+{
+    m_sType = type;
+    m_sName.Clear();
+    m_sDesc.Clear();
+    m_sGUID.Clear();
+    m_sTimeDisplay.Clear();
+    m_iFirstLink = 0;
+    m_iLinks = 0;
+    m_iFirstPoint = 0;
+    m_iPoints = 0;
+    m_iFields = 0;
+    m_bPropViz = false;
+    m_bViz = true;
+    m_bActive = false;
+    
+    // only read back when their ODGPX_PATH_* bit is set
+    m_wxcActiveLineColour = wxNullColour;
+    m_wxcActiveFillColour = wxNullColour;
+    m_wxcInActiveLineColour = wxNullColour;
+    m_wxcInActiveFillColour = wxNullColour;
+    m_iStyle = 0;
+    m_iWidth = 0;
+    m_uiFillTransparency = 0;
+    m_iInclusionBoundarySize = 0;
+    m_bExclusionBoundary = false;
+    m_bInclusionBoundary = false;
+    m_iPersistence = 0;
+    m_bDrawArrow = false;
+    m_bVRM = false;
+    m_bFixedEndPosition = false;
+    m_dSoG = 0.;
+    m_iCoG = 0;
+    m_dDRPathLength = 0.;
+    m_dTotalLengthNM = 0.;
+    m_dDRPointInterval = 0.;
+    m_dDRPointIntervalNM = 0.;
+    m_iLengthType = 0;
+    m_iIntervalType = 0;
+    m_iDistanceUnits = 0;
+    m_iTimeUnits = 0;
+}
+
+void ODGPXRecordSet::Clear( void )
+{
+    m_Points.clear();
+    m_Paths.clear();
+    m_Links.clear();
+    m_Objects.clear();
+}
+
+static ODGPXNameHash s_NameHash;
+
+static void FillNameHash( void )
+{
+    if( !s_NameHash.empty() ) return;
+    for( size_t i = 0; i < sizeof( s_Names ) / sizeof( s_Names[0] ); i++ )
+        s_NameHash[ s_Names[i].m_pName ] = s_Names[i].m_iId;
+}
+
+//  A colour with data of its own, where assigning would share the original's
+static wxColour CopyColour( const wxColour &c )
+{
+    if( !c.IsOk() ) return wxColour();
+    return wxColour( c.Red(), c.Green(), c.Blue(), c.Alpha() );
+}
+
+//  Runs on the GUI thread. The colours and face name are copied by value, not
+//  shared with the settings, so the records can then be read on another thread.
+void ODGPXLoadContext::Snapshot( void )
+{
+    FillNameHash();
+    ODGPXPointRecord &d = m_PointDefaults;
+    
+    d.m_dLat = 0.;
+    d.m_dLon = 0.;
+    d.m_iFirstLink = 0;
+    d.m_iLinks = 0;
+    d.m_bPropViz = false;
+    d.m_bViz = false;
+    d.m_bPropVizName = false;
+    d.m_bVizName = false;
+    d.m_bAutoName = false;
+    d.m_bShared = false;
+    d.m_dArrivalRadius = 0.;
+    
+    d.m_iTextPointFontSize = g_DisplayTextFont.GetPointSize();
+    d.m_iTextPointFontFamily = g_DisplayTextFont.GetFamily();
+    d.m_iTextPointFontStyle = g_DisplayTextFont.GetStyle();
+    d.m_iTextPointFontWeight = g_DisplayTextFont.GetWeight();
+    d.m_bTextPointFontUnderline = g_DisplayTextFont.GetUnderlined();
+#if wxCHECK_VERSION(3,0,0) 
+    d.m_bTextPointFontStrikethrough = g_DisplayTextFont.GetStrikethrough();
+#else
+    d.m_bTextPointFontStrikethrough = false;
+#endif
+    d.m_wxsTextPointFontFace = wxString( g_DisplayTextFont.GetFaceName().wc_str() );
+    d.m_iTextPointFontEncoding = g_DisplayTextFont.GetEncoding();
+    d.m_iTextPosition = g_iTextPosition;
+    d.m_colourTextColour = CopyColour( g_colourDefaultTextColour );
+    d.m_colourBackgroundColour = CopyColour( g_colourDefaultTextBackgroundColour );
+    d.m_iBackgroundTransparency = g_iTextBackgroundTransparency;
+    d.m_dNaturalScale = 0.;
+    d.m_iDisplayTextWhen = ID_TEXTPOINT_DISPLAY_TEXT_SHOW_ALWAYS;
+    
+    d.m_iODPointRangeRingsNumber = -1;
+    d.m_fODPointRangeRingsStep = -1;
+    d.m_iODPointRangeRingsStepUnits = -1;
+    d.m_bODPointRangeRingsVisible = false;
+    d.m_wxcODPointRangeRingsColour.Set( _T( "#FFFFFF" ) );
+    d.m_iODPointRangeRingWidth = 0;
+    d.m_iODPointRangeRingStyle = 0;
+    
+    d.m_bExclusionBoundaryPoint = g_bExclusionBoundaryPoint;
+    d.m_bInclusionBoundaryPoint = g_bInclusionBoundaryPoint;
+    d.m_iInclusionBoundaryPointSize = g_iInclusionBoundaryPointSize;
+    d.m_uiBoundaryPointFillTransparency = g_uiBoundaryPointFillTransparency;
+    m_bValid = true;
+}
+
+void ODGPXLoadContext::ResetPoint( ODGPXPointRecord *pRec, const wxString &sym, const wxString &guid )
+{
+    if( !m_bValid ) Snapshot();
+    *pRec = m_PointDefaults;
+    pRec->m_sSym = sym;
+    pRec->m_sGUID = guid;
+}
+
+int ODGPXLoadContext::Lookup( const char *name )
+{
+    FillNameHash();
+    ODGPXNameHash::iterator it = s_NameHash.find( name );
+    return it == s_NameHash.end() ? ODGPX_UNKNOWN : it->second;
+}
+
+bool ODGPXLoadContext::ToLong( const char *s, long *v )
+{
+    char *end;
+    errno = 0;
+    *v = strtol( s, &end, 10 );
+    return !*end && end != s && errno != ERANGE;
+}
+
+bool ODGPXLoadContext::ToDouble( const char *s, double *v )
+{
+    char *end;
+    errno = 0;
+    *v = strtod( s, &end );
+    return !*end && end != s && errno != ERANGE;
+}
@@ -0,0 +1,508 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw lightweight JSON message reader and writer
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODJSON.h"
+
+#include <stdio.h>
+#include <string.h>
+
+ODJSONReader::ODJSONReader()
+{
+    m_pText = NULL;
+}
+
+bool ODJSONReader::Parse( const wxString &text )
+{
+    m_pText = &text;
+    m_Fields.clear();
+
+    const wxChar *p = text.wc_str();
+    size_t len = text.length();
+    size_t pos = 0;
+    SkipSpace( p, len, &pos );
+    return ParseObject( pos, len );
+}
+
+bool ODJSONReader::SetError( const wxChar *msg, size_t pos )
+{
+    m_sError.Printf( _T("%s at character %lu"), msg, (unsigned long)pos );
+    m_Fields.clear();
+    return false;
+}
+
+void ODJSONReader::SkipSpace( const wxChar *p, size_t len, size_t *pos )
+{
+    while( *pos < len && ( p[*pos] == ' ' || p[*pos] == '\t' || p[*pos] == '\n' || p[*pos] == '\r' ) )
+        ( *pos )++;
+}
+
+bool ODJSONReader::SkipString( const wxChar *p, size_t len, size_t *pos, bool *escaped )
+{
+    // *pos is on the opening quote
+    for( ( *pos )++; *pos < len; ( *pos )++ ) {
+        if( p[*pos] == '\\' ) {
+            *escaped = true;
+            ( *pos )++;
+        } else if( p[*pos] == '"' ) {
+            ( *pos )++;
+            return true;
+        }
+    }
+    return SetError( _T("Unterminated string"), *pos );
+}
+
+bool ODJSONReader::SkipNested( const wxChar *p, size_t len, size_t *pos )
+{
+    int depth = 0;
+    bool escaped;
+    while( *pos < len ) {
+        wxChar c = p[*pos];
+        if( c == '"' ) {
+            if( !SkipString( p, len, pos, &escaped ) ) return false;
+            continue;
+        }
+        if( c == '{' || c == '[' ) depth++;
+        else if( c == '}' || c == ']' ) {
+            if( --depth == 0 ) {
+                ( *pos )++;
+                return true;
+            }
+        }
+        ( *pos )++;
+    }
+    return SetError( _T("Unterminated object or array"), *pos );
+}
+
+bool ODJSONReader::ParseValue( const wxChar *p, size_t len, size_t *pos, ODJSONField *field )
+{
+    if( *pos >= len ) return SetError( _T("Missing value"), *pos );
+
+    field->m_bEscaped = false;
+    wxChar c = p[*pos];
+    if( c == '"' ) {
+        field->m_cType = ODJSON_STRING;
+        field->m_iValueStart = *pos + 1;
+        if( !SkipString( p, len, pos, &field->m_bEscaped ) ) return false;
+        field->m_iValueLen = *pos - 1 - field->m_iValueStart;
+        return true;
+    }
+
+    field->m_iValueStart = *pos;
+    if( c == '{' || c == '[' ) {
+        field->m_cType = ( c == '{' ) ? ODJSON_OBJECT : ODJSON_ARRAY;
+        if( !SkipNested( p, len, pos ) ) return false;
+    } else {
+        while( *pos < len && p[*pos] != ',' && p[*pos] != '}' && p[*pos] != ']' &&
+               p[*pos] != ' ' && p[*pos] != '\t' && p[*pos] != '\n' && p[*pos] != '\r' )
+            ( *pos )++;
+        size_t l_len = *pos - field->m_iValueStart;
+        const wxChar *v = p + field->m_iValueStart;
+        if( l_len == 4 && v[0] == 't' && v[1] == 'r' && v[2] == 'u' && v[3] == 'e' )
+            field->m_cType = ODJSON_BOOL;
+        else if( l_len == 5 && v[0] == 'f' && v[1] == 'a' && v[2] == 'l' && v[3] == 's' && v[4] == 'e' )
+            field->m_cType = ODJSON_BOOL;
+        else if( l_len == 4 && v[0] == 'n' && v[1] == 'u' && v[2] == 'l' && v[3] == 'l' )
+            field->m_cType = ODJSON_NULL;
+        else if( l_len && ( v[0] == '-' || ( v[0] >= '0' && v[0] <= '9' ) ) )
+            field->m_cType = ODJSON_NUMBER;
+        else
+            return SetError( _T("Invalid value"), field->m_iValueStart );
+    }
+    field->m_iValueLen = *pos - field->m_iValueStart;
+    return true;
+}
+
+bool ODJSONReader::ParseObject( size_t start, size_t end )
+{
+    const wxChar *p = m_pText->wc_str();
+    size_t pos = start;
+
+    if( pos >= end || p[pos] != '{' ) return SetError( _T("Expected '{'"), pos );
+    pos++;
+    SkipSpace( p, end, &pos );
+    if( pos < end && p[pos] == '}' ) return true;
+
+    for( ;; ) {
+        ODJSONField field;
+        bool escaped = false;
+
+        if( pos >= end || p[pos] != '"' ) return SetError( _T("Expected member name"), pos );
+        field.m_iKeyStart = pos + 1;
+        if( !SkipString( p, end, &pos, &escaped ) ) return false;
+        field.m_iKeyLen = pos - 1 - field.m_iKeyStart;
+
+        SkipSpace( p, end, &pos );
+        if( pos >= end || p[pos] != ':' ) return SetError( _T("Expected ':'"), pos );
+        pos++;
+        SkipSpace( p, end, &pos );
+
+        if( !ParseValue( p, end, &pos, &field ) ) return false;
+        m_Fields.push_back( field );
+
+        SkipSpace( p, end, &pos );
+        if( pos < end && p[pos] == ',' ) {
+            pos++;
+            SkipSpace( p, end, &pos );
+            continue;
+        }
+        if( pos < end && p[pos] == '}' ) return true;
+        return SetError( _T("Expected ',' or '}'"), pos );
+    }
+}
+
+ODJSONField *ODJSONReader::Find( const char *key )
+{
+    if( !m_pText ) return NULL;
+
+    const wxChar *p = m_pText->wc_str();
+    size_t l_len = strlen( key );
+    for( size_t i = 0; i < m_Fields.size(); i++ ) {
+        ODJSONField *field = &m_Fields[i];
+        if( field->m_iKeyLen != l_len ) continue;
+        const wxChar *k = p + field->m_iKeyStart;
+        size_t j = 0;
+        while( j < l_len && k[j] == (wxChar)(unsigned char)key[j] ) j++;
+        if( j == l_len ) return field;
+    }
+    return NULL;
+}
+
+bool ODJSONReader::HasMember( const char *key )
+{
+    return Find( key ) != NULL;
+}
+
+//  Reads the four hex digits of a \u escape that starts after p[*i]
+static bool ReadHex4( const wxChar *p, size_t len, size_t *i, unsigned long *code )
+{
+    *code = 0;
+    if( *i + 4 >= len ) return false;
+    for( int n = 0; n < 4; n++ ) {
+        wxChar h = p[++*i];
+        *code <<= 4;
+        if( h >= '0' && h <= '9' ) *code += h - '0';
+        else if( h >= 'a' && h <= 'f' ) *code += h - 'a' + 10;
+        else if( h >= 'A' && h <= 'F' ) *code += h - 'A' + 10;
+        else return false;
+    }
+    return true;
+}
+
+bool ODJSONReader::Unescape( ODJSONField *field, wxString *value )
+{
+    const wxChar *p = m_pText->wc_str() + field->m_iValueStart;
+    size_t len = field->m_iValueLen;
+
+    value->Empty();
+    value->reserve( len );
+    for( size_t i = 0; i < len; i++ ) {
+        if( p[i] != '\\' || i + 1 >= len ) {
+            *value += p[i];
+            continue;
+        }
+        switch( p[++i] ) {
+            case 'b': *value += wxT('\b'); break;
+            case 'f': *value += wxT('\f'); break;
+            case 'n': *value += wxT('\n'); break;
+            case 'r': *value += wxT('\r'); break;
+            case 't': *value += wxT('\t'); break;
+            case 'u': {
+                unsigned long code;
+                if( !ReadHex4( p, len, &i, &code ) ) return false;
+                if( code >= 0xDC00 && code <= 0xDFFF ) return false;    // low surrogate on its own
+                if( code >= 0xD800 && code <= 0xDBFF ) {
+                    //  A character outside the BMP comes as a high surrogate
+                    //  escape followed by a low one
+                    unsigned long low;
+                    if( i + 2 >= len || p[i + 1] != '\\' || p[i + 2] != 'u' ) return false;
+                    i += 2;
+                    if( !ReadHex4( p, len, &i, &low ) ) return false;
+                    if( low < 0xDC00 || low > 0xDFFF ) return false;
+#if wxUSE_UNICODE_UTF16
+                    *value += (wxChar)code;
+                    *value += (wxChar)low;
+                    break;
+#else
+                    code = 0x10000 + ( ( code - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+#endif
+                }
+                *value += (wxChar)code;
+                break;
+            }
+            default:
+                *value += p[i];
+                break;
+        }
+    }
+    return true;
+}
+
+bool ODJSONReader::IsString( const char *key, const char *value )
+{
+    ODJSONField *field = Find( key );
+    if( !field || field->m_cType != ODJSON_STRING ) return false;
+
+    if( field->m_bEscaped ) {
+        wxString l_sValue;
+        return Unescape( field, &l_sValue ) && l_sValue == wxString::FromUTF8( value );
+    }
+
+    size_t l_len = strlen( value );
+    if( field->m_iValueLen != l_len ) return false;
+    const wxChar *v = m_pText->wc_str() + field->m_iValueStart;
+    for( size_t i = 0; i < l_len; i++ )
+        if( v[i] != (wxChar)(unsigned char)value[i] ) return false;
+    return true;
+}
+
+bool ODJSONReader::GetString( const char *key, wxString *value )
+{
+    ODJSONField *field = Find( key );
+    if( !field ) return false;
+
+    if( field->m_cType == ODJSON_STRING && field->m_bEscaped )
+        return Unescape( field, value );
+
+    // Other types are returned as their JSON text, the way wxJSONValue::AsString does for numbers
+    value->assign( *m_pText, field->m_iValueStart, field->m_iValueLen );
+    return true;
+}
+
+bool ODJSONReader::GetDouble( const char *key, double *value )
+{
+    ODJSONField *field = Find( key );
+    if( !field || ( field->m_cType != ODJSON_NUMBER && field->m_cType != ODJSON_STRING ) ) return false;
+
+    m_sScratch.assign( *m_pText, field->m_iValueStart, field->m_iValueLen );
+    return m_sScratch.ToCDouble( value );
+}
+
+bool ODJSONReader::GetInt( const char *key, int *value )
+{
+    ODJSONField *field = Find( key );
+    if( !field || ( field->m_cType != ODJSON_NUMBER && field->m_cType != ODJSON_STRING ) ) return false;
+
+    long l_value;
+    m_sScratch.assign( *m_pText, field->m_iValueStart, field->m_iValueLen );
+    if( !m_sScratch.ToCLong( &l_value ) ) return false;
+    *value = (int)l_value;
+    return true;
+}
+
+bool ODJSONReader::GetBool( const char *key, bool *value )
+{
+    ODJSONField *field = Find( key );
+    if( !field || field->m_cType != ODJSON_BOOL ) return false;
+
+    *value = ( (*m_pText)[ field->m_iValueStart ] == 't' );
+    return true;
+}
+
+int ODJSONReader::GetArrayCount( const char *key )
+{
+    ODJSONField *field = Find( key );
+    if( !field || field->m_cType != ODJSON_ARRAY ) return 0;
+
+    const wxChar *p = m_pText->wc_str();
+    size_t end = field->m_iValueStart + field->m_iValueLen - 1;     // closing ']'
+    size_t pos = field->m_iValueStart + 1;
+    int count = 0;
+
+    SkipSpace( p, end, &pos );
+    while( pos < end ) {
+        ODJSONField element;
+        if( !ParseValue( p, end, &pos, &element ) ) return 0;
+        count++;
+        SkipSpace( p, end, &pos );
+        if( pos < end && p[pos] == ',' ) pos++;
+        SkipSpace( p, end, &pos );
+    }
+    return count;
+}
+
+//  Start with *cursor set to 0, each call moves it past the object returned
+bool ODJSONReader::GetNextArrayObject( const char *key, size_t *cursor, ODJSONReader *object )
+{
+    ODJSONField *field = Find( key );
+    if( !field || field->m_cType != ODJSON_ARRAY ) return false;
+
+    const wxChar *p = m_pText->wc_str();
+    size_t end = field->m_iValueStart + field->m_iValueLen - 1;
+    size_t pos = *cursor ? *cursor : field->m_iValueStart + 1;
+
+    for( ;; ) {
+        SkipSpace( p, end, &pos );
+        if( pos >= end ) {
+            *cursor = end;
+            return false;
+        }
+
+        ODJSONField element;
+        if( !ParseValue( p, end, &pos, &element ) ) return false;
+        SkipSpace( p, end, &pos );
+        if( pos < end && p[pos] == ',' ) pos++;
+        *cursor = pos;
+
+        if( element.m_cType == ODJSON_OBJECT ) {
+            object->m_pText = m_pText;
+            object->m_Fields.clear();
+            return object->ParseObject( element.m_iValueStart, element.m_iValueStart + element.m_iValueLen );
+        }
+    }
+}
+
+ODJSONWriter::ODJSONWriter()
+{
+    m_bFirst = true;
+}
+
+void ODJSONWriter::Begin( void )
+{
+    // Truncate keeps the buffer's allocation for the next message
+    m_sBuffer.Truncate( 0 );
+    m_sBuffer += wxT('{');
+    m_bFirst = true;
+}
+
+const wxString &ODJSONWriter::End( void )
+{
+    m_sBuffer += wxT('}');
+    return m_sBuffer;
+}
+
+void ODJSONWriter::AddKey( const char *key )
+{
+    if( !m_bFirst ) m_sBuffer += wxT(',');
+    m_bFirst = false;
+    m_sBuffer += wxT('"');
+    for( const char *k = key; *k; k++ )
+        m_sBuffer += (wxChar)(unsigned char)*k;
+    m_sBuffer += wxT("\":");
+}
+
+void ODJSONWriter::AppendEscaped( const wxString &value )
+{
+    m_sBuffer += wxT('"');
+    for( wxString::const_iterator it = value.begin(); it != value.end(); ++it ) {
+        wxChar c = *it;
+        switch( c ) {
+            case '"':  m_sBuffer += wxT("\\\""); break;
+            case '\\': m_sBuffer += wxT("\\\\"); break;
+            case '\b': m_sBuffer += wxT("\\b"); break;
+            case '\f': m_sBuffer += wxT("\\f"); break;
+            case '\n': m_sBuffer += wxT("\\n"); break;
+            case '\r': m_sBuffer += wxT("\\r"); break;
+            case '\t': m_sBuffer += wxT("\\t"); break;
+            default:
+                if( c < 0x20 ) {
+                    char buf[8];
+                    snprintf( buf, sizeof( buf ), "\\u%04x", (unsigned int)c );
+                    m_sBuffer += wxString::FromAscii( buf );
+                } else
+                    m_sBuffer += c;
+                break;
+        }
+    }
+    m_sBuffer += wxT('"');
+}
+
+void ODJSONWriter::AddString( const char *key, const wxString &value )
+{
+    AddKey( key );
+    AppendEscaped( value );
+}
+
+void ODJSONWriter::AddString( const char *key, const char *value )
+{
+    AddKey( key );
+    m_sBuffer += wxT('"');
+    for( const char *v = value; *v; v++ )
+        m_sBuffer += (wxChar)(unsigned char)*v;
+    m_sBuffer += wxT('"');
+}
+
+void ODJSONWriter::AddDouble( const char *key, double value )
+{
+    AddKey( key );
+    if( !wxFinite( value ) ) {
+        m_sBuffer += wxT("null");
+        return;
+    }
+
+    char buf[32];
+    snprintf( buf, sizeof( buf ), "%.10g", value );
+    for( char *c = buf; *c; c++ ) {
+        // the C library follows the locale, JSON always wants a point
+        m_sBuffer += ( *c == ',' ) ? wxT('.') : (wxChar)*c;
+    }
+}
+
+void ODJSONWriter::AddInt( const char *key, long value )
+{
+    AddKey( key );
+
+    char buf[32];
+    snprintf( buf, sizeof( buf ), "%ld", value );
+    for( char *c = buf; *c; c++ )
+        m_sBuffer += (wxChar)*c;
+}
+
+void ODJSONWriter::AddBool( const char *key, bool value )
+{
+    AddKey( key );
+    m_sBuffer += value ? wxT("true") : wxT("false");
+}
+
+void ODJSONWriter::BeginArray( const char *key )
+{
+    AddKey( key );
+    m_sBuffer += wxT('[');
+    m_bFirst = true;
+}
+
+void ODJSONWriter::EndArray( void )
+{
+    m_sBuffer += wxT(']');
+    m_bFirst = false;
+}
+
+void ODJSONWriter::BeginObject( void )
+{
+    if( !m_bFirst ) m_sBuffer += wxT(',');
+    m_sBuffer += wxT('{');
+    m_bFirst = true;
+}
+
+void ODJSONWriter::EndObject( void )
+{
+    m_sBuffer += wxT('}');
+    m_bFirst = false;
+}
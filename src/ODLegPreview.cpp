@@ -0,0 +1,128 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw interactive path leg preview
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODLegPreview.h"
+#include "ocpn_draw_pi.h"
+#include "ODdc.h"
+#include "ODTextCache.h"
+#include "PathMan.h"
+#include "cutil.h"
+
+extern ocpn_draw_pi     *g_ocpn_draw_pi;
+extern PathMan          *g_pPathMan;
+extern ODTextCache      *g_pODTextCache;
+extern bool             g_bShowMag;
+
+ODLegPreview::ODLegPreview()
+{
+    m_bValid = false;
+    m_pFont = NULL;
+    m_pLinePen = NULL;
+    m_pTextPen = NULL;
+    m_iBearing = -1;
+    m_bMag = false;
+    m_dDist = -1.;
+    m_LegInfoExtents = wxSize( 0, 0 );
+}
+
+void ODLegPreview::Refresh( void )
+{
+    m_pFont = GetOCPNScaledFont_PlugIn( wxS("OD_PathLegInfoRollover"), 0 );
+    m_pLinePen = g_pPathMan->GetActivePathPen();     // the path being drawn is active
+    GetGlobalColor( wxS("YELO1"), &m_BackColour );
+    GetGlobalColor( wxS("UBLCK"), &m_TextColour );
+    m_pTextPen = wxThePenList->FindOrCreatePen( m_TextColour, 1, wxPENSTYLE_SOLID );
+
+    // units or font may have changed, force the label to be rebuilt
+    m_iBearing = -1;
+    m_bValid = true;
+}
+
+wxFont *ODLegPreview::GetFont( void )
+{
+    if( !m_bValid ) Refresh();
+    return m_pFont;
+}
+
+void ODLegPreview::DrawSegment( ODDC &dc, const wxPoint &from, const wxPoint &to, PlugIn_ViewPort &VP )
+{
+    if( !m_bValid ) Refresh();
+
+    //    Same early exit and clipping as ODPath::RenderSegment
+    wxRect r( 0, 0, VP.pix_width, VP.pix_height );
+    wxRect s( from.x, from.y, 1, 1 );
+    s.Union( wxRect( to.x, to.y, 1, 1 ) );
+    if( !r.Intersects( s ) ) return;
+
+    int x0 = from.x;
+    int y0 = from.y;
+    int x1 = to.x;
+    int y1 = to.y;
+    if( Visible == cohen_sutherland_line_clip_i( &x0, &y0, &x1, &y1, 0, VP.pix_width, 0, VP.pix_height ) ) {
+        dc.SetPen( *m_pLinePen );
+        dc.StrokeLine( x0, y0, x1, y1 );
+    }
+}
+
+void ODLegPreview::DrawLegInfo( ODDC &dc, const wxPoint &ref_point, double brg, double dist )
+{
+    if( !m_bValid ) Refresh();
+
+    int l_iBearing = (int)g_ocpn_draw_pi->GetTrueOrMag( brg );
+    if( l_iBearing != m_iBearing || g_bShowMag != m_bMag || dist != m_dDist ) {
+        m_sLegInfo.Empty();
+        if( g_bShowMag )
+            m_sLegInfo << wxString::Format( wxString("%03d°(M)  ", wxConvUTF8 ), l_iBearing );
+        else
+            m_sLegInfo << wxString::Format( wxString("%03d°  ", wxConvUTF8 ), l_iBearing );
+        m_sLegInfo << wxS(" ") << g_ocpn_draw_pi->FormatDistanceAdaptive( dist );
+        m_LegInfoExtents = g_pODTextCache->GetTextExtent( *m_pFont, m_sLegInfo );
+
+        m_iBearing = l_iBearing;
+        m_bMag = g_bShowMag;
+        m_dDist = dist;
+    }
+
+    int hilite_offset = 3;
+    DrawLabel( dc, ref_point.x - m_LegInfoExtents.x, ref_point.y + hilite_offset, m_sLegInfo, m_LegInfoExtents );
+}
+
+void ODLegPreview::DrawLabel( ODDC &dc, int xp, int yp, const wxString &s, const wxSize &extents )
+{
+    if( !m_bValid ) Refresh();
+
+    dc.SetFont( *m_pFont );
+    g_ocpn_draw_pi->AlphaBlending( dc, xp, yp, extents.x, extents.y, 0.0, m_BackColour, 172 );
+
+    dc.SetTextForeground( m_TextColour );
+    dc.SetPen( *m_pTextPen );
+    dc.DrawText( s, xp, yp );
+}
@@ -0,0 +1,183 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw navobj file compaction
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODNavObjCompactor.h"
+#include "ODNavObjectChanges.h"
+#include "ODNavObjSnapshot.h"
+
+#include <wx/filefn.h>
+
+#include <stdio.h>
+#ifdef __WXMSW__
+#include <wx/msw/wrapwin.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+class ODNavObjFileWriter : public pugi::xml_writer
+{
+public:
+    ODNavObjFileWriter( FILE *file ) { m_file = file; }
+    
+    virtual void write( const void *data, size_t size )
+    {
+        fwrite( data, 1, size, m_file );
+    }
+    
+    FILE    *m_file;
+};
+
+class ODNavObjCompactorThread : public wxThread
+{
+public:
+    ODNavObjCompactorThread( ODNavObjCompactor *pCompactor ) : wxThread( wxTHREAD_JOINABLE ) { m_pCompactor = pCompactor; }
+    
+    virtual ExitCode Entry()
+    {
+        m_pCompactor->WriteSnapshot();
+        return 0;
+    }
+    
+    ODNavObjCompactor *m_pCompactor;
+};
+
+ODNavObjCompactor::ODNavObjCompactor( const wxString &navobj_file, const wxString &pending_changes_file, const wxString &snapshot_file )
+{
+    m_sNavObjFile = navobj_file;
+    m_sPendingChangesFile = pending_changes_file;
+    m_sSnapshotFile = snapshot_file;
+    m_pSnapshot = NULL;
+    m_pThread = NULL;
+    m_bFinished = false;
+    m_bOK = false;
+}
+
+ODNavObjCompactor::~ODNavObjCompactor()
+{
+    bool l_bOK;
+    Finish( &l_bOK );
+}
+
+bool ODNavObjCompactor::Start( ODNavObjectChanges *pSnapshot )
+{
+    if( m_pSnapshot ) return false;
+    
+    m_pSnapshot = pSnapshot;
+    // The settings are only read here, the worker reads the records with them
+    m_pSnapshot->SnapshotLoadDefaults();
+    m_bFinished = false;
+    m_bOK = false;
+    
+    m_pThread = new ODNavObjCompactorThread( this );
+    if( m_pThread->Create() != wxTHREAD_NO_ERROR || m_pThread->Run() != wxTHREAD_NO_ERROR ) {
+        // No thread to be had, write it here instead
+        delete m_pThread;
+        m_pThread = NULL;
+        WriteSnapshot();
+    }
+    return true;
+}
+
+bool ODNavObjCompactor::IsBusy( void )
+{
+    if( !m_pThread ) return false;
+    wxCriticalSectionLocker l_lock( m_csState );
+    return !m_bFinished;
+}
+
+//  Waits for the current rewrite, if there is one, and reports how it went
+bool ODNavObjCompactor::Finish( bool *pbOK )
+{
+    if( !m_pSnapshot ) return false;
+    
+    if( m_pThread ) {
+        m_pThread->Wait();
+        delete m_pThread;
+        m_pThread = NULL;
+    }
+    delete m_pSnapshot;
+    m_pSnapshot = NULL;
+    
+    *pbOK = m_bOK;
+    return true;
+}
+
+void ODNavObjCompactor::WriteSnapshot( void )
+{
+    bool l_bOK = ReplaceFile( *m_pSnapshot, m_sNavObjFile );
+    
+    // The navobj file now holds everything the pending changes did
+    if( l_bOK && ::wxFileExists( m_sPendingChangesFile ) )
+        ::wxRemoveFile( m_sPendingChangesFile );
+    
+    // The old snapshot no longer matches the navobj file, make one from the document just written
+    if( l_bOK ) {
+        ODGPXRecordSet l_records;
+        m_pSnapshot->ReadAllGPXRecords( &l_records, false );
+        if( !ODNavObjSnapshot::Write( m_sSnapshotFile, m_sNavObjFile, l_records ) )
+            wxLogMessage( _T("Unable to save ") + m_sSnapshotFile );
+    }
+    
+    wxCriticalSectionLocker l_lock( m_csState );
+    m_bOK = l_bOK;
+    m_bFinished = true;
+}
+
+bool ODNavObjCompactor::ReplaceFile( pugi::xml_document &doc, const wxString &filename )
+{
+    wxString l_sTemp = filename + wxT(".tmp");
+    FILE *l_file = wxFopen( l_sTemp, wxT("wb") );
+    if( !l_file ) return false;
+    
+    ODNavObjFileWriter l_writer( l_file );
+    doc.save( l_writer, "  " );
+    
+    // The data has to be on disk before the rename makes it the navobj file
+    bool l_bOK = !ferror( l_file ) && fflush( l_file ) == 0;
+#ifdef __WXMSW__
+    if( l_bOK ) l_bOK = ( _commit( _fileno( l_file ) ) == 0 );
+#else
+    if( l_bOK ) l_bOK = ( fsync( fileno( l_file ) ) == 0 );
+#endif
+    if( fclose( l_file ) != 0 ) l_bOK = false;
+    
+    if( l_bOK ) {
+#ifdef __WXMSW__
+        l_bOK = ( MoveFileEx( l_sTemp.fn_str(), filename.fn_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0 );
+#else
+        l_bOK = ( rename( l_sTemp.fn_str(), filename.fn_str() ) == 0 );
+#endif
+    }
+    
+    if( !l_bOK && ::wxFileExists( l_sTemp ) ) ::wxRemoveFile( l_sTemp );
+    return l_bOK;
+}
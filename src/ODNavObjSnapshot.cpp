@@ -0,0 +1,512 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw binary cache of the navobj file
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODNavObjSnapshot.h"
+
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <string.h>
+#include <vector>
+
+static const char s_Magic[8] = { 'O', 'D', 'N', 'A', 'V', 'S', 'N', 'P' };
+#define ODNAVOBJ_SNAPSHOT_BYTE_ORDER    0x01020304
+
+#define ODNAVOBJ_FNV_OFFSET     wxULL( 0xcbf29ce484222325 )
+#define ODNAVOBJ_FNV_PRIME      wxULL( 0x100000001b3 )
+
+struct ODNavObjSnapshotHeader
+{
+    char        m_Magic[8];
+    wxUint32    m_iVersion;
+    wxUint32    m_iByteOrder;
+    wxUint64    m_iXMLSize;
+    wxInt64     m_iXMLTime;
+    wxUint64    m_iXMLHash;
+    wxUint64    m_iPayloadSize;
+    wxUint64    m_iPayloadHash;
+};
+
+static wxUint64 Hash( const unsigned char *p, size_t len, wxUint64 h = ODNAVOBJ_FNV_OFFSET )
+{
+    for( size_t i = 0; i < len; i++ ) {
+        h ^= p[i];
+        h *= ODNAVOBJ_FNV_PRIME;
+    }
+    return h;
+}
+
+//  Size, modification time and hash of the navobj file
+static bool StatXML( const wxString &filename, ODNavObjSnapshotHeader *pHeader )
+{
+    wxFile l_file;
+    if( !::wxFileExists( filename ) || !l_file.Open( filename ) ) return false;
+    
+    unsigned char l_buf[ 64 * 1024 ];
+    wxUint64 l_size = 0;
+    wxUint64 l_hash = ODNAVOBJ_FNV_OFFSET;
+    for( ;; ) {
+        ssize_t l_read = l_file.Read( l_buf, sizeof( l_buf ) );
+        if( l_read == wxInvalidOffset ) return false;
+        if( l_read == 0 ) break;
+        l_hash = Hash( l_buf, l_read, l_hash );
+        l_size += l_read;
+    }
+    
+    pHeader->m_iXMLSize = l_size;
+    pHeader->m_iXMLTime = ::wxFileModificationTime( filename );
+    pHeader->m_iXMLHash = l_hash;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  Payload encoding, all in the writing machine's byte order
+//----------------------------------------------------------------------------
+
+class ODSnapshotWriter
+{
+public:
+    void Bytes( const void *p, size_t len )
+    {
+        const unsigned char *c = (const unsigned char *)p;
+        m_Buffer.insert( m_Buffer.end(), c, c + len );
+    }
+    void U8( unsigned char v ) { m_Buffer.push_back( v ); }
+    void Bool( bool v ) { U8( v ? 1 : 0 ); }
+    void I32( wxInt32 v ) { Bytes( &v, sizeof( v ) ); }
+    void U32( wxUint32 v ) { Bytes( &v, sizeof( v ) ); }
+    void I64( wxInt64 v ) { Bytes( &v, sizeof( v ) ); }
+    void Float( float v ) { Bytes( &v, sizeof( v ) ); }
+    void Double( double v ) { Bytes( &v, sizeof( v ) ); }
+    void String( const wxString &s )
+    {
+        wxCharBuffer l_utf8 = s.ToUTF8();
+        size_t l_len = l_utf8.data() ? strlen( l_utf8.data() ) : 0;
+        U32( l_len );
+        Bytes( l_utf8.data(), l_len );
+    }
+    void Colour( const wxColour &c )
+    {
+        Bool( c.IsOk() );
+        if( c.IsOk() ) {
+            U8( c.Red() );
+            U8( c.Green() );
+            U8( c.Blue() );
+            U8( c.Alpha() );
+        }
+    }
+
+    std::vector<unsigned char>  m_Buffer;
+};
+
+//  Every read is bounds checked, after the first failure all reads return zero
+class ODSnapshotReader
+{
+public:
+    ODSnapshotReader( const unsigned char *p, size_t len ) { m_p = p; m_len = len; m_pos = 0; m_bOK = true; }
+    
+    bool Bytes( void *p, size_t len )
+    {
+        if( !m_bOK || len > m_len - m_pos ) {
+            m_bOK = false;
+            memset( p, 0, len );
+            return false;
+        }
+        memcpy( p, m_p + m_pos, len );
+        m_pos += len;
+        return true;
+    }
+    unsigned char U8( void ) { unsigned char v; Bytes( &v, sizeof( v ) ); return v; }
+    bool Bool( void ) { return U8() != 0; }
+    wxInt32 I32( void ) { wxInt32 v; Bytes( &v, sizeof( v ) ); return v; }
+    wxUint32 U32( void ) { wxUint32 v; Bytes( &v, sizeof( v ) ); return v; }
+    wxInt64 I64( void ) { wxInt64 v; Bytes( &v, sizeof( v ) ); return v; }
+    float Float( void ) { float v; Bytes( &v, sizeof( v ) ); return v; }
+    double Double( void ) { double v; Bytes( &v, sizeof( v ) ); return v; }
+    void String( wxString *s )
+    {
+        wxUint32 l_len = U32();
+        if( !m_bOK || l_len > m_len - m_pos ) {
+            m_bOK = false;
+            s->Clear();
+            return;
+        }
+        *s = wxString::FromUTF8( (const char *)m_p + m_pos, l_len );
+        m_pos += l_len;
+    }
+    void Colour( wxColour *c )
+    {
+        if( !Bool() ) {
+            *c = wxNullColour;
+            return;
+        }
+        unsigned char r = U8();
+        unsigned char g = U8();
+        unsigned char b = U8();
+        unsigned char a = U8();
+        c->Set( r, g, b, a );
+    }
+    
+    bool IsOK( void ) { return m_bOK; }
+    bool AtEnd( void ) { return m_pos == m_len; }
+
+private:
+    const unsigned char *m_p;
+    size_t  m_len;
+    size_t  m_pos;
+    bool    m_bOK;
+};
+
+static void WriteLink( ODSnapshotWriter &w, const ODGPXLink &l )
+{
+    w.String( l.m_sHref );
+    w.String( l.m_sText );
+    w.String( l.m_sType );
+}
+
+static void ReadLink( ODSnapshotReader &r, ODGPXLink *l )
+{
+    r.String( &l->m_sHref );
+    r.String( &l->m_sText );
+    r.String( &l->m_sType );
+}
+
+static void WritePoint( ODSnapshotWriter &w, const ODGPXPointRecord &p )
+{
+    w.Double( p.m_dLat );
+    w.Double( p.m_dLon );
+    w.String( p.m_sSym );
+    w.String( p.m_sName );
+    w.String( p.m_sDesc );
+    w.String( p.m_sText );
+    w.String( p.m_sType );
+    w.String( p.m_sGUID );
+    w.String( p.m_sTime );
+    w.U32( p.m_iFirstLink );
+    w.U32( p.m_iLinks );
+    
+    w.Bool( p.m_bPropViz );
+    w.Bool( p.m_bViz );
+    w.Bool( p.m_bPropVizName );
+    w.Bool( p.m_bVizName );
+    w.Bool( p.m_bAutoName );
+    w.Bool( p.m_bShared );
+    w.Double( p.m_dArrivalRadius );
+    
+    w.I32( p.m_iTextPointFontSize );
+    w.I32( p.m_iTextPointFontFamily );
+    w.I32( p.m_iTextPointFontStyle );
+    w.I32( p.m_iTextPointFontWeight );
+    w.Bool( p.m_bTextPointFontUnderline );
+    w.Bool( p.m_bTextPointFontStrikethrough );
+    w.String( p.m_wxsTextPointFontFace );
+    w.I32( p.m_iTextPointFontEncoding );
+    w.I32( p.m_iTextPosition );
+    w.Colour( p.m_colourTextColour );
+    w.Colour( p.m_colourBackgroundColour );
+    w.I32( p.m_iBackgroundTransparency );
+    w.Double( p.m_dNaturalScale );
+    w.I32( p.m_iDisplayTextWhen );
+    
+    w.I32( p.m_iODPointRangeRingsNumber );
+    w.Float( p.m_fODPointRangeRingsStep );
+    w.I32( p.m_iODPointRangeRingsStepUnits );
+    w.Bool( p.m_bODPointRangeRingsVisible );
+    w.Colour( p.m_wxcODPointRangeRingsColour );
+    w.I32( p.m_iODPointRangeRingWidth );
+    w.I32( p.m_iODPointRangeRingStyle );
+    
+    w.Bool( p.m_bExclusionBoundaryPoint );
+    w.Bool( p.m_bInclusionBoundaryPoint );
+    w.I32( p.m_iInclusionBoundaryPointSize );
+    w.U32( p.m_uiBoundaryPointFillTransparency );
+}
+
+static void ReadPoint( ODSnapshotReader &r, ODGPXPointRecord *p )
+{
+    p->m_dLat = r.Double();
+    p->m_dLon = r.Double();
+    r.String( &p->m_sSym );
+    r.String( &p->m_sName );
+    r.String( &p->m_sDesc );
+    r.String( &p->m_sText );
+    r.String( &p->m_sType );
+    r.String( &p->m_sGUID );
+    r.String( &p->m_sTime );
+    p->m_iFirstLink = r.U32();
+    p->m_iLinks = r.U32();
+    
+    p->m_bPropViz = r.Bool();
+    p->m_bViz = r.Bool();
+    p->m_bPropVizName = r.Bool();
+    p->m_bVizName = r.Bool();
+    p->m_bAutoName = r.Bool();
+    p->m_bShared = r.Bool();
+    p->m_dArrivalRadius = r.Double();
+    
+    p->m_iTextPointFontSize = r.I32();
+    p->m_iTextPointFontFamily = r.I32();
+    p->m_iTextPointFontStyle = r.I32();
+    p->m_iTextPointFontWeight = r.I32();
+    p->m_bTextPointFontUnderline = r.Bool();
+    p->m_bTextPointFontStrikethrough = r.Bool();
+    r.String( &p->m_wxsTextPointFontFace );
+    p->m_iTextPointFontEncoding = r.I32();
+    p->m_iTextPosition = r.I32();
+    r.Colour( &p->m_colourTextColour );
+    r.Colour( &p->m_colourBackgroundColour );
+    p->m_iBackgroundTransparency = r.I32();
+    p->m_dNaturalScale = r.Double();
+    p->m_iDisplayTextWhen = r.I32();
+    
+    p->m_iODPointRangeRingsNumber = r.I32();
+    p->m_fODPointRangeRingsStep = r.Float();
+    p->m_iODPointRangeRingsStepUnits = r.I32();
+    p->m_bODPointRangeRingsVisible = r.Bool();
+    r.Colour( &p->m_wxcODPointRangeRingsColour );
+    p->m_iODPointRangeRingWidth = r.I32();
+    p->m_iODPointRangeRingStyle = r.I32();
+    
+    p->m_bExclusionBoundaryPoint = r.Bool();
+    p->m_bInclusionBoundaryPoint = r.Bool();
+    p->m_iInclusionBoundaryPointSize = r.I32();
+    p->m_uiBoundaryPointFillTransparency = r.U32();
+}
+
+static void WritePath( ODSnapshotWriter &w, const ODGPXPathRecord &p )
+{
+    w.String( p.m_sType );
+    w.String( p.m_sName );
+    w.String( p.m_sDesc );
+    w.String( p.m_sGUID );
+    w.String( p.m_sTimeDisplay );
+    w.U32( p.m_iFirstLink );
+    w.U32( p.m_iLinks );
+    w.U32( p.m_iFirstPoint );
+    w.U32( p.m_iPoints );
+    
+    w.U32( p.m_iFields );
+    w.Bool( p.m_bPropViz );
+    w.Bool( p.m_bViz );
+    w.Bool( p.m_bActive );
+    w.Colour( p.m_wxcActiveLineColour );
+    w.Colour( p.m_wxcActiveFillColour );
+    w.Colour( p.m_wxcInActiveLineColour );
+    w.Colour( p.m_wxcInActiveFillColour );
+    w.I32( p.m_iStyle );
+    w.I32( p.m_iWidth );
+    w.U32( p.m_uiFillTransparency );
+    w.I32( p.m_iInclusionBoundarySize );
+    w.Bool( p.m_bExclusionBoundary );
+    w.Bool( p.m_bInclusionBoundary );
+    w.I32( p.m_iPersistence );
+    w.Bool( p.m_bDrawArrow );
+    w.Bool( p.m_bVRM );
+    w.Bool( p.m_bFixedEndPosition );
+    w.Double( p.m_dSoG );
+    w.I32( p.m_iCoG );
+    w.Double( p.m_dDRPathLength );
+    w.Double( p.m_dTotalLengthNM );
+    w.Double( p.m_dDRPointInterval );
+    w.Double( p.m_dDRPointIntervalNM );
+    w.I32( p.m_iLengthType );
+    w.I32( p.m_iIntervalType );
+    w.I32( p.m_iDistanceUnits );
+    w.I32( p.m_iTimeUnits );
+}
+
+static void ReadPath( ODSnapshotReader &r, ODGPXPathRecord *p )
+{
+    r.String( &p->m_sType );
+    r.String( &p->m_sName );
+    r.String( &p->m_sDesc );
+    r.String( &p->m_sGUID );
+    r.String( &p->m_sTimeDisplay );
+    p->m_iFirstLink = r.U32();
+    p->m_iLinks = r.U32();
+    p->m_iFirstPoint = r.U32();
+    p->m_iPoints = r.U32();
+    
+    p->m_iFields = r.U32();
+    p->m_bPropViz = r.Bool();
+    p->m_bViz = r.Bool();
+    p->m_bActive = r.Bool();
+    r.Colour( &p->m_wxcActiveLineColour );
+    r.Colour( &p->m_wxcActiveFillColour );
+    r.Colour( &p->m_wxcInActiveLineColour );
+    r.Colour( &p->m_wxcInActiveFillColour );
+    p->m_iStyle = r.I32();
+    p->m_iWidth = r.I32();
+    p->m_uiFillTransparency = r.U32();
+    p->m_iInclusionBoundarySize = r.I32();
+    p->m_bExclusionBoundary = r.Bool();
+    p->m_bInclusionBoundary = r.Bool();
+    p->m_iPersistence = r.I32();
+    p->m_bDrawArrow = r.Bool();
+    p->m_bVRM = r.Bool();
+    p->m_bFixedEndPosition = r.Bool();
+    p->m_dSoG = r.Double();
+    p->m_iCoG = r.I32();
+    p->m_dDRPathLength = r.Double();
+    p->m_dTotalLengthNM = r.Double();
+    p->m_dDRPointInterval = r.Double();
+    p->m_dDRPointIntervalNM = r.Double();
+    p->m_iLengthType = r.I32();
+    p->m_iIntervalType = r.I32();
+    p->m_iDistanceUnits = r.I32();
+    p->m_iTimeUnits = r.I32();
+}
+
+//  start and count have to lie within a table of size entries
+static bool InRange( size_t start, size_t count, size_t size )
+{
+    return start <= size && count <= size - start;
+}
+
+bool ODNavObjSnapshot::Write( const wxString &filename, const wxString &navobj_file, const ODGPXRecordSet &set )
+{
+    ODNavObjSnapshotHeader l_header;
+    memcpy( l_header.m_Magic, s_Magic, sizeof( s_Magic ) );
+    l_header.m_iVersion = ODNAVOBJ_SNAPSHOT_VERSION;
+    l_header.m_iByteOrder = ODNAVOBJ_SNAPSHOT_BYTE_ORDER;
+    if( !StatXML( navobj_file, &l_header ) ) return false;
+    
+    ODSnapshotWriter w;
+    w.U32( set.m_Links.size() );
+    w.U32( set.m_Points.size() );
+    w.U32( set.m_Paths.size() );
+    w.U32( set.m_Objects.size() );
+    for( size_t i = 0; i < set.m_Links.size(); i++ )
+        WriteLink( w, set.m_Links[i] );
+    for( size_t i = 0; i < set.m_Points.size(); i++ )
+        WritePoint( w, set.m_Points[i] );
+    for( size_t i = 0; i < set.m_Paths.size(); i++ )
+        WritePath( w, set.m_Paths[i] );
+    for( size_t i = 0; i < set.m_Objects.size(); i++ )
+        w.I64( set.m_Objects[i] );
+    
+    l_header.m_iPayloadSize = w.m_Buffer.size();
+    l_header.m_iPayloadHash = w.m_Buffer.empty() ? ODNAVOBJ_FNV_OFFSET : Hash( &w.m_Buffer[0], w.m_Buffer.size() );
+    
+    // A snapshot cut short fails its hash, so the rename is only there to keep
+    // a half written file from replacing a good one
+    wxString l_sTemp = filename + wxT(".tmp");
+    wxFile l_file;
+    if( !l_file.Create( l_sTemp, true ) ) return false;
+    bool l_bOK = l_file.Write( &l_header, sizeof( l_header ) ) == sizeof( l_header );
+    if( l_bOK && !w.m_Buffer.empty() )
+        l_bOK = l_file.Write( &w.m_Buffer[0], w.m_Buffer.size() ) == w.m_Buffer.size();
+    if( !l_file.Close() ) l_bOK = false;
+    
+    if( l_bOK ) l_bOK = ::wxRenameFile( l_sTemp, filename, true );
+    if( !l_bOK && ::wxFileExists( l_sTemp ) ) ::wxRemoveFile( l_sTemp );
+    return l_bOK;
+}
+
+bool ODNavObjSnapshot::Read( const wxString &filename, const wxString &navobj_file, ODGPXRecordSet *pSet )
+{
+    pSet->Clear();
+    
+    wxFile l_file;
+    if( !::wxFileExists( filename ) || !l_file.Open( filename ) ) return false;
+    wxFileOffset l_len = l_file.Length();
+    if( l_len < (wxFileOffset)sizeof( ODNavObjSnapshotHeader ) ) return false;
+    
+    std::vector<unsigned char> l_buf( l_len );
+    if( l_file.Read( &l_buf[0], l_len ) != l_len ) return false;
+    l_file.Close();
+    
+    ODNavObjSnapshotHeader l_header;
+    memcpy( &l_header, &l_buf[0], sizeof( l_header ) );
+    if( memcmp( l_header.m_Magic, s_Magic, sizeof( s_Magic ) ) ||
+        l_header.m_iVersion != ODNAVOBJ_SNAPSHOT_VERSION ||
+        l_header.m_iByteOrder != ODNAVOBJ_SNAPSHOT_BYTE_ORDER ||
+        l_header.m_iPayloadSize != (wxUint64)( l_len - sizeof( l_header ) ) ) return false;
+    
+    const unsigned char *l_pPayload = &l_buf[0] + sizeof( l_header );
+    size_t l_iPayload = l_header.m_iPayloadSize;
+    wxUint64 l_hash = l_iPayload ? Hash( l_pPayload, l_iPayload ) : ODNAVOBJ_FNV_OFFSET;
+    if( l_hash != l_header.m_iPayloadHash ) return false;
+    
+    // Size and time are cheap, only hash the XML when they match
+    if( !::wxFileExists( navobj_file ) ) return false;
+    wxULongLong l_size = wxFileName::GetSize( navobj_file );
+    if( l_size == wxInvalidSize || l_size.GetValue() != l_header.m_iXMLSize ||
+        (wxInt64)::wxFileModificationTime( navobj_file ) != l_header.m_iXMLTime ) return false;
+    ODNavObjSnapshotHeader l_xml;
+    if( !StatXML( navobj_file, &l_xml ) || l_xml.m_iXMLSize != l_header.m_iXMLSize ||
+        l_xml.m_iXMLHash != l_header.m_iXMLHash ) return false;
+    
+    ODSnapshotReader r( l_pPayload, l_iPayload );
+    size_t l_iLinks = r.U32();
+    size_t l_iPoints = r.U32();
+    size_t l_iPaths = r.U32();
+    size_t l_iObjects = r.U32();
+    // every entry takes at least a byte, so the counts cannot ask for more than that
+    if( !r.IsOK() || l_iLinks > l_iPayload || l_iPoints > l_iPayload || l_iPaths > l_iPayload || l_iObjects > l_iPayload )
+        return false;
+    
+    bool l_bOK = true;
+    pSet->m_Links.resize( l_iLinks );
+    for( size_t i = 0; i < l_iLinks && l_bOK; i++ ) {
+        ReadLink( r, &pSet->m_Links[i] );
+        l_bOK = r.IsOK();
+    }
+    pSet->m_Points.resize( l_iPoints );
+    for( size_t i = 0; i < l_iPoints && l_bOK; i++ ) {
+        ODGPXPointRecord &p = pSet->m_Points[i];
+        ReadPoint( r, &p );
+        l_bOK = r.IsOK() && InRange( p.m_iFirstLink, p.m_iLinks, l_iLinks );
+    }
+    pSet->m_Paths.resize( l_iPaths );
+    for( size_t i = 0; i < l_iPaths && l_bOK; i++ ) {
+        ODGPXPathRecord &p = pSet->m_Paths[i];
+        ReadPath( r, &p );
+        l_bOK = r.IsOK() && InRange( p.m_iFirstLink, p.m_iLinks, l_iLinks ) && InRange( p.m_iFirstPoint, p.m_iPoints, l_iPoints );
+    }
+    pSet->m_Objects.resize( l_iObjects );
+    for( size_t i = 0; i < l_iObjects && l_bOK; i++ ) {
+        wxInt64 l_iObject = r.I64();
+        if( l_iObject < 0 )
+            l_bOK = (wxUint64)-( l_iObject + 1 ) < l_iPoints;
+        else
+            l_bOK = (wxUint64)l_iObject < l_iPaths;
+        l_bOK = l_bOK && r.IsOK();
+        pSet->m_Objects[i] = (long)l_iObject;
+    }
+    
+    if( !l_bOK || !r.AtEnd() ) {
+        pSet->Clear();
+        return false;
+    }
+    return true;
+}
@@ -36,6 +36,12 @@
 #include "EBL.h"
 #include "DR.h"
 #include "ODUtils.h"
+#include "ODGPXImport.h"
+#include "Layer.h"
+#include "ODStats.h"
+#include "ODChangesWriter.h"
+
+#include <string>
 
 extern PathList         *g_pPathList;
 extern BoundaryList     *g_pBoundaryList;
@@ -47,39 +53,47 @@ pugi::xml_node          gpx_path_root;
 extern ODConfig         *g_pODConfig;
 extern PointMan         *g_pODPointMan;
 extern PathMan          *g_pPathMan;
-extern int              g_iTextPosition;
-extern wxColour         g_colourDefaultTextColour;
-extern wxColour         g_colourDefaultTextBackgroundColour;
-extern int              g_iTextBackgroundTransparency;
-extern wxFont           g_DisplayTextFont;
-extern int              g_iInclusionBoundaryPointSize;
-extern unsigned int     g_uiBoundaryPointFillTransparency;
-extern bool             g_bExclusionBoundaryPoint;
-extern bool             g_bInclusionBoundaryPoint;
+extern int              g_iODChangesFlushInterval;
+
+WX_DECLARE_STRING_HASH_MAP( int, ODDeleteGUIDHash );
 
 
 ODNavObjectChanges::ODNavObjectChanges() : pugi::xml_document()
 {
     //ctor
     m_bFirstPath = true;
-    m_ODchanges_file = 0;
+    m_pChangesWriter = NULL;
     m_ptODPointList = new ODPointList;
+    m_bBatching = false;
+    m_pPointIndex = NULL;
+    m_pPathIndex = NULL;
+    m_iChangeRecords = 0;
+    m_iChangeBytes = 0;
+    m_iCreatedPaths = 0;
+    m_iCreatedPoints = 0;
 }
 
 ODNavObjectChanges::ODNavObjectChanges(wxString file_name) : pugi::xml_document()
 {
     //ctor
     m_ODfilename = file_name;
-    m_ODchanges_file = fopen(m_ODfilename.mb_str(), "a");
+    m_pChangesWriter = new ODChangesWriter( m_ODfilename );
+    m_pChangesWriter->SetFlushInterval( g_iODChangesFlushInterval );
     m_bFirstPath = true;
     m_ptODPointList = new ODPointList;
+    m_bBatching = false;
+    m_pPointIndex = NULL;
+    m_pPathIndex = NULL;
+    m_iChangeRecords = 0;
+    m_iChangeBytes = 0;
+    m_iCreatedPaths = 0;
+    m_iCreatedPoints = 0;
 }
 
 ODNavObjectChanges::~ODNavObjectChanges()
 {
     //dtor
-    if(m_ODchanges_file)
-        fclose(m_ODchanges_file);
+    delete m_pChangesWriter;
 
     if( ::wxFileExists( m_ODfilename ) )
         ::wxRemoveFile( m_ODfilename );
@@ -89,12 +103,27 @@ ODNavObjectChanges::~ODNavObjectChanges()
 
 void ODNavObjectChanges::RemoveChangesFile( void )
 {
-    if(m_ODchanges_file)
-        fclose(m_ODchanges_file);
-    if( ::wxFileExists( m_ODfilename ) )
+    if( m_pChangesWriter )
+        m_pChangesWriter->Remove();
+    else if( ::wxFileExists( m_ODfilename ) )
         ::wxRemoveFile( m_ODfilename );
     
-    m_ODchanges_file = fopen(m_ODfilename.mb_str(), "a");
+    m_iChangeRecords = 0;
+    m_iChangeBytes = 0;
+}
+
+//  Moves the changes recorded so far to another file and starts a new one.
+//  Fails, leaving the changes where they are, if that file already exists.
+bool ODNavObjectChanges::RotateChangesFile( const wxString &to )
+{
+    if( !m_pChangesWriter ) return false;
+    bool l_bOK = m_pChangesWriter->Rotate( to );
+    
+    if( l_bOK ) {
+        m_iChangeRecords = 0;
+        m_iChangeBytes = 0;
+    }
+    return l_bOK;
 }
 
 bool ODNavObjectChanges::GPXCreateODPoint( pugi::xml_node node, ODPoint *pop, unsigned int flags )
@@ -481,51 +510,294 @@ bool ODNavObjectChanges::GPXCreatePath( pugi::xml_node node, ODPath *pInPath )
                     
 bool ODNavObjectChanges::AddPath( ODPath *pb, const char *action )
 {
-    if( !m_ODchanges_file ) return false;
+    if( !m_pChangesWriter || !m_pChangesWriter->IsOpen() ) return false;
 
-    SetRootGPXNode();
-
-    pugi::xml_node object = m_gpx_root.append_child("opencpn:path");
+    pugi::xml_node object;
+    if( m_bBatching )
+        object = m_batch_root.append_child("opencpn:path");
+    else {
+        SetRootGPXNode();
+        object = m_gpx_root.append_child("opencpn:path");
+    }
     GPXCreatePath(object, pb );
     
     pugi::xml_node child = object.append_child("opencpn:action");
     child.append_child(pugi::node_pcdata).set_value(action);
 
-    pugi::xml_writer_file writer(m_ODchanges_file);
-    object.print(writer, " ");
-#ifdef __WXMSW__
-    fclose(m_ODchanges_file);
-    m_ODchanges_file = fopen(m_ODfilename.mb_str(), "a");
-#else __WXMSW__    
-    fflush(m_ODchanges_file);
-#endif __WXMSW__
+    // Paths are found by GUID when the changes are applied
+    if( m_bBatching )
+        return BatchChange( object, wxS("path:") + pb->m_GUID, action, true );
     
-    return true;
+    return WriteChange( object );
 }
 
 bool ODNavObjectChanges::AddODPoint( ODPoint *pOP, const char *action )
 {
-    SetRootGPXNode();
-    
-    pugi::xml_node object = m_gpx_root.append_child("opencpn:ODPoint");
+    if( !m_pChangesWriter || !m_pChangesWriter->IsOpen() ) return false;
+
+    pugi::xml_node object;
+    if( m_bBatching )
+        object = m_batch_root.append_child("opencpn:ODPoint");
+    else {
+        SetRootGPXNode();
+        object = m_gpx_root.append_child("opencpn:ODPoint");
+    }
     GPXCreateODPoint(object, pOP, OPT_OCPNPOINT);
 
 //    pugi::xml_node xchild = child_ext.child("extensions");
     pugi::xml_node child = object.append_child("opencpn:action");
     child.append_child(pugi::node_pcdata).set_value(action);
 
-    pugi::xml_writer_file writer(m_ODchanges_file);
+    // Points are found by name and position when the changes are applied
+    if( m_bBatching )
+        return BatchChange( object, wxS("point:") + pOP->m_GUID, action, false );
+    
+    return WriteChange( object );
+}
+
+//  A single record for objects deleted together. It only holds what is needed
+//  to find them again: the GUID of a path, the name and position of a point.
+bool ODNavObjectChanges::AddDeletes( const ODPathSet *pPaths, const ODPointSet *pPoints )
+{
+    if( !m_pChangesWriter || !m_pChangesWriter->IsOpen() ) return false;
+
+    pugi::xml_node object;
+    if( m_bBatching )
+        object = m_batch_root.append_child("opencpn:delete");
+    else {
+        SetRootGPXNode();
+        object = m_gpx_root.append_child("opencpn:delete");
+    }
+
+    if( pPaths ) {
+        for( ODPathSet::const_iterator it = pPaths->begin(); it != pPaths->end(); ++it ) {
+            ODPath *pb = *it;
+            if( m_bBatching && UnbatchChange( wxS("path:") + pb->m_GUID, true ) ) continue;
+            wxCharBuffer l_guid = pb->m_GUID.ToUTF8();
+            object.append_child("opencpn:path").append_child(pugi::node_pcdata).set_value(l_guid.data());
+        }
+    }
+
+    if( pPoints ) {
+        wxString s;
+        for( ODPointSet::const_iterator it = pPoints->begin(); it != pPoints->end(); ++it ) {
+            ODPoint *pOP = *it;
+            if( m_bBatching && UnbatchChange( wxS("point:") + pOP->m_GUID, false ) ) continue;
+            pugi::xml_node point = object.append_child("opencpn:ODPoint");
+            s.Printf(_T("%.9f"), pOP->m_lat);
+            point.append_attribute("lat") = s.mb_str();
+            s.Printf(_T("%.9f"), pOP->m_lon);
+            point.append_attribute("lon") = s.mb_str();
+            wxCharBuffer l_name = pOP->GetName().ToUTF8();
+            if( l_name.data() )
+                point.append_child(pugi::node_pcdata).set_value(l_name.data());
+        }
+    }
+
+    if( !object.first_child() ) {
+        object.parent().remove_child( object );
+        return true;
+    }
+    if( m_bBatching ) return true;
+
+    return WriteChange( object );
+}
+
+//  Collects printed change records so they can be handed to the writer in one go
+class ODChangeBatchWriter : public pugi::xml_writer
+{
+public:
+    virtual void write( const void *data, size_t size )
+    {
+        m_buffer.append( static_cast<const char *>( data ), size );
+    }
+    
+    std::string m_buffer;
+};
+
+bool ODNavObjectChanges::WriteChange( pugi::xml_node object )
+{
+    ODStatsTimer l_timer( ODSTATS_CHANGES_WRITE );
+    ODChangeBatchWriter writer;
     object.print(writer, " ");
-#ifdef __WXMSW__
-    fclose(m_ODchanges_file);
-    m_ODchanges_file = fopen(m_ODfilename.mb_str(), "a");
-#else __WXMSW__    
-    fflush(m_ODchanges_file);
-#endif __WXMSW__
+    ODStatsCount( ODSTATS_CHANGES_BYTES, writer.m_buffer.size() );
+    m_iChangeRecords++;
+    m_iChangeBytes += writer.m_buffer.size();
+    
+    return m_pChangesWriter->Write( writer.m_buffer, 1 );
+}
+
+void ODNavObjectChanges::BeginBatch( void )
+{
+    if( m_bBatching ) return;
+    
+    m_batch.reset();
+    m_batch_root = m_batch.append_child("OCPNDraw");
+    m_BatchIndex.clear();
+    m_bBatching = true;
+}
+
+void ODNavObjectChanges::DiscardBatch( void )
+{
+    m_batch.reset();
+    m_batch_root = pugi::xml_node();
+    m_BatchIndex.clear();
+    m_bBatching = false;
+}
+
+bool ODNavObjectChanges::BatchChange( pugi::xml_node object, const wxString &key, const char *action, bool b_match_guid )
+{
+    ODChangeBatchHash::iterator it = m_BatchIndex.find( key );
+    if( it == m_BatchIndex.end() ) {
+        m_BatchIndex[ key ] = object;
+        return true;
+    }
+    
+    pugi::xml_node prev = it->second;
+    const char *prev_action = prev.child( "opencpn:action" ).first_child().value();
+    
+    if( !strcmp( prev_action, "add" ) ) {
+        if( !strcmp( action, "delete" ) ) {
+            // Added and deleted in the same batch, nothing needs to be written
+            m_batch_root.remove_child( object );
+            m_batch_root.remove_child( prev );
+            m_BatchIndex.erase( it );
+            return true;
+        }
+        // Not written yet, so the newest state is still an add
+        object.child( "opencpn:action" ).first_child().set_value( "add" );
+    } else if( !strcmp( prev_action, "update" ) ) {
+        // A point delete is matched on the position in the update, so keep both
+        if( !b_match_guid && !strcmp( action, "delete" ) ) {
+            it->second = object;
+            return true;
+        }
+    } else if( strcmp( action, "delete" ) ) {
+        // A re-add after a delete has to follow the delete
+        it->second = object;
+        return true;
+    }
+    
+    m_batch_root.remove_child( prev );
+    it->second = object;
+    return true;
+}
+
+//  Settles a pending change to an object that is about to go in a bulk delete
+//  record, as BatchChange would for a single delete. Returns true when the
+//  object was added in this batch and so needs no delete record.
+bool ODNavObjectChanges::UnbatchChange( const wxString &key, bool b_match_guid )
+{
+    ODChangeBatchHash::iterator it = m_BatchIndex.find( key );
+    if( it == m_BatchIndex.end() ) return false;
+
+    pugi::xml_node prev = it->second;
+    const char *prev_action = prev.child( "opencpn:action" ).first_child().value();
+    bool b_added = !strcmp( prev_action, "add" );
+
+    if( b_added || ( b_match_guid && !strcmp( prev_action, "update" ) ) )
+        m_batch_root.remove_child( prev );
+
+    // Anything after this has to follow the delete record
+    m_BatchIndex.erase( it );
+    return b_added;
+}
+
+//  Inserts pOP after pPrev in, or with no pPrev removes pOP from, the point
+//  records of a pending change to the path. Returns false when the batch has
+//  no such change, the caller then writes the path out in full.
+bool ODNavObjectChanges::AddPathPoint( ODPath *pb, ODPoint *pPrev, ODPoint *pOP )
+{
+    if( !m_pChangesWriter || !m_pChangesWriter->IsOpen() ) return false;
+
+    pugi::xml_node object;
+    if( m_bBatching )
+        object = m_batch_root.append_child("opencpn:path_point");
+    else {
+        SetRootGPXNode();
+        object = m_gpx_root.append_child("opencpn:path_point");
+    }
+
+    wxCharBuffer l_guid = pb->m_GUID.ToUTF8();
+    object.append_child("opencpn:path").append_child(pugi::node_pcdata).set_value(l_guid.data());
+    if( pPrev ) {
+        l_guid = pPrev->m_GUID.ToUTF8();
+        object.append_child("opencpn:after").append_child(pugi::node_pcdata).set_value(l_guid.data());
+        GPXCreateODPoint( object.append_child("opencpn:ODPoint"), pOP, OPT_OCPNPOINT );
+    } else {
+        l_guid = pOP->m_GUID.ToUTF8();
+        object.append_child("opencpn:guid").append_child(pugi::node_pcdata).set_value(l_guid.data());
+    }
+
+    pugi::xml_node child = object.append_child("opencpn:action");
+    child.append_child(pugi::node_pcdata).set_value( pPrev ? "insert" : "remove" );
+
+    // Kept in order with the path records around it, it is not coalesced
+    if( m_bBatching ) return true;
+
+    return WriteChange( object );
+}
+
+bool ODNavObjectChanges::PatchBatchedPath( ODPath *pb, ODPoint *pPrev, ODPoint *pOP )
+{
+    if( !m_bBatching ) return false;
+    
+    ODChangeBatchHash::iterator it = m_BatchIndex.find( wxS("path:") + pb->m_GUID );
+    if( it == m_BatchIndex.end() ) return false;
+    
+    pugi::xml_node object = it->second;
+    if( !strcmp( object.child( "opencpn:action" ).first_child().value(), "delete" ) ) return false;
+    
+    wxCharBuffer l_guid = ( pPrev ? pPrev : pOP )->m_GUID.ToUTF8();
+    pugi::xml_node point = object.child( "opencpn:ODPoint" );
+    while( point && strcmp( point.child_value( "opencpn:guid" ), l_guid.data() ) )
+        point = point.next_sibling( "opencpn:ODPoint" );
+    if( !point ) return false;
+    
+    if( pPrev )
+        GPXCreateODPoint( object.insert_child_after( "opencpn:ODPoint", point ), pOP, OPT_OCPNPOINT );
+    else
+        object.remove_child( point );
     
     return true;
 }
 
+bool ODNavObjectChanges::CommitBatch( void )
+{
+    if( !m_bBatching ) return true;
+    ODStatsTimer l_timer( ODSTATS_CHANGES_WRITE );
+    
+    ODChangeBatchWriter writer;
+    size_t l_iRecords = 0;
+    for( pugi::xml_node object = m_batch_root.first_child(); object; object = object.next_sibling(), l_iRecords++ )
+        object.print( writer, " " );
+    DiscardBatch();
+    
+    if( writer.m_buffer.empty() ) return true;
+    if( !m_pChangesWriter || !m_pChangesWriter->IsOpen() ) return false;
+
+    // The writer thread writes the batch whole or, if that fails, not at all
+    ODStatsCount( ODSTATS_CHANGES_BYTES, writer.m_buffer.size() );
+    m_iChangeRecords += l_iRecords;
+    m_iChangeBytes += writer.m_buffer.size();
+    return m_pChangesWriter->Write( writer.m_buffer, l_iRecords );
+}
+
+bool ODNavObjectChanges::FlushChanges( void )
+{
+    return m_pChangesWriter ? m_pChangesWriter->Flush() : true;
+}
+
+void ODNavObjectChanges::StopChangesWriter( void )
+{
+    if( m_pChangesWriter ) m_pChangesWriter->Stop();
+}
+
+void ODNavObjectChanges::SetChangesFlushInterval( int ms )
+{
+    if( m_pChangesWriter ) m_pChangesWriter->SetFlushInterval( ms );
+}
+
 bool ODNavObjectChanges::AddGPXPathsList( PathList *pPaths )
 {
     SetRootGPXNode();
@@ -572,7 +844,7 @@ bool ODNavObjectChanges::AddGPXODPointsList( ODPointList *pODPoints )
     return true;
 }
 
-bool ODNavObjectChanges::CreateNavObjGPXPoints( void )
+bool ODNavObjectChanges::CreateNavObjGPXPoints( wxLongLong_t until_us )
 {
     
     //    Iterate over the ODPoint list, creating Nodes for
@@ -580,13 +852,16 @@ bool ODNavObjectChanges::CreateNavObjGPXPoints( void )
     //    as indicated by m_bIsolatedMark == false
     
     if(!g_pODPointMan)
-        return false;
+        return true;
     
     wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst();
+    for( size_t i = 0; node && i < m_iCreatedPoints; i++ )
+        node = node->GetNext();
     
     ODPoint *pOP;
     
     while( node ) {
+        if( until_us && ODStatsNowUs() >= until_us ) return false;
         pOP = node->GetData();
         
         if( ( pOP->m_bIsolatedMark ) && !( pOP->m_bIsInLayer ) && !(pOP->m_btemp) )
@@ -594,21 +869,25 @@ bool ODNavObjectChanges::CreateNavObjGPXPoints( void )
             GPXCreateODPoint(m_gpx_root.append_child("opencpn:ODPoint"), pOP, OPT_OCPNPOINT);
         }
         node = node->GetNext();
+        m_iCreatedPoints++;
     }
     
     return true;
 }
 
-bool ODNavObjectChanges::CreateNavObjGPXPaths( void )
+bool ODNavObjectChanges::CreateNavObjGPXPaths( wxLongLong_t until_us )
 {
     pugi::xml_node child_ext;
     // Paths
     wxPathListNode *node1 = g_pPathList->GetFirst();
+    for( size_t i = 0; node1 && i < m_iCreatedPaths; i++ )
+        node1 = node1->GetNext();
 //    child_ext = m_gpx_root.append_child("extensions");
     ODPath *pPath = NULL;
     Boundary *pBoundary = NULL;
     EBL *pEBL = NULL;
     while( node1 ) {
+        if( until_us && ODStatsNowUs() >= until_us ) return false;
         pPath = (ODPath *)node1->GetData();
         pBoundary = NULL;
         pEBL = NULL;
@@ -624,19 +903,19 @@ bool ODNavObjectChanges::CreateNavObjGPXPaths( void )
                 GPXCreatePath(m_gpx_root.append_child("opencpn:path"), pPath);
         }
         node1 = node1->GetNext();
+        m_iCreatedPaths++;
     }
     
     
     return true;
 }
 
-bool ODNavObjectChanges::CreateAllGPXObjects()
+bool ODNavObjectChanges::CreateAllGPXObjects( wxLongLong_t until_us )
 {
     SetRootGPXNode();
-    CreateNavObjGPXPaths();
-    CreateNavObjGPXPoints();
+    if( !CreateNavObjGPXPaths( until_us ) ) return false;
     
-    return true;
+    return CreateNavObjGPXPoints( until_us );
 }
 
 void ODNavObjectChanges::SetRootGPXNode(void)
@@ -652,24 +931,26 @@ void ODNavObjectChanges::SetRootGPXNode(void)
 
 bool ODNavObjectChanges::LoadAllGPXObjects( bool b_full_viz )
 {
+    ReadAllGPXRecords( &m_LoadRecords );
+    bool l_bRet = LoadAllGPXRecords( m_LoadRecords, b_full_viz );
+    m_LoadRecords.Clear();
+    
+    return l_bRet;
+}
+
+bool ODNavObjectChanges::ReadAllGPXRecords( ODGPXRecordSet *pSet, bool b_snapshot_defaults )
+{
+    if( b_snapshot_defaults )
+        m_LoadContext.Snapshot();
+    pSet->Clear();
     pugi::xml_node objects = this->child("OCPNDraw");
     
     for (pugi::xml_node object = objects.first_child(); object; object = object.next_sibling())
     {
         if( !strcmp(object.name(), "opencpn:ODPoint") ) {
-            ODPoint *pOp = GPXLoadODPoint1( object, _T("circle"), _T(""), b_full_viz, false, false, 0 );
-            
-            if(pOp) {
-                pOp->m_bIsolatedMark = true;      // This is an isolated mark
-                ODPoint *pExisting = ODPointExists( pOp->GetName(), pOp->m_lat, pOp->m_lon );
-                if( !pExisting ) {
-                    if( NULL != g_pODPointMan )
-                        g_pODPointMan->AddODPoint( pOp );
-                    g_pODSelect->AddSelectableODPoint( pOp->m_lat, pOp->m_lon, pOp );
-                }
-                else
-                    delete pOp;
-            }
+            pSet->m_Points.push_back( ODGPXPointRecord() );
+            ReadODPointRecord( object, _T("circle"), _T(""), &pSet->m_Points.back(), &pSet->m_Links );
+            pSet->m_Objects.push_back( -1 - (long)( pSet->m_Points.size() - 1 ) );
         }
             else
                 if( !strcmp(object.name(), "opencpn:path") ) {
@@ -683,8 +964,9 @@ bool ODNavObjectChanges::LoadAllGPXObjects( bool b_full_viz )
                         }
                     }
                     if ( !TypeString.compare( wxS("Boundary") ) || !TypeString.compare( wxS("EBL") ) || !TypeString.compare( wxS("DR") ) ) {
-                        ODPath *pPath = GPXLoadPath1( object, b_full_viz, false, false, 0, &TypeString );
-                        InsertPathA( pPath );
+                        pSet->m_Paths.push_back( ODGPXPathRecord() );
+                        ReadPathRecord( object, TypeString, &pSet->m_Paths.back(), pSet );
+                        pSet->m_Objects.push_back( (long)( pSet->m_Paths.size() - 1 ) );
                     }
                 }
                 
@@ -694,6 +976,65 @@ bool ODNavObjectChanges::LoadAllGPXObjects( bool b_full_viz )
     return true;
 }
 
+bool ODNavObjectChanges::LoadAllGPXRecords( const ODGPXRecordSet &set, bool b_full_viz )
+{
+    for( size_t i = 0; i < set.m_Objects.size(); i++ ) {
+        long l_iObject = set.m_Objects[i];
+        if( l_iObject < 0 ) {
+            ODPoint *pOp = CreateODPoint( set.m_Points[ -1 - l_iObject ], set.m_Links, b_full_viz, false, false, 0 );
+            
+            if(pOp) {
+                pOp->m_bIsolatedMark = true;      // This is an isolated mark
+                ODPoint *pExisting = ODPointExists( pOp->GetName(), pOp->m_lat, pOp->m_lon );
+                if( !pExisting ) {
+                    if( NULL != g_pODPointMan )
+                        g_pODPointMan->AddODPoint( pOp );
+                    if( m_pPointIndex )
+                        m_pPointIndex->Add( pOp );
+                    g_pODSelect->AddSelectableODPoint( pOp->m_lat, pOp->m_lon, pOp );
+                }
+                else
+                    delete pOp;
+            }
+        } else {
+            ODPath *pPath = CreatePath( set.m_Paths[ l_iObject ], set, b_full_viz, false, false, 0 );
+            InsertPathA( pPath );
+        }
+    }
+    
+    return true;
+}
+
+static void ReadGPXLink( pugi::xml_node &node, std::vector<ODGPXLink> *pLinks )
+{
+    pLinks->push_back( ODGPXLink() );
+    ODGPXLink &link = pLinks->back();
+    link.m_sHref = wxString::FromUTF8( node.first_attribute().value() );
+
+    for( pugi::xml_node child1 = node.first_child(); child1; child1 = child1.next_sibling() ) {
+        int l_iName = ODGPXLoadContext::Lookup( child1.name() );
+        if( l_iName == ODGPX_LINK_TEXT )
+            link.m_sText.append( wxString::FromUTF8( child1.first_child().value() ) );
+        else if( l_iName == ODGPX_LINK_TYPE )
+            link.m_sType.append( wxString::FromUTF8( child1.first_child().value() ) );
+    }
+}
+
+static HyperlinkList *CreateLinkList( const std::vector<ODGPXLink> &links, size_t first, size_t count )
+{
+    if( !count ) return NULL;
+    
+    HyperlinkList *linklist = new HyperlinkList;
+    for( size_t i = first; i < first + count; i++ ) {
+        Hyperlink *link = new Hyperlink;
+        link->Link = links[i].m_sHref;
+        link->DescrText = links[i].m_sText;
+        link->LType = links[i].m_sType;
+        linklist->Append( link );
+    }
+    return linklist;
+}
+
 ODPoint * ODNavObjectChanges::GPXLoadODPoint1( pugi::xml_node &opt_node, 
                             wxString def_symbol_name,
                             wxString GUID,
@@ -703,226 +1044,155 @@ ODPoint * ODNavObjectChanges::GPXLoadODPoint1( pugi::xml_node &opt_node,
                             int layer_id
                             )
 {
-    bool bviz = false;
-    bool bviz_name = false;
-    bool bauto_name = false;
-    bool bshared = false;
-    bool b_propvizname = false;
-    bool b_propviz = false;
-
-    wxString SymString = def_symbol_name;       // default icon
-    wxString NameString;
-    wxString DescString;
-    wxString TextString;
-    wxString TypeString;
-    wxString GuidString = GUID;         // default
-    wxString TimeString;
-    wxDateTime dt;
-    ODPoint *pOP = NULL;
-    TextPoint *pTP = NULL;
-    BoundaryPoint *pBP = NULL;
-    
-    HyperlinkList *linklist = NULL;
-
-    double rlat = opt_node.attribute( "lat" ).as_double();
-    double rlon = opt_node.attribute( "lon" ).as_double();
-    double ArrivalRadius = 0;
-    int     l_iTextPointFontSize = g_DisplayTextFont.GetPointSize();
-    int     l_iTextPointFontFamily = g_DisplayTextFont.GetFamily();
-    int     l_iTextPointFontStyle = g_DisplayTextFont.GetStyle();
-    int     l_iTextPointFontWeight = g_DisplayTextFont.GetWeight();
-    bool    l_bTextPointFontUnderline = g_DisplayTextFont.GetUnderlined();
-#if wxCHECK_VERSION(3,0,0) 
-    bool    l_bTextPointFontStrikethrough = g_DisplayTextFont.GetStrikethrough();
-#else
-    bool    l_bTextPointFontStrikethrough = false;
-#endif
-    wxString    l_wxsTextPointFontFace = g_DisplayTextFont.GetFaceName();
-    int     l_iTextPointFontEncoding = g_DisplayTextFont.GetEncoding();
-    int     l_iODPointRangeRingsNumber = -1;
-    float   l_fODPointRangeRingsStep = -1;
-    int     l_pODPointRangeRingsStepUnits = -1;
-    bool    l_bODPointRangeRingsVisible = false;
-    int     l_iTextPosition = g_iTextPosition;
-    wxColour    l_wxcODPointRangeRingsColour;
-    int     l_iODPointRangeRingWidth;
-    int     l_iODPointRangeRingStyle;
-    wxColour    l_colourTextColour = g_colourDefaultTextColour;
-    wxColour    l_colourBackgroundColour = g_colourDefaultTextBackgroundColour;
-    int     l_iBackgroundTransparency = g_iTextBackgroundTransparency;
-    bool    l_bExclusionBoundaryPoint = g_bExclusionBoundaryPoint;
-    bool    l_bInclusionBoundaryPoint = g_bInclusionBoundaryPoint;
-    int     l_iInclusionBoundaryPointSize = g_iInclusionBoundaryPointSize;
-    unsigned int l_uiBoundaryPointFillTransparency = g_uiBoundaryPointFillTransparency;
-    double  l_natural_scale = 0.0;
-    int     l_display_text_when = ID_TEXTPOINT_DISPLAY_TEXT_SHOW_ALWAYS;
-    
-    l_wxcODPointRangeRingsColour.Set( _T( "#FFFFFF" ) );
+    m_LoadRecords.m_Links.clear();
+    ODGPXPointRecord l_rec;
+    ReadODPointRecord( opt_node, def_symbol_name, GUID, &l_rec, &m_LoadRecords.m_Links );
+    return CreateODPoint( l_rec, m_LoadRecords.m_Links, b_fullviz, b_layer, b_layerviz, layer_id );
+}
 
+void ODNavObjectChanges::ReadODPointRecord( pugi::xml_node &opt_node, const wxString &def_symbol_name, const wxString &GUID,
+                                            ODGPXPointRecord *pRec, std::vector<ODGPXLink> *pLinks )
+{
+    m_LoadContext.ResetPoint( pRec, def_symbol_name, GUID );
+    ODGPXPointRecord &r = *pRec;
+    
+    r.m_dLat = opt_node.attribute( "lat" ).as_double();
+    r.m_dLon = opt_node.attribute( "lon" ).as_double();
+    r.m_iFirstLink = pLinks->size();
+    long    v;
+    
     for( pugi::xml_node child = opt_node.first_child(); child != 0; child = child.next_sibling() ) {
-        const char *pcn = child.name();
+        const char *pcv = child.first_child().value();
         
-        if( !strcmp( pcn, "sym" ) ) {
-            SymString.clear();
-            SymString.append( wxString::FromUTF8( child.first_child().value() ) );
-        }
-        else if( !strcmp( pcn, "time") ) 
-            TimeString.append( wxString::FromUTF8( child.first_child().value() ) );
-
-        else if( !strcmp( pcn, "name") ) {
-            NameString.append( wxString::FromUTF8( child.first_child().value() ) );
-        } else if( !strcmp( pcn, "desc") ) {
-            DescString.append( wxString::FromUTF8( child.first_child().value() ) );
-        } else if( !strcmp( pcn, "opencpn:text") ) {
-            TextString.append( wxString::FromUTF8( child.first_child().value() ) );
-        } else if( !strcmp( pcn, "opencpn:text_position") ) {
-            wxString s = wxString::FromUTF8( child.first_child().value() );
-            long v = 0;
-            if( s.ToLong( &v ) )
-                l_iTextPosition = v;
-        } else if( !strcmp( pcn, "opencpn:text_colour") ) {
-            l_colourTextColour.Set( wxString::FromUTF8( child.first_child().value() ) );
-
-        } else if ( !strcmp( pcn, "opencpn:font_info") ) {
+        switch( ODGPXLoadContext::Lookup( child.name() ) ) {
+            case ODGPX_SYM:
+                r.m_sSym = wxString::FromUTF8( pcv );
+                break;
+            case ODGPX_TIME:
+                r.m_sTime.append( wxString::FromUTF8( pcv ) );
+                break;
+            case ODGPX_NAME:
+                r.m_sName.append( wxString::FromUTF8( pcv ) );
+                break;
+            case ODGPX_DESC:
+                r.m_sDesc.append( wxString::FromUTF8( pcv ) );
+                break;
+            case ODGPX_TEXT:
+                r.m_sText.append( wxString::FromUTF8( pcv ) );
+                break;
+            case ODGPX_TEXT_POSITION:
+                if( ODGPXLoadContext::ToLong( pcv, &v ) )
+                    r.m_iTextPosition = v;
+                break;
+            case ODGPX_TEXT_COLOUR:
+                r.m_colourTextColour.Set( wxString::FromUTF8( pcv ) );
+                break;
+            case ODGPX_FONT_INFO:
                 for ( pugi::xml_attribute attr = child.first_attribute(); attr; attr = attr.next_attribute() ) {
-                    if ( wxString::FromUTF8(attr.name()) == _T("size") )
-                        l_iTextPointFontSize = attr.as_int();
-                    else if ( wxString::FromUTF8(attr.name()) == _T("family") )
-                        l_iTextPointFontFamily = attr.as_int();
-                    else if ( wxString::FromUTF8(attr.name()) == _T("style") )
-                        l_iTextPointFontStyle = attr.as_int();
-                    else if ( wxString::FromUTF8(attr.name()) == _T("weight") )
-                        l_iTextPointFontWeight = attr.as_int();
-                    else if ( wxString::FromUTF8(attr.name()) == _T("underline") )
-                        l_bTextPointFontUnderline =  attr.as_bool();
-                    else if ( wxString::FromUTF8(attr.name()) == _T("strikethrough") )
-                        l_bTextPointFontStrikethrough =  attr.as_bool();
-                    else if ( wxString::FromUTF8(attr.name()) == _T("face") ) {
-                        l_wxsTextPointFontFace.clear();
-                        l_wxsTextPointFontFace.Append( wxString::FromUTF8( attr.as_string() ) );
+                    switch( ODGPXLoadContext::Lookup( attr.name() ) ) {
+                        case ODGPX_ATTR_SIZE: r.m_iTextPointFontSize = attr.as_int(); break;
+                        case ODGPX_ATTR_FAMILY: r.m_iTextPointFontFamily = attr.as_int(); break;
+                        case ODGPX_ATTR_STYLE: r.m_iTextPointFontStyle = attr.as_int(); break;
+                        case ODGPX_ATTR_WEIGHT: r.m_iTextPointFontWeight = attr.as_int(); break;
+                        case ODGPX_ATTR_UNDERLINE: r.m_bTextPointFontUnderline = attr.as_bool(); break;
+                        case ODGPX_ATTR_STRIKETHROUGH: r.m_bTextPointFontStrikethrough = attr.as_bool(); break;
+                        case ODGPX_ATTR_FACE: r.m_wxsTextPointFontFace = wxString::FromUTF8( attr.as_string() ); break;
+                        case ODGPX_ATTR_ENCODING: r.m_iTextPointFontEncoding = attr.as_int(); break;
                     }
-                    else if ( wxString::FromUTF8(attr.name()) == _T("encoding") )
-                        l_iTextPointFontEncoding = attr.as_int();
                 }
-                
-        } else if( !strcmp( pcn, "opencpn:background_colour") ) {
-            l_colourBackgroundColour.Set( wxString::FromUTF8( child.first_child().value() ) );
-        } else if( !strcmp( pcn, "opencpn:background_transparency") ) {
-            wxString s = wxString::FromUTF8( child.first_child().value() );
-            long v = 0;
-            if( s.ToLong( &v ) )
-                l_iBackgroundTransparency = v;
-        } else if( !strcmp( pcn, "opencpn:type") ) {
-            TypeString.append( wxString::FromUTF8( child.first_child().value() ) );
-        } else              // Read hyperlink
-        if( !strcmp( pcn, "link") ) {
-            wxString HrefString;
-            wxString HrefTextString;
-            wxString HrefTypeString;
-            if( linklist == NULL )
-                linklist = new HyperlinkList;
-            HrefString.append( wxString::FromUTF8( child.first_attribute().value() ) );
-
-            for( pugi::xml_node child1 = child.first_child(); child1; child1 = child1.next_sibling() ) {
-                wxString LinkString = wxString::FromUTF8( child1.name() );
-
-                if( LinkString == _T ( "text" ) )
-                    HrefTextString.append( wxString::FromUTF8( child1.first_child().value() ) );
-                if( LinkString == _T ( "type" ) ) 
-                    HrefTypeString.append( wxString::FromUTF8( child1.first_child().value() ) );
-            }
-        
-            Hyperlink *link = new Hyperlink;
-            link->Link = HrefString;
-            link->DescrText = HrefTextString;
-            link->LType = HrefTypeString;
-            linklist->Append( link );
-        }
+                break;
+            case ODGPX_BACKGROUND_COLOUR:
+                r.m_colourBackgroundColour.Set( wxString::FromUTF8( pcv ) );
+                break;
+            case ODGPX_BACKGROUND_TRANSPARENCY:
+                if( ODGPXLoadContext::ToLong( pcv, &v ) )
+                    r.m_iBackgroundTransparency = v;
+                break;
+            case ODGPX_TYPE:
+                r.m_sType.append( wxString::FromUTF8( pcv ) );
+                break;
+            case ODGPX_LINK:
+                ReadGPXLink( child, pLinks );
+                break;
 
-    //    OpenCPN Extensions....
-        else
-        if( !strcmp( pcn, "opencpn:viz" ) ) {
-            b_propviz = true;
-            wxString s = wxString::FromUTF8( child.first_child().value() );
-            long v = 0;
-            if( s.ToLong( &v ) )
-                bviz = ( v != 0 );
-        }
-        else
-        if( !strcmp( pcn, "opencpn:viz_name") ) {
-            b_propvizname = true;
-            wxString s = wxString::FromUTF8( child.first_child().value() );
-            long v = 0;
-            if( s.ToLong( &v ) )
-                bviz_name = ( v != 0 );
-        }
-        else
-        if( !strcmp( pcn, "opencpn:guid" ) ) {
-            GuidString.clear();
-            GuidString.append( wxString::FromUTF8(child.first_child().value()) );
-        }
-        else
-        if( !strcmp( pcn, "opencpn:auto_name" ) ) {
-            wxString s = wxString::FromUTF8( child.first_child().value() );
-            long v = 0;
-            if( s.ToLong( &v ) )
-                bauto_name = ( v != 0 );
-        }
-        else
-        if( !strcmp( pcn, "opencpn:shared" ) ) {
-            wxString s = wxString::FromUTF8( child.first_child().value() );
-            long v = 0;
-            if( s.ToLong( &v ) )
-                bshared = ( v != 0 );
-        }
-        else
-        if( !strcmp( pcn, "opencpn:arrival_radius" ) ) {
-            wxString::FromUTF8(child.first_child().value()).ToDouble(&ArrivalRadius ) ;
-        }
-        else
-        if ( !strcmp( pcn, "opencpn:ODPoint_range_rings") ) {
-            for ( pugi::xml_attribute attr = child.first_attribute(); attr; attr = attr.next_attribute() ) {
-                if ( wxString::FromUTF8(attr.name()) == _T("number") )
-                    l_iODPointRangeRingsNumber = attr.as_int();
-                else if ( wxString::FromUTF8(attr.name()) == _T("step") )
-                    l_fODPointRangeRingsStep = attr.as_float();
-                else if ( wxString::FromUTF8(attr.name()) == _T("units") )
-                    l_pODPointRangeRingsStepUnits = attr.as_int();
-                else if ( wxString::FromUTF8(attr.name()) == _T("visible") )
-                    l_bODPointRangeRingsVisible =  attr.as_bool();
-                else if ( wxString::FromUTF8(attr.name()) == _T("colour") )
-                    l_wxcODPointRangeRingsColour.Set( wxString::FromUTF8( attr.as_string() ) );
-                else if ( wxString::FromUTF8(attr.name()) == _T("width") )
-                    l_iODPointRangeRingWidth = attr.as_int();
-                else if ( wxString::FromUTF8(attr.name()) == _T("line_style") )
-                    l_iODPointRangeRingStyle = attr.as_int();
-            }
-        } else if ( !strcmp( pcn, "opencpn:boundary_type" ) ) {
-            wxString s = wxString::FromUTF8( child.first_child().value() );
-            if( s == _T("Exclusion") ) {
-                l_bExclusionBoundaryPoint = true;
-                l_bInclusionBoundaryPoint = false;
-            } else if( s == _T("Inclusion") ) {
-                l_bExclusionBoundaryPoint = false;
-                l_bInclusionBoundaryPoint = true;
-            } else if( s == _T("Neither") ) {
-                l_bExclusionBoundaryPoint = false;
-                l_bInclusionBoundaryPoint = false;
-            } else l_bExclusionBoundaryPoint = false;
-        } else if ( !strcmp( pcn, "opencpn:boundary_point_style" ) ) {
-            for ( pugi::xml_attribute attr = child.first_attribute(); attr; attr = attr.next_attribute() ) {
-                if ( wxString::FromUTF8(attr.name()) == _T("fill_transparency") )
-                    l_uiBoundaryPointFillTransparency = attr.as_uint();
-                else if ( wxString::FromUTF8(attr.name()) == _T("inclusion_fill_size") )
-                    l_iInclusionBoundaryPointSize = attr.as_int();
-                
-            }
-        }else if ( !strcmp( pcn, "opencpn:natural_scale" ) ){
-        wxString::FromUTF8(child.first_child().value()).ToDouble( &l_natural_scale );
-        }else if ( !strcmp( pcn, "opencpn:display_text_when" ) ){
-            wxString::FromUTF8(child.first_child().value()).ToLong( (long *) &l_display_text_when );
+            //    OpenCPN Extensions....
+            case ODGPX_VIZ:
+                r.m_bPropViz = true;
+                if( ODGPXLoadContext::ToLong( pcv, &v ) )
+                    r.m_bViz = ( v != 0 );
+                break;
+            case ODGPX_VIZ_NAME:
+                r.m_bPropVizName = true;
+                if( ODGPXLoadContext::ToLong( pcv, &v ) )
+                    r.m_bVizName = ( v != 0 );
+                break;
+            case ODGPX_GUID:
+                r.m_sGUID = wxString::FromUTF8( pcv );
+                break;
+            case ODGPX_AUTO_NAME:
+                if( ODGPXLoadContext::ToLong( pcv, &v ) )
+                    r.m_bAutoName = ( v != 0 );
+                break;
+            case ODGPX_SHARED:
+                if( ODGPXLoadContext::ToLong( pcv, &v ) )
+                    r.m_bShared = ( v != 0 );
+                break;
+            case ODGPX_ARRIVAL_RADIUS:
+                ODGPXLoadContext::ToDouble( pcv, &r.m_dArrivalRadius );
+                break;
+            case ODGPX_RANGE_RINGS:
+                for ( pugi::xml_attribute attr = child.first_attribute(); attr; attr = attr.next_attribute() ) {
+                    switch( ODGPXLoadContext::Lookup( attr.name() ) ) {
+                        case ODGPX_ATTR_NUMBER: r.m_iODPointRangeRingsNumber = attr.as_int(); break;
+                        case ODGPX_ATTR_STEP: r.m_fODPointRangeRingsStep = attr.as_float(); break;
+                        case ODGPX_ATTR_UNITS: r.m_iODPointRangeRingsStepUnits = attr.as_int(); break;
+                        case ODGPX_ATTR_VISIBLE: r.m_bODPointRangeRingsVisible = attr.as_bool(); break;
+                        case ODGPX_ATTR_COLOUR: r.m_wxcODPointRangeRingsColour.Set( wxString::FromUTF8( attr.as_string() ) ); break;
+                        case ODGPX_ATTR_WIDTH: r.m_iODPointRangeRingWidth = attr.as_int(); break;
+                        case ODGPX_ATTR_LINE_STYLE: r.m_iODPointRangeRingStyle = attr.as_int(); break;
+                    }
+                }
+                break;
+            case ODGPX_BOUNDARY_TYPE:
+                if( !strcmp( pcv, "Exclusion" ) ) {
+                    r.m_bExclusionBoundaryPoint = true;
+                    r.m_bInclusionBoundaryPoint = false;
+                } else if( !strcmp( pcv, "Inclusion" ) ) {
+                    r.m_bExclusionBoundaryPoint = false;
+                    r.m_bInclusionBoundaryPoint = true;
+                } else if( !strcmp( pcv, "Neither" ) ) {
+                    r.m_bExclusionBoundaryPoint = false;
+                    r.m_bInclusionBoundaryPoint = false;
+                } else r.m_bExclusionBoundaryPoint = false;
+                break;
+            case ODGPX_BOUNDARY_POINT_STYLE:
+                for ( pugi::xml_attribute attr = child.first_attribute(); attr; attr = attr.next_attribute() ) {
+                    switch( ODGPXLoadContext::Lookup( attr.name() ) ) {
+                        case ODGPX_ATTR_FILL_TRANSPARENCY: r.m_uiBoundaryPointFillTransparency = attr.as_uint(); break;
+                        case ODGPX_ATTR_INCLUSION_FILL_SIZE: r.m_iInclusionBoundaryPointSize = attr.as_int(); break;
+                    }
+                }
+                break;
+            case ODGPX_NATURAL_SCALE:
+                ODGPXLoadContext::ToDouble( pcv, &r.m_dNaturalScale );
+                break;
+            case ODGPX_DISPLAY_TEXT_WHEN:
+                ODGPXLoadContext::ToLong( pcv, &v );
+                r.m_iDisplayTextWhen = v;
+                break;
         }
     }   // for
+    
+    r.m_iLinks = pLinks->size() - r.m_iFirstLink;
+}
+
+ODPoint *ODNavObjectChanges::CreateODPoint( const ODGPXPointRecord &r, const std::vector<ODGPXLink> &links,
+                                            bool b_fullviz, bool b_layer, bool b_layerviz, int layer_id )
+{
+    wxString GuidString = r.m_sGUID;
+    ODPoint *pOP = NULL;
+    TextPoint *pTP = NULL;
+    BoundaryPoint *pBP = NULL;
 
     // Create ODPoint
 
@@ -935,15 +1205,15 @@ ODPoint * ODNavObjectChanges::GPXLoadODPoint1( pugi::xml_node &opt_node,
     pOP = tempODPointExists( GuidString );
     if(!pOP) pOP = ODPointExists( GuidString );
     if( !pOP ) {
-        if( TypeString == wxT("Text Point") ) {
-            pTP = new TextPoint( rlat, rlon, SymString, NameString, GuidString, false );
+        if( r.m_sType == wxT("Text Point") ) {
+            pTP = new TextPoint( r.m_dLat, r.m_dLon, r.m_sSym, r.m_sName, GuidString, false );
             pOP = pTP;
-        } else if( TypeString == wxT("Boundary Point") ) {
-            pBP = new BoundaryPoint( rlat, rlon, SymString, NameString, GuidString, false );
+        } else if( r.m_sType == wxT("Boundary Point") ) {
+            pBP = new BoundaryPoint( r.m_dLat, r.m_dLon, r.m_sSym, r.m_sName, GuidString, false );
             pOP = pBP;
         }
         else
-            pOP = new ODPoint( rlat, rlon, SymString, NameString, GuidString, false ); // do not add to global WP list yet...
+            pOP = new ODPoint( r.m_dLat, r.m_dLon, r.m_sSym, r.m_sName, GuidString, false ); // do not add to global WP list yet...
             
         m_ptODPointList->Append( pOP ); 
     } else {
@@ -952,57 +1222,61 @@ ODPoint * ODNavObjectChanges::GPXLoadODPoint1( pugi::xml_node &opt_node,
         else if(pOP->m_sTypeString == wxT("Boundary Point"))
             pBP = (BoundaryPoint *)pOP;
         
-        pOP->m_lat = rlat;
-        pOP->m_lon = rlon;
-        pOP->m_IconName = SymString;
-        pOP->SetName( NameString );
+        // the point moves, so it has to be filed again under its new position
+        bool l_bIndexed = m_pPointIndex && m_pPointIndex->Remove( pOP );
+        pOP->m_lat = r.m_dLat;
+        pOP->m_lon = r.m_dLon;
+        pOP->m_IconName = r.m_sSym;
+        pOP->SetName( r.m_sName );
+        if( l_bIndexed )
+            m_pPointIndex->Add( pOP );
     }
-    if( TypeString == _T("Text Point") ) {
-        pTP->SetPointText( TextString );
-        pTP->m_iTextPosition = l_iTextPosition;
-        pTP->m_colourTextColour = l_colourTextColour;
-        pTP->m_DisplayTextFont.SetPointSize( l_iTextPointFontSize );
-        pTP->m_DisplayTextFont.SetFamily( l_iTextPointFontFamily );
-        pTP->m_DisplayTextFont.SetStyle( l_iTextPointFontStyle );
-        pTP->m_DisplayTextFont.SetWeight( l_iTextPointFontWeight );
-        pTP->m_DisplayTextFont.SetUnderlined( l_bTextPointFontUnderline );
+    if( r.m_sType == _T("Text Point") ) {
+        pTP->SetPointText( r.m_sText );
+        pTP->m_iTextPosition = r.m_iTextPosition;
+        pTP->m_colourTextColour = r.m_colourTextColour;
+        pTP->m_DisplayTextFont.SetPointSize( r.m_iTextPointFontSize );
+        pTP->m_DisplayTextFont.SetFamily( r.m_iTextPointFontFamily );
+        pTP->m_DisplayTextFont.SetStyle( r.m_iTextPointFontStyle );
+        pTP->m_DisplayTextFont.SetWeight( r.m_iTextPointFontWeight );
+        pTP->m_DisplayTextFont.SetUnderlined( r.m_bTextPointFontUnderline );
 #if wxCHECK_VERSION(3,0,0) 
-        pTP->m_DisplayTextFont.SetStrikethrough( l_bTextPointFontStrikethrough );
+        pTP->m_DisplayTextFont.SetStrikethrough( r.m_bTextPointFontStrikethrough );
 #endif
-        pTP->m_DisplayTextFont.SetFaceName( l_wxsTextPointFontFace );
-        pTP->m_DisplayTextFont.SetEncoding( (wxFontEncoding)l_iTextPointFontEncoding );
-        pTP->m_colourTextBackgroundColour = l_colourBackgroundColour;
-        pTP->m_iBackgroundTransparency = l_iBackgroundTransparency;
-        pTP->m_natural_scale = l_natural_scale;
-        pTP->m_iDisplayTextWhen = l_display_text_when;
-    } else if ( TypeString == _T("Boundary Point") ) {
-        pBP -> m_bExclusionBoundaryPoint = l_bExclusionBoundaryPoint;
-        pBP -> m_bInclusionBoundaryPoint = l_bInclusionBoundaryPoint;
-        pBP -> m_iInclusionBoundaryPointSize = l_iInclusionBoundaryPointSize;
-        pBP -> m_uiBoundaryPointFillTransparency = l_uiBoundaryPointFillTransparency;
+        pTP->m_DisplayTextFont.SetFaceName( r.m_wxsTextPointFontFace );
+        pTP->m_DisplayTextFont.SetEncoding( (wxFontEncoding)r.m_iTextPointFontEncoding );
+        pTP->m_colourTextBackgroundColour = r.m_colourBackgroundColour;
+        pTP->m_iBackgroundTransparency = r.m_iBackgroundTransparency;
+        pTP->m_natural_scale = r.m_dNaturalScale;
+        pTP->m_iDisplayTextWhen = r.m_iDisplayTextWhen;
+    } else if ( r.m_sType == _T("Boundary Point") ) {
+        pBP -> m_bExclusionBoundaryPoint = r.m_bExclusionBoundaryPoint;
+        pBP -> m_bInclusionBoundaryPoint = r.m_bInclusionBoundaryPoint;
+        pBP -> m_iInclusionBoundaryPointSize = r.m_iInclusionBoundaryPointSize;
+        pBP -> m_uiBoundaryPointFillTransparency = r.m_uiBoundaryPointFillTransparency;
     }
     
-    pOP->SetMarkDescription( DescString );
-    pOP->m_sTypeString = TypeString;
-    pOP->SetODPointArrivalRadius( ArrivalRadius );
-    pOP->SetODPointRangeRingsNumber( l_iODPointRangeRingsNumber );
-    pOP->SetODPointRangeRingsStep( l_fODPointRangeRingsStep );
-    pOP->SetODPointRangeRingsStepUnits( l_pODPointRangeRingsStepUnits );
-    pOP->SetShowODPointRangeRings( l_bODPointRangeRingsVisible );
-    pOP->SetODPointRangeRingsColour( l_wxcODPointRangeRingsColour );
-    pOP->SetODPointRangeRingWidth( l_iODPointRangeRingWidth );
-    pOP->SetODPointRangeRingStyle( l_iODPointRangeRingStyle );
-
-    if( b_propvizname )
-        pOP->m_bShowName = bviz_name;
+    pOP->SetMarkDescription( r.m_sDesc );
+    pOP->m_sTypeString = r.m_sType;
+    pOP->SetODPointArrivalRadius( r.m_dArrivalRadius );
+    pOP->SetODPointRangeRingsNumber( r.m_iODPointRangeRingsNumber );
+    pOP->SetODPointRangeRingsStep( r.m_fODPointRangeRingsStep );
+    pOP->SetODPointRangeRingsStepUnits( r.m_iODPointRangeRingsStepUnits );
+    pOP->SetShowODPointRangeRings( r.m_bODPointRangeRingsVisible );
+    pOP->SetODPointRangeRingsColour( r.m_wxcODPointRangeRingsColour );
+    pOP->SetODPointRangeRingWidth( r.m_iODPointRangeRingWidth );
+    pOP->SetODPointRangeRingStyle( r.m_iODPointRangeRingStyle );
+
+    if( r.m_bPropVizName )
+        pOP->m_bShowName = r.m_bVizName;
     else
         if( b_fullviz )
             pOP->m_bShowName = true;
         else
             pOP->m_bShowName = false;
 
-    if( b_propviz )
-        pOP->m_bIsVisible = bviz;
+    if( r.m_bPropViz )
+        pOP->m_bIsVisible = r.m_bViz;
     else
         if( b_fullviz )
             pOP->m_bIsVisible = true;
@@ -1014,15 +1288,16 @@ ODPoint * ODNavObjectChanges::GPXLoadODPoint1( pugi::xml_node &opt_node,
         pOP->SetListed( false );
     }
 
-    pOP->m_bKeepXPath = bshared;
-    pOP->m_bDynamicName = bauto_name;
+    pOP->m_bKeepXPath = r.m_bShared;
+    pOP->m_bDynamicName = r.m_bAutoName;
 
-    if(TimeString.Len()) {
-        pOP->m_timestring = TimeString;
+    if(r.m_sTime.Len()) {
+        pOP->m_timestring = r.m_sTime;
         pOP->SetCreateTime(wxInvalidDateTime);          // cause deferred timestamp parsing
     }
         
 
+    HyperlinkList *linklist = CreateLinkList( links, r.m_iFirstLink, r.m_iLinks );
     if( linklist ) {
         delete pOP->m_HyperlinkList;                    // created in RoutePoint ctor
         pOP->m_HyperlinkList = linklist;
@@ -1036,183 +1311,264 @@ ODPath *ODNavObjectChanges::GPXLoadPath1( pugi::xml_node &odpoint_node  , bool b
                     bool b_layerviz,
                     int layer_id, wxString *pPathType )
 {
-    wxString PathName;
-    wxString DescString;
-    bool b_propviz = false;
-    bool b_viz = true;
-    bool b_active = false;
-    Boundary    *pTentBoundary = NULL;
-    EBL         *pTentEBL = NULL;
-    DR          *pTentDR = NULL;
-    ODPath        *pTentPath = NULL;
-    HyperlinkList *linklist = NULL;
-    
-    //m_ptODPointList->clear();
-    wxString Name = wxString::FromUTF8( odpoint_node.name() );
-    if( Name == _T ( "opencpn:path" ) ) {
-        if (!strcmp(pPathType->mb_str(), "Boundary" ) ) {
-            pTentBoundary = new Boundary();
-            pTentPath = pTentBoundary;
-        } else if (!strcmp(pPathType->mb_str(), "EBL" ) ) {
-            pTentEBL = new EBL();
-            pTentPath = pTentEBL;
-        } else if (!strcmp(pPathType->mb_str(), "DR" ) ) {
-            pTentDR = new DR();
-            pTentPath = pTentDR;
-        } else 
-            pTentPath = new ODPath();
-        
-        for( pugi::xml_node tschild = odpoint_node.first_child(); tschild; tschild = tschild.next_sibling() ) {
-            wxString ChildName = wxString::FromUTF8( tschild.name() );
+    m_LoadRecords.Clear();
+    ODGPXPathRecord l_rec;
+    ReadPathRecord( odpoint_node, *pPathType, &l_rec, &m_LoadRecords );
+    return CreatePath( l_rec, m_LoadRecords, b_fullviz, b_layer, b_layerviz, layer_id );
+}
 
-            if( ChildName == _T ( "opencpn:ODPoint" ) ) {
-                ODPoint *tpOp = GPXLoadODPoint1(  tschild, _T("square"), _T(""), b_fullviz, b_layer, b_layerviz, layer_id);
-                
-                pTentPath->AddPoint( tpOp, false, true, true);          // defer BBox calculation
-                if(pTentBoundary) tpOp->m_bIsInBoundary = true;                      // Hack
-            }
-            else if( ChildName == _T ( "name" ) ) {
-                PathName.append( wxString::FromUTF8( tschild.first_child().value() ) );
-            }
-            else if( ChildName == _T ( "desc" ) ) {
-                DescString.append( wxString::FromUTF8( tschild.first_child().value() ) );
-            }
-                
-            else if( ChildName == _T ( "link") ) {
-                wxString HrefString;
-                wxString HrefTextString;
-                wxString HrefTypeString;
-                if( linklist == NULL )
-                    linklist = new HyperlinkList;
-                HrefString = wxString::FromUTF8( tschild.first_attribute().value() );
-
-                for( pugi::xml_node child1 = tschild.first_child(); child1; child1 = child1.next_sibling() ) {
-                    wxString LinkString = wxString::FromUTF8( child1.name() );
-
-                    if( LinkString == _T ( "text" ) )
-                        HrefTextString.append( wxString::FromUTF8( child1.first_child().value() ) );
-                    if( LinkString == _T ( "type" ) ) 
-                        HrefTypeString.append( wxString::FromUTF8( child1.first_child().value() ) );
-                }
-            
-                Hyperlink *link = new Hyperlink;
-                link->Link = HrefString;
-                link->DescrText = HrefTextString;
-                link->LType = HrefTypeString;
-                linklist->Append( link );
-            }
-            
-            else if( ChildName == _T ( "opencpn:viz" ) ) {
-                wxString viz = wxString::FromUTF8(tschild.first_child().value());
-                b_propviz = true;
-                b_viz = ( viz == _T("1") );
-            }
-            
-            else if( ChildName == _T ( "opencpn:active" ) ) {
-                wxString active = wxString::FromUTF8(tschild.first_child().value());
-                b_active = ( active == _T("1") );
-            }
-            else if( ChildName == _T ( "opencpn:style" ) ) {
+void ODNavObjectChanges::ReadPathRecord( pugi::xml_node &odpoint_node, const wxString &type, ODGPXPathRecord *pRec, ODGPXRecordSet *pSet )
+{
+    pRec->Reset( type );
+    ODGPXPathRecord &r = *pRec;
+    r.m_iFirstPoint = pSet->m_Points.size();
+    
+    // the points bring their own links, these are added once the points are done
+    std::vector<ODGPXLink> l_PathLinks;
+    
+    for( pugi::xml_node tschild = odpoint_node.first_child(); tschild; tschild = tschild.next_sibling() ) {
+        const char *pcv = tschild.first_child().value();
+        long v;
+
+        switch( ODGPXLoadContext::Lookup( tschild.name() ) ) {
+            case ODGPX_ODPOINT:
+                pSet->m_Points.push_back( ODGPXPointRecord() );
+                ReadODPointRecord( tschild, _T("square"), _T(""), &pSet->m_Points.back(), &pSet->m_Links );
+                break;
+            case ODGPX_NAME:
+                r.m_sName.append( wxString::FromUTF8( pcv ) );
+                break;
+            case ODGPX_DESC:
+                r.m_sDesc.append( wxString::FromUTF8( pcv ) );
+                break;
+            case ODGPX_LINK:
+                ReadGPXLink( tschild, &l_PathLinks );
+                break;
+            case ODGPX_VIZ:
+                r.m_bPropViz = true;
+                r.m_bViz = !strcmp( pcv, "1" );
+                break;
+            case ODGPX_ACTIVE:
+                r.m_bActive = !strcmp( pcv, "1" );
+                break;
+            case ODGPX_STYLE:
                 for (pugi::xml_attribute attr = tschild.first_attribute(); attr; attr = attr.next_attribute())
                 {
-                    if ( wxString::FromUTF8( attr.name() ) == _T("active_colour" ) )
-                        pTentPath->m_wxcActiveLineColour.Set( wxString::FromUTF8( attr.as_string() ) );
-                    else if ( wxString::FromUTF8( attr.name() ) == _T("active_fillcolour" ) )
-                        pTentBoundary->m_wxcActiveFillColour.Set( wxString::FromUTF8( attr.as_string() ) );
-                    if ( wxString::FromUTF8( attr.name() ) == _T("inactive_colour" ) )
-                        pTentPath->m_wxcInActiveLineColour.Set( wxString::FromUTF8( attr.as_string() ) );
-                    else if ( wxString::FromUTF8( attr.name() ) == _T("inactive_fillcolour" ) )
-                        pTentBoundary->m_wxcInActiveFillColour.Set( wxString::FromUTF8( attr.as_string() ) );
-                    else if ( wxString::FromUTF8( attr.name() ) == _T("style" ) )
-                        pTentPath->m_style = attr.as_int();
-                    else if ( wxString::FromUTF8( attr.name() ) == _T("width" ) )
-                        pTentPath->m_width = attr.as_int();
-                    else if ( wxString::FromUTF8( attr.name() ) == _T("fill_transparency") )
-                        pTentBoundary->m_uiFillTransparency = attr.as_uint();
-                    else if ( wxString::FromUTF8( attr.name() ) == _T("inclusion_boundary_size") )
-                        pTentBoundary->m_iInclusionBoundarySize = attr.as_uint();
+                    switch( ODGPXLoadContext::Lookup( attr.name() ) ) {
+                        case ODGPX_ATTR_ACTIVE_COLOUR:
+                            if( r.m_wxcActiveLineColour.Set( wxString::FromUTF8( attr.as_string() ) ) )
+                                r.m_iFields |= ODGPX_PATH_ACTIVE_COLOUR;
+                            break;
+                        case ODGPX_ATTR_ACTIVE_FILLCOLOUR:
+                            if( r.m_wxcActiveFillColour.Set( wxString::FromUTF8( attr.as_string() ) ) )
+                                r.m_iFields |= ODGPX_PATH_ACTIVE_FILLCOLOUR;
+                            break;
+                        case ODGPX_ATTR_INACTIVE_COLOUR:
+                            if( r.m_wxcInActiveLineColour.Set( wxString::FromUTF8( attr.as_string() ) ) )
+                                r.m_iFields |= ODGPX_PATH_INACTIVE_COLOUR;
+                            break;
+                        case ODGPX_ATTR_INACTIVE_FILLCOLOUR:
+                            if( r.m_wxcInActiveFillColour.Set( wxString::FromUTF8( attr.as_string() ) ) )
+                                r.m_iFields |= ODGPX_PATH_INACTIVE_FILLCOLOUR;
+                            break;
+                        case ODGPX_ATTR_STYLE:
+                            r.m_iStyle = attr.as_int();
+                            r.m_iFields |= ODGPX_PATH_STYLE;
+                            break;
+                        case ODGPX_ATTR_WIDTH:
+                            r.m_iWidth = attr.as_int();
+                            r.m_iFields |= ODGPX_PATH_WIDTH;
+                            break;
+                        case ODGPX_ATTR_FILL_TRANSPARENCY:
+                            r.m_uiFillTransparency = attr.as_uint();
+                            r.m_iFields |= ODGPX_PATH_FILL_TRANSPARENCY;
+                            break;
+                        case ODGPX_ATTR_INCLUSION_BOUNDARY_SIZE:
+                            r.m_iInclusionBoundarySize = attr.as_uint();
+                            r.m_iFields |= ODGPX_PATH_INCLUSION_SIZE;
+                            break;
+                    }
                 }
-            } else if( ChildName == _T( "opencpn:boundary_type") ) {
-                wxString s = wxString::FromUTF8( tschild.first_child().value() );
-                if( s == _T("Exclusion") ) {
-                    pTentBoundary->m_bExclusionBoundary = true;
-                    pTentBoundary->m_bInclusionBoundary = false;
-                } else if( s == _T("Inclusion") ) {
-                    pTentBoundary->m_bExclusionBoundary = false;
-                    pTentBoundary->m_bInclusionBoundary = true;
-                } else if( s == _T("Neither") ) {
-                    pTentBoundary->m_bExclusionBoundary = false;
-                    pTentBoundary->m_bInclusionBoundary = false;
-                } else pTentBoundary->m_bExclusionBoundary = false;
-            } else if( ChildName == _T ( "opencpn:guid" ) ) {
-                //if ( !g_bODIsNewLayer ) ) 
-                pTentPath->m_GUID.clear();
-                pTentPath->m_GUID.append( wxString::FromUTF8(tschild.first_child().value()) );
-            } else if( ChildName == _T ( "opencpn:time_display" ) ) {
-                pTentPath->m_TimeDisplayFormat.append( wxString::FromUTF8(tschild.first_child().value()) );
-            } else if( ChildName == _T ( "opencpn:persistence" ) ) {
-                wxString s = wxString::FromUTF8( tschild.first_child().value() );
-                long v = 0;
-                if( s.ToLong( &v ) ) {
-                    if (!strcmp(pPathType->mb_str(), "EBL" ) )
-                        pTentEBL->SetPersistence( v );
-                    else if (!strcmp(pPathType->mb_str(), "DR" ) )
-                        pTentDR->SetPersistence( v );
+                break;
+            case ODGPX_BOUNDARY_TYPE:
+                r.m_iFields |= ODGPX_PATH_EXCLUSION;
+                if( !strcmp( pcv, "Exclusion" ) ) {
+                    r.m_bExclusionBoundary = true;
+                    r.m_bInclusionBoundary = false;
+                    r.m_iFields |= ODGPX_PATH_INCLUSION;
+                } else if( !strcmp( pcv, "Inclusion" ) ) {
+                    r.m_bExclusionBoundary = false;
+                    r.m_bInclusionBoundary = true;
+                    r.m_iFields |= ODGPX_PATH_INCLUSION;
+                } else if( !strcmp( pcv, "Neither" ) ) {
+                    r.m_bExclusionBoundary = false;
+                    r.m_bInclusionBoundary = false;
+                    r.m_iFields |= ODGPX_PATH_INCLUSION;
+                } else r.m_bExclusionBoundary = false;
+                break;
+            case ODGPX_GUID:
+                r.m_sGUID = wxString::FromUTF8( pcv );
+                r.m_iFields |= ODGPX_PATH_GUID;
+                break;
+            case ODGPX_TIME_DISPLAY:
+                r.m_sTimeDisplay.append( wxString::FromUTF8( pcv ) );
+                break;
+            case ODGPX_PERSISTENCE:
+                if( ODGPXLoadContext::ToLong( pcv, &v ) ) {
+                    r.m_iPersistence = v;
+                    r.m_iFields |= ODGPX_PATH_PERSISTENCE;
                 }
-            } else if( ChildName == _T ( "opencpn:show_arrow" ) ) {
-                wxString s = wxString::FromUTF8( tschild.first_child().value() );
-                pTentEBL->m_bDrawArrow = ( s == wxT("1") );
-            } else if( ChildName == _T ( "opencpn:VRM" ) ) {
-                wxString s = wxString::FromUTF8( tschild.first_child().value() );
-                pTentEBL->m_bVRM = ( s == wxT("1") );
-            } else if( ChildName == _T ( "opencpn:fixed_end_position" ) ) {
-                wxString s = wxString::FromUTF8( tschild.first_child().value() );
-                pTentEBL->m_bFixedEndPosition = ( s == wxT("1") );
-            } else if( ChildName == _T ( "opencpn:DRSOG" ) ) {
-                wxString::FromUTF8( tschild.first_child().value() ).ToDouble( &pTentDR->m_dSoG );
-            } else if( ChildName == _T ( "opencpn:DRCOG" ) ) {
-                wxString::FromUTF8( tschild.first_child().value() ).ToLong( (long *)&pTentDR->m_iCoG );
-            } else if( ChildName == _T ( "opencpn:DRLength" ) ) {
-                wxString::FromUTF8( tschild.first_child().value() ).ToDouble( &pTentDR->m_dDRPathLength );
-            } else if( ChildName == _T ( "opencpn:DRLengthNM" ) ) {
-                wxString::FromUTF8( tschild.first_child().value() ).ToDouble( &pTentDR->m_dTotalLengthNM );
-            } else if( ChildName == _T ( "opencpn:DRPointIterval" ) ) {
-                wxString::FromUTF8( tschild.first_child().value() ).ToDouble( &pTentDR->m_dDRPointInterval );
-            } else if( ChildName == _T ( "opencpn:DRPointItervalNM" ) ) {
-                wxString::FromUTF8( tschild.first_child().value() ).ToDouble( &pTentDR->m_dDRPointIntervalNM );
-            } else if( ChildName == _T ( "opencpn:DRLengthType" ) ) {
-                wxString::FromUTF8( tschild.first_child().value() ).ToLong( (long *)&pTentDR->m_iLengthType );
-            } else if( ChildName == _T ( "opencpn:DRIntervalType" ) ) {
-                wxString::FromUTF8( tschild.first_child().value() ).ToLong( (long *)&pTentDR->m_iIntervalType );
-            } else if( ChildName == _T ( "opencpn:DRDistanceUnits" ) ) {
-                wxString::FromUTF8( tschild.first_child().value() ).ToLong( (long *)&pTentDR->m_iDistanceUnits );
-            } else if( ChildName == _T ( "opencpn:DRTimeUnits" ) ) {
-                wxString::FromUTF8( tschild.first_child().value() ).ToLong( (long *)&pTentDR->m_iTimeUnits );
-            }
-        }   
-        pTentPath->m_PathNameString = PathName;
-        pTentPath->m_PathDescription = DescString;
-
-        pTentPath->m_wxcActiveLineColour.Set( pTentPath->m_wxcActiveLineColour.Red(), pTentPath->m_wxcActiveLineColour.Green(), pTentPath->m_wxcActiveLineColour.Blue() );
-        pTentPath->m_wxcInActiveLineColour.Set( pTentPath->m_wxcInActiveLineColour.Red(), pTentPath->m_wxcInActiveLineColour.Green(), pTentPath->m_wxcInActiveLineColour.Blue() );
-        
-        if( b_propviz )
-                pTentPath->SetVisible( b_viz );
-        else {
-            if( b_fullviz )
-                pTentPath->SetVisible();
+                break;
+            case ODGPX_SHOW_ARROW:
+                r.m_bDrawArrow = !strcmp( pcv, "1" );
+                r.m_iFields |= ODGPX_PATH_SHOW_ARROW;
+                break;
+            case ODGPX_VRM:
+                r.m_bVRM = !strcmp( pcv, "1" );
+                r.m_iFields |= ODGPX_PATH_VRM;
+                break;
+            case ODGPX_FIXED_END_POSITION:
+                r.m_bFixedEndPosition = !strcmp( pcv, "1" );
+                r.m_iFields |= ODGPX_PATH_FIXED_END_POSITION;
+                break;
+            case ODGPX_DR_SOG:
+                ODGPXLoadContext::ToDouble( pcv, &r.m_dSoG );
+                r.m_iFields |= ODGPX_PATH_DR_SOG;
+                break;
+            case ODGPX_DR_COG:
+                ODGPXLoadContext::ToLong( pcv, &v );
+                r.m_iCoG = v;
+                r.m_iFields |= ODGPX_PATH_DR_COG;
+                break;
+            case ODGPX_DR_LENGTH:
+                ODGPXLoadContext::ToDouble( pcv, &r.m_dDRPathLength );
+                r.m_iFields |= ODGPX_PATH_DR_LENGTH;
+                break;
+            case ODGPX_DR_LENGTH_NM:
+                ODGPXLoadContext::ToDouble( pcv, &r.m_dTotalLengthNM );
+                r.m_iFields |= ODGPX_PATH_DR_LENGTH_NM;
+                break;
+            case ODGPX_DR_POINT_INTERVAL:
+                ODGPXLoadContext::ToDouble( pcv, &r.m_dDRPointInterval );
+                r.m_iFields |= ODGPX_PATH_DR_POINT_INTERVAL;
+                break;
+            case ODGPX_DR_POINT_INTERVAL_NM:
+                ODGPXLoadContext::ToDouble( pcv, &r.m_dDRPointIntervalNM );
+                r.m_iFields |= ODGPX_PATH_DR_POINT_INTERVAL_NM;
+                break;
+            case ODGPX_DR_LENGTH_TYPE:
+                ODGPXLoadContext::ToLong( pcv, &v );
+                r.m_iLengthType = v;
+                r.m_iFields |= ODGPX_PATH_DR_LENGTH_TYPE;
+                break;
+            case ODGPX_DR_INTERVAL_TYPE:
+                ODGPXLoadContext::ToLong( pcv, &v );
+                r.m_iIntervalType = v;
+                r.m_iFields |= ODGPX_PATH_DR_INTERVAL_TYPE;
+                break;
+            case ODGPX_DR_DISTANCE_UNITS:
+                ODGPXLoadContext::ToLong( pcv, &v );
+                r.m_iDistanceUnits = v;
+                r.m_iFields |= ODGPX_PATH_DR_DISTANCE_UNITS;
+                break;
+            case ODGPX_DR_TIME_UNITS:
+                ODGPXLoadContext::ToLong( pcv, &v );
+                r.m_iTimeUnits = v;
+                r.m_iFields |= ODGPX_PATH_DR_TIME_UNITS;
+                break;
         }
+    }
+    
+    r.m_iPoints = pSet->m_Points.size() - r.m_iFirstPoint;
+    r.m_iFirstLink = pSet->m_Links.size();
+    r.m_iLinks = l_PathLinks.size();
+    pSet->m_Links.insert( pSet->m_Links.end(), l_PathLinks.begin(), l_PathLinks.end() );
+}
 
-        pTentPath->m_bPathIsActive = b_active;
+ODPath *ODNavObjectChanges::CreatePath( const ODGPXPathRecord &r, const ODGPXRecordSet &set, bool b_fullviz,
+                                        bool b_layer, bool b_layerviz, int layer_id )
+{
+    Boundary    *pTentBoundary = NULL;
+    EBL         *pTentEBL = NULL;
+    DR          *pTentDR = NULL;
+    ODPath        *pTentPath = NULL;
+    
+    if( r.m_sType == wxS("Boundary") ) {
+        pTentBoundary = new Boundary();
+        pTentPath = pTentBoundary;
+    } else if( r.m_sType == wxS("EBL") ) {
+        pTentEBL = new EBL();
+        pTentPath = pTentEBL;
+    } else if( r.m_sType == wxS("DR") ) {
+        pTentDR = new DR();
+        pTentPath = pTentDR;
+    } else 
+        pTentPath = new ODPath();
+    
+    unsigned int f = r.m_iFields;
+    if( f & ODGPX_PATH_GUID ) pTentPath->m_GUID = r.m_sGUID;
+    pTentPath->m_TimeDisplayFormat.append( r.m_sTimeDisplay );
+    if( f & ODGPX_PATH_ACTIVE_COLOUR ) pTentPath->m_wxcActiveLineColour = r.m_wxcActiveLineColour;
+    if( f & ODGPX_PATH_INACTIVE_COLOUR ) pTentPath->m_wxcInActiveLineColour = r.m_wxcInActiveLineColour;
+    if( f & ODGPX_PATH_STYLE ) pTentPath->m_style = r.m_iStyle;
+    if( f & ODGPX_PATH_WIDTH ) pTentPath->m_width = r.m_iWidth;
+    
+    if( pTentBoundary ) {
+        if( f & ODGPX_PATH_ACTIVE_FILLCOLOUR ) pTentBoundary->m_wxcActiveFillColour = r.m_wxcActiveFillColour;
+        if( f & ODGPX_PATH_INACTIVE_FILLCOLOUR ) pTentBoundary->m_wxcInActiveFillColour = r.m_wxcInActiveFillColour;
+        if( f & ODGPX_PATH_FILL_TRANSPARENCY ) pTentBoundary->m_uiFillTransparency = r.m_uiFillTransparency;
+        if( f & ODGPX_PATH_INCLUSION_SIZE ) pTentBoundary->m_iInclusionBoundarySize = r.m_iInclusionBoundarySize;
+        if( f & ODGPX_PATH_EXCLUSION ) pTentBoundary->m_bExclusionBoundary = r.m_bExclusionBoundary;
+        if( f & ODGPX_PATH_INCLUSION ) pTentBoundary->m_bInclusionBoundary = r.m_bInclusionBoundary;
+    } else if( pTentEBL ) {
+        if( f & ODGPX_PATH_PERSISTENCE ) pTentEBL->SetPersistence( r.m_iPersistence );
+        if( f & ODGPX_PATH_SHOW_ARROW ) pTentEBL->m_bDrawArrow = r.m_bDrawArrow;
+        if( f & ODGPX_PATH_VRM ) pTentEBL->m_bVRM = r.m_bVRM;
+        if( f & ODGPX_PATH_FIXED_END_POSITION ) pTentEBL->m_bFixedEndPosition = r.m_bFixedEndPosition;
+    } else if( pTentDR ) {
+        if( f & ODGPX_PATH_PERSISTENCE ) pTentDR->SetPersistence( r.m_iPersistence );
+        if( f & ODGPX_PATH_DR_SOG ) pTentDR->m_dSoG = r.m_dSoG;
+        if( f & ODGPX_PATH_DR_COG ) pTentDR->m_iCoG = r.m_iCoG;
+        if( f & ODGPX_PATH_DR_LENGTH ) pTentDR->m_dDRPathLength = r.m_dDRPathLength;
+        if( f & ODGPX_PATH_DR_LENGTH_NM ) pTentDR->m_dTotalLengthNM = r.m_dTotalLengthNM;
+        if( f & ODGPX_PATH_DR_POINT_INTERVAL ) pTentDR->m_dDRPointInterval = r.m_dDRPointInterval;
+        if( f & ODGPX_PATH_DR_POINT_INTERVAL_NM ) pTentDR->m_dDRPointIntervalNM = r.m_dDRPointIntervalNM;
+        if( f & ODGPX_PATH_DR_LENGTH_TYPE ) pTentDR->m_iLengthType = r.m_iLengthType;
+        if( f & ODGPX_PATH_DR_INTERVAL_TYPE ) pTentDR->m_iIntervalType = r.m_iIntervalType;
+        if( f & ODGPX_PATH_DR_DISTANCE_UNITS ) pTentDR->m_iDistanceUnits = r.m_iDistanceUnits;
+        if( f & ODGPX_PATH_DR_TIME_UNITS ) pTentDR->m_iTimeUnits = r.m_iTimeUnits;
+    }
+    
+    for( size_t i = r.m_iFirstPoint; i < r.m_iFirstPoint + r.m_iPoints; i++ ) {
+        ODPoint *tpOp = CreateODPoint( set.m_Points[i], set.m_Links, b_fullviz, b_layer, b_layerviz, layer_id );
         
-        if( b_layer ){
-            pTentPath->SetVisible( b_layerviz );
-            pTentPath->m_bIsInLayer = true;
-            pTentPath->m_LayerID = layer_id;
-            pTentPath->SetListed( false );
-        }            
+        pTentPath->AddPoint( tpOp, false, true, true);          // defer BBox calculation
+        if(pTentBoundary) tpOp->m_bIsInBoundary = true;                      // Hack
+    }
+    
+    pTentPath->m_PathNameString = r.m_sName;
+    pTentPath->m_PathDescription = r.m_sDesc;
 
+    pTentPath->m_wxcActiveLineColour.Set( pTentPath->m_wxcActiveLineColour.Red(), pTentPath->m_wxcActiveLineColour.Green(), pTentPath->m_wxcActiveLineColour.Blue() );
+    pTentPath->m_wxcInActiveLineColour.Set( pTentPath->m_wxcInActiveLineColour.Red(), pTentPath->m_wxcInActiveLineColour.Green(), pTentPath->m_wxcInActiveLineColour.Blue() );
+    
+    if( r.m_bPropViz )
+            pTentPath->SetVisible( r.m_bViz );
+    else {
+        if( b_fullviz )
+            pTentPath->SetVisible();
     }
+
+    pTentPath->m_bPathIsActive = r.m_bActive;
+    
+    if( b_layer ){
+        pTentPath->SetVisible( b_layerviz );
+        pTentPath->m_bIsInLayer = true;
+        pTentPath->m_LayerID = layer_id;
+        pTentPath->SetListed( false );
+    }            
+
+    HyperlinkList *linklist = CreateLinkList( set.m_Links, r.m_iFirstLink, r.m_iLinks );
     if( linklist ) {
         delete pTentPath->m_HyperlinkList;                    // created in RoutePoint ctor
         pTentPath->m_HyperlinkList = linklist;
@@ -1225,6 +1581,9 @@ ODPath *ODNavObjectChanges::GPXLoadPath1( pugi::xml_node &odpoint_node  , bool b
 
 ODPoint *ODNavObjectChanges::ODPointExists( const wxString& name, double lat, double lon )
 {
+    if( m_pPointIndex )
+        return m_pPointIndex->Find( name, lat, lon );
+    
     ODPoint *pret = NULL;
     wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst();
     while( node ) {
@@ -1246,6 +1605,9 @@ ODPoint *ODNavObjectChanges::ODPointExists( const wxString& name, double lat, do
 
 ODPoint *ODNavObjectChanges::ODPointExists( const wxString& guid )
 {
+    if( m_pPointIndex )
+        return m_pPointIndex->Find( guid );
+    
     wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst();
     while( node ) {
         ODPoint *pr = node->GetData();
@@ -1278,16 +1640,20 @@ ODPoint *ODNavObjectChanges::tempODPointExists( const wxString& guid )
     return NULL;
 }
 
-void ODNavObjectChanges::InsertPathA( ODPath *pTentPath )
+bool ODNavObjectChanges::InsertPathA( ODPath *pTentPath )
 {
     if( !pTentPath )
-        return;
+        return false;
     
     bool bAddpath = true;
     //    If the path has only 1 point, don't load it.
     if( pTentPath->GetnPoints() < 2 )
         bAddpath = false;
     
+    //    Nor if it is already loaded
+    if( bAddpath && m_pPathIndex && PathExists( pTentPath ) )
+        bAddpath = false;
+    
     //    TODO  All this trouble for a tentative path.......Should make some path methods????
     if( bAddpath ) {
         if( PathExists( pTentPath->m_GUID ) ) { //We are importing a different path with the same guid, so let's generate it a new guid
@@ -1296,8 +1662,14 @@ void ODNavObjectChanges::InsertPathA( ODPath *pTentPath )
             wxODPointListNode *pthisnode = ( pTentPath->m_pODPointList )->GetFirst();
             while( pthisnode ) {
                 ODPoint *pP =  pthisnode->GetData();
-                if( pP && pP->m_bIsolatedMark )
+                if( pP && pP->m_bIsolatedMark ) {
+                    // the index is keyed on the GUID
+                    if( m_pPointIndex )
+                        m_pPointIndex->Remove( pP );
                     pP->m_GUID = GetUUID();
+                    if( m_pPointIndex )
+                        m_pPointIndex->Add( pP );
+                }
                 pthisnode = pthisnode->GetNext();
             }
         }
@@ -1305,6 +1677,8 @@ void ODNavObjectChanges::InsertPathA( ODPath *pTentPath )
         g_pPathList->Append( pTentPath );
         if(pTentPath->m_sTypeString == wxT("Boundary")) g_pBoundaryList->Append( (Boundary *)pTentPath );
         if(pTentPath->m_sTypeString == wxT("EBL")) g_pEBLList->Append( (EBL *)pTentPath );
+        if( m_pPathIndex )
+            m_pPathIndex->Add( pTentPath );
         
         pTentPath->RebuildGUIDList();                  // ensure the GUID list is intact
         
@@ -1344,14 +1718,22 @@ void ODNavObjectChanges::InsertPathA( ODPath *pTentPath )
             ODPoint *pop = pnode->GetData();
             
             // check all other paths to see if this point appears in any other path
-            ODPath *pcontainer_path = g_pPathMan->FindPathContainingODPoint( pop );
+            bool b_used;
+            if( m_pPathIndex )
+                b_used = m_pPathIndex->IsPointUsed( pop );
+            else
+                b_used = g_pPathMan->FindPathContainingODPoint( pop ) != NULL;
             
-            if( pcontainer_path == NULL ) {
+            if( !b_used ) {
                 pop->m_bIsInPath = false; // Take this point out of this (and only) track/route
                 if( !pop->m_bKeepXPath ) {
+                    bool prev_bskip = g_pODConfig->m_bSkipChangeSetUpdate;
                     g_pODConfig->m_bSkipChangeSetUpdate = true;
                     g_pODConfig->DeleteODPoint( pop );
-                    g_pODConfig->m_bSkipChangeSetUpdate = false;
+                    g_pODConfig->m_bSkipChangeSetUpdate = prev_bskip;
+                    if( m_pPointIndex )
+                        m_pPointIndex->Remove( pop );
+                    m_ptODPointList->DeleteObject( pop );
                     delete pop;
                 }
             }
@@ -1361,10 +1743,14 @@ void ODNavObjectChanges::InsertPathA( ODPath *pTentPath )
         
         delete pTentPath;
     }
+    return bAddpath;
 }
                     
 ODPath *ODNavObjectChanges::PathExists( const wxString& guid )
 {
+    if( m_pPathIndex )
+        return m_pPathIndex->Find( guid );
+    
     wxPathListNode *path_node = g_pPathList->GetFirst();
 
     while( path_node ) {
@@ -1379,6 +1765,9 @@ ODPath *ODNavObjectChanges::PathExists( const wxString& guid )
 
 ODPath *ODNavObjectChanges::PathExists( ODPath * pTentPath )
 {
+    if( m_pPathIndex )
+        return m_pPathIndex->Find( pTentPath );
+    
     wxPathListNode *path_node = g_pPathList->GetFirst();
     while( path_node ) {
         ODPath *ppath = path_node->GetData();
@@ -1400,6 +1789,7 @@ bool ODNavObjectChanges::SaveFile( const wxString filename )
 
 bool ODNavObjectChanges::ApplyChanges(void)
 {
+    m_LoadContext.Snapshot();
     //Let's reconstruct the unsaved changes
     
     pugi::xml_node object = this->first_child();
@@ -1457,9 +1847,10 @@ bool ODNavObjectChanges::ApplyChanges(void)
                     else if(!strcmp(child.first_child().value(), "delete") ){
                         ODPath *pExisting = PathExists( pPath->m_GUID );
                         if(pExisting){
+                            bool prev_bskip = g_pODConfig->m_bSkipChangeSetUpdate;
                             g_pODConfig->m_bSkipChangeSetUpdate = true;
                             g_pPathMan->DeletePath( pExisting );
-                            g_pODConfig->m_bSkipChangeSetUpdate = false;
+                            g_pODConfig->m_bSkipChangeSetUpdate = prev_bskip;
                         }
                     }
                 
@@ -1467,6 +1858,12 @@ bool ODNavObjectChanges::ApplyChanges(void)
                         delete pPath;
                 }
             }
+            else
+                if( !strcmp(object.name(), "opencpn:delete") )
+                    ApplyDeletes( object );
+                else
+                    if( !strcmp(object.name(), "opencpn:path_point") )
+                        ApplyPathPoint( object );
     
         object = object.next_sibling();
                 
@@ -1475,8 +1872,67 @@ bool ODNavObjectChanges::ApplyChanges(void)
     return true;
 }
 
-int ODNavObjectChanges::LoadAllGPXObjectsAsLayer(int layer_id, bool b_layerviz)
+void ODNavObjectChanges::ApplyDeletes( pugi::xml_node object )
+{
+    if( !g_pPathMan || !g_pODPointMan ) return;
+
+    //  Paths are collected in one pass over the path list
+    ODDeleteGUIDHash l_guids;
+    for( pugi::xml_node path = object.child("opencpn:path"); path; path = path.next_sibling("opencpn:path") )
+        l_guids[ wxString::FromUTF8( path.child_value() ) ] = 1;
+
+    ODPathSet l_paths;
+    if( !l_guids.empty() ) {
+        for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() ) {
+            ODPath *ppath = node->GetData();
+            if( l_guids.count( ppath->m_GUID ) ) l_paths.insert( ppath );
+        }
+    }
+
+    ODPointSet l_points;
+    for( pugi::xml_node point = object.child("opencpn:ODPoint"); point; point = point.next_sibling("opencpn:ODPoint") ) {
+        ODPoint *pExisting = ODPointExists( wxString::FromUTF8( point.child_value() ),
+                                            point.attribute("lat").as_double(), point.attribute("lon").as_double() );
+        if( pExisting ) l_points.insert( pExisting );
+    }
+
+    g_pODConfig->m_bSkipChangeSetUpdate = true;
+    if( !l_paths.empty() ) g_pPathMan->DeletePaths( l_paths );
+    if( !l_points.empty() ) g_pODPointMan->DeleteODPoints( l_points, false );
+    g_pODConfig->m_bSkipChangeSetUpdate = false;
+}
+
+void ODNavObjectChanges::ApplyPathPoint( pugi::xml_node object )
+{
+    if( !g_pPathMan || !g_pODPointMan ) return;
+
+    ODPath *pPath = PathExists( wxString::FromUTF8( object.child_value("opencpn:path") ) );
+    if( !pPath ) return;
+
+    g_pODConfig->m_bSkipChangeSetUpdate = true;
+    if( !strcmp( object.child_value("opencpn:action"), "insert" ) ) {
+        ODPoint *pPrev = pPath->GetPoint( wxString::FromUTF8( object.child_value("opencpn:after") ) );
+        pugi::xml_node point = object.child("opencpn:ODPoint");
+        ODPoint *pOp = point ? GPXLoadODPoint1( point, _T("circle"), _T(""), false, false, false, 0 ) : NULL;
+        if( pPrev && pOp ) {
+            pOp->m_bIsInPath = true;
+            g_pODPointMan->AddODPoint( pOp );
+            pPath->InsertPointAfter( pPrev, pOp );
+        } else
+            delete pOp;
+    } else {
+        ODPoint *pOp = pPath->GetPoint( wxString::FromUTF8( object.child_value("opencpn:guid") ) );
+        if( pOp ) pPath->RemovePoint( pOp );
+    }
+    g_pODConfig->m_bSkipChangeSetUpdate = false;
+}
+
+int ODNavObjectChanges::LoadAllGPXObjectsAsLayer( Layer *pLayer )
 {
+    m_LoadContext.Snapshot();
+    int layer_id = pLayer->m_LayerID;
+    bool b_layerviz = pLayer->m_bIsVisibleOnChart;
+
     if(!g_pODPointMan)
         return 0;
     
@@ -1491,6 +1947,9 @@ int ODNavObjectChanges::LoadAllGPXObjectsAsLayer(int layer_id, bool b_layerviz)
             
             if(pOp) {
                 g_pODPointMan->AddODPoint( pOp );
+                if( m_pPointIndex )
+                    m_pPointIndex->Add( pOp );
+                pLayer->AddODPoint( pOp );
                 g_pODSelect->AddSelectableODPoint( pOp->m_lat, pOp->m_lon, pOp );
                 n_obj++;
             }
@@ -1510,7 +1969,8 @@ int ODNavObjectChanges::LoadAllGPXObjectsAsLayer(int layer_id, bool b_layerviz)
                 if ( !TypeString.compare( wxS("Boundary") ) ) {
                     ODPath *pPath = GPXLoadPath1( object, true, true, b_layerviz, layer_id, &TypeString );
                     n_obj++;
-                    InsertPathA( pPath );
+                    if( InsertPathA( pPath ) )
+                        pLayer->AddPath( pPath );
                 }
             }
         }   
@@ -1524,19 +1984,22 @@ void ODNavObjectChanges::UpdatePathA( ODPath *pPathUpdate )
     ODPath * pExistingPath = PathExists( pPathUpdate->m_GUID );
 
     if( pExistingPath ) {
-        if ( pPathUpdate->GetnPoints() < pExistingPath->GetnPoints() ) {
-            wxODPointListNode *enode = pExistingPath->m_pODPointList->GetFirst();
-            while( enode ) {
-                ODPoint *pFP = enode->GetData();
-                ODPoint *pOP = pPathUpdate->GetPoint( pFP->m_GUID );
-                if (!pOP ) {
-                    pExistingPath->RemovePoint( pFP );
-                    enode = pExistingPath->m_pODPointList->GetFirst(); // start at begining of list again
-                } else enode = enode->GetNext();
-            }
+        //  The update holds the whole path, so take its order and only look
+        //  each point up once in the other path's GUID index
+        g_pODSelect->DeleteAllSelectableODPoints( pExistingPath );
+        g_pODSelect->DeleteAllSelectablePathSegments( pExistingPath );
+
+        std::vector<ODPoint *> l_Removed;
+        wxODPointListNode *enode = pExistingPath->m_pODPointList->GetFirst();
+        while( enode ) {
+            ODPoint *ex_op = enode->GetData();
+            if( !pPathUpdate->GetPoint( ex_op->m_GUID ) ) l_Removed.push_back( ex_op );
+            enode = enode->GetNext();
         }
+
+        std::vector<ODPoint *> l_Points;
+        l_Points.reserve( pPathUpdate->m_pODPointList->GetCount() );
         wxODPointListNode *unode = pPathUpdate->m_pODPointList->GetFirst();
-        ODPoint *save_ex_op = NULL;
         while( unode ) {
             ODPoint *up_op = unode->GetData();
             ODPoint *ex_op = pExistingPath->GetPoint( up_op->m_GUID );
@@ -1546,15 +2009,23 @@ void ODNavObjectChanges::UpdatePathA( ODPath *pPathUpdate )
                 ex_op->SetIconName( up_op->GetIconName() );
                 ex_op->m_ODPointDescription = up_op->m_ODPointDescription;
                 ex_op->SetName( up_op->GetName() );
-                save_ex_op = ex_op;
-            } else {
-                pExistingPath->InsertPointAfter( save_ex_op, up_op );
-                save_ex_op = up_op;
-            }
+                l_Points.push_back( ex_op );
+            } else
+                l_Points.push_back( up_op );
             unode = unode->GetNext();
         }
-        g_pODSelect->DeleteAllSelectableODPoints( pExistingPath );
-        g_pODSelect->DeleteAllSelectablePathSegments( pExistingPath );
+        pExistingPath->SetPoints( l_Points );
+
+        for( size_t i = 0; i < l_Removed.size(); i++ ) {
+            ODPoint *pOP = l_Removed[i];
+            if( g_pPathMan->FindPathContainingODPoint( pOP ) ) continue;
+            pOP->m_bIsInPath = false;
+            pOP->m_bDynamicName = false;
+            pOP->m_bIsolatedMark = true;
+            pOP->SetTypeString( wxT("Boundary Point") );
+            g_pODConfig->AddNewODPoint( pOP );
+        }
+
         g_pODSelect->AddAllSelectablePathSegments( pExistingPath );
         g_pODSelect->AddAllSelectableODPoints( pExistingPath );
     } else {
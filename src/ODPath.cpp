@@ -30,6 +30,7 @@
 #endif //precompiled headers
 
 #include "ODPath.h"
+#include "ODProjection.h"
 #include "georef.h"
 #include "ODdc.h"
 #include "cutil.h"
@@ -43,7 +44,9 @@
 #include "bbox.h"
 #include "ODdc.h"
 #include "dychart.h"
+#include "Layer.h"
 #include <wx/gdicmn.h>
+#include <algorithm>
 
 extern PointMan *g_pODPointMan;
 extern bool g_bODIsNewLayer;
@@ -60,7 +63,7 @@ extern wxColour    g_colourInActivePathLineColour;
 
 
 #include <wx/listimpl.cpp>
-WX_DEFINE_LIST ( PathList );
+OD_DEFINE_POOLED_LIST ( PathList );
 
 ODPath::ODPath( void )
 {
@@ -74,6 +77,7 @@ ODPath::ODPath( void )
     m_nPoints = 0;
     m_nm_sequence = 1;
     m_path_length = 0.0;
+    m_bVertexIndexValid = false;
     m_bVisible = true;
     m_bListed = true;
     m_bPathManagerBlink = false;
@@ -109,6 +113,11 @@ ODPath::ODPath( void )
 
 ODPath::~ODPath( void )
 {
+    if( m_bIsInLayer ) {
+        Layer *pLayer = Layer::Find( m_LayerID );
+        if( pLayer ) pLayer->RemovePath( this );
+    }
+    
     m_pODPointList->DeleteContents( false );            // do not delete Marks
     m_pODPointList->Clear();
     delete m_pODPointList;
@@ -125,6 +134,7 @@ void ODPath::AddPoint( ODPoint *pNewPoint, bool b_rename_in_sequence, bool b_def
     pNewPoint->m_bIsInPath = true;
 
     m_pODPointList->Append( pNewPoint );
+    IndexPointGUID( pNewPoint );
 
     m_nPoints++;
 
@@ -147,12 +157,6 @@ void ODPath::AddPoint( ODPoint *pNewPoint, bool b_rename_in_sequence, bool b_def
     return;
 }
 
-void ODPath::AddTentativePoint( const wxString& GUID )
-{
-    ODPointGUIDList.Add( GUID );
-    return;
-}
-
 ODPoint *ODPath::GetPoint( int nWhichPoint )
 {
     ODPoint *pOp;
@@ -172,19 +176,35 @@ ODPoint *ODPath::GetPoint( int nWhichPoint )
 
 ODPoint *ODPath::GetPoint( const wxString &guid )
 {
-    ODPoint *pOp;
-    wxODPointListNode *node = m_pODPointList->GetFirst();
-
-    while( node ) {
-        pOp = node->GetData();
-        if( guid == pOp->m_GUID ) return pOp;
-
-        node = node->GetNext();
+    ODPathGUIDHash::iterator it = m_PointGUIDIndex.find( guid );
+    if( it != m_PointGUIDIndex.end() && it->second.m_pODPoint->m_GUID == guid )
+        return it->second.m_pODPoint;
+
+    //  Not indexed under this GUID, or no longer, if a point has been given a
+    //  new GUID since it was indexed. The list has the last word.
+    for( wxODPointListNode *node = m_pODPointList->GetFirst(); node; node = node->GetNext() ) {
+        if( node->GetData()->m_GUID == guid ) {
+            RebuildGUIDList();
+            return node->GetData();
+        }
     }
-
     return ( NULL );
 }
 
+void ODPath::IndexPointGUID( ODPoint *pOP )
+{
+    ODPathGUIDEntry &entry = m_PointGUIDIndex[ pOP->m_GUID ];
+    entry.m_pODPoint = pOP;
+    entry.m_iCount++;
+}
+
+void ODPath::UnindexPointGUID( ODPoint *pOP )
+{
+    ODPathGUIDHash::iterator it = m_PointGUIDIndex.find( pOP->m_GUID );
+    if( it != m_PointGUIDIndex.end() && --it->second.m_iCount <= 0 )
+        m_PointGUIDIndex.erase( it );
+}
+
 void ODPath::DrawPointWhich( ODDC& dc, int iPoint, wxPoint *rpn )
 {
     if( iPoint <= GetnPoints() )
@@ -224,7 +244,9 @@ void ODPath::Draw( ODDC& dc, PlugIn_ViewPort &VP )
     dc.SetBrush( *wxTheBrushList->FindOrCreateBrush( m_col, wxBRUSHSTYLE_SOLID ) );
 
     wxPoint ppt1, ppt2;
+    ODProjection &l_Projection = ODProjection::ForViewPort( VP );
     m_bpts = new wxPoint[ m_pODPointList->GetCount() ];
+    l_Projection.GetPixFromLL( m_pODPointList, m_bpts );
     int j = 0;
 
     if ( m_bVisible )
@@ -234,23 +256,24 @@ void ODPath::Draw( ODDC& dc, PlugIn_ViewPort &VP )
     ODPoint *pOp1 = node->GetData();
     node = node->GetNext();
     
-    m_bpts[ j++ ] = ppt1;
+    ppt1 = m_bpts[ j++ ];
         
     if ( !m_bVisible && pOp1->m_bKeepXPath )
             pOp1->Draw( dc );
 
+    //    Handle offscreen points
+    LLBBox llbb;
+    llbb.SetMin(VP.lon_min, VP.lat_min);
+    llbb.SetMax(VP.lon_max, VP.lat_max);
+    double pix_full_circle = l_Projection.GetPixFullCircle();
+
     while( node ) {
 
         ODPoint *pOp2 = node->GetData();
-        GetCanvasPixLL( &VP, &ppt2,  pOp2->m_lat, pOp2->m_lon);
-        m_bpts[ j++ ] = ( ppt2 );
+        ppt2 = m_bpts[ j++ ];
 
         if ( m_bVisible )
         {
-            //    Handle offscreen points
-            LLBBox llbb;
-            llbb.SetMin(VP.lon_min, VP.lat_min);
-            llbb.SetMax(VP.lon_max, VP.lat_max);
             bool b_2_on = llbb.PointInBox( pOp2->m_lon, pOp2->m_lat, 0 );
             bool b_1_on = llbb.PointInBox( pOp1->m_lon, pOp1->m_lat, 0 );
 
@@ -261,8 +284,6 @@ void ODPath::Draw( ODDC& dc, PlugIn_ViewPort &VP )
             //    we must decide which way to go in longitude
             //     Arbitrarily, we will go the shortest way
 
-            double pix_full_circle = WGS84_semimajor_axis_meters * mercator_k0 * 2 * PI
-                * VP.view_scale_ppm;
             double dp = pow( (double) ( ppt1.x - ppt2.x ), 2 ) + pow( (double) ( ppt1.y - ppt2.y ), 2 );
             double dtest;
             int adder;
@@ -301,10 +322,8 @@ void ODPath::Draw( ODDC& dc, PlugIn_ViewPort &VP )
     
     for(wxODPointListNode *node  = m_pODPointList->GetFirst(); node; node = node->GetNext()) {
         ODPoint *pOp = node->GetData();
-        wxPoint r;
-        GetCanvasPixLL( &VP, &r, pOp->m_lat, pOp->m_lon );
         if ( m_bVisible || pOp->m_bKeepXPath )
-            pOp->Draw( dc, &r );
+            pOp->Draw( dc );
     }        
     wxDELETEA( m_bpts );
 }
@@ -325,15 +344,8 @@ void ODPath::DrawGL( PlugIn_ViewPort &piVP )
     
     SetActiveColours();
 
-    int j = 0;
-    wxPoint r;
-
     m_bpts = new wxPoint[ m_pODPointList->GetCount() ];
-    for(wxODPointListNode *node = m_pODPointList->GetFirst(); node; node = node->GetNext()) {
-        ODPoint *pOp = node->GetData();
-        GetCanvasPixLL( &piVP, &r, pOp->m_lat, pOp->m_lon );
-        m_bpts[ j++ ] = r;
-    }
+    ODProjection::ForViewPort( piVP ).GetPixFromLL( m_pODPointList, m_bpts );
     
     dc.SetPen( *wxThePenList->FindOrCreatePen( m_col, width, style ) );
     dc.SetBrush( *wxTheBrushList->FindOrCreateBrush( m_col, wxBRUSHSTYLE_TRANSPARENT ) );
@@ -558,42 +570,39 @@ void ODPath::DeletePoint( ODPoint *rp, bool bRenamePoints )
     //    n.b. must delete Selectables  and update config before deleting the point
     if( rp->m_bIsInLayer ) return;
 
-    g_pODSelect->DeleteAllSelectableODPoints( (ODPath *) this );
-    g_pODSelect->DeleteAllSelectablePathSegments( (ODPath *) this );
     g_pODConfig->DeleteODPoint( rp );
 
-    m_pODPointList->DeleteObject( rp );
-
-    if( ( rp->m_GUID.Len() ) && ( wxNOT_FOUND != ODPointGUIDList.Index( rp->m_GUID ) ) ) ODPointGUIDList.Remove(
-            rp->m_GUID );
-
-    delete rp;
-
-    m_nPoints -= 1;
+    bool l_bInPlace = false;
+    if( !UnlinkPoint( rp, &l_bInPlace ) ) {
+        //  Already out of the point list (EBL::RemovePoint), so redo the whole path
+        g_pODSelect->DeleteSelectableODPoint( rp );
+        UnindexPointGUID( rp );
+        m_nPoints -= 1;
+        if( m_nPoints > 1 ) {
+            g_pODSelect->DeleteAllSelectablePathSegments( this );
+            g_pODSelect->AddAllSelectablePathSegments( this );
+            g_pODSelect->AddAllSelectableODPoints( this );
+            FinalizeForRendering();
+            UpdateSegmentDistances();
+        }
+    }
 
     if( bRenamePoints ) RenameODPoints();
 
     if( m_nPoints > 1 ) {
-        g_pODSelect->AddAllSelectablePathSegments( this );
-        g_pODSelect->AddAllSelectableODPoints( this );
-
-        g_pODConfig->UpdatePath( this );
-        RebuildGUIDList();                  // ensure the GUID list is intact and good
-
-        FinalizeForRendering();
-        UpdateSegmentDistances();
+        if( l_bInPlace && !bRenamePoints )
+            g_pODConfig->UpdatePathPointRemoved( this, rp );
+        else
+            g_pODConfig->UpdatePath( this );
     }
+
+    delete rp;
 }
 
 void ODPath::RemovePoint( ODPoint *op, bool bRenamePoints )
 {
-    g_pODSelect->DeleteAllSelectableODPoints( this );
-    g_pODSelect->DeleteAllSelectablePathSegments( this );
-
-    m_pODPointList->DeleteObject( op );
-    if( wxNOT_FOUND != ODPointGUIDList.Index( op->m_GUID ) ) ODPointGUIDList.Remove(
-            op->m_GUID );
-    m_nPoints -= 1;
+    bool l_bInPlace = false;
+    if( !UnlinkPoint( op, &l_bInPlace ) ) return;
 
     // check all other routes to see if this point appears in any other route
     ODPath *pcontainer_path = g_pPathMan->FindPathContainingODPoint( op );
@@ -606,19 +615,117 @@ void ODPath::RemovePoint( ODPoint *op, bool bRenamePoints )
         g_pODConfig->AddNewODPoint( op );
     }
 
+    // UnlinkPoint dropped the point's selectable, but the point lives on as
+    // an isolated mark or in another path, so it must stay selectable
+    g_pODSelect->AddSelectableODPoint( op->m_lat, op->m_lon, op );
+
     if( bRenamePoints ) RenameODPoints();
 
     if ( m_nPoints > 1 ) {
-        g_pODSelect->AddAllSelectablePathSegments( this );
-        g_pODSelect->AddAllSelectableODPoints( this );
+        if( l_bInPlace && !bRenamePoints )
+            g_pODConfig->UpdatePathPointRemoved( this, op );
+        else
+            g_pODConfig->UpdatePath( this );
+    }
 
-        g_pODConfig->UpdatePath( this );
-        RebuildGUIDList();                  // ensure the GUID list is intact and good
+}
 
-        FinalizeForRendering();
-        UpdateSegmentDistances();
+//  Takes every occurrence of the points out of the path and saves it once. The
+//  caller knows which paths the points were in, so it sees to points left in none.
+void ODPath::RemovePoints( const ODPointSet &points )
+{
+    std::vector<ODPoint *> l_found;
+    for( wxODPointListNode *node = m_pODPointList->GetFirst(); node; node = node->GetNext() ) {
+        if( points.count( node->GetData() ) ) l_found.push_back( node->GetData() );
+    }
+    if( l_found.empty() ) return;
+
+    bool l_bInPlace;
+    for( size_t i = 0; i < l_found.size(); i++ )
+        UnlinkPoint( l_found[i], &l_bInPlace );
+
+    if( m_nPoints > 1 ) g_pODConfig->UpdatePath( this );
+}
+
+static bool IsNearIDL( ODPoint *pOP )
+{
+    return pOP && ( pOP->m_lon < -150. || pOP->m_lon > 150. );
+}
+
+//  Takes the first occurrence of a point out of the path and patches what
+//  hangs off the two legs either side of it: the selectables, GUID index,
+//  bounding box and leg distances. pbInPlace is cleared when a saved copy of
+//  the path could not simply drop the point's entry, see below.
+bool ODPath::UnlinkPoint( ODPoint *pOP, bool *pbInPlace )
+{
+    int l_iIndex = 0;
+    wxODPointListNode *node = m_pODPointList->GetFirst();
+    while( node && node->GetData() != pOP ) {
+        node = node->GetNext();
+        l_iIndex++;
     }
+    if( !node ) return false;
+
+    ODPoint *pPrev = node->GetPrevious() ? node->GetPrevious()->GetData() : NULL;
+    ODPoint *pNext = node->GetNext() ? node->GetNext()->GetData() : NULL;
+
+    //  Boundary::DeletePoint turns a closed path round before it takes the
+    //  first point out, so a leg into the closing point means the saved
+    //  order no longer matches
+    *pbInPlace = !( pNext && pNext == m_pODPointList->GetFirst()->GetData() && pNext == m_pODPointList->GetLast()->GetData() );
+
+    g_pODSelect->DeleteSelectableODPoint( pOP );
+    if( pPrev ) g_pODSelect->DeleteSelectablePathSegment( this, pPrev, pOP );
+    if( pNext ) g_pODSelect->DeleteSelectablePathSegment( this, pOP, pNext );
+
+    m_pODPointList->DeleteNode( node );
+    m_nPoints -= 1;
+
+    if( m_nPoints > 1 ) {
+        if( pPrev && pNext )
+            g_pODSelect->AddSelectablePathSegment( pPrev->m_lat, pPrev->m_lon, pNext->m_lat, pNext->m_lon, pPrev, pNext, this );
+        // a closed path still has the point at its other end
+        if( m_pODPointList->GetFirst()->GetData() == pOP || m_pODPointList->GetLast()->GetData() == pOP )
+            g_pODSelect->AddSelectableODPoint( pOP->m_lat, pOP->m_lon, pOP );
+    } else {
+        g_pODSelect->DeleteAllSelectableODPoints( this );
+        g_pODSelect->DeleteAllSelectablePathSegments( this );
+    }
+
+    UnindexPointGUID( pOP );
+
+    //  A point inside the box, away from the date line, leaves the box as it was
+    if( m_bNeedsUpdateBBox || m_bcrosses_idl || IsNearIDL( pPrev ) || IsNearIDL( pOP ) || IsNearIDL( pNext ) ||
+        pOP->m_lon <= RBBox.GetMinX() || pOP->m_lon >= RBBox.GetMaxX() ||
+        pOP->m_lat <= RBBox.GetMinY() || pOP->m_lat >= RBBox.GetMaxY() )
+        FinalizeForRendering();
+
+    VertexRemoved( l_iIndex, pOP );
+
+    return true;
+}
+
+//  The point at node has just been put into the list at index
+void ODPath::LinkPoint( wxODPointListNode *node, int index )
+{
+    ODPoint *pOP = node->GetData();
+    ODPoint *pPrev = node->GetPrevious() ? node->GetPrevious()->GetData() : NULL;
+    ODPoint *pNext = node->GetNext() ? node->GetNext()->GetData() : NULL;
+
+    m_nPoints++;
+    IndexPointGUID( pOP );
+
+    if( pPrev && pNext ) g_pODSelect->DeleteSelectablePathSegment( this, pPrev, pNext );
+    if( pPrev ) g_pODSelect->AddSelectablePathSegment( pPrev->m_lat, pPrev->m_lon, pOP->m_lat, pOP->m_lon, pPrev, pOP, this );
+    if( pNext ) g_pODSelect->AddSelectablePathSegment( pOP->m_lat, pOP->m_lon, pNext->m_lat, pNext->m_lon, pOP, pNext, this );
+    g_pODSelect->AddSelectableODPoint( pOP->m_lat, pOP->m_lon, pOP );
 
+    if( m_bNeedsUpdateBBox || m_bcrosses_idl || IsNearIDL( pPrev ) || IsNearIDL( pOP ) || IsNearIDL( pNext ) )
+        FinalizeForRendering();
+    else
+        RBBox.Expand( pOP->m_lon, pOP->m_lat );
+
+    VertexInserted( index, pOP );
 }
 
 void ODPath::DeSelectPath()
@@ -772,15 +879,11 @@ void ODPath::CalculateDCRect( wxDC& dc_boundary, wxRect *prect, PlugIn_ViewPort
 
 void ODPath::RebuildGUIDList( void )
 {
-    ODPointGUIDList.Clear();               // empty the GUID list
+    m_PointGUIDIndex.clear();
 
     wxODPointListNode *node = m_pODPointList->GetFirst();
-
-    ODPoint *rp;
     while( node ) {
-        rp = node->GetData();
-        ODPointGUIDList.Add( rp->m_GUID );
-
+        IndexPointGUID( node->GetData() );
         node = node->GetNext();
     }
 }
@@ -808,26 +911,6 @@ void ODPath::SetListed( bool visible )
     m_bListed = visible;
 }
 
-void ODPath::AssemblePath( void )
-{
-    //    iterate over the ODPointGUIDs
-    for( unsigned int ip = 0; ip < ODPointGUIDList.GetCount(); ip++ ) {
-        wxString GUID = ODPointGUIDList[ip];
-
-        //    And on the ODPoints themselves
-        wxODPointListNode *pOpnode = g_pODPointMan->GetODPointList()->GetFirst();
-        while( pOpnode ) {
-            ODPoint *pOp = pOpnode->GetData();
-
-            if( pOp->m_GUID == GUID ) {
-                AddPoint( pOp );
-                break;
-            }
-            pOpnode = pOpnode->GetNext(); //ODPoint
-        }
-    }
-}
-
 void ODPath::RenameODPoints( void )
 {
     //    iterate on the route points.
@@ -885,43 +968,178 @@ bool ODPath::IsEqualTo( ODPath *ptargetroute )
  */
 void ODPath::UpdateSegmentDistances()
 {
-    wxPoint ppt, pptn;
-    float slat1, slon1, slat2, slon2;
-
+    //  Legs whose two ends are the same points, in the same places, as at the
+    //  last update keep their length. The old vertices are matched in order,
+    //  allowing for a point added or removed between them.
+    ODPathVertexArray l_Old;
+    l_Old.swap( m_Vertices );
+    m_Vertices.reserve( m_pODPointList->GetCount() );
+
+    bool l_bRenumbered = ( l_Old.size() != m_pODPointList->GetCount() );
+    size_t j = 0;
+    int l_iPrevOld = -1;
+    bool l_bPrevSame = false;
     double path_len = 0.0;
 
-    wxODPointListNode *node = m_pODPointList->GetFirst();
+    for( wxODPointListNode *node = m_pODPointList->GetFirst(); node; node = node->GetNext() ) {
+        ODPoint *pOp = node->GetData();
+        ODPathVertex v;
+        v.m_pODPoint = pOp;
+        v.m_dLat = pOp->m_lat;
+        v.m_dLon = pOp->m_lon;
+        v.m_dBearing = 0.0;
+        v.m_dSegLen = 0.0;
+
+        int l_iOld = -1;
+        if( j < l_Old.size() && l_Old[j].m_pODPoint == pOp )
+            l_iOld = j++;
+        else if( j + 1 < l_Old.size() && l_Old[j + 1].m_pODPoint == pOp ) {
+            l_iOld = j + 1;
+            j += 2;
+        }
+        if( l_iOld != (int)m_Vertices.size() ) l_bRenumbered = true;
+        bool l_bSame = l_iOld >= 0 && l_Old[l_iOld].m_dLat == v.m_dLat && l_Old[l_iOld].m_dLon == v.m_dLon;
+
+        if( !m_Vertices.empty() ) {
+            const ODPathVertex &prev = m_Vertices.back();
+            if( l_bSame && l_bPrevSame && l_iPrevOld == l_iOld - 1 ) {
+                v.m_dBearing = l_Old[l_iOld].m_dBearing;
+                v.m_dSegLen = l_Old[l_iOld].m_dSegLen;
+            } else
+                DistanceBearingMercator_Plugin( prev.m_dLat, prev.m_dLon, v.m_dLat, v.m_dLon, &v.m_dBearing, &v.m_dSegLen );
 
-    if( node ) {
-        ODPoint *pOp0 = node->GetData();
-        slat1 = pOp0->m_lat;
-        slon1 = pOp0->m_lon;
+//    And store in Point 2
+            pOp->m_seg_len = v.m_dSegLen;
+            path_len += v.m_dSegLen;
+        }
+        v.m_dCumulative = path_len;
+        m_Vertices.push_back( v );
 
-        node = node->GetNext();
+        l_iPrevOld = l_iOld;
+        l_bPrevSame = l_bSame;
+    }
 
-        while( node ) {
-            ODPoint *pOp = node->GetData();
-            slat2 = pOp->m_lat;
-            slon2 = pOp->m_lon;
+    m_path_length = path_len;
 
-//    Calculate the absolute distance from 1->2
+    if( l_bRenumbered ) m_bVertexIndexValid = false;
+}
 
-            double brg, dd;
-            DistanceBearingMercator_Plugin( slat1, slon1, slat2, slon2, &brg, &dd );
+void ODPath::VertexRemoved( size_t index, ODPoint *pOP )
+{
+    if( m_Vertices.size() != m_pODPointList->GetCount() + 1 || index >= m_Vertices.size() ||
+        m_Vertices[index].m_pODPoint != pOP ) {
+        UpdateSegmentDistances();
+        return;
+    }
 
-//    And store in Point 2
-            pOp->m_seg_len = dd;
+    m_Vertices.erase( m_Vertices.begin() + index );
+    m_bVertexIndexValid = false;
+    UpdateVertexLegs( index, index + 1 );
+}
 
-            path_len += dd;
+void ODPath::VertexInserted( size_t index, ODPoint *pOP )
+{
+    if( m_Vertices.size() + 1 != m_pODPointList->GetCount() || index > m_Vertices.size() ) {
+        UpdateSegmentDistances();
+        return;
+    }
+
+    ODPathVertex v;
+    v.m_pODPoint = pOP;
+    v.m_dLat = pOP->m_lat;
+    v.m_dLon = pOP->m_lon;
+    v.m_dBearing = 0.0;
+    v.m_dSegLen = 0.0;
+    v.m_dCumulative = 0.0;
+    m_Vertices.insert( m_Vertices.begin() + index, v );
+    m_bVertexIndexValid = false;
+    UpdateVertexLegs( index, index + 2 );
+}
 
-            slat1 = slat2;
-            slon1 = slon2;
+//  Works out the legs ending at first .. last - 1 again, then moves the
+//  vertices after them along by however much the path length changed
+void ODPath::UpdateVertexLegs( size_t first, size_t last )
+{
+    if( last > m_Vertices.size() ) last = m_Vertices.size();
+    if( first >= last ) {
+        m_path_length = m_Vertices.empty() ? 0.0 : m_Vertices.back().m_dCumulative;
+        return;
+    }
 
-            node = node->GetNext();
+    double l_dOldEnd = m_Vertices[last - 1].m_dCumulative;
+
+    for( size_t i = first; i < last; i++ ) {
+        ODPathVertex &v = m_Vertices[i];
+        v.m_dLat = v.m_pODPoint->m_lat;
+        v.m_dLon = v.m_pODPoint->m_lon;
+        if( i == 0 ) {
+            v.m_dBearing = 0.0;
+            v.m_dSegLen = 0.0;
+            v.m_dCumulative = 0.0;
+            continue;
         }
+        const ODPathVertex &prev = m_Vertices[i - 1];
+        DistanceBearingMercator_Plugin( prev.m_dLat, prev.m_dLon, v.m_dLat, v.m_dLon, &v.m_dBearing, &v.m_dSegLen );
+        v.m_pODPoint->m_seg_len = v.m_dSegLen;
+        v.m_dCumulative = prev.m_dCumulative + v.m_dSegLen;
     }
 
-    m_path_length = path_len;
+    double l_dShift = m_Vertices[last - 1].m_dCumulative - l_dOldEnd;
+    for( size_t i = last; i < m_Vertices.size(); i++ )
+        m_Vertices[i].m_dCumulative += l_dShift;
+
+    m_path_length = m_Vertices.back().m_dCumulative;
+}
+
+double ODPath::GetDistanceToPoint( int index )
+{
+    if( index < 0 || index >= (int)m_Vertices.size() ) return 0.0;
+    return m_Vertices[index].m_dCumulative;
+}
+
+double ODPath::GetDistanceToPoint( ODPoint *pOP )
+{
+    //  A point is looked up as the end of a leg, so the first point of a closed
+    //  path finds the closing leg
+    if( !m_bVertexIndexValid ) {
+        m_VertexIndex.clear();
+        for( size_t i = 1; i < m_Vertices.size(); i++ ) {
+            if( m_VertexIndex.find( m_Vertices[i].m_pODPoint ) == m_VertexIndex.end() )
+                m_VertexIndex[ m_Vertices[i].m_pODPoint ] = i;
+        }
+        m_bVertexIndexValid = true;
+    }
+
+    ODPathVertexHash::iterator it = m_VertexIndex.find( pOP );
+    if( it == m_VertexIndex.end() ) return 0.0;
+    return m_Vertices[it->second].m_dCumulative;
+}
+
+static bool IsBeforeVertex( double dist, const ODPathVertex &v )
+{
+    return dist < v.m_dCumulative;
+}
+
+bool ODPath::GetPositionAtDistance( double dist, double *lat, double *lon )
+{
+    if( m_Vertices.empty() ) return false;
+
+    if( dist <= 0.0 ) {
+        *lat = m_Vertices.front().m_dLat;
+        *lon = m_Vertices.front().m_dLon;
+        return true;
+    }
+    if( dist >= m_Vertices.back().m_dCumulative ) {
+        *lat = m_Vertices.back().m_dLat;
+        *lon = m_Vertices.back().m_dLon;
+        return true;
+    }
+
+    // first vertex beyond the distance, the leg ending there holds the position
+    ODPathVertexArray::iterator it = std::upper_bound( m_Vertices.begin() + 1, m_Vertices.end(), dist, IsBeforeVertex );
+    const ODPathVertex &start = *( it - 1 );
+    PositionBearingDistanceMercator_Plugin( start.m_dLat, start.m_dLon, it->m_dBearing, dist - start.m_dCumulative, lat, lon );
+    return true;
 }
 
 ODPoint *ODPath::InsertPointBefore( ODPoint *pOP, double lat, double lon, bool bRenamePoints )
@@ -941,7 +1159,7 @@ ODPoint *ODPath::InsertPointBefore( ODPoint *pOP, double lat, double lon, bool b
         m_pODPointList->Insert( nOP, newpoint );
     }
 
-    ODPointGUIDList.Insert( pOP->m_GUID, nOP );
+    IndexPointGUID( newpoint );
 
     m_nPoints++;
 
@@ -953,6 +1171,19 @@ ODPoint *ODPath::InsertPointBefore( ODPoint *pOP, double lat, double lon, bool b
     return ( newpoint );
 }
 
+//  Replaces the whole point sequence, the caller looks after the selectables
+void ODPath::SetPoints( const std::vector<ODPoint *> &points )
+{
+    m_pODPointList->Clear();
+    for( size_t i = 0; i < points.size(); i++ )
+        m_pODPointList->Append( points[i] );
+    m_nPoints = points.size();
+
+    RebuildGUIDList();
+    FinalizeForRendering();
+    UpdateSegmentDistances();
+}
+
 ODPoint *ODPath::InsertPointAfter( ODPoint *pOP, double lat, double lon, bool bRenamePoints )
 {
     int nOP = m_pODPointList->IndexOf( pOP );
@@ -966,17 +1197,10 @@ ODPoint *ODPath::InsertPointAfter( ODPoint *pOP, double lat, double lon, bool bR
     newpoint->SetNameShown( false );
     newpoint->SetTypeString( wxT("OD Point") );
     
-    m_pODPointList->Insert( nOP, newpoint );
-    
-    ODPointGUIDList.Insert( pOP->m_GUID, nOP );
-    
-    m_nPoints++;
+    LinkPoint( m_pODPointList->Insert( nOP, newpoint ), nOP );
     
     if( bRenamePoints ) RenameODPoints();
     
-    FinalizeForRendering();
-    UpdateSegmentDistances();
-    
     return ( newpoint );
 }
 
@@ -987,17 +1211,10 @@ void ODPath::InsertPointAfter( ODPoint *pOP, ODPoint *pnOP, bool bRenamePoints )
         return;
     nOP++;
     
-    m_pODPointList->Insert( nOP, pnOP );
-    
-    ODPointGUIDList.Insert( pnOP->m_GUID, nOP );
-    
-    m_nPoints++;
+    LinkPoint( m_pODPointList->Insert( nOP, pnOP ), nOP );
     
     if( bRenamePoints ) RenameODPoints();
     
-    FinalizeForRendering();
-    UpdateSegmentDistances();
-    
     return;
 }
 
@@ -41,19 +41,6 @@
 #include "ODEventHandler.h"
 #include "chcanv.h"
 
-enum {
-    ID_FROM_POINT = 0,
-    ID_TO_POINT,
-    ID_DISTANCE_FROM_BOAT,
-    ID_BEARING_FROM_BOAT,
-    ID_LATITUDE,
-    ID_LONGITUDE,
-    ID_BEARING_FROM_TO,
-    ID_DESCRIPTION,
-    
-    ID_POINTS_LIST_LAST
-};
-
 extern bool                 g_bShowMag;
 extern ocpn_draw_pi         *g_ocpn_draw_pi;
 extern double               g_dLat, g_dLon, gSog, gCog;
@@ -196,7 +183,7 @@ void ODPathPropertiesDialogImpl::OnLeftDoubleClick( wxMouseEvent& event )
     
     if( item == -1 ) return;
     
-    ODPoint *op = (ODPoint *) m_listCtrlODPoints->GetItemData( item );
+    ODPoint *op = m_listCtrlODPoints->GetODPoint( item );
     if( !op ) return;
     
     PathManagerDialog::ODPointShowPropertiesDialog( op, this );
@@ -226,9 +213,6 @@ void ODPathPropertiesDialogImpl::SetPathAndUpdate( ODPath *pP, bool only_points
         
         m_textCtrlName->SetFocus();
     }
-    m_listCtrlODPoints->DeleteAllItems();
-    
-
     InitializeList();
 
     UpdateProperties( pP );
@@ -267,9 +251,6 @@ bool ODPathPropertiesDialogImpl::UpdateProperties( ODPath *pInPath )
     m_textCtrlGUID->SetValue( pPath->m_GUID );
     m_checkBoxActive->SetValue( pPath->IsActive() );
     
-    double brgFromBoat = 0.;
-    double distanceFromBoat = 0.;
-
     //  Total length
     double total_length = pPath->m_path_length;
     
@@ -277,83 +258,9 @@ bool ODPathPropertiesDialogImpl::UpdateProperties( ODPath *pInPath )
     slen.Printf( wxT("%5.2f ") + getUsrDistanceUnit_Plugin(), toUsrDistance_Plugin( total_length ) );
     m_textCtrlTotalLength->SetValue( slen );
     
-    wxString time_form;
-    wxString tide_form;
-    
-    //  Iterate on Path Points
-    wxODPointListNode *node = pPath->m_pODPointList->GetFirst();
-    double slat, slon;
-    slat = g_pfFix.Lat;
-    slon = g_pfFix.Lon;
-    wxString nullify = _T("----");
-    long item_line_index = 0;
-    wxString wxsLastPoint = _("Boat");
-    while( node ) {
-        ODPoint *pOp = node->GetData();
-        wxString t;
-        //  Leg
-        m_listCtrlODPoints->SetItem( item_line_index, ID_FROM_POINT, wxsLastPoint );
-        
-        if(pOp->m_ODPointName != _("Boat")) {
-        //  ODPoint Name
-            m_listCtrlODPoints->SetItem( item_line_index, ID_TO_POINT, pOp->GetName() );
-            wxsLastPoint = pOp->GetName();
-            // Store Description
-            m_listCtrlODPoints->SetItem( item_line_index, ID_DESCRIPTION, pOp->GetDescription() );
-            
-            //  Distance
-            //  Note that Distance/Bearing for Leg 000 is as from current position
-            DistanceBearingMercator_Plugin( pOp->m_lat, pOp->m_lon, slat, slon, &brgFromBoat, &distanceFromBoat );
-            
-            t.Printf( _T("%6.2f ") + getUsrDistanceUnit_Plugin(), toUsrDistance_Plugin( distanceFromBoat ) );
-            m_listCtrlODPoints->SetItem( item_line_index, ID_DISTANCE_FROM_BOAT, t );
-            pOp->SetDistance( distanceFromBoat ); // save the course to the next point for printing.
-            //  Bearing
-            if( g_bShowMag )
-                t.Printf( _T("%03.0f Deg. M"), g_ocpn_draw_pi->GetTrueOrMag( brgFromBoat ) );
-            else
-                t.Printf( _T("%03.0f Deg. T"), g_ocpn_draw_pi->GetTrueOrMag( brgFromBoat ) );
-            
-            m_listCtrlODPoints->SetItem( item_line_index, ID_BEARING_FROM_BOAT, t );
-        } else {
-            m_listCtrlODPoints->SetItem( item_line_index, ID_TO_POINT, wxT("") );
-            m_listCtrlODPoints->SetItem( item_line_index, ID_DISTANCE_FROM_BOAT, wxT("") );
-            m_listCtrlODPoints->SetItem( item_line_index, ID_BEARING_FROM_BOAT, wxT("") );
-        }
-        
-        // calculation of bearging from current point to next point.
-        double brgFromTo, tmp_leg_dist;
-        wxODPointListNode *next_node = node->GetNext();
-        ODPoint * p_next_pOp = (next_node)? next_node->GetData(): NULL;
-        if ( p_next_pOp ) {
-            DistanceBearingMercator_Plugin( p_next_pOp->m_lat, p_next_pOp->m_lon, pOp->m_lat, pOp->m_lon, &brgFromTo, &tmp_leg_dist );
-        }else {
-            brgFromTo = 0.0;
-            tmp_leg_dist = 0.0;
-        }
-        
-        if (p_next_pOp){
-            if( g_bShowMag )
-                t.Printf( _T("%03.0f Deg. M"), g_ocpn_draw_pi->GetTrueOrMag( brgFromTo ) );
-            else
-                t.Printf( _T("%03.0f Deg. T"), g_ocpn_draw_pi->GetTrueOrMag( brgFromTo ) );
-            m_listCtrlODPoints->SetItem( item_line_index, ID_BEARING_FROM_TO, t );
-        }
-        else
-            m_listCtrlODPoints->SetItem( item_line_index, ID_BEARING_FROM_TO, nullify );
-        
-        //  Lat/Lon
-        wxString tlat = toSDMM_PlugIn( 1, pOp->m_lat, pOp->m_bIsInTrack );  // low precision for routes
-        m_listCtrlODPoints->SetItem( item_line_index, ID_LATITUDE, tlat );
-        
-        wxString tlon = toSDMM_PlugIn( 2, pOp->m_lon, pOp->m_bIsInTrack );
-        m_listCtrlODPoints->SetItem( item_line_index, ID_LONGITUDE, tlon );
-        
-        item_line_index++;
-
-        node = node->GetNext();
-        
-    }
+    //  The list only formats the rows it shows
+    m_listCtrlODPoints->SetPath( pPath );
+    m_listCtrlODPoints->SetBoatPosition( g_pfFix.Lat, g_pfFix.Lon );
     
 //    if( pPath->m_ActiveLineColour == wxEmptyString ) m_colourPickerLineColour->SetColour( g_colourActivePathLineColour );
     m_colourPickerLineColour->SetColour( pPath->m_wxcActiveLineColour );
@@ -372,13 +279,16 @@ bool ODPathPropertiesDialogImpl::UpdateProperties( ODPath *pInPath )
         }
     }
     
-    // Set column width correctly for data
-    for(int i = 0; i < m_listCtrlODPoints->GetColumnCount(); i++) {
+    // Set column width correctly for data, once there are rows to fit
+    if( !m_bColumnsSized && m_listCtrlODPoints->GetItemCount() > 0 ) {
+        for(int i = 0; i < m_listCtrlODPoints->GetColumnCount(); i++) {
 #ifdef WIN32
-        m_listCtrlODPoints->SetColumnWidth( i, wxLIST_AUTOSIZE_USEHEADER );
+            m_listCtrlODPoints->SetColumnWidth( i, wxLIST_AUTOSIZE_USEHEADER );
 #else WIN32        
-        m_listCtrlODPoints->SetColumnWidth( i, wxLIST_AUTOSIZE );
+            m_listCtrlODPoints->SetColumnWidth( i, wxLIST_AUTOSIZE );
 #endif WIN32        
+        }
+        m_bColumnsSized = true;
     }
     
     ::wxEndBusyCursor();
@@ -388,100 +298,21 @@ bool ODPathPropertiesDialogImpl::UpdateProperties( ODPath *pInPath )
 
 bool ODPathPropertiesDialogImpl::UpdateProperties( void )
 {
-    ::wxBeginBusyCursor();
-    
-    //  Iterate on Path Points
-    wxODPointListNode *node = m_pPath->m_pODPointList->GetFirst();
-    
-    double brgFromBoat = 0.;
-    double distanceFromBoat = 0.;
-    
-    wxString nullify = _T("----");
-    long item_line_index = 0;
-    wxString wxsLastPoint = wxT("Boat");
-    while( node ) {
-        ODPoint *pOp = node->GetData();
-        wxString t;
-        //  Leg
-        m_listCtrlODPoints->SetItem( item_line_index, ID_FROM_POINT, wxsLastPoint );
-
-        if(pOp->m_ODPointName != _("Boat")) {
-            //  ODPoint Name
-            m_listCtrlODPoints->SetItem( item_line_index, ID_TO_POINT, pOp->GetName() );
-            wxsLastPoint = pOp->GetName();
-            // Store Description
-            m_listCtrlODPoints->SetItem( item_line_index, ID_DESCRIPTION, pOp->GetDescription() );
-            
-            //  Distance
-            //  Note that Distance/Bearing for Leg 000 is as from current position
-            DistanceBearingMercator_Plugin(  g_dLat, g_dLon, pOp->m_lat, pOp->m_lon, &brgFromBoat, &distanceFromBoat );
-            
-            t.Printf( _T("%6.2f ") + getUsrDistanceUnit_Plugin(), toUsrDistance_Plugin( distanceFromBoat ) );
-            m_listCtrlODPoints->SetItem( item_line_index, ID_DISTANCE_FROM_BOAT, t );
-            pOp->SetDistance( distanceFromBoat ); // save the course to the next point for printing.
-            //  Bearing
-            if( g_bShowMag )
-                t.Printf( _T("%03.0f Deg. M"), g_ocpn_draw_pi->GetTrueOrMag( brgFromBoat ) );
-            else
-                t.Printf( _T("%03.0f Deg. T"), g_ocpn_draw_pi->GetTrueOrMag( brgFromBoat ) );
-            
-            m_listCtrlODPoints->SetItem( item_line_index, ID_BEARING_FROM_BOAT, t );
-        } else {
-            m_listCtrlODPoints->SetItem( item_line_index, ID_TO_POINT, wxT("") );
-            m_listCtrlODPoints->SetItem( item_line_index, ID_DISTANCE_FROM_BOAT, wxT("") );
-            m_listCtrlODPoints->SetItem( item_line_index, ID_BEARING_FROM_BOAT, wxT("") );
-        }
-        
-        // calculation of bearging from current point to next point.
-        double brgFromTo, tmp_leg_dist;
-        wxODPointListNode *next_node = node->GetNext();
-        ODPoint * _next_pOp = (next_node)? next_node->GetData(): NULL;
-        if (_next_pOp ) {
-            DistanceBearingMercator_Plugin( pOp->m_lat, pOp->m_lon, _next_pOp->m_lat, _next_pOp->m_lon, &brgFromTo, &tmp_leg_dist );
-        }else {
-            brgFromTo = 0.0;
-            tmp_leg_dist = 0.0;
-        }
-        
-        if (_next_pOp){
-            if( g_bShowMag )
-                t.Printf( _T("%03.0f Deg. M"), g_ocpn_draw_pi->GetTrueOrMag( brgFromTo ) );
-            else
-                t.Printf( _T("%03.0f Deg. T"), g_ocpn_draw_pi->GetTrueOrMag( brgFromTo ) );
-            m_listCtrlODPoints->SetItem( item_line_index, ID_BEARING_FROM_TO, t );
-        }
-        else
-            m_listCtrlODPoints->SetItem( item_line_index, ID_BEARING_FROM_TO, nullify );
-        
-        //  Lat/Lon
-        wxString tlat = toSDMM_PlugIn( 1, pOp->m_lat, pOp->m_bIsInTrack );  // low precision for routes
-        m_listCtrlODPoints->SetItem( item_line_index, ID_LATITUDE, tlat );
-        
-        wxString tlon = toSDMM_PlugIn( 2, pOp->m_lon, pOp->m_bIsInTrack );
-        m_listCtrlODPoints->SetItem( item_line_index, ID_LONGITUDE, tlon );
-        
-        item_line_index++;
-        node = node->GetNext();
-        
-    }
-
-    // Set column width correctly for data
-    for(int i = 0; i < m_listCtrlODPoints->GetColumnCount(); i++) {
-#ifdef WIN32
-        m_listCtrlODPoints->SetColumnWidth( i, wxLIST_AUTOSIZE_USEHEADER );
-#else WIN32        
-        m_listCtrlODPoints->SetColumnWidth( i, wxLIST_AUTOSIZE );
-#endif WIN32        
-    }
+    //  The points may have moved, rows are formatted again as they are drawn
+    m_listCtrlODPoints->SetPath( m_pPath );
+    m_listCtrlODPoints->SetBoatPosition( g_pfFix.Lat, g_pfFix.Lon );
     
     this->GetSizer()->Fit( this );
     this->Layout();
     
-    ::wxEndBusyCursor();
-    
     return true;
 }
 
+void ODPathPropertiesDialogImpl::UpdateBoatPosition( void )
+{
+    m_listCtrlODPoints->SetBoatPosition( g_pfFix.Lat, g_pfFix.Lon );
+}
+
 void ODPathPropertiesDialogImpl::SetDialogTitle(const wxString & title)
 {
     SetTitle(title);
@@ -524,23 +355,12 @@ void ODPathPropertiesDialogImpl::InitializeList()
 {
     if( NULL == m_pPath ) return;
     
-    //  Iterate on Route Points, inserting blank fields starting with index 0
-    wxODPointListNode *pnode = m_pPath->m_pODPointList->GetFirst();
-    int in = 0;
-    while( pnode ) {
-        m_listCtrlODPoints->InsertItem( in, _T(""), 0 );
-        m_listCtrlODPoints->SetItemPtrData( in, (wxUIntPtr)pnode->GetData() );
-        in++;
-        if( pnode->GetData()->m_seg_etd.IsValid() ) {
-            m_listCtrlODPoints->InsertItem( in, _T(""), 0 );
-            in++;
-        }
-        pnode = pnode->GetNext();
-    }
+    m_listCtrlODPoints->SetPath( m_pPath );
 }
 
 void ODPathPropertiesDialogImpl::SetPointsListHeadings()
 {
+    m_bColumnsSized = false;
     m_listCtrlODPoints->DeleteAllColumns();
     m_listCtrlODPoints->InsertColumn( ID_FROM_POINT, _("From Point"), wxLIST_FORMAT_LEFT );
     m_listCtrlODPoints->InsertColumn( ID_TO_POINT, _("To Point"), wxLIST_FORMAT_LEFT );
@@ -610,7 +430,7 @@ void ODPathPropertiesDialogImpl::OnPathPropMenuSelected( wxCommandEvent& event )
                 if( item == -1 ) break;
                 
                 ODPoint *odp;
-                odp = (ODPoint *) m_listCtrlODPoints->GetItemData( item );
+                odp = m_listCtrlODPoints->GetODPoint( item );
                 
                 m_pPath->RemovePointFromPath( odp, m_pPath );
             }
@@ -624,7 +444,7 @@ void ODPathPropertiesDialogImpl::OnPathPropMenuSelected( wxCommandEvent& event )
             if( item == -1 ) break;
             
             ODPoint *odp;
-            odp = (ODPoint *) m_listCtrlODPoints->GetItemData( item );
+            odp = m_listCtrlODPoints->GetODPoint( item );
             if( !odp ) break;
             
             g_pPathManagerDialog->ODPointShowPropertiesDialog( odp, GetParent() );
@@ -28,12 +28,16 @@
 #endif //precompiled headers
 
 #include "ODPoint.h"
+#include "ODProjection.h"
+#include "ODTextCache.h"
 #include "PointMan.h"
 #include "PathMan.h"
 #include "cutil.h"
 #include "ocpn_draw_pi.h"
 #include "ODUtils.h"
 #include "ODdc.h"
+#include "Layer.h"
+#include "ODSlabPool.h"
 
 #include "GL/gl.h"
 
@@ -57,9 +61,10 @@ extern bool         g_bBoundaryPointShowName;
 
 extern PlugIn_ViewPort  *g_pivp;
 extern ocpn_draw_pi     *g_ocpn_draw_pi;
+extern ODTextCache      *g_pODTextCache;
 
 #include <wx/listimpl.cpp>
-WX_DEFINE_LIST ( ODPointList );
+OD_DEFINE_POOLED_LIST ( ODPointList );
 
 ODPoint::ODPoint()
 {
@@ -247,12 +252,27 @@ ODPoint::ODPoint( double lat, double lon, const wxString& icon_ident, const wxSt
     
 }
 
+void *ODPoint::operator new( size_t size )
+{
+    return ODSlabPool::ForSize( size )->Alloc();
+}
+
+void ODPoint::operator delete( void *p, size_t size )
+{
+    ODSlabPool::ForSize( size )->Free( p );
+}
+
 ODPoint::~ODPoint( void )
 {
 //  Remove this point from the global ODPoint list
     if( NULL != g_pODPointMan )
         g_pODPointMan->RemoveODPoint( this );
 
+    if( m_bIsInLayer ) {
+        Layer *pLayer = Layer::Find( m_LayerID );
+        if( pLayer ) pLayer->RemoveODPoint( this );
+    }
+
     if( m_HyperlinkList ) {
         m_HyperlinkList->DeleteContents( true );
         delete m_HyperlinkList;
@@ -282,12 +302,9 @@ void ODPoint::SetName(const wxString & name)
 
 void ODPoint::CalculateNameExtents( void )
 {
-    if( m_pMarkFont ) {
-        wxScreenDC dc;
-
-        dc.SetFont( *m_pMarkFont );
-        m_NameExtents = dc.GetTextExtent( m_ODPointName );
-    } else
+    if( m_pMarkFont )
+        m_NameExtents = g_pODTextCache->GetTextExtent( *m_pMarkFont, m_ODPointName );
+    else
         m_NameExtents = wxSize( 0, 0 );
 
 }
@@ -318,8 +335,6 @@ void ODPoint::ReLoadIcon( void )
 
 #ifdef ocpnUSE_GL
     m_wpBBox_chart_scale = -1;
-
-    m_iTextTexture = 0;
 #endif
 }
 
@@ -328,7 +343,7 @@ void ODPoint::Draw( ODDC& dc, wxPoint *rpn )
     wxPoint r;
     wxRect hilitebox;
 
-    GetCanvasPixLL( g_pivp, &r,  m_lat, m_lon);
+    ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( m_lat, m_lon, &r );
 
     //  return the home point in this dc to allow "connect the dots"
     if( NULL != rpn ) *rpn = r;
@@ -430,7 +445,7 @@ void ODPoint::Draw( ODDC& dc, wxPoint *rpn )
         double tlat, tlon;
         wxPoint r1;
         ll_gc_ll( m_lat, m_lon, 0, factor, &tlat, &tlon );
-        GetCanvasPixLL( g_pivp, &r1,  tlat, tlon);
+        ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( tlat, tlon, &r1 );
 
         double lpp = sqrt( pow( (double) (r.x - r1.x), 2) +
                            pow( (double) (r.y - r1.y), 2 ) );
@@ -500,7 +515,7 @@ void ODPoint::DrawGL( PlugIn_ViewPort &pivp )
     wxRect hilitebox;
     unsigned char transparency = 150;
 
-    GetCanvasPixLL( g_pivp, &r, m_lat, m_lon );
+    ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( m_lat, m_lon, &r );
 
 //    Substitue icon?
     wxBitmap *pbm;
@@ -612,46 +627,13 @@ void ODPoint::DrawGL( PlugIn_ViewPort &pivp )
     }
 
     if( m_bShowName && m_pMarkFont ) {
-        int w = m_NameExtents.x, h = m_NameExtents.y;
-        if(!m_iTextTexture && w && h) {
-            wxBitmap tbm(w, h); /* render text on dc */
-            wxMemoryDC dc;
-            dc.SelectObject( tbm );               
-            dc.SetBackground( wxBrush( *wxBLACK ) );
-            dc.Clear();
-            dc.SetFont( *m_pMarkFont );
-            dc.SetTextForeground( *wxWHITE );
-            dc.DrawText( m_ODPointName, 0, 0);
-            dc.SelectObject( wxNullBitmap );
-            
-            /* make alpha texture for text */
-            wxImage image = tbm.ConvertToImage();
-            unsigned char *d = image.GetData();
-            unsigned char *e = new unsigned char[w * h];
-            if(d && e){
-                for( int p = 0; p < w*h; p++)
-                    e[p] = d[3*p + 0];
-            }
-            
-            /* create texture for rendered text */
-            glGenTextures(1, &m_iTextTexture);
-            glBindTexture(GL_TEXTURE_2D, m_iTextTexture);
-            
-            glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
-            glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
-
-            m_iTextTextureWidth = NextPow2(w);
-            m_iTextTextureHeight = NextPow2(h);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, m_iTextTextureWidth, m_iTextTextureHeight,
-                         0, GL_ALPHA, GL_UNSIGNED_BYTE, NULL);
-            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h,
-                            GL_ALPHA, GL_UNSIGNED_BYTE, e);
-            delete [] e;
-        }
+        wxSize l_TextExtents, l_TextureSize;
+        unsigned int l_iTextTexture = g_pODTextCache->GetLabelTexture( *m_pMarkFont, m_ODPointName, &l_TextExtents, &l_TextureSize );
 
-        if(m_iTextTexture) {
+        if(l_iTextTexture) {
+            int w = l_TextExtents.x, h = l_TextExtents.y;
             /* draw texture with text */
-            glBindTexture(GL_TEXTURE_2D, m_iTextTexture);
+            glBindTexture(GL_TEXTURE_2D, l_iTextTexture);
             
             glEnable(GL_TEXTURE_2D);
             glEnable(GL_BLEND);
@@ -660,7 +642,7 @@ void ODPoint::DrawGL( PlugIn_ViewPort &pivp )
             glColor3ub(m_FontColor.Red(), m_FontColor.Green(), m_FontColor.Blue());
             
             int x = r.x + m_NameLocationOffsetX, y = r.y + m_NameLocationOffsetY;
-            float u = (float)w/m_iTextTextureWidth, v = (float)h/m_iTextTextureHeight;
+            float u = (float)w/l_TextureSize.x, v = (float)h/l_TextureSize.y;
             glBegin(GL_QUADS);
             glTexCoord2f(0, 0); glVertex2f(x, y);
             glTexCoord2f(u, 0); glVertex2f(x+w, y);
@@ -683,7 +665,7 @@ void ODPoint::DrawGL( PlugIn_ViewPort &pivp )
         double tlat, tlon;
         wxPoint r1;
         ll_gc_ll( m_lat, m_lon, 0, factor, &tlat, &tlon );
-        GetCanvasPixLL( g_pivp, &r1,  tlat, tlon);
+        ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( tlat, tlon, &r1 );
         
         double lpp = sqrt( pow( (double) (r.x - r1.x), 2) +
         pow( (double) (r.y - r1.y), 2 ) );
@@ -0,0 +1,197 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw path properties point list
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODPointListCtrl.h"
+#include "ODPath.h"
+#include "ODPoint.h"
+#include "ocpn_draw_pi.h"
+
+extern bool                 g_bShowMag;
+extern ocpn_draw_pi         *g_ocpn_draw_pi;
+
+ODPointListCtrl::ODPointListCtrl( wxWindow *parent, wxWindowID id, const wxPoint &pos, const wxSize &size, long style )
+: wxListCtrl( parent, id, pos, size, style | wxLC_VIRTUAL )
+{
+    m_dBoatLat = 0.;
+    m_dBoatLon = 0.;
+    m_iFixStamp = 1;
+    m_pPath = NULL;
+}
+
+void ODPointListCtrl::SetPath( ODPath *pPath )
+{
+    //  Only GUIDs are copied here, the points may have moved so nothing cached is kept
+    m_Rows.clear();
+    m_pPath = pPath;
+    if( pPath ) {
+        m_Rows.reserve( pPath->m_pODPointList->GetCount() );
+        ODPointListRow l_row;
+        l_row.m_bFormatted = false;
+        l_row.m_iFixStamp = 0;
+        wxODPointListNode *node = pPath->m_pODPointList->GetFirst();
+        while( node ) {
+            wxODPointListNode *next_node = node->GetNext();
+            l_row.m_sGUID = node->GetData()->m_GUID;
+            l_row.m_sNextGUID = next_node ? next_node->GetData()->m_GUID : wxString();
+            m_Rows.push_back( l_row );
+            node = next_node;
+        }
+    }
+    
+    SetItemCount( m_Rows.size() );
+    RefreshVisibleRows();
+}
+
+void ODPointListCtrl::SetBoatPosition( double lat, double lon )
+{
+    if( lat == m_dBoatLat && lon == m_dBoatLon ) return;
+    
+    m_dBoatLat = lat;
+    m_dBoatLon = lon;
+    m_iFixStamp++;
+    RefreshVisibleRows();
+}
+
+ODPoint *ODPointListCtrl::GetODPoint( long item )
+{
+    if( item < 0 || item >= (long)m_Rows.size() ) return NULL;
+    return FindODPoint( m_Rows[ item ].m_sGUID );
+}
+
+ODPoint *ODPointListCtrl::FindODPoint( const wxString &guid ) const
+{
+    if( !m_pPath || guid.IsEmpty() ) return NULL;
+    return m_pPath->GetPoint( guid );
+}
+
+void ODPointListCtrl::RefreshVisibleRows( void )
+{
+    if( m_Rows.empty() ) return;
+    
+    long l_first = GetTopItem();
+    if( l_first < 0 ) l_first = 0;
+    long l_last = wxMin( l_first + GetCountPerPage(), (long)m_Rows.size() - 1 );
+    RefreshItems( l_first, l_last );
+}
+
+void ODPointListCtrl::FormatRow( ODPointListRow &row ) const
+{
+    if( row.m_bFormatted ) return;
+    
+    ODPoint *pOp = FindODPoint( row.m_sGUID );
+    if( !pOp ) return;
+    row.m_sLat = toSDMM_PlugIn( 1, pOp->m_lat, pOp->m_bIsInTrack );  // low precision for routes
+    row.m_sLon = toSDMM_PlugIn( 2, pOp->m_lon, pOp->m_bIsInTrack );
+    
+    // calculation of bearing from current point to next point.
+    row.m_dBrgFromTo = 0.;
+    ODPoint *pNextOp = FindODPoint( row.m_sNextGUID );
+    if( pNextOp ) {
+        double tmp_leg_dist;
+        DistanceBearingMercator_Plugin( pNextOp->m_lat, pNextOp->m_lon, pOp->m_lat, pOp->m_lon, &row.m_dBrgFromTo, &tmp_leg_dist );
+    }
+    row.m_bFormatted = true;
+}
+
+void ODPointListCtrl::UpdateFromBoat( ODPointListRow &row ) const
+{
+    if( row.m_iFixStamp == m_iFixStamp ) return;
+    
+    ODPoint *pOp = FindODPoint( row.m_sGUID );
+    if( !pOp ) return;
+    DistanceBearingMercator_Plugin( pOp->m_lat, pOp->m_lon, m_dBoatLat, m_dBoatLon, &row.m_dBrgFromBoat, &row.m_dDistFromBoat );
+    pOp->SetDistance( row.m_dDistFromBoat ); // save the course to the next point for printing.
+    row.m_iFixStamp = m_iFixStamp;
+}
+
+wxString ODPointListCtrl::FormatBearing( double brg ) const
+{
+    wxString t;
+    if( g_bShowMag )
+        t.Printf( _T("%03.0f Deg. M"), g_ocpn_draw_pi->GetTrueOrMag( brg ) );
+    else
+        t.Printf( _T("%03.0f Deg. T"), g_ocpn_draw_pi->GetTrueOrMag( brg ) );
+    return t;
+}
+
+wxString ODPointListCtrl::OnGetItemText( long item, long column ) const
+{
+    if( item < 0 || item >= (long)m_Rows.size() ) return wxEmptyString;
+    
+    ODPointListRow &row = m_Rows[ item ];
+    ODPoint *pOp = FindODPoint( row.m_sGUID );
+    if( !pOp ) return wxEmptyString;       // deleted since the list was filled
+    bool l_bBoat = ( pOp->m_ODPointName == _("Boat") );
+    wxString t;
+    
+    switch( column ) {
+        case ID_FROM_POINT:
+            //  Leg, from the last point that is not the boat
+            for( long i = item - 1; i >= 0; i-- ) {
+                ODPoint *pPrevOp = FindODPoint( m_Rows[ i ].m_sGUID );
+                if( pPrevOp && pPrevOp->m_ODPointName != _("Boat") )
+                    return pPrevOp->GetName();
+            }
+            return _("Boat");
+        case ID_TO_POINT:
+            if( l_bBoat ) return wxEmptyString;
+            return pOp->GetName();
+        case ID_DISTANCE_FROM_BOAT:
+            //  Note that Distance/Bearing for Leg 000 is as from current position
+            if( l_bBoat ) return wxEmptyString;
+            UpdateFromBoat( row );
+            t.Printf( _T("%6.2f ") + getUsrDistanceUnit_Plugin(), toUsrDistance_Plugin( row.m_dDistFromBoat ) );
+            return t;
+        case ID_BEARING_FROM_BOAT:
+            if( l_bBoat ) return wxEmptyString;
+            UpdateFromBoat( row );
+            return FormatBearing( row.m_dBrgFromBoat );
+        case ID_LATITUDE:
+            FormatRow( row );
+            return row.m_sLat;
+        case ID_LONGITUDE:
+            FormatRow( row );
+            return row.m_sLon;
+        case ID_BEARING_FROM_TO:
+            if( row.m_sNextGUID.IsEmpty() ) return _T("----");
+            FormatRow( row );
+            return FormatBearing( row.m_dBrgFromTo );
+        case ID_DESCRIPTION:
+            if( l_bBoat ) return wxEmptyString;
+            return pOp->GetDescription();
+    }
+    return wxEmptyString;
+}
+
+int ODPointListCtrl::OnGetItemImage( long item ) const
+{
+    return -1;
+}
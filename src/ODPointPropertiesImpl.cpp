@@ -323,6 +323,7 @@ void ODPointPropertiesImpl::SaveChanges()
             wxArrayPtrVoid *pEditPathArray = g_pPathMan->GetPathArrayContaining( m_pODPoint );
 
             if( pEditPathArray ) {
+                g_pODConfig->BeginTransaction();
                 for( unsigned int ip = 0; ip < pEditPathArray->GetCount(); ip++ ) {
                     ODPath *pp = (ODPath *) pEditPathArray->Item( ip );
                     pp->FinalizeForRendering();
@@ -340,6 +341,7 @@ void ODPointPropertiesImpl::SaveChanges()
                     
                     g_pODConfig->UpdatePath( pp );
                 }
+                g_pODConfig->CommitTransaction();
                 delete pEditPathArray;
             }
         } else
@@ -0,0 +1,195 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw batched lat/lon to canvas projection
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODProjection.h"
+#include "georef.h"
+
+#include <math.h>
+
+// Maximum pixel error allowed between the local maths and the core before
+// the local maths is not trusted for the viewport
+#define PROJECTION_TOLERANCE 1.5
+
+//  Frames can alternate between viewports, g_pivp and the canvas one say, so
+//  a few are kept and the oldest goes when another is needed
+#define PROJECTION_CACHE_SLOTS 4
+
+static ODProjection s_ODProjections[ PROJECTION_CACHE_SLOTS ];
+static int s_iNextODProjection = 0;
+
+ODProjection::ODProjection()
+{
+    m_bMercator = false;
+    m_dY30 = 0.;
+    m_dSinAngle = 0.;
+    m_dCosAngle = 1.;
+    m_dHalfWidth = 0.;
+    m_dHalfHeight = 0.;
+    m_dPixFullCircle = 0.;
+    m_vp.clat = 0.;
+    m_vp.clon = 0.;
+    m_vp.view_scale_ppm = 0.;
+    m_vp.skew = 0.;
+    m_vp.rotation = 0.;
+    m_vp.pix_width = 0;
+    m_vp.pix_height = 0;
+    m_vp.m_projection_type = PI_PROJECTION_UNKNOWN;
+}
+
+ODProjection::ODProjection( PlugIn_ViewPort &vp )
+{
+    SetViewPort( vp );
+}
+
+ODProjection &ODProjection::ForViewPort( PlugIn_ViewPort &vp )
+{
+    for( int i = 0; i < PROJECTION_CACHE_SLOTS; i++ ) {
+        if( s_ODProjections[i].IsSameViewPort( vp ) )
+            return s_ODProjections[i];
+    }
+
+    ODProjection &l_Projection = s_ODProjections[ s_iNextODProjection ];
+    s_iNextODProjection = ( s_iNextODProjection + 1 ) % PROJECTION_CACHE_SLOTS;
+    l_Projection.SetViewPort( vp );
+    return l_Projection;
+}
+
+bool ODProjection::IsSameViewPort( PlugIn_ViewPort &vp )
+{
+    return m_vp.view_scale_ppm == vp.view_scale_ppm && m_vp.clat == vp.clat && m_vp.clon == vp.clon &&
+        m_vp.rotation == vp.rotation && m_vp.skew == vp.skew &&
+        m_vp.pix_width == vp.pix_width && m_vp.pix_height == vp.pix_height &&
+        m_vp.m_projection_type == vp.m_projection_type;
+}
+
+void ODProjection::SetViewPort( PlugIn_ViewPort &vp )
+{
+    m_vp = vp;
+    m_dY30 = toSMcache_y30( vp.clat );
+    m_dHalfWidth = vp.pix_width / 2.0;
+    m_dHalfHeight = vp.pix_height / 2.0;
+    m_dPixFullCircle = WGS84_semimajor_axis_meters * mercator_k0 * 2 * PI * vp.view_scale_ppm;
+    m_bMercator = ( vp.m_projection_type == PI_PROJECTION_MERCATOR );
+    if( !m_bMercator ) return;
+
+    // The core only adds the skew to the rotation when skew compensation is
+    // off, which a plugin cannot see. Two points away from the centre, and
+    // not in line with it, are checked against the core to find out which it
+    // is, and that the local maths agrees with it at all.
+    double l_dRefLat[2], l_dRefLon[2];
+    wxPoint l_Ref[2];
+    for( int j = 0; j < 2; j++ ) {
+        l_dRefLat[j] = vp.clat + ( vp.lat_max - vp.lat_min ) / 4.;
+        l_dRefLon[j] = vp.clon + ( j ? -1. : 1. ) * ( vp.lon_max - vp.lon_min ) / 4.;
+        GetCanvasPixLL( &m_vp, &l_Ref[j], l_dRefLat[j], l_dRefLon[j] );
+    }
+
+    double l_dAngles[2] = { vp.rotation, vp.rotation + vp.skew };
+    for( int i = 0; i < 2; i++ ) {
+        m_dSinAngle = sin( l_dAngles[i] );
+        m_dCosAngle = cos( l_dAngles[i] );
+        int j = 0;
+        for( ; j < 2; j++ ) {
+            double x, y;
+            ProjectMercator( l_dRefLat[j], l_dRefLon[j], m_dSinAngle, m_dCosAngle, &x, &y );
+            if( fabs( x - l_Ref[j].x ) > PROJECTION_TOLERANCE || fabs( y - l_Ref[j].y ) > PROJECTION_TOLERANCE )
+                break;
+        }
+        if( j == 2 ) return;
+        if( vp.skew == 0. ) break;
+    }
+
+    m_bMercator = false;
+}
+
+void ODProjection::ProjectMercator( double lat, double lon, double angle_sin, double angle_cos, double *x, double *y )
+{
+    double l_dLon = lon;
+
+    //  Make sure lon and clon are the same phase, taking the shortest way round
+    if( l_dLon * m_vp.clon < 0. ) {
+        if( l_dLon < 0. ) l_dLon += 360.;
+        else l_dLon -= 360.;
+    }
+    if( fabs( l_dLon - m_vp.clon ) > 180. ) {
+        if( l_dLon > m_vp.clon ) l_dLon -= 360.;
+        else l_dLon += 360.;
+    }
+
+    double easting, northing;
+    toSMcache( lat, l_dLon, m_dY30, m_vp.clon, &easting, &northing );
+
+    double epix = easting * m_vp.view_scale_ppm;
+    double npix = northing * m_vp.view_scale_ppm;
+
+    *x = m_dHalfWidth + epix * angle_cos + npix * angle_sin;
+    *y = m_dHalfHeight - ( npix * angle_cos - epix * angle_sin );
+}
+
+void ODProjection::GetPixFromLL( double lat, double lon, wxPoint *r )
+{
+    if( !m_bMercator ) {
+        GetCanvasPixLL( &m_vp, r, lat, lon );
+        return;
+    }
+
+    double x, y;
+    ProjectMercator( lat, lon, m_dSinAngle, m_dCosAngle, &x, &y );
+    if( wxFinite( x ) && wxFinite( y ) ) {
+        r->x = wxRound( x );
+        r->y = wxRound( y );
+    } else
+        GetCanvasPixLL( &m_vp, r, lat, lon );
+}
+
+int ODProjection::GetPixFromLL( ODPointList *pODPointList, wxPoint *r )
+{
+    int i = 0;
+    if( !m_bMercator ) {
+        for( wxODPointListNode *node = pODPointList->GetFirst(); node; node = node->GetNext() ) {
+            ODPoint *pOp = node->GetData();
+            GetCanvasPixLL( &m_vp, &r[ i++ ], pOp->m_lat, pOp->m_lon );
+        }
+        return i;
+    }
+
+    double x, y;
+    for( wxODPointListNode *node = pODPointList->GetFirst(); node; node = node->GetNext(), i++ ) {
+        ODPoint *pOp = node->GetData();
+        ProjectMercator( pOp->m_lat, pOp->m_lon, m_dSinAngle, m_dCosAngle, &x, &y );
+        if( wxFinite( x ) && wxFinite( y ) ) {
+            r[i].x = wxRound( x );
+            r[i].y = wxRound( y );
+        } else
+            GetCanvasPixLL( &m_vp, &r[i], pOp->m_lat, pOp->m_lon );
+    }
+    return i;
+}
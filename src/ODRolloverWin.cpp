@@ -36,10 +36,12 @@
 #include "ocpn_plugin.h"
 #include "ODRolloverWin.h"
 #include "ODdc.h"
+#include "ODTextCache.h"
 #include "timers.h"
 #include "chart1.h"
 
 extern ocpn_draw_pi     *g_ocpn_draw_pi;
+extern ODTextCache      *g_pODTextCache;
 
 BEGIN_EVENT_TABLE(ODRolloverWin, wxWindow)
     EVT_PAINT(ODRolloverWin::OnPaint)
@@ -165,14 +167,9 @@ void ODRolloverWin::SetBestPosition( int x, int y, int off_x, int off_y, int rol
                          dFont->GetStyle(), dFont->GetWeight(), false, dFont->GetFaceName() );
 
     if(m_plabelFont && m_plabelFont->IsOk()) {
-#ifdef __WXMAC__
-        wxScreenDC sdc;
-        sdc.GetMultiLineTextExtent(m_string, &w, &h, NULL, m_plabelFont);
-#else
-//        wxClientDC cdc( GetParent() );
-        wxClientDC cdc( g_ocpn_draw_pi->m_parent_window );
-        cdc.GetMultiLineTextExtent( m_string, &w, &h, NULL, m_plabelFont );
-#endif
+        wxSize l_TextExtents = g_pODTextCache->GetMultiLineTextExtent( *m_plabelFont, m_string );
+        w = l_TextExtents.x;
+        h = l_TextExtents.y;
     }
     else {
         w = 10;
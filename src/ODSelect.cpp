@@ -29,16 +29,34 @@
 //#include "navutil.h"
 #include "chcanv.h"
 #include "ODPath.h"
+#include "ODStats.h"
+#include "ODSlabPool.h"
+
+#include <new>
 
 extern ChartCanvas                  *ocpncc1;
 extern ocpn_draw_pi                 *g_ocpn_draw_pi;
 extern ODPlugIn_Position_Fix_Ex     g_pfFix;
 extern SelectItem                   *g_pRolloverPoint;
 
+//  The selectables are many and small, so they come from a pool. They are
+//  only ever made and freed through these two.
+static SelectItem *NewSelectItem( void )
+{
+    return new( ODSlabPool::ForSize( sizeof( SelectItem ) )->Alloc() ) SelectItem;
+}
+
+static void DeleteSelectItem( SelectItem *pSelItem )
+{
+    pSelItem->~SelectItem();
+    ODSlabPool::ForSize( sizeof( SelectItem ) )->Free( pSelItem );
+}
+
 ODSelect::ODSelect()
 {
     pSelectList = new SelectableItemList;
     pixelRadius = 8;
+    m_dSelectScale = 0.;
     int w,h;
     wxDisplaySize( &w, &h );
     if( h > 800 ) pixelRadius = 10;
@@ -48,15 +66,26 @@ ODSelect::ODSelect()
 
 ODSelect::~ODSelect()
 {
-    pSelectList->DeleteContents( true );
+    for( wxSelectableItemListNode *node = pSelectList->GetFirst(); node; node = node->GetNext() )
+        DeleteSelectItem( node->GetData() );
     pSelectList->Clear();
     delete pSelectList;
+    m_SegmentIndex.clear();
 
 }
 
 bool ODSelect::AddSelectableODPoint( float slat, float slon, ODPoint *pODPointAdd )
 {
-    SelectItem *pSelItem = new SelectItem;
+    //  A point only gets one selectable, a closed path would otherwise add its
+    //  first point twice
+    wxSelectableItemListNode *pExisting = (wxSelectableItemListNode *)pODPointAdd->GetSelectNode();
+    if( pExisting ) {
+        pExisting->GetData()->m_slat = slat;
+        pExisting->GetData()->m_slon = slon;
+        return true;
+    }
+
+    SelectItem *pSelItem = NewSelectItem();
     pSelItem->m_slat = slat;
     pSelItem->m_slon = slon;
     pSelItem->m_seltype = SELTYPE_ODPOINT;
@@ -78,7 +107,7 @@ bool ODSelect::AddSelectableODPoint( float slat, float slon, ODPoint *pODPointAd
 bool ODSelect::AddSelectablePathSegment( float slat1, float slon1, float slat2, float slon2,
         ODPoint *pODPointAdd1, ODPoint *pODPointAdd2, ODPath *pPath )
 {
-    SelectItem *pSelItem = new SelectItem;
+    SelectItem *pSelItem = NewSelectItem();
     pSelItem->m_slat = slat1;
     pSelItem->m_slon = slon1;
     pSelItem->m_slat2 = slat2;
@@ -89,73 +118,99 @@ bool ODSelect::AddSelectablePathSegment( float slat1, float slon1, float slat2,
     pSelItem->m_pData2 = pODPointAdd2;
     pSelItem->m_pData3 = pPath;
 
-    if( pPath->m_bIsInLayer ) pSelectList->Append( pSelItem );
+    wxSelectableItemListNode *node;
+
+    if( pPath->m_bIsInLayer ) node = pSelectList->Append( pSelItem );
     else
-        pSelectList->Append( pSelItem );
+        node = pSelectList->Append( pSelItem );
+
+    IndexSegment( node );
 
     return true;
 }
 
-bool ODSelect::DeleteAllSelectablePathSegments( ODPath *pr )
+void ODSelect::IndexSegment( wxSelectableItemListNode *node )
 {
-    SelectItem *pFindSel;
-
-//    Iterate on the select list
-    wxSelectableItemListNode *node = pSelectList->GetFirst();
-
-    while( node ) {
-        pFindSel = node->GetData();
-        if( pFindSel->m_seltype == SELTYPE_PATHSEGMENT ) {
-
-            if( (ODPath *) pFindSel->m_pData3 == pr ) {
-                delete pFindSel;
-                pSelectList->DeleteNode( node );   //delete node;
-
-                node = pSelectList->GetFirst();     // reset the top node
+    SelectItem *pSelItem = node->GetData();
+    m_SegmentIndex[ (ODPoint *) pSelItem->m_pData1 ].push_back( node );
+    if( pSelItem->m_pData2 != pSelItem->m_pData1 )
+        m_SegmentIndex[ (ODPoint *) pSelItem->m_pData2 ].push_back( node );
+}
 
-                goto got_next_outer_node;
+void ODSelect::UnindexSegment( wxSelectableItemListNode *node )
+{
+    SelectItem *pSelItem = node->GetData();
+    ODPoint *ends[2] = { (ODPoint *) pSelItem->m_pData1, (ODPoint *) pSelItem->m_pData2 };
+
+    for( int i = 0; i < 2; i++ ) {
+        ODSegmentIndexHash::iterator it = m_SegmentIndex.find( ends[i] );
+        if( it == m_SegmentIndex.end() ) continue;
+
+        ODSegmentNodeArray &nodes = it->second;
+        for( size_t j = 0; j < nodes.size(); j++ ) {
+            if( nodes[j] == node ) {
+                nodes.erase( nodes.begin() + j );
+                break;
             }
         }
-
-        node = node->GetNext();
-        got_next_outer_node: continue;
+        if( nodes.empty() ) m_SegmentIndex.erase( it );
     }
-
-    return true;
 }
 
-bool ODSelect::DeleteAllSelectableODPoints( ODPath *pr )
+void ODSelect::DeleteSegmentNode( wxSelectableItemListNode *node )
 {
-    SelectItem *pFindSel;
+    SelectItem *pFindSel = node->GetData();
+
+    UnindexSegment( node );
+    if( pFindSel == g_pRolloverPoint ) g_pRolloverPoint = NULL;
+    DeleteSelectItem( pFindSel );
+    delete node;            // automatically removes from list
+}
 
-//    Iterate on the select list
+bool ODSelect::DeleteAllSelectablePathSegments( ODPath *pr )
+{
+    //  One pass over the list, deleting the nodes in place
     wxSelectableItemListNode *node = pSelectList->GetFirst();
 
     while( node ) {
-        pFindSel = node->GetData();
-        if( pFindSel->m_seltype == SELTYPE_ODPOINT ) {
-            ODPoint *ps = (ODPoint *) pFindSel->m_pData1;
+        wxSelectableItemListNode *next = node->GetNext();
+        SelectItem *pFindSel = node->GetData();
 
-            //    inner loop iterates on the path's point list
-            wxODPointListNode *pnode = ( pr->m_pODPointList )->GetFirst();
-            while( pnode ) {
-                ODPoint *prp = pnode->GetData();
+        if( pFindSel->m_seltype == SELTYPE_PATHSEGMENT && (ODPath *) pFindSel->m_pData3 == pr )
+            DeleteSegmentNode( node );
 
-                if( prp == ps ) {
-                    delete pFindSel;
-                    pSelectList->DeleteNode( node );   //delete node;
-                    prp->SetSelectNode( NULL );
-                    
-                    node = pSelectList->GetFirst();
+        node = next;
+    }
 
-                    goto got_next_outer_node;
-                }
-                pnode = pnode->GetNext();
-            }
+    return true;
+}
+
+bool ODSelect::DeleteSelectablePathSegment( ODPath *pr, ODPoint *prp1, ODPoint *prp2 )
+{
+    ODSegmentIndexHash::iterator it = m_SegmentIndex.find( prp1 );
+    if( it == m_SegmentIndex.end() ) return false;
+
+    ODSegmentNodeArray &nodes = it->second;
+    for( size_t i = 0; i < nodes.size(); i++ ) {
+        SelectItem *pFindSel = nodes[i]->GetData();
+        if( (ODPath *) pFindSel->m_pData3 == pr && pFindSel->m_pData1 == prp1 && pFindSel->m_pData2 == prp2 ) {
+            DeleteSegmentNode( nodes[i] );
+            return true;
         }
+    }
 
-        node = node->GetNext();
-got_next_outer_node: continue;
+    return false;
+}
+
+bool ODSelect::DeleteAllSelectableODPoints( ODPath *pr )
+{
+    //  Each point knows its own selectable
+    wxODPointListNode *pnode = ( pr->m_pODPointList )->GetFirst();
+    while( pnode ) {
+        ODPoint *prp = pnode->GetData();
+        if( prp->GetSelectNode() )
+            DeleteSelectableODPoint( prp );
+        pnode = pnode->GetNext();
     }
     return true;
 }
@@ -209,38 +264,29 @@ bool ODSelect::AddAllSelectablePathSegments( ODPath *pr )
 
 bool ODSelect::UpdateSelectablePathSegments( ODPoint *prp )
 {
-    SelectItem *pFindSel;
-    bool ret = false;
-
-//    Iterate on the select list
-    wxSelectableItemListNode *node = pSelectList->GetFirst();
-
-    while( node ) {
-        pFindSel = node->GetData();
-        if( pFindSel->m_seltype == SELTYPE_PATHSEGMENT ) {
-            if( pFindSel->m_pData1 == prp ) {
-                pFindSel->m_slat = prp->m_lat;
-                pFindSel->m_slon = prp->m_lon;
-                ret = true;
-                ;
-            }
-
-            else
-                if( pFindSel->m_pData2 == prp ) {
-                    pFindSel->m_slat2 = prp->m_lat;
-                    pFindSel->m_slon2 = prp->m_lon;
-                    ret = true;
-                }
+    ODSegmentIndexHash::iterator it = m_SegmentIndex.find( prp );
+    if( it == m_SegmentIndex.end() ) return false;
+
+    ODSegmentNodeArray &nodes = it->second;
+    for( size_t i = 0; i < nodes.size(); i++ ) {
+        SelectItem *pFindSel = nodes[i]->GetData();
+        if( pFindSel->m_pData1 == prp ) {
+            pFindSel->m_slat = prp->m_lat;
+            pFindSel->m_slon = prp->m_lon;
         }
-        node = node->GetNext();
+        else
+            if( pFindSel->m_pData2 == prp ) {
+                pFindSel->m_slat2 = prp->m_lat;
+                pFindSel->m_slon2 = prp->m_lon;
+            }
     }
 
-    return ret;
+    return true;
 }
 
 SelectItem *ODSelect::AddSelectablePoint( float slat, float slon, const void *pdata, int fseltype )
 {
-    SelectItem *pSelItem = new SelectItem;
+    SelectItem *pSelItem = NewSelectItem();
     if( pSelItem ) {
         pSelItem->m_slat = slat;
         pSelItem->m_slon = slon;
@@ -275,7 +321,9 @@ bool ODSelect::DeleteSelectablePoint( void *pdata, int SeltypeToDelete )
             pFindSel = node->GetData();
             if( pFindSel->m_seltype == SeltypeToDelete ) {
                 if( pdata == pFindSel->m_pData1 ) {
-                    delete pFindSel;
+                    if( SELTYPE_PATHSEGMENT == SeltypeToDelete )
+                        UnindexSegment( node );
+                    DeleteSelectItem( pFindSel );
                     delete node;
                     g_pRolloverPoint = NULL;
                     
@@ -303,13 +351,15 @@ bool ODSelect::DeleteAllSelectableTypePoints( int SeltypeToDelete )
     while( node ) {
         pFindSel = node->GetData();
         if( pFindSel->m_seltype == SeltypeToDelete ) {
+            if( SELTYPE_PATHSEGMENT == SeltypeToDelete )
+                UnindexSegment( node );
             delete node;
             
             if( SELTYPE_ODPOINT == SeltypeToDelete ){
                 ODPoint *prp = (ODPoint *)pFindSel->m_pData1;
                 prp->SetSelectNode( NULL );
             }
-            delete pFindSel;
+            DeleteSelectItem( pFindSel );
             
             node = pSelectList->GetFirst();
             goto got_next_node;
@@ -321,6 +371,63 @@ bool ODSelect::DeleteAllSelectableTypePoints( int SeltypeToDelete )
     return true;
 }
 
+bool ODSelect::DeleteAllSelectableLayerObjects( int layer_id )
+{
+    //  One pass over the list, deleting the nodes in place
+    wxSelectableItemListNode *node = pSelectList->GetFirst();
+
+    while( node ) {
+        wxSelectableItemListNode *next = node->GetNext();
+        SelectItem *pFindSel = node->GetData();
+        bool bDelete = false;
+
+        if( pFindSel->m_seltype == SELTYPE_ODPOINT ) {
+            ODPoint *prp = (ODPoint *) pFindSel->m_pData1;
+            if( prp->m_bIsInLayer && prp->m_LayerID == layer_id ) {
+                prp->SetSelectNode( NULL );
+                bDelete = true;
+            }
+        } else if( pFindSel->m_seltype == SELTYPE_PATHSEGMENT ) {
+            ODPath *pr = (ODPath *) pFindSel->m_pData3;
+            bDelete = pr->m_bIsInLayer && pr->m_LayerID == layer_id;
+            if( bDelete ) UnindexSegment( node );
+        }
+
+        if( bDelete ) {
+            if( pFindSel == g_pRolloverPoint ) g_pRolloverPoint = NULL;
+            DeleteSelectItem( pFindSel );
+            delete node;
+        }
+        node = next;
+    }
+    return true;
+}
+
+bool ODSelect::DeleteSelectableObjects( const ODPathSet *pPaths, const ODPointSet *pPoints )
+{
+    wxSelectableItemListNode *node = pSelectList->GetFirst();
+
+    while( node ) {
+        wxSelectableItemListNode *next = node->GetNext();
+        SelectItem *pFindSel = node->GetData();
+
+        if( pFindSel->m_seltype == SELTYPE_ODPOINT ) {
+            ODPoint *prp = (ODPoint *) pFindSel->m_pData1;
+            if( pPoints && pPoints->count( prp ) ) {
+                prp->SetSelectNode( NULL );
+                if( pFindSel == g_pRolloverPoint ) g_pRolloverPoint = NULL;
+                DeleteSelectItem( pFindSel );
+                delete node;
+            }
+        } else if( pFindSel->m_seltype == SELTYPE_PATHSEGMENT ) {
+            if( pPaths && pPaths->count( (ODPath *) pFindSel->m_pData3 ) )
+                DeleteSegmentNode( node );
+        }
+        node = next;
+    }
+    return true;
+}
+
 bool ODSelect::DeleteSelectableODPoint( ODPoint *prp )
 {
     
@@ -329,7 +436,7 @@ bool ODSelect::DeleteSelectableODPoint( ODPoint *prp )
         if(node){
             SelectItem *pFindSel = node->GetData();
             if(pFindSel){
-                delete pFindSel;
+                DeleteSelectItem( pFindSel );
                 delete node;            // automatically removes from list
                 prp->SetSelectNode( NULL );
                 return true;
@@ -417,7 +524,8 @@ bool ODSelect::IsSegmentSelected( float a, float b, float c, float d, float slat
 
 void ODSelect::CalcSelectRadius()
 {
-    selectRadius = pixelRadius / ( ocpncc1->GetCanvasTrueScale() * 1852 * 60 );
+    double l_dScale = m_dSelectScale > 0. ? m_dSelectScale : ocpncc1->GetCanvasTrueScale();
+    selectRadius = pixelRadius / ( l_dScale * 1852 * 60 );
 }
 
 SelectItem *ODSelect::FindSelection( float slat, float slon, int fseltype )
@@ -425,18 +533,22 @@ SelectItem *ODSelect::FindSelection( float slat, float slon, int fseltype )
     float a, b, c, d;
     SelectItem *pFindSel;
 
+    SelectItem *pFound = NULL;
+    int l_iScanned = 0;
+
     CalcSelectRadius();
 
 //    Iterate on the list
     wxSelectableItemListNode *node = pSelectList->GetFirst();
 
-    while( node ) {
+    while( node && !pFound ) {
         pFindSel = node->GetData();
+        l_iScanned++;
         if( pFindSel->m_seltype == fseltype ) {
             switch( fseltype ){
                 case SELTYPE_ODPOINT:
                     if( ( fabs( slat - pFindSel->m_slat ) < selectRadius )
-                            && ( fabs( slon - pFindSel->m_slon ) < selectRadius ) ) return pFindSel;
+                            && ( fabs( slon - pFindSel->m_slon ) < selectRadius ) ) pFound = pFindSel;
                     break;
                 case SELTYPE_PATHSEGMENT: 
                     a = pFindSel->m_slat;
@@ -444,7 +556,7 @@ SelectItem *ODSelect::FindSelection( float slat, float slon, int fseltype )
                     c = pFindSel->m_slon;
                     d = pFindSel->m_slon2;
 
-                    if( IsSegmentSelected( a, b, c, d, slat, slon ) ) return pFindSel;
+                    if( IsSegmentSelected( a, b, c, d, slat, slon ) ) pFound = pFindSel;
                     break;
                 default:
                     break;
@@ -454,7 +566,8 @@ SelectItem *ODSelect::FindSelection( float slat, float slon, int fseltype )
         node = node->GetNext();
     }
 
-    return NULL;
+    ODStatsCount( ODSTATS_SELECTABLES_SCANNED, l_iScanned );
+    return pFound;
 }
 
 bool ODSelect::IsSelectableSegmentSelected( float slat, float slon, SelectItem *pFindSel )
@@ -482,6 +595,7 @@ SelectableItemList ODSelect::FindSelectionList( float slat, float slon, int fsel
     
     //    Iterate on the list
         wxSelectableItemListNode *node = pSelectList->GetFirst();
+        ODStatsCount( ODSTATS_SELECTABLES_SCANNED, pSelectList->GetCount() );
 
         while( node ) {
             pFindSel = node->GetData();
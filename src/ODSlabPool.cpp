@@ -0,0 +1,173 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw fixed size block pools
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODSlabPool.h"
+#include "ODStats.h"
+
+#include <wx/thread.h>
+
+#include <algorithm>
+
+ODSlabPool::ODSlabPool( size_t size )
+{
+    m_iBlockSize = BlockSize( size );
+    m_pFree = NULL;
+    m_iFree = 0;
+}
+
+//  Keeps every block aligned for the doubles and pointers put in it
+size_t ODSlabPool::BlockSize( size_t size )
+{
+    if( size < sizeof( FreeBlock ) ) size = sizeof( FreeBlock );
+    return ( size + 7 ) & ~(size_t)7;
+}
+
+ODSlabPool::~ODSlabPool()
+{
+    for( size_t i = 0; i < m_Slabs.size(); i++ )
+        ::operator delete( m_Slabs[i] );
+}
+
+void ODSlabPool::AddSlab( void )
+{
+    char *pSlab = (char *)::operator new( m_iBlockSize * ODSLABPOOL_BLOCKS );
+    m_Slabs.push_back( pSlab );
+    ODStatsCount( ODSTATS_POOL_SLABS );
+
+    // thread the new blocks onto the free list so the first is taken first
+    for( int i = ODSLABPOOL_BLOCKS - 1; i >= 0; i-- ) {
+        FreeBlock *pBlock = (FreeBlock *)( pSlab + i * m_iBlockSize );
+        pBlock->m_pNext = m_pFree;
+        m_pFree = pBlock;
+    }
+    m_iFree += ODSLABPOOL_BLOCKS;
+}
+
+void *ODSlabPool::Alloc( void )
+{
+    wxASSERT( wxThread::IsMain() );
+    if( !m_pFree ) AddSlab();
+
+    FreeBlock *pBlock = m_pFree;
+    m_pFree = pBlock->m_pNext;
+    m_iFree--;
+    ODStatsCount( ODSTATS_POOL_BLOCKS );
+    return pBlock;
+}
+
+void ODSlabPool::Free( void *p )
+{
+    if( !p ) return;
+    wxASSERT( wxThread::IsMain() );
+
+    FreeBlock *pBlock = (FreeBlock *)p;
+    pBlock->m_pNext = m_pFree;
+    m_pFree = pBlock;
+    m_iFree++;
+}
+
+//  Releases the slabs whose blocks are all on the free list. The blocks of
+//  the slabs kept stay on it in the order they were.
+void ODSlabPool::Trim( void )
+{
+    if( m_iFree < ODSLABPOOL_BLOCKS ) return;
+
+    std::sort( m_Slabs.begin(), m_Slabs.end() );
+    size_t l_iSlabBytes = m_iBlockSize * ODSLABPOOL_BLOCKS;
+    std::vector<size_t> l_Free( m_Slabs.size(), 0 );
+    std::vector<size_t> l_BlockSlab;
+    l_BlockSlab.reserve( m_iFree );
+    for( FreeBlock *pBlock = m_pFree; pBlock; pBlock = pBlock->m_pNext ) {
+        size_t l_iSlab = std::upper_bound( m_Slabs.begin(), m_Slabs.end(), (char *)pBlock ) - m_Slabs.begin() - 1;
+        wxASSERT( (char *)pBlock < m_Slabs[ l_iSlab ] + l_iSlabBytes );
+        l_Free[ l_iSlab ]++;
+        l_BlockSlab.push_back( l_iSlab );
+    }
+
+    //  Relink the free list without the blocks of the slabs going
+    FreeBlock *pBlock = m_pFree;
+    FreeBlock **ppLink = &m_pFree;
+    for( size_t i = 0; pBlock; i++ ) {
+        FreeBlock *pNext = pBlock->m_pNext;
+        if( l_Free[ l_BlockSlab[i] ] == ODSLABPOOL_BLOCKS )
+            m_iFree--;
+        else {
+            *ppLink = pBlock;
+            ppLink = &pBlock->m_pNext;
+        }
+        pBlock = pNext;
+    }
+    *ppLink = NULL;
+
+    size_t l_iKept = 0;
+    for( size_t i = 0; i < m_Slabs.size(); i++ ) {
+        if( l_Free[i] == ODSLABPOOL_BLOCKS )
+            ::operator delete( m_Slabs[i] );
+        else
+            m_Slabs[ l_iKept++ ] = m_Slabs[i];
+    }
+    m_Slabs.resize( l_iKept );
+}
+
+//  Owns the shared pools so they go when the plugin is unloaded
+class ODSlabPools
+{
+public:
+    ~ODSlabPools()
+    {
+        for( size_t i = 0; i < m_Pools.size(); i++ )
+            delete m_Pools[i];
+    }
+
+    std::vector<ODSlabPool *> m_Pools;
+};
+
+static ODSlabPools s_SlabPools;
+
+ODSlabPool *ODSlabPool::ForSize( size_t size )
+{
+    // only a handful of sizes are ever asked for
+    size_t l_iBlockSize = BlockSize( size );
+    for( size_t i = 0; i < s_SlabPools.m_Pools.size(); i++ ) {
+        if( s_SlabPools.m_Pools[i]->GetBlockSize() == l_iBlockSize )
+            return s_SlabPools.m_Pools[i];
+    }
+
+    ODSlabPool *pPool = new ODSlabPool( size );
+    s_SlabPools.m_Pools.push_back( pPool );
+    return pPool;
+}
+
+void ODSlabPool::TrimAll( void )
+{
+    for( size_t i = 0; i < s_SlabPools.m_Pools.size(); i++ )
+        s_SlabPools.m_Pools[i]->Trim();
+}
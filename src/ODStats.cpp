@@ -0,0 +1,222 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw runtime counters and timing histograms
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODStats.h"
+#include "ODJSON.h"
+
+#include <wx/stopwatch.h>
+
+#ifdef __WXMSW__
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include <string.h>
+
+extern ODStats          *g_pODStats;
+
+static const char *s_TimerNames[ ODSTATS_TIMER_COUNT ] = {
+    "RenderOverlay",
+    "RenderGLOverlay",
+    "MouseEventHook",
+    "SetPositionFixEx",
+    "SetPluginMessage",
+    "ChangesWrite",
+    "LoadNavObjects",
+    "NavObjSnapshot",
+    "ChangesFlush",
+    "ChangesCommit"
+};
+
+static const char *s_CounterNames[ ODSTATS_COUNTER_COUNT ] = {
+    "PathsDrawn",
+    "PathsCulled",
+    "PointsDrawn",
+    "PointsCulled",
+    "SelectablesScanned",
+    "ChangesBytes",
+    "ChangesQueuePeak",
+    "ChangesQueueWaits",
+    "PoolBlocks",
+    "PoolSlabs"
+};
+
+ODStats::ODStats()
+{
+    m_bEnabled = false;
+    m_iLogInterval = 0;
+    m_iLastLogUs = 0;
+    Reset();
+}
+
+void ODStats::Enable( bool bEnable )
+{
+    m_bEnabled = bEnable;
+    m_iLastLogUs = ODStatsNowUs();
+}
+
+void ODStats::SetLogInterval( int seconds )
+{
+    m_iLogInterval = seconds > 0 ? seconds : 0;
+}
+
+void ODStats::Reset( void )
+{
+    memset( m_Timers, 0, sizeof( m_Timers ) );
+    memset( m_Counters, 0, sizeof( m_Counters ) );
+}
+
+void ODStats::Record( int timer, wxLongLong_t start_us, wxLongLong_t end_us )
+{
+    wxLongLong_t l_iUs = end_us - start_us;
+    if( l_iUs < 0 ) l_iUs = 0;
+
+    ODStatsHistogram &h = m_Timers[ timer ];
+    h.m_iCount++;
+    h.m_iTotalUs += l_iUs;
+    if( l_iUs > h.m_iMaxUs ) h.m_iMaxUs = l_iUs;
+
+    int b = 0;
+    for( wxLongLong_t l_iLimit = 2; b < ODSTATS_BUCKETS - 1 && l_iUs >= l_iLimit; l_iLimit <<= 1 )
+        b++;
+    h.m_iBuckets[ b ]++;
+
+    if( m_iLogInterval && end_us - m_iLastLogUs >= (wxLongLong_t)m_iLogInterval * 1000000 ) {
+        m_iLastLogUs = end_us;
+        LogSummary();
+    }
+}
+
+//  Upper edge, in milliseconds, of the bucket holding the given fraction of the samples
+double ODStats::GetPercentile( const ODStatsHistogram &h, double fraction )
+{
+    if( !h.m_iCount ) return 0.;
+
+    wxLongLong_t l_iWanted = (wxLongLong_t)( fraction * h.m_iCount + 0.5 );
+    if( l_iWanted < 1 ) l_iWanted = 1;
+    wxLongLong_t l_iSeen = 0;
+    for( int b = 0; b < ODSTATS_BUCKETS - 1; b++ ) {
+        l_iSeen += h.m_iBuckets[ b ];
+        if( l_iSeen >= l_iWanted ) return (double)( (wxLongLong_t)2 << b ) / 1000.;
+    }
+    return (double)h.m_iMaxUs / 1000.;
+}
+
+void ODStats::Write( ODJSONWriter &writer )
+{
+    writer.AddBool( "Enabled", m_bEnabled );
+    writer.AddInt( "LogInterval", m_iLogInterval );
+    for( int i = 0; i < ODSTATS_COUNTER_COUNT; i++ )
+        writer.AddDouble( s_CounterNames[ i ], (double)m_Counters[ i ] );
+
+    writer.BeginArray( "Timers" );
+    for( int i = 0; i < ODSTATS_TIMER_COUNT; i++ ) {
+        const ODStatsHistogram &h = m_Timers[ i ];
+        writer.BeginObject();
+        writer.AddString( "Name", s_TimerNames[ i ] );
+        writer.AddDouble( "Count", (double)h.m_iCount );
+        writer.AddDouble( "TotalMs", (double)h.m_iTotalUs / 1000. );
+        writer.AddDouble( "MeanMs", h.m_iCount ? (double)h.m_iTotalUs / h.m_iCount / 1000. : 0. );
+        writer.AddDouble( "MaxMs", (double)h.m_iMaxUs / 1000. );
+        writer.AddDouble( "P50Ms", GetPercentile( h, 0.50 ) );
+        writer.AddDouble( "P95Ms", GetPercentile( h, 0.95 ) );
+        writer.AddDouble( "P99Ms", GetPercentile( h, 0.99 ) );
+        writer.EndObject();
+    }
+    writer.EndArray();
+}
+
+void ODStats::LogSummary( void )
+{
+    wxString l_msg;
+    l_msg.Append( wxT("ocpn_draw_pi stats:") );
+    for( int i = 0; i < ODSTATS_TIMER_COUNT; i++ ) {
+        const ODStatsHistogram &h = m_Timers[ i ];
+        if( !h.m_iCount ) continue;
+        l_msg.Append( wxString::Format( wxT(" %s n=%") wxLongLongFmtSpec wxT("d mean=%.3fms p95=%.3fms max=%.3fms;"),
+                                        wxString::FromAscii( s_TimerNames[ i ] ).c_str(), h.m_iCount,
+                                        (double)h.m_iTotalUs / h.m_iCount / 1000., GetPercentile( h, 0.95 ),
+                                        (double)h.m_iMaxUs / 1000. ) );
+    }
+    for( int i = 0; i < ODSTATS_COUNTER_COUNT; i++ )
+        l_msg.Append( wxString::Format( wxT(" %s=%") wxLongLongFmtSpec wxT("d"), wxString::FromAscii( s_CounterNames[ i ] ).c_str(), m_Counters[ i ] ) );
+    wxLogMessage( l_msg );
+}
+
+ODStatsTimer::ODStatsTimer( int timer )
+{
+    m_iTimer = timer;
+    m_iStartUs = ( g_pODStats && g_pODStats->IsEnabled() ) ? ODStatsNowUs() : 0;
+}
+
+ODStatsTimer::~ODStatsTimer()
+{
+    if( m_iStartUs && g_pODStats->IsEnabled() )
+        g_pODStats->Record( m_iTimer, m_iStartUs, ODStatsNowUs() );
+}
+
+void ODStatsCount( int counter, wxLongLong_t n )
+{
+    if( g_pODStats && g_pODStats->IsEnabled() )
+        g_pODStats->Count( counter, n );
+}
+
+void ODStatsPeak( int counter, wxLongLong_t n )
+{
+    if( g_pODStats && g_pODStats->IsEnabled() )
+        g_pODStats->Peak( counter, n );
+}
+
+void ODStatsRecord( int timer, wxLongLong_t start_us, wxLongLong_t end_us )
+{
+    if( g_pODStats && g_pODStats->IsEnabled() )
+        g_pODStats->Record( timer, start_us, end_us );
+}
+
+wxLongLong_t ODStatsNowUs( void )
+{
+#if defined( __WXMSW__ )
+    static LARGE_INTEGER s_Frequency = { 0 };
+    if( !s_Frequency.QuadPart ) ::QueryPerformanceFrequency( &s_Frequency );
+    LARGE_INTEGER l_Counter;
+    ::QueryPerformanceCounter( &l_Counter );
+    return (wxLongLong_t)( l_Counter.QuadPart / s_Frequency.QuadPart * 1000000 +
+                           l_Counter.QuadPart % s_Frequency.QuadPart * 1000000 / s_Frequency.QuadPart );
+#elif defined( CLOCK_MONOTONIC )
+    struct timespec l_ts;
+    clock_gettime( CLOCK_MONOTONIC, &l_ts );
+    return (wxLongLong_t)l_ts.tv_sec * 1000000 + l_ts.tv_nsec / 1000;
+#else
+    // Started with the plugin, good enough where there is nothing better
+    static wxStopWatch s_sw;
+    return (wxLongLong_t)s_sw.Time() * 1000;
+#endif
+}
@@ -0,0 +1,241 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  OCPN Draw text extents and label cache
+ * Author:   Jon Gough
+ *
+ ***************************************************************************
+ *   Copyright (C) 2010 by David S. Register                               *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ **************************************************************************/
+
+#include "wx/wxprec.h"
+
+#ifndef  WX_PRECOMP
+#include "wx/wx.h"
+#endif //precompiled headers
+
+#include "ODTextCache.h"
+#include "cutil.h"
+
+#include <wx/dcscreen.h>
+#ifdef ocpnUSE_GL
+#include <wx/dcmemory.h>
+#endif
+
+//    Fonts the cache will tell apart before it starts again, font and
+//    scale changes add to the table
+#define ODTEXTCACHE_MAX_FONTS   64
+
+#ifdef ocpnUSE_GL
+#ifdef __WXMSW__
+    #include "GL/gl.h"            // local copy for Windows
+#else
+    #ifndef __OCPN__ANDROID__
+        #include <GL/gl.h>
+    #else
+        #include "qopengl.h"                  // this gives us the qt runtime gles2.h
+        #include "GL/gl_private.h"
+    #endif
+#endif
+#endif
+
+ODTextCacheEntry::ODTextCacheEntry()
+{
+    m_iFont = 0;
+    m_bMultiLine = false;
+    m_Extents = wxSize( 0, 0 );
+#ifdef ocpnUSE_GL
+    m_iTexture = 0;
+    m_iTextureWidth = 0;
+    m_iTextureHeight = 0;
+#endif
+}
+
+ODTextCacheEntry::~ODTextCacheEntry()
+{
+}
+
+size_t ODTextCacheEntry::GetSize( void )
+{
+    size_t l_size = sizeof( ODTextCacheEntry ) + m_sText.Len() * sizeof( wxChar );
+#ifdef ocpnUSE_GL
+    if( m_iTexture ) l_size += m_iTextureWidth * m_iTextureHeight;
+#endif
+    return l_size;
+}
+
+ODTextCache::ODTextCache( size_t max_bytes )
+{
+    m_MaxBytes = max_bytes;
+    m_BytesUsed = 0;
+}
+
+ODTextCache::~ODTextCache()
+{
+    // Textures not yet deleted go with OpenCPN's GL context, which may
+    // already be gone, so they are left alone
+    Clear();
+}
+
+void ODTextCache::Clear( void )
+{
+    for( ODTextCacheLRU::iterator it = m_LRU.begin(); it != m_LRU.end(); ++it ) {
+#ifdef ocpnUSE_GL
+        if( (*it)->m_iTexture ) m_ReleasedTextures.push_back( (*it)->m_iTexture );
+#endif
+        delete *it;
+    }
+    m_LRU.clear();
+    m_Hash.clear();
+    m_Fonts.clear();
+    m_BytesUsed = 0;
+}
+
+int ODTextCache::FontId( const wxFont &font )
+{
+    // Callers hold on to their fonts, so there are only a few of them and
+    // the one asked for is found by comparing pointers
+    for( size_t i = 0; i < m_Fonts.size(); i++ ) {
+        if( m_Fonts[i].IsSameAs( font ) ) return (int)i;
+    }
+    if( m_Fonts.size() >= ODTEXTCACHE_MAX_FONTS ) Clear();
+    m_Fonts.push_back( font );
+    return (int)m_Fonts.size() - 1;
+}
+
+ODTextCacheEntry *ODTextCache::Find( const wxFont &font, const wxString &text, bool bMultiLine )
+{
+    int l_iFont = FontId( font );
+
+    ODTextCacheHash::iterator it = m_Hash.find( ODTextCacheKey( l_iFont, bMultiLine, &text ) );
+    if( it != m_Hash.end() ) {
+        // move to the front of the LRU list, the iterator stays valid
+        m_LRU.splice( m_LRU.begin(), m_LRU, it->second );
+        return *( it->second );
+    }
+
+    ODTextCacheEntry *pEntry = new ODTextCacheEntry;
+    pEntry->m_iFont = l_iFont;
+    pEntry->m_bMultiLine = bMultiLine;
+    pEntry->m_sText = text;
+    if( font.IsOk() && text.Len() ) {
+        wxScreenDC dc;
+        dc.SetFont( font );
+        if( bMultiLine )
+            pEntry->m_Extents = dc.GetMultiLineTextExtent( text );
+        else
+            pEntry->m_Extents = dc.GetTextExtent( text );
+    }
+
+    m_LRU.push_front( pEntry );
+    m_Hash[ ODTextCacheKey( l_iFont, bMultiLine, &pEntry->m_sText ) ] = m_LRU.begin();
+    m_BytesUsed += pEntry->GetSize();
+    Trim();
+
+    return pEntry;
+}
+
+void ODTextCache::Delete( ODTextCacheEntry *pEntry )
+{
+    ODTextCacheHash::iterator it = m_Hash.find( ODTextCacheKey( pEntry->m_iFont, pEntry->m_bMultiLine, &pEntry->m_sText ) );
+    if( it != m_Hash.end() ) {
+        m_LRU.erase( it->second );
+        m_Hash.erase( it );
+    }
+    m_BytesUsed -= pEntry->GetSize();
+#ifdef ocpnUSE_GL
+    // Entries can be dropped while drawing to a DC, with no GL context current
+    if( pEntry->m_iTexture ) m_ReleasedTextures.push_back( pEntry->m_iTexture );
+#endif
+    delete pEntry;
+}
+
+void ODTextCache::Trim( void )
+{
+    // Never drop the entry at the front, it has just been asked for
+    while( m_BytesUsed > m_MaxBytes && m_LRU.size() > 1 )
+        Delete( m_LRU.back() );
+}
+
+wxSize ODTextCache::GetTextExtent( const wxFont &font, const wxString &text )
+{
+    return Find( font, text, false )->m_Extents;
+}
+
+wxSize ODTextCache::GetMultiLineTextExtent( const wxFont &font, const wxString &text )
+{
+    return Find( font, text, true )->m_Extents;
+}
+
+#ifdef ocpnUSE_GL
+unsigned int ODTextCache::GetLabelTexture( const wxFont &font, const wxString &text, wxSize *extents, wxSize *texture_size )
+{
+    ODTextCacheEntry *pEntry = Find( font, text, false );
+    int w = pEntry->m_Extents.x;
+    int h = pEntry->m_Extents.y;
+    if( !pEntry->m_iTexture && w && h ) {
+        /* render text on dc, white on black so any channel can be used as alpha */
+        wxBitmap tbm( w, h );
+        wxMemoryDC dc;
+        dc.SelectObject( tbm );
+        dc.SetBackground( wxBrush( *wxBLACK ) );
+        dc.Clear();
+        dc.SetFont( font );
+        dc.SetTextForeground( *wxWHITE );
+        dc.DrawText( text, 0, 0 );
+        dc.SelectObject( wxNullBitmap );
+
+        wxImage image = tbm.ConvertToImage();
+        unsigned char *d = image.GetData();
+        if( !d ) return 0;
+
+        std::vector<unsigned char> e( w * h );
+        for( int p = 0; p < w * h; p++ )
+            e[p] = d[ 3 * p + 0 ];
+
+        m_BytesUsed -= pEntry->GetSize();
+        /* create texture for rendered text */
+        glGenTextures( 1, &pEntry->m_iTexture );
+        glBindTexture( GL_TEXTURE_2D, pEntry->m_iTexture );
+
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+
+        pEntry->m_iTextureWidth = NextPow2( w );
+        pEntry->m_iTextureHeight = NextPow2( h );
+        glTexImage2D( GL_TEXTURE_2D, 0, GL_ALPHA, pEntry->m_iTextureWidth, pEntry->m_iTextureHeight,
+                      0, GL_ALPHA, GL_UNSIGNED_BYTE, NULL );
+        glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, w, h, GL_ALPHA, GL_UNSIGNED_BYTE, &e[0] );
+
+        m_BytesUsed += pEntry->GetSize();
+        Trim();
+        DeleteReleasedTextures();
+    }
+
+    *extents = pEntry->m_Extents;
+    *texture_size = wxSize( pEntry->m_iTextureWidth, pEntry->m_iTextureHeight );
+    return pEntry->m_iTexture;
+}
+
+void ODTextCache::DeleteReleasedTextures( void )
+{
+    if( m_ReleasedTextures.empty() ) return;
+    glDeleteTextures( (GLsizei)m_ReleasedTextures.size(), &m_ReleasedTextures[0] );
+    m_ReleasedTextures.clear();
+}
+#endif
@@ -142,7 +142,7 @@ bool PathMan::DeactivatePath( ODPath *pPathToDeactivate )
     return true;
 }
 
-bool PathMan::DeletePath( ODPath *pPath )
+bool PathMan::DeletePath( ODPath *pPath, bool b_remove_selectables )
 {
     if( pPath ) {
 
@@ -154,7 +154,8 @@ bool PathMan::DeletePath( ODPath *pPath )
         g_pODConfig->DeleteConfigPath( pPath );
 
         //    Remove the path from associated lists
-        g_pODSelect->DeleteAllSelectablePathSegments( pPath );
+        if( b_remove_selectables )
+            g_pODSelect->DeleteAllSelectablePathSegments( pPath );
         g_pPathList->DeleteObject( pPath );
         if(pPath->m_sTypeString == wxT("Boundary")) g_pBoundaryList->DeleteObject( (Boundary *)pPath );
         if(pPath->m_sTypeString == wxT("EBL")) g_pEBLList->DeleteObject( (EBL *)pPath );
@@ -174,7 +175,8 @@ bool PathMan::DeletePath( ODPath *pPath )
 //    This does not need to be done with navobj.xml storage, since the ODPoints are stored with the route
 //                              g_pODConfig->DeleteODPoint(prp);
 
-                    g_pODSelect->DeleteSelectablePoint( prp, SELTYPE_ODPOINT );
+                    if( b_remove_selectables )
+                        g_pODSelect->DeleteSelectablePoint( prp, SELTYPE_ODPOINT );
 
                     // Remove all instances of this point from the list.
                     wxODPointListNode *pdnode = pnode;
@@ -275,26 +277,82 @@ wxArrayPtrVoid *PathMan::GetPathArrayContaining( ODPoint *pWP )
 
 void PathMan::DeleteAllPaths( void )
 {
-    ::wxBeginBusyCursor();
+    ODPathSet l_paths;
+    for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() ) {
+        ODPath *ppath = node->GetData();
+        if( !ppath->m_bIsInLayer ) l_paths.insert( ppath );
+    }
 
-    //    Iterate on the RouteList
-    wxPathListNode *node = g_pPathList->GetFirst();
+    DeletePaths( l_paths );
+}
+
+//  Takes the nodes of the given paths out of one of the path lists
+template <class T>
+static void DeletePathNodes( T *pList, const ODPathSet &paths )
+{
+    typename T::compatibility_iterator node = pList->GetFirst();
     while( node ) {
-        ODPath *ppath = node->GetData();
-        if( ppath->m_bIsInLayer ) {
-            node = node->GetNext();
-            continue;
-        }
+        typename T::compatibility_iterator next = node->GetNext();
+        if( paths.count( node->GetData() ) ) pList->DeleteNode( node );
+        node = next;
+    }
+}
+
+void PathMan::DeletePaths( const ODPathSet &paths )
+{
+    ODPathSet l_paths;
+    for( ODPathSet::const_iterator it = paths.begin(); it != paths.end(); ++it )
+        if( !(*it)->m_bIsInLayer ) l_paths.insert( *it );
+    if( l_paths.empty() ) return;
 
-//        g_pODConfig->m_bSkipChangeSetUpdate = true;
-        g_pODConfig->DeleteConfigPath( ppath );
-        DeletePath( ppath );
-        node = g_pPathList->GetFirst();                   // Path
-//        g_pODConfig->m_bSkipChangeSetUpdate = false;
+    ::wxBeginBusyCursor();
+
+    g_pODConfig->DeleteConfigObjects( &l_paths, NULL );
+
+    //    Remove the paths from associated lists
+    DeletePathNodes( g_pPathList, l_paths );
+    DeletePathNodes( g_pBoundaryList, l_paths );
+    DeletePathNodes( g_pEBLList, l_paths );
+    DeletePathNodes( g_pDRList, l_paths );
+
+    //    Points that a remaining path still uses are left alone
+    ODPointSet l_used;
+    for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() ) {
+        wxODPointListNode *pnode = ( node->GetData()->m_pODPointList )->GetFirst();
+        for( ; pnode; pnode = pnode->GetNext() )
+            l_used.insert( pnode->GetData() );
     }
 
-    ::wxEndBusyCursor();
+    // walk the paths, deleting/marking points used only by them
+    ODPointSet l_points;
+    for( ODPathSet::iterator it = l_paths.begin(); it != l_paths.end(); ++it ) {
+        ODPath *pPath = *it;
+        wxODPointListNode *pnode = ( pPath->m_pODPointList )->GetFirst();
+        for( ; pnode; pnode = pnode->GetNext() ) {
+            ODPoint *prp = pnode->GetData();
+            if( !prp->m_bIsInPath || l_used.count( prp ) ) continue;
+
+            prp->m_bIsInPath = false;
+            if( !prp->m_bKeepXPath ) {
+                if(prp->m_ODPointName == wxT("Boat") && pPath->m_sTypeString == wxT("EBL") ) g_ocpn_draw_pi->m_pEBLBoatPoint = NULL;
+                l_points.insert( prp );
+            } else {
+                prp->m_bDynamicName = false;
+                prp->m_bIsolatedMark = true;        // This has become an isolated mark
+                prp->m_bKeepXPath = false;         // and is no longer part of a Boundary
+            }
+        }
+    }
 
+    g_pODSelect->DeleteSelectableObjects( &l_paths, &l_points );
+
+    for( ODPathSet::iterator it = l_paths.begin(); it != l_paths.end(); ++it )
+        delete *it;
+    for( ODPointSet::iterator it = l_points.begin(); it != l_points.end(); ++it )
+        delete *it;
+    ODSlabPool::TrimAll();
+
+    ::wxEndBusyCursor();
 }
 
 ODPath *PathMan::FindPathContainingODPoint( ODPoint *pWP )
@@ -54,6 +54,7 @@ extern ODPoint          *pAnchorWatchPoint1;
 extern ODPoint          *pAnchorWatchPoint2;
 extern ODConfig         *g_pODConfig;
 extern PathMan          *g_pPathMan;
+extern PathList         *g_pPathList;
 extern ODSelect         *g_pODSelect;
 extern ocpn_draw_pi     *g_ocpn_draw_pi;
 
@@ -673,60 +674,126 @@ bool PointMan::SharedODPointsExist()
 
 void PointMan::DeleteAllODPoints( bool b_delete_used )
 {
-    //    Iterate on the ODPoint list, deleting all
-    wxODPointListNode *node = m_pODPointList->GetFirst();
-    while( node ) {
+    //    Collect the points to go, then delete them together
+    ODPointSet l_points;
+    for( wxODPointListNode *node = m_pODPointList->GetFirst(); node; node = node->GetNext() ) {
         ODPoint *prp = node->GetData();
         // if argument is false, then only delete non-path ODPoints
         if( !prp->m_bIsInLayer && ( prp->GetIconName() != _T("mob") )
             && ( ( b_delete_used && prp->m_bKeepXPath )
-                        || ( ( !prp->m_bIsInPath ) && !( prp == pAnchorWatchPoint1 ) && !( prp == pAnchorWatchPoint2 ) ) ) ) {
-            DestroyODPoint(prp);
-            if(prp->m_sTypeString == wxT("ODPoint"))
-                delete prp;
-            else if(prp->m_sTypeString == wxT("Text Point")) {
-                delete (TextPoint *)node->GetData();
-            }
-            node = m_pODPointList->GetFirst();
-        } else
-            node = node->GetNext();
+                        || ( ( !prp->m_bIsInPath ) && !( prp == pAnchorWatchPoint1 ) && !( prp == pAnchorWatchPoint2 ) ) ) )
+            l_points.insert( prp );
     }
-    return;
 
+    DeleteODPoints( l_points );
 }
 
-void PointMan::DestroyODPoint( ODPoint *pRp, bool b_update_changeset )
+void PointMan::DeleteODPoints( const ODPointSet &points, bool b_update_changeset )
 {
+    ODPointSet l_points;
+    for( ODPointSet::const_iterator it = points.begin(); it != points.end(); ++it )
+        if( !(*it)->m_bIsInLayer ) l_points.insert( *it );
+    if( l_points.empty() ) return;
+
+    ::wxBeginBusyCursor();
+    bool prev_bskip = g_pODConfig->m_bSkipChangeSetUpdate;
     if( ! b_update_changeset )
-        g_pODConfig->m_bSkipChangeSetUpdate = true;             // turn OFF change-set updating if requested
-        
-    if( pRp ) {
-        // Get a list of all boundaries containing this point
-        // and remove the point from them all
-        wxArrayPtrVoid *ppath_array = g_pPathMan->GetPathArrayContaining( pRp );
-        if( ppath_array ) {
-            for( unsigned int ib = 0; ib < ppath_array->GetCount(); ib++ ) {
-                ODPath *pb = (ODPath *) ppath_array->Item( ib );
+        g_pODConfig->m_bSkipChangeSetUpdate = true;
+    g_pODConfig->BeginTransaction();
+
+    //  Every point of the set that is in a path is marked as kept before any
+    //  path is touched, so a path deleted for being left too short cannot
+    //  delete another point of this set along with it
+    for( ODPointSet::iterator it = l_points.begin(); it != l_points.end(); ++it )
+        if( (*it)->m_bIsInPath ) (*it)->m_bKeepXPath = true;
+
+    //  One sweep of the paths finds those using any of the points
+    std::vector<ODPath *> l_paths;
+    for( wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() ) {
+        wxODPointListNode *pnode = ( node->GetData()->m_pODPointList )->GetFirst();
+        for( ; pnode; pnode = pnode->GetNext() ) {
+            if( l_points.count( pnode->GetData() ) ) {
+                l_paths.push_back( node->GetData() );
+                break;
+            }
+        }
+    }
 
-                pb->RemovePoint( pRp );
+    //  then the points come out of them, and the paths left too short go together
+    ODPathSet l_short;
+    for( size_t i = 0; i < l_paths.size(); i++ ) {
+        l_paths[i]->RemovePoints( l_points );
+        if( l_paths[i]->GetnPoints() < 2 ) l_short.insert( l_paths[i] );
+    }
+    for( ODPointSet::iterator it = l_points.begin(); it != l_points.end(); ++it ) {
+        ODPoint *prp = *it;
+        if( !prp->m_bIsInPath ) continue;
+        prp->m_bIsInPath = false;
+        prp->m_bDynamicName = false;
+        prp->m_bIsolatedMark = true;
+        prp->SetTypeString( wxT("Boundary Point") );
+    }
+    if( !l_short.empty() ) {
+        bool l_bskip = g_pODConfig->m_bSkipChangeSetUpdate;
+        g_pODConfig->m_bSkipChangeSetUpdate = true;
+        g_pPathMan->DeletePaths( l_short );
+        g_pODConfig->m_bSkipChangeSetUpdate = l_bskip;
+    }
 
-            }
+    g_pODConfig->DeleteConfigObjects( NULL, &l_points );
+    g_pODSelect->DeleteSelectableObjects( NULL, &l_points );
+    if( l_points.count( pAnchorWatchPoint1 ) ) pAnchorWatchPoint1 = NULL;
+    if( l_points.count( pAnchorWatchPoint2 ) ) pAnchorWatchPoint2 = NULL;
 
-            //    Scrub the paths, looking for one-point routes
-            for( unsigned int ib = 0; ib < ppath_array->GetCount(); ib++ ) {
-                ODPath *pb = (ODPath *) ppath_array->Item( ib );
-                if( pb->GetnPoints() < 2 ) {
-                    bool prev_bskip = g_pODConfig->m_bSkipChangeSetUpdate;
-                    g_pODConfig->m_bSkipChangeSetUpdate = true;
-                    g_pODConfig->DeleteConfigPath( pb );
-                    g_pPathMan->DeletePath( pb );
-                    g_pODConfig->m_bSkipChangeSetUpdate = prev_bskip;
-                }
-            }
+    g_pODConfig->CommitTransaction();
+    g_pODConfig->m_bSkipChangeSetUpdate = prev_bskip;
+
+    //  Each point still holds its node in the point list, so deleting
+    //  it takes it off the list without a search
+    for( ODPointSet::iterator it = l_points.begin(); it != l_points.end(); ++it )
+        delete *it;
+    ODSlabPool::TrimAll();
+
+    ::wxEndBusyCursor();
+}
+
+void PointMan::RemoveODPointFromPaths( ODPoint *pRp )
+{
+    // Get a list of all boundaries containing this point
+    // and remove the point from them all
+    wxArrayPtrVoid *ppath_array = g_pPathMan->GetPathArrayContaining( pRp );
+    if( ppath_array ) {
+        for( unsigned int ib = 0; ib < ppath_array->GetCount(); ib++ ) {
+            ODPath *pb = (ODPath *) ppath_array->Item( ib );
+
+            pb->RemovePoint( pRp );
 
-            delete ppath_array;
         }
 
+        //    Scrub the paths, looking for one-point routes
+        for( unsigned int ib = 0; ib < ppath_array->GetCount(); ib++ ) {
+            ODPath *pb = (ODPath *) ppath_array->Item( ib );
+            if( pb->GetnPoints() < 2 ) {
+                bool prev_bskip = g_pODConfig->m_bSkipChangeSetUpdate;
+                g_pODConfig->m_bSkipChangeSetUpdate = true;
+                g_pODConfig->DeleteConfigPath( pb );
+                g_pPathMan->DeletePath( pb );
+                g_pODConfig->m_bSkipChangeSetUpdate = prev_bskip;
+            }
+        }
+
+        delete ppath_array;
+    }
+}
+
+void PointMan::DestroyODPoint( ODPoint *pRp, bool b_update_changeset )
+{
+    if( ! b_update_changeset )
+        g_pODConfig->m_bSkipChangeSetUpdate = true;             // turn OFF change-set updating if requested
+        
+    if( pRp ) {
+        RemoveODPointFromPaths( pRp );
+
         // Now it is safe to delete the point
         g_pODConfig->DeleteODPoint( pRp );
         g_pODConfig->m_bSkipChangeSetUpdate = false;
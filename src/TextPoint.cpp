@@ -30,6 +30,8 @@
 #endif //precompiled headers
 
 #include "TextPoint.h"
+#include "ODProjection.h"
+#include "ODTextCache.h"
 #include "ocpn_draw_pi.h"
 #include "ODdc.h"
 #include "PointMan.h"
@@ -62,6 +64,7 @@ extern int          g_iTextRightOffsetY;
 extern int          g_iTextLeftOffsetX;
 extern int          g_iTextLeftOffsetY;
 extern int          g_iTextPointDisplayTextWhen;
+extern ODTextCache  *g_pODTextCache;
 
 //extern ChartCanvas  *ocpncc1;
 // Fix for VS2010 not having the round function
@@ -266,7 +269,7 @@ void TextPoint::Draw( ODDC& dc, wxPoint *rpn )
                 
                 //    Calculate the mark drawing extents
                 wxPoint r;
-                GetCanvasPixLL( g_pivp, &r,  m_lat, m_lon);    
+                ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( m_lat, m_lon, &r );    
                 wxRect r1( r.x - sx2, r.y - sy2, sx2 * 2, sy2 * 2 );           // the bitmap extents
                 if( m_DisplayTextFont.IsOk() ) {
                     // Added to help with display of text (stops end clipping)
@@ -349,7 +352,7 @@ void TextPoint::DrawGL( PlugIn_ViewPort &pivp )
                 
                 //    Calculate the mark drawing extents
                 wxPoint r;
-                GetCanvasPixLL( g_pivp, &r,  m_lat, m_lon);    
+                ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( m_lat, m_lon, &r );    
                 wxRect r1( r.x - sx2, r.y - sy2, sx2 * 2, sy2 * 2 );           // the bitmap extents
                 if( m_DisplayTextFont.IsOk() ) {
                     // Added to help with display of text (stops end clipping)
@@ -435,12 +438,9 @@ void TextPoint::DrawGL( PlugIn_ViewPort &pivp )
 
 void TextPoint::CalculateTextExtents( void )
 {
-    if( m_DisplayTextFont.IsOk() ) {
-        wxScreenDC dc;
-        
-        dc.SetFont( m_DisplayTextFont );
-        m_TextExtents = dc.GetMultiLineTextExtent( m_TextPointText );
-    } else
+    if( m_DisplayTextFont.IsOk() )
+        m_TextExtents = g_pODTextCache->GetMultiLineTextExtent( m_DisplayTextFont, m_TextPointText );
+    else
         m_TextExtents = wxSize( 0, 0 );
     
 }
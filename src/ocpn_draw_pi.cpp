@@ -34,6 +34,7 @@
 #endif //precompiled headers
 
 #include "ocpn_draw_pi.h"
+#include "ODAPI.h"
 #include "Boundary.h"
 #include "BoundaryMan.h"
 #include "BoundaryPoint.h"
@@ -52,8 +53,12 @@
 #include "ODEventHandler.h"
 #include "ODPropertiesDialogImpl.h"
 #include "ODicons.h"
+#include "ODLegPreview.h"
 #include "ODPoint.h"
+#include "ODProjection.h"
 #include "ODSelect.h"
+#include "ODTextCache.h"
+#include "ODStats.h"
 #include "ODPointPropertiesImpl.h"
 #include "ODToolbarImpl.h"
 #include "ODUtils.h"
@@ -132,6 +137,9 @@ ODPath                  *g_PathToEdit;
 ODRolloverWin           *g_pODRolloverWin;
 SelectItem              *g_pRolloverPathSeg;
 SelectItem              *g_pRolloverPoint;
+ODTextCache             *g_pODTextCache;
+ODAPI                   *g_pODAPI;
+ODStats                 *g_pODStats;
 
 wxColour    g_colourActiveBoundaryLineColour;
 wxColour    g_colourInActiveBoundaryLineColour;
@@ -228,6 +236,7 @@ wxString        g_VisibleLayers;
 wxString        g_InvisibleLayers;
 LayerList       *pLayerList;
 int             g_navobjbackups;
+int             g_iODChangesFlushInterval;
 int             g_EdgePanSensitivity;
 int             g_InitialEdgePanSensitivity;
 
@@ -315,6 +324,7 @@ ocpn_draw_pi::ocpn_draw_pi(void *ppimgr)
         wxMkdir( *g_pData );
     
     m_pODicons = new ODicons();
+    m_pLegPreview = NULL;
 }
 
 ocpn_draw_pi::~ocpn_draw_pi()
@@ -371,8 +381,14 @@ int ocpn_draw_pi::Init(void)
     //    g_pODConfig->m_pODNavObjectChangesSet = new ODNavObjectChanges( sChangesFile );
     
     g_pODSelect = new ODSelect();
+    g_pODTextCache = new ODTextCache();
+    m_pLegPreview = new ODLegPreview();
+    g_pODAPI = new ODAPI();
+    g_pODStats = new ODStats();
     
     LoadConfig();
+    // The changes set was made before the setting was read
+    g_pODConfig->m_pODNavObjectChangesSet->SetChangesFlushInterval( g_iODChangesFlushInterval );
 
     g_pODPointList = new ODPointList;
     g_pBoundaryList = new BoundaryList;
@@ -570,8 +586,19 @@ bool ocpn_draw_pi::DeInit(void)
     m_draw_button_id = 0;
     if( g_pODConfig ) {
         g_pODConfig->UpdateNavObj();
+        // Anything the save could not take over still has to reach the changes file
+        if( g_pODConfig->m_pODNavObjectChangesSet )
+            g_pODConfig->m_pODNavObjectChangesSet->StopChangesWriter();
         SaveConfig();
     }
+    if( g_pODTextCache ) delete g_pODTextCache;
+    g_pODTextCache = NULL;
+    if( m_pLegPreview ) delete m_pLegPreview;
+    m_pLegPreview = NULL;
+    if( g_pODAPI ) delete g_pODAPI;
+    g_pODAPI = NULL;
+    if( g_pODStats ) delete g_pODStats;
+    g_pODStats = NULL;
     shutdown(false);
     return true;
 }
@@ -605,6 +632,7 @@ void ocpn_draw_pi::SetOriginalColors()
 void ocpn_draw_pi::SetColorScheme(PI_ColorScheme cs)
 {
     global_color_scheme = cs;
+    if( m_pLegPreview ) m_pLegPreview->Invalidate();
 }
 
 void ocpn_draw_pi::UpdateAuiStatus(void)
@@ -687,6 +715,7 @@ void ocpn_draw_pi::ShowPreferencesDialog( wxWindow* parent )
 
 void ocpn_draw_pi::SetPositionFixEx( PlugIn_Position_Fix_Ex &pfix )
 {
+    ODStatsTimer l_timer( ODSTATS_POSITION_FIX );
     double incLat, incLon;
     
     if(pfix.FixTime && pfix.nSats)
@@ -723,6 +752,11 @@ void ocpn_draw_pi::SetPositionFixEx( PlugIn_Position_Fix_Ex &pfix )
             }
             node = node->GetNext();
         }
+        
+        //  Only the distance and bearing from the boat change, and only for the rows on show
+        if( g_pODPathPropDialog && g_pODPathPropDialog->IsShown() ) g_pODPathPropDialog->UpdateBoatPosition();
+        if( g_pBoundaryPropDialog && g_pBoundaryPropDialog->IsShown() ) g_pBoundaryPropDialog->UpdateBoatPosition();
+        if( g_pDRPropDialog && g_pDRPropDialog->IsShown() ) g_pDRPropDialog->UpdateBoatPosition();
     }
 }
 
@@ -964,6 +998,7 @@ void ocpn_draw_pi::SaveConfig()
         pConf->Write( wxS( "ShowMag" ), g_bShowMag );
         pConf->Write( wxS( "UserMagVariation" ), wxString::Format( _T("%.2f"), g_UserVar ) );
         pConf->Write( wxS( "KeepODNavobjBackups" ), g_navobjbackups );
+        pConf->Write( wxS( "ChangesFlushInterval" ), g_iODChangesFlushInterval );
         pConf->Write( wxS( "CurrentDrawMode" ), m_Mode );
         pConf->Write( wxS( "ConfirmObjectDelete" ), g_bConfirmObjectDelete );
         pConf->Write( wxS( "InitialEdgePanSensitivity" ), g_InitialEdgePanSensitivity );
@@ -1133,6 +1168,7 @@ void ocpn_draw_pi::LoadConfig()
         if(umv.Len())
             umv.ToDouble( &g_UserVar );
         pConf->Read( wxS( "KeepODNavobjBackups" ), &g_navobjbackups, 0 );
+        pConf->Read( wxS( "ChangesFlushInterval" ), &g_iODChangesFlushInterval, 0 );
         pConf->Read( wxS( "CurrentDrawMode" ), &m_Mode, 0 );
         pConf->Read( wxS( "ConfirmObjectDelete" ), &g_bConfirmObjectDelete, 0 );
         
@@ -1188,378 +1224,23 @@ void ocpn_draw_pi::LoadConfig()
         pConf->Read( wxS( "DefaultTextPointFontEncoding" ), &l_fontInfo, (int)l_pDisplayTextFont->GetEncoding() );
         g_DisplayTextFont.SetEncoding( (wxFontEncoding)l_fontInfo );
         pConf->Read( wxS( "DefaultTextPointDisplayTextWhen" ), &g_iTextPointDisplayTextWhen, ID_TEXTPOINT_DISPLAY_TEXT_SHOW_ALWAYS );
+        
+        // Diagnostics, only set by hand in the config file
+        bool l_bStats;
+        int l_iStatsLogInterval;
+        pConf->Read( wxS( "StatsEnabled" ), &l_bStats, false );
+        pConf->Read( wxS( "StatsLogInterval" ), &l_iStatsLogInterval, 0 );
+        g_pODStats->SetLogInterval( l_iStatsLogInterval );
+        g_pODStats->Enable( l_bStats );
     }
     
 }
 
 void ocpn_draw_pi::SetPluginMessage(wxString &message_id, wxString &message_body)
 {
-    wxJSONValue     root;
-    wxJSONReader    reader;
-    wxJSONValue     jMsg;
-    wxJSONWriter    writer;
-    wxString        MsgString;
-    
-    wxString    sLogMessage;
-    wxString    l_sType;
-    wxString    l_sMsg;
-    double      l_dLat;
-    double      l_dLon;
-    wxString    l_GUID;
-    int         l_BoundaryType;
-    bool        bFail = false;
-    
+    ODStatsTimer l_timer( ODSTATS_PLUGIN_MESSAGE );
     if(message_id == wxS("OCPN_DRAW_PI")) {
-        // now read the JSON text and store it in the 'root' structure
-        // check for errors before retreiving values...
-        int numErrors = reader.Parse( message_body, &root );
-        if ( numErrors > 0 )  {
-            const wxArrayString& errors = reader.GetErrors();
-            for(size_t i = 0; i < errors.GetCount(); i++)
-            {
-                if(i == 0) {
-                    sLogMessage.clear();
-                    sLogMessage.Append(wxT("ocpn_draw_pi: Error parsing JSON message - "));
-                    sLogMessage.Append( message_id );
-                }
-                else sLogMessage.Append(wxT(" "));
-                sLogMessage.append( errors.Item( i ) );
-                wxLogMessage( sLogMessage );
-            }
-            return;
-        }
-        
-        if(!root.HasMember( wxS("Source"))) {
-            // Originator
-            wxLogMessage( wxS("No Source found in message") );
-            bFail = true;
-        }
-        
-        if(!root.HasMember( wxS("Msg"))) {
-            // Message identifier
-            wxLogMessage( wxS("No Msg found in message") );
-            bFail = true;
-        }
-        
-        if(!root.HasMember( wxS("Type"))) {
-            // Message type, orig or resp
-            wxLogMessage( wxS("No Type found in message") );
-            bFail = true;
-        }
-        
-        if(!root.HasMember( wxS("MsgId"))) {
-            // Unique (?) Msg number
-            wxLogMessage( wxS("No MsgId found in message") );
-            bFail = true;
-        }
-
-        if(!bFail && root[wxS("Msg")].AsString() == wxS("Version")) {
-            jMsg[wxT("Source")] = wxT("OCPN_DRAW_PI");
-            jMsg[wxT("Msg")] = root[wxT("Msg")];
-            jMsg[wxT("Type")] = wxT("Response");
-            jMsg[wxT("MsgId")] = root[wxT("MsgId")].AsString();
-            jMsg[wxS("Major")] = PLUGIN_VERSION_MAJOR;
-            jMsg[wxS("Minor")] = PLUGIN_VERSION_MINOR;
-            jMsg[wxS("Patch")] = PLUGIN_VERSION_PATCH;
-            jMsg[wxS("Date")] = PLUGIN_VERSION_DATE;
-            writer.Write( jMsg, MsgString );
-            SendPluginMessage( root[wxS("Source")].AsString(), MsgString );
-            
-        } else if(!bFail && root[wxS("Msg")].AsString() == wxS("FindPathByGUID")) {
-            if(!root.HasMember( wxS("GUID"))) {
-                wxLogMessage( wxS("No GUID found in message") );
-                bFail = true;
-            }
-            
-            if(!bFail) {
-                wxString l_sGUID = root[wxS("GUID")].AsString();
-                l_sType = root[wxS("Type")].AsString();
-                l_sMsg = root[wxT("Msg")].AsString();
-                
-                if(l_sType == wxS("Request")) {
-                    ODPath *l_path = NULL;
-                        l_path = g_pPathMan->FindPathByGUID( l_sGUID );
-                        if(!l_path) {
-                            wxString l_msg;
-                            l_msg.append( wxS("Path, with GUID: ") );
-                            l_msg.append( l_sGUID );
-                            l_msg.append( wxS(", not found") );
-                            wxLogMessage( l_msg );
-                            jMsg[wxT("Source")] = wxT("OCPN_DRAW_PI");
-                            jMsg[wxT("Msg")] = root[wxT("Msg")];
-                            jMsg[wxT("Type")] = wxT("Response");
-                            jMsg[wxT("MsgId")] = root[wxT("MsgId")].AsString();
-                            jMsg[wxS("Found")] = false;
-                            jMsg[wxS("GUID")] = root[wxS("GUID")];
-                            writer.Write( jMsg, MsgString );
-                            SendPluginMessage( root[wxT("Source")].AsString(), MsgString );
-                            return;
-                        }
-                        jMsg[wxT("Source")] = wxT("OCPN_DRAW_PI");
-                        jMsg[wxT("Msg")] = root[wxT("Msg")];
-                        jMsg[wxT("Type")] = wxT("Response");
-                        jMsg[wxT("MsgId")] = root[wxT("MsgId")].AsString();
-                        jMsg[wxT("Found")] = true;
-                        jMsg[wxT("GUID")] = root[wxS("GUID")];
-                        jMsg[wxT("Name")] = l_path->m_PathNameString;
-                        jMsg[wxT("Description")] = l_path->m_PathDescription;
-                        writer.Write( jMsg, MsgString );
-                        SendPluginMessage( root[wxT("Source")].AsString(), MsgString );
-                        return;
-                }
-            }
-                    
-        } else if(!bFail && root[wxS("Msg")].AsString() == wxS("FindPointInAnyBoundary")) {
-            if(!root.HasMember( wxS("lat"))) {
-                wxLogMessage( wxS("No Latitude found in message") );
-                bFail = true;
-            }
-            
-            if(!root.HasMember( wxS("lon"))) {
-                wxLogMessage( wxS("No Longitude found in message") );
-                bFail = true;
-            }
-            
-            if(!root.HasMember( wxS("BoundaryType"))) {
-                wxLogMessage( wxS("No Boundary Type found in message") );
-                bFail = true;
-            }
-            
-            if(!bFail) {
-                l_dLat = root[wxS("lat")].AsDouble();
-                l_dLon = root[wxS("lon")].AsDouble();
-                
-                l_sType = root[wxS("Type")].AsString();
-                l_sMsg = root[wxT("Msg")].AsString();
-                
-                if(root[wxT("BoundaryType")].AsString() == wxT("Exclusion")) l_BoundaryType = ID_BOUNDARY_EXCLUSION;
-                else if(root[wxT("BoundaryType")].AsString() == wxT("Inclusion")) l_BoundaryType = ID_BOUNDARY_INCLUSION;
-                else if(root[wxT("BoundaryType")].AsString() == wxT("Neither")) l_BoundaryType = ID_BOUNDARY_NIETHER;
-                else if(root[wxT("BoundaryType")].AsString() == wxT("Any")) l_BoundaryType = ID_BOUNDARY_ANY;
-                else l_BoundaryType = ID_BOUNDARY_ANY;
-                
-                if(l_sType == wxS("Request")) {
-                    bool    l_bFoundBoundary = false;
-                    bool    l_bFoundBoundaryPoint = false;
-                    wxString l_sGUID = g_pBoundaryMan->FindPointInBoundary( l_dLat, l_dLon, l_BoundaryType );
-                    if(l_sGUID.length() > 0) 
-                        l_bFoundBoundary = true;
-                    else {
-                        l_sGUID = g_pBoundaryMan->FindPointInBoundaryPoint( l_dLat, l_dLon, l_BoundaryType );
-                        if(l_sGUID.length() > 0)
-                            l_bFoundBoundaryPoint = true;
-                    }
-                    jMsg[wxT("Source")] = wxT("OCPN_DRAW_PI");
-                    jMsg[wxT("Msg")] = root[wxT("Msg")];
-                    jMsg[wxT("Type")] = wxT("Response");
-                    jMsg[wxT("MsgId")] = root[wxT("MsgId")].AsString();
-                    jMsg[wxS("GUID")] = l_sGUID;
-                    jMsg[wxS("lat")] = l_dLat;
-                    jMsg[wxS("lon")] = l_dLon;
-                    if(l_bFoundBoundary ) {
-                        Boundary *l_boundary = (Boundary *)g_pBoundaryMan->FindPathByGUID( l_sGUID );
-                        jMsg[wxS("Name")] = l_boundary->m_PathNameString;
-                        jMsg[wxS("Description")] = l_boundary->m_PathDescription;
-                        jMsg[wxS("Found")] = true;
-                        jMsg[wxS("BoundaryObjectType")] = wxT("Boundary");
-                        if( l_boundary->m_bExclusionBoundary && !l_boundary->m_bInclusionBoundary)
-                            jMsg[wxS("BoundaryType")] = wxT("Exclusion");
-                        else if( !l_boundary->m_bExclusionBoundary && l_boundary->m_bInclusionBoundary)
-                            jMsg[wxS("BoundaryType")] = wxT("Inclusion");
-                        else if( !l_boundary->m_bExclusionBoundary && !l_boundary->m_bInclusionBoundary)
-                            jMsg[wxS("BoundaryType")] = wxT("Neither");
-                        else
-                            jMsg[wxS("BoundaryType")] = wxT("Unknown");
-                    }
-                    else if(l_bFoundBoundaryPoint ) {
-                        jMsg[wxS("Found")] = true;
-                        BoundaryPoint *l_boundarypoint = (BoundaryPoint *)g_pODPointMan->FindODPointByGUID( l_sGUID );
-                        jMsg[wxS("Name")] = l_boundarypoint->m_ODPointName;
-                        jMsg[wxS("Description")] = l_boundarypoint->m_ODPointDescription;
-                        jMsg[wxS("BoundaryObjectType")] = wxT("Boundary Point");
-                        if( l_boundarypoint->m_bExclusionBoundaryPoint && !l_boundarypoint->m_bInclusionBoundaryPoint)
-                            jMsg[wxS("BoundaryType")] = wxT("Exclusion");
-                        else if( !l_boundarypoint->m_bExclusionBoundaryPoint && l_boundarypoint->m_bInclusionBoundaryPoint)
-                            jMsg[wxS("BoundaryType")] = wxT("Inclusion");
-                        else if( !l_boundarypoint->m_bExclusionBoundaryPoint && !l_boundarypoint->m_bInclusionBoundaryPoint)
-                            jMsg[wxS("BoundaryType")] = wxT("Neither");
-                        else
-                            jMsg[wxS("BoundaryType")] = wxT("Unknown");
-                    }
-                    else jMsg[wxS("Found")] = false;
-                    writer.Write( jMsg, MsgString );
-                    SendPluginMessage( root[wxS("Source")].AsString(), MsgString );
-                    return;
-                }
-            }
-            
-        } else if(!bFail && root[wxS("Msg")].AsString() == wxS("FindPointInBoundary")) {
-            if(!root.HasMember( wxS("GUID"))) {
-                wxLogMessage( wxS("No GUID found in message") );
-                bFail = true;
-            }
-            
-            if(!root.HasMember( wxS("lat"))) {
-                wxLogMessage( wxS("No Latitude found in message") );
-                bFail = true;
-            }
-            
-            if(!root.HasMember( wxS("lon"))) {
-                wxLogMessage( wxS("No Longitude found in message") );
-                bFail = true;
-            }
-            
-            if(!bFail) {
-                wxString l_sGUID = root[wxS("GUID")].AsString();
-                l_dLat = root[wxS("lat")].AsDouble();
-                l_dLon = root[wxS("lon")].AsDouble();
-                
-                l_sType = root[wxS("Type")].AsString();
-                l_sMsg = root[wxT("Msg")].AsString();
-                
-                if(l_sType == wxS("Request")) {
-                    Boundary *l_boundary = NULL;
-                    BoundaryPoint *l_boundarypoint = NULL;
-                    if(l_sMsg == wxS("FindPointInBoundary")) {
-                        l_dLat = root[wxS("lat")].AsDouble();
-                        l_dLon = root[wxS("lon")].AsDouble();
-                        
-                        l_boundary = (Boundary *)g_pBoundaryMan->FindPathByGUID( l_sGUID );
-                        if(!l_boundary) l_boundarypoint = (BoundaryPoint *)g_pODPointMan->FindODPointByGUID( l_sGUID );
-                        if(!l_boundary && !l_boundarypoint) {
-                            wxString l_msg;
-                            l_msg.append( wxS("Boundary, with GUID: ") );
-                            l_msg.append( l_sGUID );
-                            l_msg.append( wxS(", not found") );
-                            wxLogMessage( l_msg );
-                            jMsg[wxT("Source")] = wxT("OCPN_DRAW_PI");
-                            jMsg[wxT("Msg")] = root[wxT("Msg")];
-                            jMsg[wxT("Type")] = wxT("Response");
-                            jMsg[wxT("MsgId")] = root[wxT("MsgId")].AsString();
-                            jMsg[wxS("Found")] = false;
-                            jMsg[wxS("lat")] = l_dLat;
-                            jMsg[wxS("lon")] = l_dLon;
-                            jMsg[wxS("GUID")] = root[wxS("GUID")];
-                            writer.Write( jMsg, MsgString );
-                            SendPluginMessage( root[wxT("Source")].AsString(), MsgString );
-                            return;
-                        }
-                        bool l_bFound = false;
-                        if(l_boundary) l_bFound = g_pBoundaryMan->FindPointInBoundary( l_boundary, l_dLat, l_dLon );
-                        else if(l_boundarypoint) l_bFound = g_pBoundaryMan->FindPointInBoundaryPoint( l_boundarypoint, l_dLat, l_dLon );
-                        jMsg[wxT("Source")] = wxT("OCPN_DRAW_PI");
-                        jMsg[wxT("Msg")] = root[wxT("Msg")];
-                        jMsg[wxT("Type")] = wxT("Response");
-                        jMsg[wxT("MsgId")] = root[wxT("MsgId")].AsString();
-                        jMsg[wxS("Found")] = l_bFound;
-                        jMsg[wxS("lat")] = l_dLat;
-                        jMsg[wxS("lon")] = l_dLon;
-                        jMsg[wxS("GUID")] = root[wxS("GUID")];
-                        if(l_boundary) {
-                            jMsg[wxS("BoundaryObjectType")] = wxT("Boundary");
-                            if( l_boundary->m_bExclusionBoundary && !l_boundary->m_bInclusionBoundary)
-                                jMsg[wxS("BoundaryType")] = wxT("Exclusion");
-                            else if( !l_boundary->m_bExclusionBoundary && l_boundary->m_bInclusionBoundary)
-                                jMsg[wxS("BoundaryType")] = wxT("Inclusion");
-                            else if( !l_boundary->m_bExclusionBoundary && !l_boundary->m_bInclusionBoundary)
-                                jMsg[wxS("BoundaryType")] = wxT("Neither");
-                            else
-                                jMsg[wxS("BoundaryType")] = wxT("Unknown");
-                        }
-                        else {
-                            jMsg[wxS("BoundaryObjectType")] = wxT("Boundary Point");
-                            if( l_boundarypoint->m_bExclusionBoundaryPoint && !l_boundarypoint->m_bInclusionBoundaryPoint)
-                                jMsg[wxS("BoundaryType")] = wxT("Exclusion");
-                            else if( !l_boundarypoint->m_bExclusionBoundaryPoint && l_boundarypoint->m_bInclusionBoundaryPoint)
-                                jMsg[wxS("BoundaryType")] = wxT("Inclusion");
-                            else if( !l_boundarypoint->m_bExclusionBoundaryPoint && !l_boundarypoint->m_bInclusionBoundaryPoint)
-                                jMsg[wxS("BoundaryType")] = wxT("Neither");
-                            else
-                                jMsg[wxS("BoundaryType")] = wxT("Unknown");
-                        }
-                        writer.Write( jMsg, MsgString );
-                        SendPluginMessage( root[wxT("Source")].AsString(), MsgString );
-                        return;
-                    }
-                }
-            }
-            
-        } else if(!bFail && root[wxS("Msg")].AsString() == wxS("FindPointInGuardZone")) {
-            if(!root.HasMember( wxS("GUID"))) {
-                wxLogMessage( wxS("No GUID found in message") );
-                bFail = true;
-            }
-            
-            if(!root.HasMember( wxS("lat"))) {
-                wxLogMessage( wxS("No Latitude found in message") );
-                bFail = true;
-            }
-            
-            if(!root.HasMember( wxS("lon"))) {
-                wxLogMessage( wxS("No Longitude found in message") );
-                bFail = true;
-            }
-            
-            if(!bFail) {
-                wxString l_sGUID = root[wxS("GUID")].AsString();
-                root[wxS("lat")].AsString().ToDouble( & l_dLat );
-                root[wxS("lon")].AsString().ToDouble( & l_dLon );
-                
-                l_sType = root[wxS("Type")].AsString();
-                l_sMsg = root[wxT("Msg")].AsString();
-                
-                if(l_sType == wxS("Request")) {
-                    Boundary *l_boundary = NULL;
-                    BoundaryPoint *l_boundarypoint = NULL;
-
-                    l_boundary = (Boundary *)g_pBoundaryMan->FindPathByGUID( l_sGUID );
-                    if(!l_boundary) l_boundarypoint = (BoundaryPoint *)g_pODPointMan->FindODPointByGUID( l_sGUID );
-                    if(!l_boundary && !l_boundarypoint) {
-                        wxString l_msg;
-                        l_msg.append( wxS("Guard Zone, with GUID: ") );
-                        l_msg.append( l_sGUID );
-                        l_msg.append( wxS(", not found") );
-                        wxLogMessage( l_msg );
-                        jMsg[wxT("Source")] = wxT("OCPN_DRAW_PI");
-                        jMsg[wxT("Msg")] = root[wxT("Msg")];
-                        jMsg[wxT("Type")] = wxT("Response");
-                        jMsg[wxT("MsgId")] = root[wxT("MsgId")].AsString();
-                        jMsg[wxS("Found")] = false;
-                        jMsg[wxS("lat")] = l_dLat;
-                        jMsg[wxS("lon")] = l_dLon;
-                        jMsg[wxS("GUID")] = root[wxS("GUID")];
-                        writer.Write( jMsg, MsgString );
-                        SendPluginMessage( root[wxT("Source")].AsString(), MsgString );
-                        return;
-                    }
-                    bool l_bFound = false;
-                    if(l_boundary) l_bFound = g_pBoundaryMan->FindPointInBoundary( l_boundary, l_dLat, l_dLon );
-                    else if(l_boundarypoint) l_bFound = g_pBoundaryMan->FindPointInBoundaryPoint( l_boundarypoint, l_dLat, l_dLon );
-                    jMsg[wxT("Source")] = wxT("OCPN_DRAW_PI");
-                    jMsg[wxT("Msg")] = root[wxT("Msg")];
-                    jMsg[wxT("Type")] = wxT("Response");
-                    jMsg[wxT("MsgId")] = root[wxT("MsgId")].AsString();
-                    jMsg[wxS("Found")] = l_bFound;
-                    jMsg[wxS("lat")] = l_dLat;
-                    jMsg[wxS("lon")] = l_dLon;
-                    if(l_boundary) {
-                        jMsg[wxS("Name")] = l_boundary->m_PathNameString;
-                        jMsg[wxS("Description")] = l_boundary->m_PathDescription;
-                    } else if(l_boundarypoint) {
-                        jMsg[wxS("Name")] = l_boundarypoint->m_ODPointName;
-                        jMsg[wxS("Description")] = l_boundarypoint->m_ODPointDescription;
-                    } else {
-                        jMsg[wxS("Name")] = wxEmptyString;
-                        jMsg[wxS("Description")] = wxEmptyString;
-                    }
-                    
-                    jMsg[wxS("GUID")] = root[wxS("GUID")];
-                    writer.Write( jMsg, MsgString );
-                    SendPluginMessage( root[wxT("Source")].AsString(), MsgString );
-                    return;
-                }
-            }
-        }
+        g_pODAPI->ProcessMessage( message_body );
         
     } else if(message_id == _T("WMM_VARIATION_BOAT")) {
 
@@ -1668,6 +1349,7 @@ bool ocpn_draw_pi::KeyboardEventHook( wxKeyEvent &event )
 
 bool ocpn_draw_pi::MouseEventHook( wxMouseEvent &event )
 {
+    ODStatsTimer l_timer( ODSTATS_MOUSE_EVENT );
     bool bret = FALSE;
     bool bRefresh = FALSE;
     
@@ -2206,11 +1888,11 @@ void ocpn_draw_pi::SetCursorLatLon(double lat, double lon)
 wxString ocpn_draw_pi::FormatDistanceAdaptive( double distance ) 
 {
     wxString result;
-    wxString *sUnit = new wxString( getUsrDistanceUnit_Plugin( -1 ) );
+    wxString sUnit = getUsrDistanceUnit_Plugin( -1 );
     double usrDistance = toUsrDistance_Plugin( distance, -1 );
-    if( usrDistance < 0.1 &&  ( sUnit->IsSameAs( wxS("km") ) || sUnit->IsSameAs( wxS("mi") ) || sUnit->IsSameAs( wxS("NMi") ) ) ) {
-        if ( sUnit->IsSameAs(wxS("mi")) ) sUnit->assign(wxS("ft"));
-        else sUnit->assign(wxS("M"));
+    if( usrDistance < 0.1 &&  ( sUnit.IsSameAs( wxS("km") ) || sUnit.IsSameAs( wxS("mi") ) || sUnit.IsSameAs( wxS("NMi") ) ) ) {
+        if ( sUnit.IsSameAs(wxS("mi")) ) sUnit.assign(wxS("ft"));
+        else sUnit.assign(wxS("M"));
         usrDistance = toUsrDistance_Plugin( distance, -1 );
     }
     wxString format;
@@ -2223,7 +1905,7 @@ wxString ocpn_draw_pi::FormatDistanceAdaptive( double distance )
     } else {
         format = wxS("%4.0f ");
     }
-    result << wxString::Format(format, usrDistance ) << *sUnit;
+    result << wxString::Format(format, usrDistance ) << sUnit;
     return result;
 }
 void ocpn_draw_pi::latlong_to_chartpix(double lat, double lon, double &pixx, double &pixy) 
@@ -2236,6 +1918,7 @@ void ocpn_draw_pi::latlong_to_chartpix(double lat, double lon, double &pixx, dou
 
 bool ocpn_draw_pi::RenderOverlay(wxMemoryDC *pmdc, PlugIn_ViewPort *pivp)
 {
+    ODStatsTimer l_timer( ODSTATS_RENDER_OVERLAY );
     m_vp = pivp;
     g_pivp = pivp;
     m_chart_scale = pivp->chart_scale;
@@ -2249,45 +1932,52 @@ bool ocpn_draw_pi::RenderOverlay(wxMemoryDC *pmdc, PlugIn_ViewPort *pivp)
 
 bool ocpn_draw_pi::RenderOverlay(wxDC &dc, PlugIn_ViewPort *pivp)
 {
+    ODStatsTimer l_timer( ODSTATS_RENDER_OVERLAY );
     m_vp = pivp;
     g_pivp = pivp;
     m_chart_scale = pivp->chart_scale;
     m_view_scale = pivp->view_scale_ppm;
     
-    g_pDC = new ODDC( dc );
+    ODDC ocpndc( dc );
     LLBBox llbb;
     llbb.SetMin( pivp->lon_min, pivp->lat_min );
     llbb.SetMax( pivp->lon_max, pivp->lat_max );
     
-    DrawAllPathsInBBox( *g_pDC, llbb );
-    DrawAllODPointsInBBox( *g_pDC, llbb );
-    RenderPathLegs( *g_pDC );
+    DrawAllPathsInBBox( ocpndc, llbb );
+    DrawAllODPointsInBBox( ocpndc, llbb );
+    RenderPathLegs( ocpndc );
     
     return TRUE;
 }
 
 bool ocpn_draw_pi::RenderGLOverlay(wxGLContext *pcontext, PlugIn_ViewPort *pivp)
 {
+    ODStatsTimer l_timer( ODSTATS_RENDER_GL_OVERLAY );
     m_pcontext = pcontext;
     m_vp = pivp;
     g_pivp = pivp;
     m_chart_scale = pivp->chart_scale;
     m_view_scale = pivp->view_scale_ppm;
     
-    g_pDC = new ODDC();
+#ifdef ocpnUSE_GL
+    // OpenCPN makes its context current before calling here
+    g_pODTextCache->DeleteReleasedTextures();
+#endif
+
+    ODDC ocpndc;
     LLBBox llbb;
     llbb.SetMin( pivp->lon_min, pivp->lat_min );
     llbb.SetMax( pivp->lon_max, pivp->lat_max );
     
-    //    DrawAllODPointsInBBox( *g_pDC, llbb );
-    RenderPathLegs( *g_pDC );
+    //    DrawAllODPointsInBBox( ocpndc, llbb );
+    RenderPathLegs( ocpndc );
     
     if (m_pMouseBoundary) m_pMouseBoundary->DrawGL( *pivp );
     
     DrawAllPathsAndODPoints( *pivp );
 
     if( g_pODRolloverWin && g_pODRolloverWin->IsActive() && g_pODRolloverWin->GetBitmap() != NULL ) {
-        g_pDC->DrawBitmap( *(g_pODRolloverWin->GetBitmap()),
+        ocpndc.DrawBitmap( *(g_pODRolloverWin->GetBitmap()),
                        g_pODRolloverWin->GetPosition().x,
                        g_pODRolloverWin->GetPosition().y, false );
     }
@@ -2297,7 +1987,9 @@ bool ocpn_draw_pi::RenderGLOverlay(wxGLContext *pcontext, PlugIn_ViewPort *pivp)
 
 void ocpn_draw_pi::RenderPathLegs( ODDC &dc ) 
 {
-    ODDC tdc( dc );
+    // Draw straight onto the caller's ODDC, a copy would share and then
+    // delete its graphics context
+    ODDC &tdc = dc;
     
     if( nBoundary_State >= 2) {
         
@@ -2334,7 +2026,7 @@ void ocpn_draw_pi::RenderPathLegs( ODDC &dc )
                 double p = (double)i * (1.0/(double)milesDiff);
                 double pLat, pLon;
                 Geodesic::GreatCircleTravel( m_prev_rlon, m_prev_rlat, gcDist*p, brg, &pLon, &pLat, &gcBearing2 );
-                GetCanvasPixLL( m_vp, &destPoint, m_cursor_lat, m_cursor_lon);
+                ODProjection::ForViewPort( *m_vp ).GetPixFromLL( m_cursor_lat, m_cursor_lon, &destPoint );
                 //destPoint = VPoint.GetPixFromLL( pLat, pLon );
                 boundary->DrawSegment( tdc, &lastPoint, &destPoint, *m_vp, false );
                 wxPoint rpn;
@@ -2355,63 +2047,30 @@ void ocpn_draw_pi::RenderPathLegs( ODDC &dc )
         wxString info = CreateExtraPathLegInfo(tdc, boundary, brg, dist, m_cursorPoint);
         RenderExtraPathLegInfo( tdc, r_rband, info );
     } else if( nEBL_State > 0 || m_bEBLMoveOrigin ) {
-        EBL *ebl = new EBL();
         double brg, dist;
         wxPoint tpoint;
         if(m_bEBLMoveOrigin) {
             ODPoint *tp = (ODPoint *) m_pSelectedEBL->m_pODPointList->GetLast()->GetData();
-            GetCanvasPixLL( g_pivp, &tpoint, tp->m_lat, tp->m_lon );
+            ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( tp->m_lat, tp->m_lon, &tpoint );
             DistanceBearingMercator_Plugin( m_cursor_lat, m_cursor_lon, tp->m_lat, tp->m_lon, &brg, &dist );
-            ebl->DrawSegment( tdc, &tpoint, &m_cursorPoint, *m_vp, false );
         } else {
-            GetCanvasPixLL( g_pivp, &tpoint, g_pfFix.Lat, g_pfFix.Lon );
+            ODProjection::ForViewPort( *g_pivp ).GetPixFromLL( g_pfFix.Lat, g_pfFix.Lon, &tpoint );
             DistanceBearingMercator_Plugin( m_cursor_lat, m_cursor_lon, g_pfFix.Lat, g_pfFix.Lon, &brg, &dist );
-            ebl->DrawSegment( tdc, &tpoint, &m_cursorPoint, *m_vp, false );
         }
-        wxString info = CreateExtraPathLegInfo(tdc, ebl, brg, dist, m_cursorPoint);
-        if(info.length() > 0)
-            RenderExtraPathLegInfo( tdc, m_cursorPoint, info );
-        delete ebl;
+        // An EBL leg has no running total, so only the bearing/distance label is drawn
+        m_pLegPreview->DrawSegment( tdc, tpoint, m_cursorPoint, *m_vp );
+        m_pLegPreview->DrawLegInfo( tdc, m_cursorPoint, brg, dist );
+    } else if( !m_bODPointEditing ) {
+        // nothing being placed or edited, pick up any font or unit changes
+        // on the next one. An EBL being edited draws its leg info every
+        // frame through CreateExtraPathLegInfo, so keep the font until done.
+        m_pLegPreview->Invalidate();
     }
-        
-        
 }
 
 wxString ocpn_draw_pi::CreateExtraPathLegInfo(ODDC &dc, ODPath *path, double brg, double dist, wxPoint ref_point)
 {
-    wxString pathInfo;
-    if( g_bShowMag )
-        pathInfo << wxString::Format( wxString("%03d°(M)  ", wxConvUTF8 ), (int)GetTrueOrMag( brg ) );
-    else
-        pathInfo << wxString::Format( wxString("%03d°  ", wxConvUTF8 ), (int)GetTrueOrMag( brg ) );
-    
-    pathInfo << wxS(" ") << FormatDistanceAdaptive( dist );
-    
-    wxFont *dFont;
-    dFont = GetOCPNScaledFont_PlugIn( wxS("OD_PathLegInfoRollover"), 0 );
-    dc.SetFont( *dFont );
-    
-    int w, h;
-    int xp, yp;
-    int hilite_offset = 3;
-    #ifdef __WXMAC__
-    wxScreenDC sdc;
-    sdc.GetTextExtent( pathInfo, &w, &h, NULL, NULL, dFont );
-    #else
-    dc.GetTextExtent( pathInfo, &w, &h );
-    #endif
-    xp = ref_point.x - w;
-    yp = ref_point.y;
-    yp += hilite_offset;
-    
-    wxColour tColour;
-    GetGlobalColor( wxS("YELO1"), &tColour );
-    AlphaBlending( dc, xp, yp, w, h, 0.0, tColour, 172 );
-    
-    GetGlobalColor( wxS("UBLCK"), &tColour );
-    dc.SetTextForeground( tColour );
-    dc.SetPen( wxPen( tColour ) );
-    dc.DrawText( pathInfo, xp, yp );
+    m_pLegPreview->DrawLegInfo( dc, ref_point, brg, dist );
     
     wxString s0;
     if(path->m_sTypeString == wxT("Boundary")) {
@@ -2431,30 +2090,10 @@ wxString ocpn_draw_pi::CreateExtraPathLegInfo(ODDC &dc, ODPath *path, double brg
 
 void ocpn_draw_pi::RenderExtraPathLegInfo( ODDC &dc, wxPoint ref_point, wxString s )
 {
-    wxFont *dFont = GetOCPNScaledFont_PlugIn( wxS("OD_PathLegInfoRollover"), 0 );
-    dc.SetFont( *dFont );
-    
-    int w, h;
-    int xp, yp;
+    wxSize l_TextExtents = g_pODTextCache->GetTextExtent( *m_pLegPreview->GetFont(), s );
     int hilite_offset = 3;
-    #ifdef __WXMAC__
-    wxScreenDC sdc;
-    sdc.GetTextExtent(s, &w, &h, NULL, NULL, dFont);
-    #else
-    dc.GetTextExtent( s, &w, &h );
-    #endif
-    
-    xp = ref_point.x - w;
-    yp = ref_point.y + h;
-    yp += hilite_offset;
-    
-    wxColour tColour;
-    GetGlobalColor( wxS("YELO1"), &tColour );
-    AlphaBlending( dc, xp, yp, w, h, 0.0, tColour, 172 );
     
-    GetGlobalColor( wxS("UBLCK"), &tColour );
-    dc.SetPen( wxPen( tColour ) );
-    dc.DrawText( s, xp, yp );
+    m_pLegPreview->DrawLabel( dc, ref_point.x - l_TextExtents.x, ref_point.y + l_TextExtents.y + hilite_offset, s, l_TextExtents );
 }
 
 void ocpn_draw_pi::SetCurrentViewPort(PlugIn_ViewPort &vp)
@@ -2514,6 +2153,7 @@ void ocpn_draw_pi::FinishBoundary( void )
 
 void ocpn_draw_pi::DrawAllPathsInBBox(ODDC &dc,  LLBBox& BltBBox)
 {
+    int l_iPathsDrawn = 0, l_iPathsCulled = 0;
     wxPathListNode *pnode = g_pPathList->GetFirst();
     while( pnode ) {
         bool b_run = false;
@@ -2580,9 +2220,13 @@ void ocpn_draw_pi::DrawAllPathsInBBox(ODDC &dc,  LLBBox& BltBBox)
                     }
                 }
             }
+            if( b_drawn ) l_iPathsDrawn++;
+            else l_iPathsCulled++;
         }
         pnode = pnode->GetNext();
     }
+    ODStatsCount( ODSTATS_PATHS_DRAWN, l_iPathsDrawn );
+    ODStatsCount( ODSTATS_PATHS_CULLED, l_iPathsCulled );
 }
 
 void ocpn_draw_pi::DrawAllODPointsInBBox( ODDC& dc, LLBBox& BltBBox )
@@ -2591,6 +2235,7 @@ void ocpn_draw_pi::DrawAllODPointsInBBox( ODDC& dc, LLBBox& BltBBox )
     if(!g_pODPointMan)
         return;
     
+    int l_iPointsDrawn = 0, l_iPointsCulled = 0;
     wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst();
     
     while( node ) {
@@ -2602,12 +2247,18 @@ void ocpn_draw_pi::DrawAllODPointsInBBox( ODDC& dc, LLBBox& BltBBox )
                 node = node->GetNext();
                 continue;
             } else {
-                if( BltBBox.PointInBox( pOP->m_lon, pOP->m_lat, 0 ) ) pOP->Draw( dc, NULL );
+                if( BltBBox.PointInBox( pOP->m_lon, pOP->m_lat, 0 ) ) {
+                    pOP->Draw( dc, NULL );
+                    l_iPointsDrawn++;
+                } else
+                    l_iPointsCulled++;
             }
         }
         
         node = node->GetNext();
     }
+    ODStatsCount( ODSTATS_POINTS_DRAWN, l_iPointsDrawn );
+    ODStatsCount( ODSTATS_POINTS_CULLED, l_iPointsCulled );
 }
 
 bool ocpn_draw_pi::CreatePointLeftClick( wxMouseEvent &event )
@@ -2976,10 +2627,12 @@ void ocpn_draw_pi::appendOSDirSlash(wxString* pString)
 
 void ocpn_draw_pi::DrawAllPathsAndODPoints( PlugIn_ViewPort &pivp )
 {
+    int l_iPaths = 0, l_iPathsDrawn = 0;
     for(wxPathListNode *node = g_pPathList->GetFirst(); node; node = node->GetNext() ) {
         ODPath *pPathDraw = node->GetData();
         if( !pPathDraw )
             continue;
+        l_iPaths++;
         
         /* defer rendering active routes until later */ 
         //if( pPathDraw->IsActive() || pPathDraw->IsSelected() )
@@ -3004,12 +2657,17 @@ void ocpn_draw_pi::DrawAllPathsAndODPoints( PlugIn_ViewPort &pivp )
         // is not wholly outside viewport
         if(test_maxx >= pivp.lon_min && test_minx <= pivp.lon_max) {
             pPathDraw->DrawGL( pivp );
+            l_iPathsDrawn++;
         } else if( pivp.lat_max > 180. ) {
-            if(test_minx + 360 <= pivp.lon_max && test_maxx + 360 >= pivp.lon_min)
+            if(test_minx + 360 <= pivp.lon_max && test_maxx + 360 >= pivp.lon_min) {
                 pPathDraw->DrawGL( pivp );
+                l_iPathsDrawn++;
+            }
         } else if( pPathDraw->CrossesIDL() || pivp.lon_min < -180. ) {
-            if(test_maxx - 360 >= pivp.lon_min && test_minx - 360 <= pivp.lon_max)
+            if(test_maxx - 360 >= pivp.lon_min && test_minx - 360 <= pivp.lon_max) {
                 pPathDraw->DrawGL( pivp );
+                l_iPathsDrawn++;
+            }
         }
         if(pPathDraw == m_pSelectedEBL && m_bODPointEditing) {
             ODDC dc;
@@ -3018,7 +2676,7 @@ void ocpn_draw_pi::DrawAllPathsAndODPoints( PlugIn_ViewPort &pivp )
             ODPoint *pStartPoint = m_pSelectedEBL->m_pODPointList->GetFirst()->GetData();
             ODPoint *pEndPoint = m_pSelectedEBL->m_pODPointList->GetLast()->GetData();
             DistanceBearingMercator_Plugin( pEndPoint->m_lat, pEndPoint->m_lon, pStartPoint->m_lat, pStartPoint->m_lon, &brg, &dist );
-            GetCanvasPixLL( m_vp, &destPoint, pEndPoint->m_lat, pEndPoint->m_lon);
+            ODProjection::ForViewPort( *m_vp ).GetPixFromLL( pEndPoint->m_lat, pEndPoint->m_lon, &destPoint );
             wxString info = CreateExtraPathLegInfo(dc, m_pSelectedEBL, brg, dist, destPoint);
             if(info.length() > 0)
                 RenderExtraPathLegInfo( dc, destPoint, info );
@@ -3026,14 +2684,23 @@ void ocpn_draw_pi::DrawAllPathsAndODPoints( PlugIn_ViewPort &pivp )
         
     }
         
+    ODStatsCount( ODSTATS_PATHS_DRAWN, l_iPathsDrawn );
+    ODStatsCount( ODSTATS_PATHS_CULLED, l_iPaths - l_iPathsDrawn );
+        
     /* ODPoints not drawn as part of routes */
     ViewPort vp = (ViewPort &)pivp;
     if( pivp.bValid && g_pODPointList ) {
+        int l_iPoints = 0, l_iPointsDrawn = 0;
         for(wxODPointListNode *pnode = g_pODPointMan->GetODPointList()->GetFirst(); pnode; pnode = pnode->GetNext() ) {
             ODPoint *pOP = pnode->GetData();
-            if( ( pOP->m_lon >= pivp.lon_min && pOP->m_lon <= pivp.lon_max ) && ( pOP->m_lat >= pivp.lat_min && pOP->m_lat <= pivp.lat_max ) )
+            l_iPoints++;
+            if( ( pOP->m_lon >= pivp.lon_min && pOP->m_lon <= pivp.lon_max ) && ( pOP->m_lat >= pivp.lat_min && pOP->m_lat <= pivp.lat_max ) ) {
                 pOP->DrawGL( pivp );
+                l_iPointsDrawn++;
+            }
         }
+        ODStatsCount( ODSTATS_POINTS_DRAWN, l_iPointsDrawn );
+        ODStatsCount( ODSTATS_POINTS_CULLED, l_iPoints - l_iPointsDrawn );
     }
         
 }
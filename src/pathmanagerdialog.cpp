@@ -827,6 +827,7 @@ void PathManagerDialog::MakeAllPathsInvisible()
 {
     PathList::iterator it;
     long index = 0;
+    g_pODConfig->BeginTransaction();
     for( it = ( *g_pPathList ).begin(); it != ( *g_pPathList ).end(); ++it, ++index ) {
         if( ( *it )->IsVisible() ) { // avoid config updating as much as possible!
             ( *it )->SetVisible( false );
@@ -834,6 +835,7 @@ void PathManagerDialog::MakeAllPathsInvisible()
             g_pODConfig->UpdatePath( *it ); 
         }
     }
+    g_pODConfig->CommitTransaction();
 }
 
 void PathManagerDialog::ZoomtoPath( ODPath *path )
@@ -876,7 +878,7 @@ void PathManagerDialog::ZoomtoPath( ODPath *path )
 //BEGIN Event handlers
 void PathManagerDialog::OnPathDeleteClick( wxCommandEvent &event )
 {
-    PathList list;
+    ODPathSet paths;
 
     int answer = OCPNMessageBox_PlugIn( this, _("Are you sure you want to delete the selected object(s)"), _("OpenCPN Alert"), wxYES_NO );
     if ( answer != wxID_YES )
@@ -900,18 +902,12 @@ void PathManagerDialog::OnPathDeleteClick( wxCommandEvent &event )
         ODPath *ppath_to_delete = g_pPathList->Item( m_pPathListCtrl->GetItemData( item ) )->GetData();
 
         if( ppath_to_delete )
-            list.Append( ppath_to_delete );
+            paths.insert( ppath_to_delete );
     }
 
     if( busy ) {
 
-        for(unsigned int i=0 ; i < list.GetCount() ; i++) {
-            ODPath *path = list.Item(i)->GetData();
-            if( path ) {
-                g_pODConfig->DeleteConfigPath( path );
-                g_pPathMan->DeletePath( path );
-            }
-        }
+        g_pPathMan->DeletePaths( paths );
 
         m_lastPathItem = -1;
         UpdatePathListCtrl();
@@ -1492,6 +1488,7 @@ void PathManagerDialog::OnODPointZoomtoClick( wxCommandEvent &event )
 void PathManagerDialog::OnODPointDeleteClick( wxCommandEvent &event )
 {
     ODPointList list;
+    ODPointSet points;
 
     int answer = OCPNMessageBox_PlugIn( this, _("Are you sure you want to delete the selected object(s)"), wxString( _("OpenCPN Alert") ), wxYES_NO );
     if ( answer != wxID_YES )
@@ -1527,13 +1524,14 @@ void PathManagerDialog::OnODPointDeleteClick( wxCommandEvent &event )
                 if ( wp->m_bIsInPath )
                 {
                     if ( wxYES == OCPNMessageBox_PlugIn(this,  _( "The OD Point you want to delete is used in a path, do you really want to delete it?" ), _( "OpenCPN Alert" ), wxYES_NO ))
-                            g_pODPointMan->DestroyODPoint( wp );
+                            points.insert( wp );
                 }
                 else
-                    g_pODPointMan->DestroyODPoint( wp );
+                    points.insert( wp );
 
             }
         }
+        g_pODPointMan->DeleteODPoints( points );
 
         long item_next = m_pODPointListCtrl->GetNextItem( item_last_selected );         // next in list
         ODPoint *wp_next = NULL;
@@ -1747,36 +1745,29 @@ void PathManagerDialog::OnLayDeleteClick( wxCommandEvent &event )
     if ( answer == wxID_NO )
         return;
     
-    // Process Tracks and Routes in this layer
-    wxPathListNode *node1 = g_pPathList->GetFirst();
-    wxPathListNode *node2;
-    while( node1 ) {
-        ODPath *pPath = node1->GetData();
-        node2 = node1->GetNext();
-        if( pPath->m_bIsInLayer && ( pPath->m_LayerID == layer->m_LayerID ) ) {
-            pPath->m_bIsInLayer = false;
-            pPath->m_LayerID = 0;
-            g_pPathMan->DeletePath( pPath );
-        }
-        node1 = node2;
-        node2 = NULL;
-    }
+    // Take the layer's contents, deleting them would otherwise edit the sets being walked
+    LayerPathSet l_Paths;
+    LayerODPointSet l_ODPoints;
+    l_Paths.swap( layer->m_Paths );
+    l_ODPoints.swap( layer->m_ODPoints );
 
     // Process ODPoints in this layer
-    wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst();
-    wxODPointListNode *node3;
+    for( LayerODPointSet::iterator it = l_ODPoints.begin(); it != l_ODPoints.end(); ++it ) {
+        ODPoint *rp = *it;
+        rp->m_bIsInLayer = false;
+        rp->m_LayerID = 0;
+        g_pODPointMan->DestroyODPoint( rp, false );         // no need to update the change set on layer ops
+    }
 
-    while( node ) {
-        node3 = node->GetNext();
-        ODPoint *rp = node->GetData();
-        if( rp && ( rp->m_LayerID == layer->m_LayerID ) ) {
-            rp->m_bIsInLayer = false;
-            rp->m_LayerID = 0;
-            g_pODPointMan->DestroyODPoint( rp, false );         // no need to update the change set on layer ops
-        }
+    // What is left selectable belongs to the layer's paths, drop it all at once
+    g_pODSelect->DeleteAllSelectableLayerObjects( layer->m_LayerID );
 
-        node = node3;
-        node3 = NULL;
+    // Process Paths in this layer
+    for( LayerPathSet::iterator it = l_Paths.begin(); it != l_Paths.end(); ++it ) {
+        ODPath *pPath = *it;
+        pPath->m_bIsInLayer = false;
+        pPath->m_LayerID = 0;
+        g_pPathMan->DeletePath( pPath, false );
     }
 
     pLayerList->DeleteObject( layer );
@@ -1810,27 +1801,15 @@ void PathManagerDialog::OnLayToggleChartClick( wxCommandEvent &event )
 void PathManagerDialog::ToggleLayerContentsOnChart( Layer *layer )
 {
     // Process Paths in this layer
-    wxPathListNode *node1 = g_pPathList->GetFirst();
-    while( node1 ) {
-        ODPath *pPath = node1->GetData();
-        if( pPath->m_bIsInLayer && ( pPath->m_LayerID == layer->m_LayerID ) ) {
-            pPath->SetVisible( layer->IsVisibleOnChart() );
-            g_pODConfig->UpdatePath( pPath );
-        }
-        node1 = node1->GetNext();
+    for( LayerPathSet::iterator it = layer->m_Paths.begin(); it != layer->m_Paths.end(); ++it ) {
+        ODPath *pPath = *it;
+        pPath->SetVisible( layer->IsVisibleOnChart() );
+        g_pODConfig->UpdatePath( pPath );
     }
 
     // Process OD points in this layer
-    wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst();
-
-    while( node ) {
-        ODPoint *rp = node->GetData();
-        if( rp && ( rp->m_LayerID == layer->m_LayerID ) ) {
-            rp->SetVisible( layer->IsVisibleOnChart() );
-        }
-
-        node = node->GetNext();
-    }
+    for( LayerODPointSet::iterator it = layer->m_ODPoints.begin(); it != layer->m_ODPoints.end(); ++it )
+        (*it)->SetVisible( layer->IsVisibleOnChart() );
 
     UpdatePathListCtrl();
     UpdateODPointsListCtrl();
@@ -1859,31 +1838,19 @@ void PathManagerDialog::OnLayToggleNamesClick( wxCommandEvent &event )
 void PathManagerDialog::ToggleLayerContentsNames( Layer *layer )
 {
     // Process Paths in this layer
-    wxPathListNode *node1 = g_pPathList->GetFirst();
-    while( node1 ) {
-        ODPath *pPath = node1->GetData();
-        if( pPath->m_bIsInLayer && ( pPath->m_LayerID == layer->m_LayerID ) ) {
-            wxODPointListNode *node = pPath->m_pODPointList->GetFirst();
-            ODPoint *prp1 = node->GetData();
-            while( node ) {
-                prp1->m_bShowName = layer->HasVisibleNames();
-                node = node->GetNext();
-            }
+    for( LayerPathSet::iterator it = layer->m_Paths.begin(); it != layer->m_Paths.end(); ++it ) {
+        ODPath *pPath = *it;
+        wxODPointListNode *node = pPath->m_pODPointList->GetFirst();
+        ODPoint *prp1 = node->GetData();
+        while( node ) {
+            prp1->m_bShowName = layer->HasVisibleNames();
+            node = node->GetNext();
         }
-        node1 = node1->GetNext();
     }
 
     // Process OD points in this layer
-    wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst();
-
-    while( node ) {
-        ODPoint *rp = node->GetData();
-        if( rp && ( rp->m_LayerID == layer->m_LayerID ) ) {
-            rp->SetNameShown( layer->HasVisibleNames() );
-        }
-
-        node = node->GetNext();
-    }
+    for( LayerODPointSet::iterator it = layer->m_ODPoints.begin(); it != layer->m_ODPoints.end(); ++it )
+        (*it)->SetNameShown( layer->HasVisibleNames() );
 
     UpdateLayButtons();
 
@@ -1911,29 +1878,21 @@ void PathManagerDialog::ToggleLayerContentsOnListing( Layer *layer )
     ::wxBeginBusyCursor();
 
     // Process Paths in this layer
-    wxPathListNode *node1 = g_pPathList->GetFirst();
-    while( node1 ) {
-        ODPath *pPath = node1->GetData();
-        if( pPath->m_bIsInLayer && ( pPath->m_LayerID == layer->m_LayerID ) ) {
-            pPath->SetListed( layer->IsVisibleOnListing() );
-            g_pODConfig->UpdatePath(pPath);
-        }
-        node1 = node1->GetNext();
+    for( LayerPathSet::iterator it = layer->m_Paths.begin(); it != layer->m_Paths.end(); ++it ) {
+        ODPath *pPath = *it;
+        pPath->SetListed( layer->IsVisibleOnListing() );
+        g_pODConfig->UpdatePath(pPath);
     }
 
     // Process OD points in this layer
     //  n.b.  If the OD point belongs to a track, and is not shared, then do not list it.
     //  This is a performance optimization, allowing large track support.
 
-    wxODPointListNode *node = g_pODPointMan->GetODPointList()->GetFirst();
-
-    while( node ) {
-        ODPoint *rp = node->GetData();
-        if( rp && !rp->m_bIsInTrack && rp->m_bIsolatedMark && ( rp->m_LayerID == layer->m_LayerID ) ) {
+    for( LayerODPointSet::iterator it = layer->m_ODPoints.begin(); it != layer->m_ODPoints.end(); ++it ) {
+        ODPoint *rp = *it;
+        if( !rp->m_bIsInTrack && rp->m_bIsolatedMark ) {
             rp->SetListed( layer->IsVisibleOnListing() );
         }
-
-        node = node->GetNext();
     }
 
     UpdatePathListCtrl();